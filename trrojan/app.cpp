@@ -170,6 +170,7 @@ void App::Run(void) {
 
                 // Run the test.
                 exe.trroll(trroll_file, *output, cool_down, power_collector);
+                output->finish();
                 } break;
 
             case State::PromptResult:
@@ -5,9 +5,11 @@
 // <author>Christoph Müller</author>
 // <author>Michael Becher</author>
 
+#include <algorithm>
 #include <iostream>
 #include <memory>
 #include <numeric>
+#include <sstream>
 
 #if defined(TRROJAN_FOR_UWP)
 #include <Windows.h>
@@ -16,13 +18,22 @@
 
 #include "trrojan/cmd_line.h"
 #include "trrojan/console_output.h"
+#include "trrojan/csv_output_params.h"
 #include "trrojan/executive.h"
 #include "trrojan/log.h"
 #include "trrojan/power_collector.h"
 #include "trrojan/power_state_scope.h"
+#include "trrojan/result_comparison.h"
+#include "trrojan/system_factors.h"
+#include "trrojan/timer.h"
+#include "trrojan/trace.h"
 
 #include "app.h"
 
+#if defined(TRROJAN_WITH_STATIC_PLUGINS)
+#include "static_plugins.h"
+#endif /* defined(TRROJAN_WITH_STATIC_PLUGINS) */
+
 
 #if defined(TRROJAN_FOR_UWP)
 /// <summary>
@@ -52,17 +63,34 @@ int main(const int argc, const char **argv) {
     const trrojan::cmd_line cmdLine(argv, argv + argc);
     std::shared_ptr<trrojan::power_collector> power_collector;
     std::unique_ptr<trrojan::power_state_scope> power_state_scope;
+    std::string trace;
+
+    /* Export the trace and summarise where the time has been spent. */
+    auto exportTrace = [&trace](void) {
+        if (!trace.empty()) {
+            trrojan::trace::enable(false);
+            trrojan::trace::write_json(trace);
+            std::cout << std::endl;
+            trrojan::trace::write_summary(std::cout);
+        }
+    };
 
     try {
         /* Configure the log, which must be the very first step. */
         {
             auto it = trrojan::find_argument("--log", cmdLine.begin(),
                 cmdLine.end());
-            if (it != cmdLine.end()) {
-                // Initialise the singleton with a file sink. If this is not
-                // done, the default initialisation with a console sink is done
-                // lazily.
-                auto& l = trrojan::log::instance(it->c_str());
+            auto queueSize = trrojan::contains_switch("--async-log",
+                cmdLine.begin(), cmdLine.end())
+                ? trrojan::log::default_queue_size
+                : 0;
+            if ((it != cmdLine.end()) || (queueSize > 0)) {
+                // Initialise the singleton with a file sink and/or in
+                // asynchronous mode. If this is not done, the default
+                // initialisation with a console sink is done lazily.
+                auto& l = trrojan::log::instance((it != cmdLine.end())
+                    ? it->c_str()
+                    : nullptr, queueSize);
             }
         }
 
@@ -77,7 +105,109 @@ int main(const int argc, const char **argv) {
                 << std::endl << std::endl;
         }
 
-#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+        /* Compare two result files instead of running benchmarks. */
+        if (trrojan::contains_switch("--compare", cmdLine.begin(),
+                cmdLine.end())) {
+            auto baseline = trrojan::find_argument("--compare",
+                cmdLine.begin(), cmdLine.end());
+            if ((baseline == cmdLine.end())
+                    || (std::next(baseline) == cmdLine.end())) {
+                throw std::invalid_argument("--compare requires the paths to "
+                    "the baseline results and to the current results.");
+            }
+            auto current = std::next(baseline);
+
+            auto metric = trrojan::find_argument("--metric", cmdLine.begin(),
+                cmdLine.end());
+            if (metric == cmdLine.end()) {
+                throw std::invalid_argument("--compare requires the name of "
+                    "the column to compare to be specified using --metric.");
+            }
+
+            // Use the same separator as when writing the files.
+            trrojan::csv_output_params params(*baseline, cmdLine.begin(),
+                cmdLine.end());
+            trrojan::result_comparison comparison(*metric,
+                params.separator());
+
+            {
+                auto it = trrojan::find_argument("--factors", cmdLine.begin(),
+                    cmdLine.end());
+                if (it == cmdLine.end()) {
+                    throw std::invalid_argument("--compare requires the "
+                        "columns identifying a configuration to be specified "
+                        "using --factors.");
+                }
+
+                std::vector<std::string> factors;
+                std::stringstream stream(*it);
+                std::string factor;
+                while (std::getline(stream, factor, ',')) {
+                    factors.push_back(trrojan::trim(factor));
+                }
+                comparison.factors(factors);
+            }
+            {
+                auto it = trrojan::find_argument("--threshold",
+                    cmdLine.begin(), cmdLine.end());
+                if (it != cmdLine.end()) {
+                    comparison.threshold(trrojan::parse<double>(it->c_str()));
+                }
+            }
+            {
+                auto it = trrojan::find_argument("--significance",
+                    cmdLine.begin(), cmdLine.end());
+                if (it != cmdLine.end()) {
+                    comparison.significance(trrojan::parse<double>(it->c_str()));
+                }
+            }
+            comparison.higher_is_better(trrojan::contains_switch(
+                "--higher-is-better", cmdLine.begin(), cmdLine.end()));
+
+            auto entries = comparison.compare(*baseline, *current);
+            trrojan::result_comparison::write_report(std::cout, entries);
+
+            // Report regressions via the exit code, e.g. to fail CI builds.
+            auto isRegression = std::any_of(entries.begin(), entries.end(),
+                [](const trrojan::result_comparison::entry& e) {
+                    return (e.verdict
+                        == trrojan::result_comparison::verdict::regression);
+                });
+            return isRegression ? 1 : 0;
+        }
+
+        /* Select the timer before anything is measured. */
+        {
+            auto it = trrojan::find_argument("--timer", cmdLine.begin(),
+                cmdLine.end());
+            if (it != cmdLine.end()) {
+                trrojan::timer::select_source(
+                    trrojan::timer::parse_source(*it));
+            }
+        }
+
+        /* Enable tracing of the campaign on request. */
+        {
+            auto it = trrojan::find_argument("--trace", cmdLine.begin(),
+                cmdLine.end());
+            if (it != cmdLine.end()) {
+                trace = *it;
+                trrojan::trace::enable(true);
+            }
+        }
+
+        /* Capture the static system factors before running anything. */
+        {
+            auto it = trrojan::find_argument("--system-info-cache",
+                cmdLine.begin(), cmdLine.end());
+            if (it != cmdLine.end()) {
+                trrojan::system_factors::use_cache_file(*it);
+            }
+
+            trrojan::system_factors::instance().snapshot();
+        }
+
+#if defined(TRROJAN_WITH_POWER_COLLECTOR)
         {
             auto it = trrojan::find_argument("--power", cmdLine.begin(),
                 cmdLine.end());
@@ -87,7 +217,7 @@ int main(const int argc, const char **argv) {
                 power_collector->start(*it, std::chrono::milliseconds(5));
             }
         }
-#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#endif /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
 
         /* Configure the output target for the results. */
         auto output = trrojan::open_output(cmdLine);
@@ -110,6 +240,35 @@ int main(const int argc, const char **argv) {
                 coolDown.duration = v_t(trrojan::parse<v_t::rep>(it->c_str()));
             }
         }
+        {
+            auto it = trrojan::find_argument("--cool-down-temperature",
+                cmdLine.begin(), cmdLine.end());
+            if (it != cmdLine.end()) {
+                coolDown.temperature = trrojan::parse<float>(it->c_str());
+            }
+        }
+        {
+            auto it = trrojan::find_argument("--cool-down-clock-ratio",
+                cmdLine.begin(), cmdLine.end());
+            if (it != cmdLine.end()) {
+                coolDown.clock_ratio = trrojan::parse<float>(it->c_str());
+            }
+        }
+        {
+            auto it = trrojan::find_argument("--cool-down-timeout",
+                cmdLine.begin(), cmdLine.end());
+            if (it != cmdLine.end()) {
+                typedef decltype(coolDown.timeout) v_t;
+                coolDown.timeout = v_t(trrojan::parse<v_t::rep>(it->c_str()));
+            }
+        }
+        {
+            auto it = trrojan::find_argument("--cool-down-retries",
+                cmdLine.begin(), cmdLine.end());
+            if (it != cmdLine.end()) {
+                coolDown.retries = trrojan::parse<unsigned int>(it->c_str());
+            }
+        }
 
         /* Configure GPU boost behaviour. */
         {
@@ -131,7 +290,11 @@ int main(const int argc, const char **argv) {
 
         /* Configure the executive. */
         trrojan::executive exe;
+#if defined(TRROJAN_WITH_STATIC_PLUGINS)
+        exe.load_plugins(cmdLine, trrojan::static_plugins);
+#else /* defined(TRROJAN_WITH_STATIC_PLUGINS) */
         exe.load_plugins(cmdLine);
+#endif /* defined(TRROJAN_WITH_STATIC_PLUGINS) */
 
         /* Run TRROLL script if any. */
         {
@@ -146,10 +309,22 @@ int main(const int argc, const char **argv) {
             }
         }
 
+        /* Mark the output as complete as we did not get any exception. */
+        output->finish();
+
+        exportTrace();
         return 0;
 
     } catch (std::exception& ex) {
         trrojan::log::instance().write_line(ex);
+
+        /* The trace is most valuable if the run failed, so write it anyway. */
+        try {
+            exportTrace();
+        } catch (std::exception& ex) {
+            trrojan::log::instance().write_line(ex);
+        }
+
         return -1;
     }
 }
@@ -17,7 +17,9 @@
 #include "trrojan/opencl/util.h"
 
 #include "trrojan/enum_parse_helper.h"
+#include "trrojan/prefetch_cache.h"
 
+#include <memory>
 #include <unordered_set>
 #include <unordered_map>
 
@@ -130,8 +132,31 @@ namespace opencl
         ///
         virtual bool can_run(trrojan::environment env, trrojan::device device) const noexcept;
 
+    protected:
+
+        /// <summary>
+        /// Reads the volume of the given configuration in the background.
+        /// </summary>
+        /// <param name="cfg">The configuration that is run next.</param>
+        virtual void prefetch(const configuration &cfg);
+
     private:
 
+        /// <summary>
+        /// A cache of volumes that have been read in the background.
+        /// </summary>
+        typedef prefetch_cache<std::string, std::shared_ptr<const dat_raw_reader>>
+            volume_cache;
+
+        /// <summary>
+        /// Read the volume data described by the given .dat file.
+        /// </summary>
+        /// <param name="dat_file">Name of the .dat-file that contains the information
+        /// on the volume data.</param>
+        /// <returns>The reader holding the volume data.</returns>
+        static std::shared_ptr<const dat_raw_reader> read_volume(
+            const std::string &dat_file);
+
         /// <summary>
         /// Add a factor that is relevant during kernel run-time.
         /// </summary>
@@ -575,6 +600,12 @@ namespace opencl
         /// </summary>
         dat_raw_reader _dr;
 
+        /// <summary>
+        /// Volumes that have been read while the previous configuration was
+        /// being measured.
+        /// </summary>
+        volume_cache _volumes;
+
         /// <summary>
         /// Unordered map to store OpenCL kernel snippets.
         /// </summary>
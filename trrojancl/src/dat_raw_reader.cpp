@@ -13,11 +13,15 @@
 #include <iterator>
 #include <cassert>
 
+#include "trrojan/trace.h"
+
 /*
  * trrojan::opencl::dat_raw_reader::read_files
  */
 void trrojan::opencl::dat_raw_reader::read_files(const std::string dat_file_name)
 {
+    TRROJAN_TRACE_ZONE("opencl::dat_raw_reader::read_files", "data");
+
     // check file
     if (!dat_file_name.empty())
     {
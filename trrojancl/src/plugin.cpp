@@ -14,7 +14,15 @@
 /// <summary>
 /// Gets a new instance of the plugin descriptor.
 /// </summary>
+/// <remarks>
+/// If the plugin is linked statically, the entry point is named after the
+/// plugin such that it does not clash with the ones of other plugins.
+/// </remarks>
+#if defined(TRROJANCL_STATIC)
+extern "C" trrojan::plugin_base *get_trrojancl_plugin(void)
+#else /* defined(TRROJANCL_STATIC) */
 extern "C" TRROJANCL_API trrojan::plugin_base *get_trrojan_plugin(void)
+#endif /* defined(TRROJANCL_STATIC) */
 {
     return new trrojan::opencl::plugin();
 }
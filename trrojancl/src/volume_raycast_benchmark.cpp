@@ -7,6 +7,8 @@
 #include "trrojan/opencl/volume_raycast_benchmark.h"
 
 #include <cassert>
+#include <deque>
+#include <limits>
 #include <random>
 #include <numeric>
 #define _USE_MATH_DEFINES
@@ -19,6 +21,7 @@
 #include "trrojan/process.h"
 #include "trrojan/timer.h"
 #include "trrojan/log.h"
+#include "trrojan/trace.h"
 
 #include "glm/gtc/type_ptr.hpp"
 #define GLM_ENABLE_EXPERIMENTAL
@@ -230,7 +233,8 @@ size_t trrojan::opencl::volume_raycast_benchmark::run(const configuration_set& c
                                                       const cool_down& coolDown)
 {
     std::unordered_set<std::string> changed;
-    size_t retval;
+    std::deque<trrojan::configuration> queue;
+    size_t retval = 0;
 
     // Check that caller has provided all required factors.
     this->check_required_factors(configs);
@@ -239,7 +243,7 @@ size_t trrojan::opencl::volume_raycast_benchmark::run(const configuration_set& c
     auto cs = configs;
     cs.merge(this->_default_configs, false);
 
-    cs.foreach_configuration([&](trrojan::configuration& cs) -> bool
+    auto invoke = [&](trrojan::configuration& cs) -> bool
     {
         auto e = cs.get<trrojan::environment>(environment_base::factor_name);
         auto d = cs.get<trrojan::device>(device_base::factor_name);
@@ -384,8 +388,31 @@ size_t trrojan::opencl::volume_raycast_benchmark::run(const configuration_set& c
         auto r = result_callback(std::move(this->run(cs)));
         ++retval;
         return r;
+    };
+
+    // Like benchmark_base::run, enumerate the configurations ahead of the
+    // measurements such that the next volume is read while measuring.
+    auto isRunning = cs.foreach_configuration([&](trrojan::configuration& c) -> bool
+    {
+        this->prefetch(c);
+
+        queue.push_back(c);
+        if (queue.size() <= this->_prefetch_depth)
+        {
+            return true;
+        }
+
+        auto r = invoke(queue.front());
+        queue.pop_front();
+        return r;
     });
 
+    while (isRunning && !queue.empty())
+    {
+        isRunning = invoke(queue.front());
+        queue.pop_front();
+    }
+
     return retval;
 }
 
@@ -402,6 +429,12 @@ trrojan::result trrojan::opencl::volume_raycast_benchmark::run(const configurati
     auto imgSize = cfg.find(factor_viewport)->value().as<std::array<unsigned int, 2>>();
     std::array<unsigned int, 3> img_dim = { {imgSize.at(0), imgSize.at(1), 1u} };
     cl_int evt_status = CL_QUEUED;
+
+    // Only the frames are measured, not the read-back of the image.
+    auto powerCollector = benchmark_base::initialise_power_collector(cfg);
+    power_scope powerScope(powerCollector);
+    const auto powerUid = powerScope.uid();
+
     for (int i = 0; i < run_iterations; ++i)
     {
         cl_int evt_status = CL_QUEUED;
@@ -431,6 +464,15 @@ trrojan::result trrojan::opencl::volume_raycast_benchmark::run(const configurati
         }
     }
 
+    const auto energy = powerScope.leave();
+
+    // The energy covers all frames, so we relate it to all of them.
+    auto framesPerJoule = std::numeric_limits<double>::quiet_NaN();
+    if (energy > 0.0)
+    {
+        framesPerJoule = static_cast<double>(run_iterations) / energy;
+    }
+
     // calc median of execution times of all runs
     //std::sort(times.begin(), times.end());
     double median = times.at(times.size() / 2);
@@ -534,12 +576,47 @@ trrojan::result trrojan::opencl::volume_raycast_benchmark::run(const configurati
     std::vector<std::string> result_names;
     for (int i = 0; i < run_iterations; ++i)
         result_names.push_back("execution_time_" + std::to_string(i));
+    result_names.push_back("power_uid");
+    result_names.push_back("energy");
+    result_names.push_back("frames_per_joule");
+    times.emplace_back(powerUid);
+    times.emplace_back(energy);
+    times.emplace_back(framesPerJoule);
 
     auto retval = std::make_shared<basic_result>(result_cfg, std::move(result_names));
     retval->add(times);
     return retval;
 }
 
+/*
+ * trrojan::opencl::volume_raycast_benchmark::prefetch
+ */
+void trrojan::opencl::volume_raycast_benchmark::prefetch(const configuration &cfg)
+{
+    // Only the volume can be read without an OpenCL context. Invalid
+    // configurations are reported once they are actually run.
+    try
+    {
+        auto dat_file = cfg.get<std::string>(factor_volume_file_name);
+        _volumes.prefetch(dat_file, [dat_file](void)
+        {
+            return volume_raycast_benchmark::read_volume(dat_file);
+        });
+    }
+    catch (...) { }
+}
+
+/*
+ * trrojan::opencl::volume_raycast_benchmark::read_volume
+ */
+std::shared_ptr<const trrojan::opencl::dat_raw_reader>
+trrojan::opencl::volume_raycast_benchmark::read_volume(const std::string &dat_file)
+{
+    auto retval = std::make_shared<dat_raw_reader>();
+    retval->read_files(dat_file);
+    return retval;
+}
+
 /**
  * trrojan::opencl::volume_raycast_benchmark::set_shuffled_ray_ids
  */
@@ -703,7 +780,12 @@ const std::vector<char> & trrojan::opencl::volume_raycast_benchmark::load_volume
 
     try
     {
-        _dr.read_files(dat_file);
+        // The volume might already have been read while the previous
+        // configuration was measured.
+        _dr = *_volumes.get(dat_file, [&dat_file](void)
+        {
+            return volume_raycast_benchmark::read_volume(dat_file);
+        });
     }
     catch (std::runtime_error e)
     {
@@ -1052,6 +1134,8 @@ void trrojan::opencl::volume_raycast_benchmark::build_kernel(environment::pointe
                                                              const float precision_div,
                                                              const std::string &build_flags)
 {
+    TRROJAN_TRACE_ZONE("opencl::volume_raycast_benchmark::build_kernel",
+        "shader");
 //    std::cout << _kernel_source << std::endl; // DEBUG: print out composed kernel source
     cl::Program::Sources source; 
     source.push_back(kernel_source);
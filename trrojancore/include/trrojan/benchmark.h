@@ -174,10 +174,71 @@ namespace trrojan {
 
     protected:
 
+        /// <summary>
+        /// A scope guard that enters a power scope when it is created and
+        /// leaves it at the latest when it is destroyed.
+        /// </summary>
+        /// <remarks>
+        /// Benchmarks should hold the guard across the timed region instead of
+        /// calling <see cref="enter_power_scope" /> and
+        /// <see cref="leave_power_scope" /> themselves, because otherwise the
+        /// <see cref="trrojan::prefetch_gate" /> would remain suspended if the
+        /// measurement throws, which blocks all background jobs forever.
+        /// </remarks>
+        class TRROJANCORE_API power_scope final {
+
+        public:
+
+            /// <summary>
+            /// Enters the power scope of <paramref name="collector" />.
+            /// </summary>
+            /// <param name="collector">An optional power collector.</param>
+            explicit power_scope(const power_collector::pointer& collector);
+
+            power_scope(const power_scope&) = delete;
+
+            /// <summary>
+            /// Leaves the scope unless <see cref="leave" /> has already been
+            /// called.
+            /// </summary>
+            ~power_scope(void);
+
+            /// <summary>
+            /// Leaves the scope.
+            /// </summary>
+            /// <returns>The energy in Joules that has been consumed in the
+            /// scope, or a quiet NaN if there is no collector, if the
+            /// collector cannot measure energy or if the scope has already
+            /// been left.</returns>
+            double leave(void);
+
+            /// <summary>
+            /// Answer the ID of the power measuring scope.
+            /// </summary>
+            inline const std::string& uid(void) const {
+                return this->_uid;
+            }
+
+            power_scope& operator =(const power_scope&) = delete;
+
+        private:
+
+            power_collector::pointer _collector;
+            bool _left;
+            std::string _uid;
+        };
+
         /// <summary>
         /// If <paramref name="collector" /> is not <c>nullptr</c>, enter a new
         /// unique power measurement scope and return its name.
         /// </summary>
+        /// <remarks>
+        /// Regardless of the collector, the method suspends the
+        /// <see cref="trrojan::prefetch_gate" /> and enters a measurement
+        /// scope of the <see cref="trrojan::log" />, which are both left in
+        /// <see cref="leave_power_scope" />. Prefer <see cref="power_scope" />
+        /// over calling this method directly.
+        /// </remarks>
         /// <param name="collector">An optional power collector.</param>
         /// <returns>The ID of the power measuring scope.</returns>
         static std::string enter_power_scope(
@@ -202,7 +263,10 @@ namespace trrojan {
         /// samples until the next scope is entered.
         /// </summary>
         /// <param name="collector">An optional power collector.</param>
-        static void leave_power_scope(
+        /// <returns>The energy in Joules that has been consumed in the scope,
+        /// or a quiet NaN if there is no collector or if the collector cannot
+        /// measure energy.</returns>
+        static double leave_power_scope(
             const power_collector::pointer& collector);
 
         /// <summary>
@@ -211,12 +275,19 @@ namespace trrojan {
         static trrojan::configuration& merge_system_factors(
             trrojan::configuration& c);
 
+        /// <summary>
+        /// The number of configurations the enumeration in
+        /// <see cref="run" /> runs ahead of the measurements by default.
+        /// </summary>
+        static const std::size_t default_prefetch_depth;
+
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
         /// <param name="name">The name of the benchmark, which must be unique
         /// within its plugin.</param>
-        inline benchmark_base(const std::string& name) : _name(name) { }
+        inline benchmark_base(const std::string& name)
+            : _prefetch_depth(default_prefetch_depth), _name(name) { }
 
         /// <summary>
         /// Initialises a new instance.
@@ -227,7 +298,8 @@ namespace trrojan {
         /// tested.</param>
         inline benchmark_base(const std::string& name,
             trrojan::configuration_set default_configs)
-            : _default_configs(default_configs), _name(name) { }
+            : _default_configs(default_configs),
+            _prefetch_depth(default_prefetch_depth), _name(name) { }
 
         /// <summary>
         /// Compares the given configuration to the last configuration and
@@ -271,6 +343,28 @@ namespace trrojan {
         /// </summary>
         void log_run(const trrojan::configuration& c) const;
 
+        /// <summary>
+        /// Notifies the benchmark that <paramref name="config" /> will be run
+        /// after the configurations that are currently queued.
+        /// </summary>
+        /// <remarks>
+        /// <para>The method is called from <see cref="run" /> for each
+        /// configuration <see cref="_prefetch_depth" /> configurations before
+        /// it is actually measured. Benchmarks can use this to start preparing
+        /// the data of the configuration in the background, for instance using
+        /// a <see cref="trrojan::prefetch_cache" />, while the current
+        /// configuration is being set up. The background work does not
+        /// overlap with timed regions, because a <see cref="power_scope" />
+        /// suspends the <see cref="trrojan::prefetch_gate" />, which waits for
+        /// the running job to complete.</para>
+        /// <para>Implementations must not block and should not throw. Errors
+        /// should rather be reported once the configuration is run.</para>
+        /// <para>The default implementation does nothing.</para>
+        /// </remarks>
+        /// <param name="config">The upcoming configuration, which does not
+        /// yet contain the system factors.</param>
+        virtual void prefetch(const trrojan::configuration& config);
+
         /// <summary>
         /// The default configuration set which is used to find required
         /// factors and to fill-in missing ones.
@@ -284,6 +378,15 @@ namespace trrojan {
         /// </remarks>
         trrojan::configuration_set _default_configs;
 
+        /// <summary>
+        /// The number of configurations that are passed to
+        /// <see cref="prefetch" /> before the current one is run.
+        /// </summary>
+        /// <remarks>
+        /// Setting this to zero disables the lookahead.
+        /// </remarks>
+        std::size_t _prefetch_depth;
+
     private:
 
         /// <summary>
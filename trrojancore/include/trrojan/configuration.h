@@ -6,11 +6,15 @@
 
 #pragma once
 
+#include <cassert>
+#include <cstddef>
 #include <iterator>
+#include <memory>
 #include <ostream>
 #include <sstream>
 #include <stdexcept>
 #include <string>
+#include <utility>
 #include <vector>
 
 #include "trrojan/export.h"
@@ -23,14 +27,83 @@ namespace trrojan {
     /// A configuration, which is defined as a set of manifestations of
     /// (named) factors.
     /// </summary>
+    /// <remarks>
+    /// The static system factors are not copied into the configuration, but
+    /// all configurations share the immutable snapshot of
+    /// <see cref="trrojan::system_factors" />. Only the dynamic system
+    /// factors are stored in each configuration. Iterating over the
+    /// configuration yields all factors in the order they have been added.
+    /// </remarks>
     class TRROJANCORE_API configuration {
 
     public:
 
         typedef std::vector<named_variant> container_type;
-        typedef container_type::const_iterator iterator_type;
         typedef container_type::value_type value_type;
 
+        /// <summary>
+        /// A forward iterator over all factors of a configuration, including
+        /// the system factors.
+        /// </summary>
+        class const_iterator {
+
+        public:
+
+            typedef std::forward_iterator_tag iterator_category;
+            typedef std::ptrdiff_t difference_type;
+            typedef const named_variant *pointer;
+            typedef const named_variant& reference;
+            typedef named_variant value_type;
+
+            inline const_iterator(void) : _index(0), _owner(nullptr) { }
+
+            inline reference operator *(void) const {
+                assert(this->_owner != nullptr);
+                return (*this->_owner)[this->_index];
+            }
+
+            inline pointer operator ->(void) const {
+                return &**this;
+            }
+
+            inline const_iterator& operator ++(void) {
+                ++this->_index;
+                return *this;
+            }
+
+            inline const_iterator operator ++(int) {
+                auto retval = *this;
+                ++this->_index;
+                return retval;
+            }
+
+            inline bool operator ==(const const_iterator& rhs) const {
+                return ((this->_owner == rhs._owner)
+                    && (this->_index == rhs._index));
+            }
+
+            inline bool operator !=(const const_iterator& rhs) const {
+                return !(*this == rhs);
+            }
+
+        private:
+
+            inline const_iterator(const configuration *owner,
+                const std::size_t index) : _index(index), _owner(owner) { }
+
+            std::size_t _index;
+            const configuration *_owner;
+
+            friend class configuration;
+        };
+
+        typedef const_iterator iterator_type;
+
+        /// <summary>
+        /// Initialises an empty configuration.
+        /// </summary>
+        inline configuration(void) : _system_offset(0) { }
+
         /// <summary>
         /// Create a copy of <paramref name="cfg" /> which contains all
         /// system factors.
@@ -83,13 +156,18 @@ namespace trrojan {
         /// <summary>
         /// Adds all <see cref="trrojan::system_factor" />s to the configuration.
         /// </summary>
+        /// <remarks>
+        /// The static system factors are shared with all other
+        /// configurations, only the dynamic ones are retrieved and stored.
+        /// If the system factors have already been added, they are replaced.
+        /// </remarks>
         void add_system_factors(void);
 
         /// <summary>
         /// Gets an iterator for the begin of the factors.
         /// </summary>
         inline iterator_type begin(void) const {
-            return this->_factors.cbegin();
+            return iterator_type(this, 0);
         }
 
         /// <summary>
@@ -105,7 +183,10 @@ namespace trrojan {
         /// Removes all factors from the configuration.
         /// </summary>
         inline void clear(void) {
+            this->_dynamic.clear();
             this->_factors.clear();
+            this->_system.reset();
+            this->_system_offset = 0;
         }
 
         /// <summary>
@@ -113,7 +194,7 @@ namespace trrojan {
         /// specified name.
         /// </summary>
         inline bool contains(const std::string& factor) const {
-            return (this->find(factor) != this->_factors.cend());
+            return (this->find(factor) != this->end());
         }
 
         /// <summary>
@@ -126,7 +207,7 @@ namespace trrojan {
         /// Gets an iterator for the end of the factors.
         /// </summary>
         inline iterator_type end(void) const {
-            return this->_factors.cend();
+            return iterator_type(this, this->size());
         }
 
         /// <summary>
@@ -194,14 +275,21 @@ namespace trrojan {
         /// Answer the <paramref name="i" />th factor.
         /// </summary>
         inline const value_type& operator [](const size_t i) const {
-            return this->_factors[i];
+            const auto cntSystem = this->system_size();
+            if (i < this->_system_offset) {
+                return this->_factors[i];
+            } else if (i < this->_system_offset + cntSystem) {
+                return this->system_factor(i - this->_system_offset);
+            } else {
+                return this->_factors[i - cntSystem];
+            }
         }
 
         /// <summary>
         /// Answer the number of factors.
         /// </summary>
         inline const std::size_t size(void) const {
-            return this->_factors.size();
+            return (this->_factors.size() + this->system_size());
         }
 
         /// <summary>
@@ -219,7 +307,7 @@ namespace trrojan {
                 std::basic_ostream<C, T>& lhs, const configuration& rhs) {
             bool isFirst = true;
 
-            for (auto& f : rhs._factors) {
+            for (auto& f : rhs) {
                 if (isFirst) {
                     isFirst = false;
                 } else {
@@ -238,8 +326,45 @@ namespace trrojan {
 
         container_type::iterator find0(const std::string& factor);
 
+        /// <summary>
+        /// Answer the <paramref name="i" />th system factor.
+        /// </summary>
+        const value_type& system_factor(const std::size_t i) const;
+
+        /// <summary>
+        /// Answer the number of system factors in the configuration.
+        /// </summary>
+        inline std::size_t system_size(void) const {
+            auto retval = this->_dynamic.size();
+            if (this->_system != nullptr) {
+                retval += this->_system->size();
+            }
+            return retval;
+        }
+
+        /// <summary>
+        /// The dynamic system factors along with their position among all
+        /// system factors in ascending order.
+        /// </summary>
+        std::vector<std::pair<std::size_t, named_variant>> _dynamic;
+
+        /// <summary>
+        /// The factors that have been added explicitly.
+        /// </summary>
         container_type _factors;
 
+        /// <summary>
+        /// The snapshot of the static system factors, which is shared by
+        /// all configurations.
+        /// </summary>
+        std::shared_ptr<const container_type> _system;
+
+        /// <summary>
+        /// The position of the first system factor, which is the number of
+        /// factors that have been added before the system factors.
+        /// </summary>
+        std::size_t _system_offset;
+
     };
 
     /// <summary>
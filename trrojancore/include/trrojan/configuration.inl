@@ -11,7 +11,7 @@
 template<class T>
 T trrojan::configuration::get(const std::string& factor) const {
     auto i = this->find(factor);
-    if (i == this->_factors.cend()) {
+    if (i == this->end()) {
         std::stringstream msg;
         msg << "The configuration does not contain a factor \""
             << factor << "\"." << std::ends;
@@ -27,5 +27,5 @@ T trrojan::configuration::get(const std::string& factor) const {
 template<class T> T trrojan::configuration::get(const std::string& factor,
         const T fallback) const {
     auto i = this->find(factor);
-    return (i != this->_factors.end()) ? i->value().as<T>() : fallback;
+    return (i != this->end()) ? i->value().as<T>() : fallback;
 }
@@ -33,11 +33,69 @@ namespace trrojan {
 
     public:
 
+        /// <summary>
+        /// A predicate deciding whether a (partial) configuration is valid.
+        /// </summary>
+        /// <remarks>
+        /// The predicate is called with a configuration which comprises only
+        /// a subset of the factors of the configuration set, but which always
+        /// includes the factors the constraint has been registered for if
+        /// they are part of the set.
+        /// </remarks>
+        typedef std::function<bool(const configuration&)> constraint_type;
+
         /// <summary>
         /// A list of <see cref="trrrojan::factor" />s.
         /// </summary>
         typedef std::vector<factor> factor_list;
 
+        /// <summary>
+        /// Add a constraint that excludes all configurations for which
+        /// <paramref name="predicate" /> returns <c>false</c> from the
+        /// enumeration.
+        /// </summary>
+        /// <remarks>
+        /// <para>The constraint is evaluated as soon as all of the given
+        /// <paramref name="factors" /> have been fixed while enumerating the
+        /// configurations, which allows for pruning all configurations that
+        /// vary only in the remaining factors without building them. It is
+        /// therefore beneficial to reference as few factors as possible.
+        /// </para>
+        /// <para>Names of factors which are not in the configuration set will
+        /// be silently ignored. The predicate must handle the case that
+        /// these are missing in the configuration.</para>
+        /// </remarks>
+        /// <param name="factors">The names of the factors the predicate
+        /// inspects.</param>
+        /// <param name="predicate">The predicate deciding whether a
+        /// configuration is valid.</param>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="predicate" /> is not valid.</exception>
+        void add_constraint(const std::vector<std::string>& factors,
+            const constraint_type& predicate);
+
+        /// <summary>
+        /// Add a constraint that allows <paramref name="factor" /> to have
+        /// <paramref name="value" /> only if <paramref name="condition" />
+        /// has one of the given <paramref name="values" />.
+        /// </summary>
+        /// <remarks>
+        /// If any of the factors is not in the configuration set, the
+        /// constraint has no effect.
+        /// </remarks>
+        /// <param name="factor">The name of the constrained factor.</param>
+        /// <param name="value">The manifestation of <paramref name="factor" />
+        /// which is subject to the constraint.</param>
+        /// <param name="condition">The name of the factor the constrained one
+        /// depends on.</param>
+        /// <param name="values">The manifestations of
+        /// <paramref name="condition" /> which allow for
+        /// <paramref name="value" />.</param>
+        void add_only_if(const std::string& factor,
+            const trrojan::variant& value,
+            const std::string& condition,
+            const std::vector<trrojan::variant>& values);
+
         /// <summary>
         /// Add an additional factor to be tested.
         /// </summary>
@@ -90,8 +148,11 @@ namespace trrojan {
         /// Call <paramref name="cb" /> for each configuration in the set.
         /// </summary>
         /// <remarks>
-        /// <paramref name="cb" /> will be called until the last configuration
-        /// is reached or until the first invocation returns <c>false</c>
+        /// <para><paramref name="cb" /> will be called until the last
+        /// configuration is reached or until the first invocation returns
+        /// <c>false</c></para>
+        /// <para>Configurations violating any of the constraints of the set
+        /// are skipped.</para>
         /// </remarks>
         bool foreach_configuration(
             std::function<bool(configuration&)> cb) const;
@@ -100,10 +161,12 @@ namespace trrojan {
         /// Merge <paramref name="other" /> into this configuration set.
         /// </summary>
         /// <remarks>
-        /// If <paramref name="overwrite" /> is <c>true</c>,
+        /// <para>If <paramref name="overwrite" /> is <c>true</c>,
         /// <see cref="trrojan::factor" />s in this configuration set will be
         /// overwritten by the ones from <paramref name="other" />. Otherwise, 
-        /// already existing factors will be ignored.
+        /// already existing factors will be ignored.</para>
+        /// <para>The constraints of <paramref name="other" /> are always
+        /// added to the ones of this configuration set.</para>
         /// </remarks>
         /// <param name="other">The configuration set to be integrated into this
         /// one.</param>
@@ -134,6 +197,33 @@ namespace trrojan {
 
     private:
 
+        /// <summary>
+        /// A predicate along with the names of the factors it depends on.
+        /// </summary>
+        struct constraint {
+            std::vector<std::string> factors;
+            constraint_type predicate;
+        };
+
+        /// <summary>
+        /// The constraints to be checked for each factor, which are the ones
+        /// that can be decided once the factor and all factors after it have
+        /// been fixed.
+        /// </summary>
+        typedef std::vector<std::vector<const constraint *>> check_list;
+
+        /// <summary>
+        /// Fixes the manifestations of the factors from
+        /// <paramref name="level" /> down to <paramref name="last" /> and
+        /// calls <paramref name="cb" /> for each combination that passes the
+        /// <paramref name="checks" />.
+        /// </summary>
+        bool enumerate(std::vector<std::size_t>& indices,
+            const std::size_t level, const std::size_t last,
+            const check_list& checks,
+            const std::function<bool(const std::vector<std::size_t>&)>& cb)
+            const;
+
         inline factor_list::iterator findFactor(const std::string& name) {
             return std::find_if(this->_factors.begin(), this->_factors.end(),
                 [&name](const factor& f) { return (f.name() == name); });
@@ -145,6 +235,11 @@ namespace trrojan {
                 [&name](const factor& f) { return (f.name() == name); });
         }
 
+        /// <summary>
+        /// Holds the constraints restricting the configurations.
+        /// </summary>
+        std::vector<constraint> _constraints;
+
         /// <summary>
         /// Holds all the factors defining the configurations.
         /// </summary>
@@ -7,18 +7,41 @@
 #pragma once
 
 #include <chrono>
+#include <string>
 
 #include "trrojan/export.h"
+#include "trrojan/thermal_monitor.h"
 
 
 namespace trrojan {
 
+    /* Forward declarations. */
+    class basic_result;
+
+
     /// <summary>
     /// Configuration of how the <see cref="executive" /> should insert
     /// cool-down periods during the benchmark.
     /// </summary>
+    /// <remarks>
+    /// <para>There are two kinds of cool-down periods, which can be combined:
+    /// fixed periods of <see cref="duration" /> inserted every
+    /// <see cref="frequency" />, and adaptive ones before each configuration,
+    /// which last until the machine has reached the <see cref="temperature" />
+    /// and <see cref="clock_ratio" /> specified.</para>
+    /// </remarks>
     struct TRROJANCORE_API cool_down {
 
+        /// <summary>
+        /// The minimum ratio between the allowed maximum clock and the
+        /// hardware maximum clock that all processors must reach before the
+        /// next configuration is started.
+        /// </summary>
+        /// <remarks>
+        /// If this value is zero, the clocks are not checked.
+        /// </remarks>
+        float clock_ratio;
+
         /// <summary>
         /// The duration of a cool-down period in seconds.
         /// </summary>
@@ -35,11 +58,50 @@ namespace trrojan {
         /// </remarks>
         std::chrono::minutes frequency;
 
+        /// <summary>
+        /// The number of times a configuration is repeated if the processors
+        /// have been throttled while it was running.
+        /// </summary>
+        /// <remarks>
+        /// This value only has an effect if the cool-down is
+        /// <see cref="adaptive" />.
+        /// </remarks>
+        unsigned int retries;
+
+        /// <summary>
+        /// The temperature in degrees Celsius that all thermal zones must
+        /// fall below before the next configuration is started.
+        /// </summary>
+        /// <remarks>
+        /// If this value is zero, the temperature is not checked.
+        /// </remarks>
+        float temperature;
+
+        /// <summary>
+        /// The maximum time to wait for the <see cref="temperature" /> and
+        /// the <see cref="clock_ratio" /> to be reached.
+        /// </summary>
+        std::chrono::seconds timeout;
+
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
-        inline cool_down(void) : duration(std::chrono::seconds::zero()),
-            frequency(std::chrono::minutes::zero()) { }
+        inline cool_down(void) : clock_ratio(0.0f),
+            duration(std::chrono::seconds::zero()),
+            frequency(std::chrono::minutes::zero()),
+            retries(0),
+            temperature(0.0f),
+            timeout(std::chrono::minutes(10)) { }
+
+        /// <summary>
+        /// Answer whether the thermal state of the machine should be checked
+        /// before each configuration.
+        /// </summary>
+        /// <returns><c>true</c> if adaptive cool-down periods are enabled,
+        /// <c>false</c> otherwise.</returns>
+        inline bool adaptive(void) const {
+            return ((this->clock_ratio > 0.0f) || (this->temperature > 0.0f));
+        }
 
         /// <summary>
         /// Answer whether the cool-down configuration is enabled.
@@ -61,20 +123,104 @@ namespace trrojan {
 
     public:
 
+        /// <summary>
+        /// The type of the thermal state recorded before and after a
+        /// configuration.
+        /// </summary>
+        typedef thermal_monitor::state state_type;
+
+        /// <summary>
+        /// The name of the result column holding the average processor clock
+        /// in MHz after the configuration has been measured.
+        /// </summary>
+        static const std::string result_name_frequency_end;
+
+        /// <summary>
+        /// The name of the result column holding the average processor clock
+        /// in MHz before the configuration has been measured.
+        /// </summary>
+        static const std::string result_name_frequency_start;
+
+        /// <summary>
+        /// The name of the result column holding the maximum temperature in
+        /// degrees Celsius after the configuration has been measured.
+        /// </summary>
+        static const std::string result_name_temperature_end;
+
+        /// <summary>
+        /// The name of the result column holding the maximum temperature in
+        /// degrees Celsius before the configuration has been measured.
+        /// </summary>
+        static const std::string result_name_temperature_start;
+
+        /// <summary>
+        /// The name of the result column indicating whether the processors
+        /// have been throttled during the measurement.
+        /// </summary>
+        static const std::string result_name_throttled;
+
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
-        inline cool_down_evaluator(const cool_down& config) : config(config),
-            last(std::chrono::system_clock::now()) { }
+        cool_down_evaluator(const cool_down& config);
 
         /// <summary>
         /// Check whether it is time for a cool-down and do so as necessary.
         /// </summary>
+        /// <remarks>
+        /// If the cool-down is <see cref="cool_down::adaptive" />, the method
+        /// will also wait until the thermal state of the machine has reached
+        /// the configured thresholds or the configured timeout has been
+        /// exceeded.
+        /// </remarks>
         void check(void);
 
+        /// <summary>
+        /// Answer whether the processors have been throttled between
+        /// <paramref name="start" /> and <paramref name="end" />.
+        /// </summary>
+        /// <param name="start">The state before the measurement.</param>
+        /// <param name="end">The state after the measurement.</param>
+        /// <returns><c>true</c> if the cool-down is adaptive and the system
+        /// has been throttled, <c>false</c> otherwise.</returns>
+        bool is_throttled(const state_type& start,
+            const state_type& end) const;
+
+        /// <summary>
+        /// Adds the thermal state before and after the measurement to the
+        /// given result if the cool-down is adaptive.
+        /// </summary>
+        /// <param name="result">The result to add the columns to.</param>
+        /// <param name="start">The state before the measurement.</param>
+        /// <param name="end">The state after the measurement.</param>
+        void record(basic_result& result, const state_type& start,
+            const state_type& end) const;
+
+        /// <summary>
+        /// Reads the current thermal state of the system if the cool-down is
+        /// adaptive.
+        /// </summary>
+        /// <returns>The current thermal state, which is all-NaN if the
+        /// cool-down is not adaptive.</returns>
+        state_type sample(void) const;
+
     private:
 
+        /// <summary>
+        /// Answer whether the given state satisfies the thresholds of
+        /// <see cref="config" />. Values that are not available are
+        /// considered to be satisfied.
+        /// </summary>
+        bool is_nominal(const state_type& state) const;
+
+        /// <summary>
+        /// Waits until <see cref="is_nominal" /> holds or the timeout has been
+        /// exceeded.
+        /// </summary>
+        void wait_for_nominal(void);
+
         cool_down config;
         std::chrono::system_clock::time_point last;
+        thermal_monitor monitor;
     };
 }
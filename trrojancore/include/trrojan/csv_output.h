@@ -7,8 +7,10 @@
 #pragma once
 
 #include <fstream>
+#include <memory>
 
 #include "trrojan/csv_output_params.h"
+#include "trrojan/journal.h"
 #include "trrojan/output.h"
 
 
@@ -17,6 +19,14 @@ namespace trrojan {
     /// <summary>
     /// Output handler writing the results to a CSV file.
     /// </summary>
+    /// <remarks>
+    /// Unless disabled in the <see cref="csv_output_params" />, the output
+    /// keeps a <see cref="trrojan::journal" /> next to the file. If the
+    /// journal shows that the previous run has been interrupted when the
+    /// output is opened, any partially written row is removed and the
+    /// results are appended to the file as if
+    /// <see cref="csv_output_params::append" /> had been set.
+    /// </remarks>
     class TRROJANCORE_API csv_output : public output_base {
 
     public:
@@ -34,14 +44,38 @@ namespace trrojan {
         /// <inheritdoc />
         virtual void close(void);
 
+        /// <inheritdoc />
+        virtual const result_index *completed(void) const;
+
+        /// <inheritdoc />
+        virtual void finish(void);
+
         /// <inheritdoc />
         virtual void open(const output_params& params);
 
         /// <inheritdoc />
+        /// <remarks>
+        /// If the user explicitly requested appending to the output, the
+        /// existing results are kept regardless of the configurations they
+        /// stem from and nothing is reported as resumed.
+        /// </remarks>
+        virtual const journal::state *resumed(void) const;
+
+        /// <inheritdoc />
+        virtual output_base& write(const basic_result& result,
+            const std::size_t index);
+
+        /// <inheritdoc />
+        /// <remarks>
+        /// The result is recorded in the journal as the successor of the one
+        /// written before.
+        /// </remarks>
         virtual output_base& operator <<(const basic_result& result);
 
     private:
 
+        void resume(const journal::state& state);
+
         void print(const std::string& str);
 
         void print(const variant& v);
@@ -50,11 +84,25 @@ namespace trrojan {
             this->print(v.value());
         }
 
+        bool appending;
+
+        std::unique_ptr<journal> checkpoints;
+
+        bool check_columns;
+
+        result_index existing;
+
         std::ofstream file;
 
         bool first_line;
 
+        journal::state interrupted;
+
+        std::size_t next_index;
+
         std::shared_ptr<csv_output_params> params;
 
+        bool resuming;
+
     };
 }
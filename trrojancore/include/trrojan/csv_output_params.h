@@ -20,6 +20,12 @@ namespace trrojan {
 
     public:
 
+        /// <summary>
+        /// The default number of configurations after which the output and
+        /// its journal are synchronised with the disk.
+        /// </summary>
+        static const std::size_t default_journal_interval;
+
         /// <summary>
         /// The default line break string.
         /// </summary>
@@ -52,10 +58,17 @@ namespace trrojan {
         /// <param name="separator"></param>
         /// <param name="quote_strings"></param>
         /// <param name="line_break"></param>
+        /// <param name="append">If <c>true</c>, append to an existing file
+        /// rather than overwriting it.</param>
+        /// <param name="journal_interval">The number of configurations after
+        /// which the output and its journal are synchronised with the disk or
+        /// zero for not writing a journal at all.</param>
         inline csv_output_params(const std::string& path,
             const std::string& separator, const bool quote_strings,
-            const std::string& line_break)
-            : basic_output_params(path), _line_break(line_break),
+            const std::string& line_break, const bool append = false,
+            const std::size_t journal_interval = default_journal_interval)
+            : basic_output_params(path), _append(append),
+            _journal_interval(journal_interval), _line_break(line_break),
             _quote_strings(quote_strings), _separator(separator) { }
 
         /// <summary>
@@ -69,7 +82,8 @@ namespace trrojan {
             I cmdLineBegin, I cmdLineEnd);
 
         inline explicit csv_output_params(const basic_output_params& params)
-            : basic_output_params(params.path()),
+            : basic_output_params(params.path()), _append(false),
+            _journal_interval(default_journal_interval),
             _line_break(default_line_break), _quote_strings(true),
             _separator(default_separator) { }
 
@@ -78,6 +92,23 @@ namespace trrojan {
         /// </summary>
         virtual ~csv_output_params(void);
 
+        /// <summary>
+        /// Answer whether the output is appended to an existing file, in
+        /// which case the configurations in this file are skipped.
+        /// </summary>
+        inline bool append(void) const {
+            return this->_append;
+        }
+
+        /// <summary>
+        /// Answer the number of configurations after which the output and its
+        /// journal are synchronised with the disk, or zero if no journal is
+        /// written.
+        /// </summary>
+        inline std::size_t journal_interval(void) const {
+            return this->_journal_interval;
+        }
+
         inline const std::string& line_break(void) const {
             return this->_line_break;
         }
@@ -92,6 +123,10 @@ namespace trrojan {
 
     private:
 
+        bool _append;
+
+        std::size_t _journal_interval;
+
         std::string _line_break;
 
         bool _quote_strings;
@@ -25,6 +25,20 @@ trrojan::csv_output_params::csv_output_params(const std::string& path,
     this->_quote_strings = !trrojan::contains_switch("--do-not-quote-strings",
         cmdLineBegin, cmdLineEnd);
 
+    this->_append = trrojan::contains_switch("--append", cmdLineBegin,
+        cmdLineEnd);
+
+    {
+        auto it = trrojan::find_argument("--journal-interval", cmdLineBegin,
+            cmdLineEnd);
+        if (it != cmdLineEnd) {
+            this->_journal_interval = trrojan::parse<std::size_t>(
+                it->c_str());
+        } else {
+            this->_journal_interval = default_journal_interval;
+        }
+    }
+
     {
         auto it = trrojan::find_argument("--line-break", cmdLineBegin,
             cmdLineEnd);
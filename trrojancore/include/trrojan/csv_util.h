@@ -7,6 +7,8 @@
 #pragma once
 
 #include <iostream>
+#include <string>
+#include <vector>
 
 #include "trrojan/named_variant.h"
 
@@ -24,6 +26,17 @@ namespace trrojan {
     TRROJANCORE_API std::ostream& print_csv_header(std::ostream& stream,
         const named_variant& variant, const bool quote);
 
+    /// <summary>
+    /// Print the given string as CSV to the given stream, which includes
+    /// doubling all quotes in it if it is quoted.
+    /// </summary>
+    /// <param name="stream"></param>
+    /// <param name="str"></param>
+    /// <param name="quote"></param>
+    /// <returns></returns>
+    TRROJANCORE_API std::ostream& print_csv_string(std::ostream& stream,
+        const std::string& str, const bool quote);
+
     /// <summary>
     /// Print the given variant as CSV (strings are quoted on request) to the
     /// given stream.
@@ -45,4 +58,15 @@ namespace trrojan {
     /// <returns></returns>
     TRROJANCORE_API std::ostream& print_csv_value(std::ostream& stream,
         const named_variant& variant, const bool quote);
+
+    /// <summary>
+    /// Splits a line of a CSV file into its values and removes the quotes
+    /// around strings.
+    /// </summary>
+    /// <param name="line">The line without the line break.</param>
+    /// <param name="separator">The separator of the columns, which must not
+    /// be empty.</param>
+    /// <returns>The values in the line.</returns>
+    TRROJANCORE_API std::vector<std::string> split_csv_line(
+        const std::string& line, const std::string& separator);
 }
@@ -9,6 +9,7 @@
 #include <iterator>
 #include <map>
 #include <memory>
+#include <set>
 #include <string>
 #include <unordered_map>
 #include <utility>
@@ -30,6 +31,7 @@
 #include "trrojan/output.h"
 #include "trrojan/power_collector.h"
 #include "trrojan/plugin.h"
+#include "trrojan/result_index.h"
 #include "trrojan/trroll_parser.h"
 
 
@@ -48,6 +50,11 @@ namespace trrojan {
         /// </summary>
         typedef trroll_parser::troll_input_type troll_input_type;
 
+        /// <summary>
+        /// The type of the function creating the descriptor of a plugin.
+        /// </summary>
+        typedef trrojan::plugin_base *(*plugin_entry_point)(void);
+
 #if defined(TRROJAN_FOR_UWP)
         /// <summary>
         /// The type used to reference the core window of an UWP application.
@@ -105,7 +112,7 @@ namespace trrojan {
 #if defined(TRROJAN_FOR_UWP)
         executive(window_type core_window);
 #else /* defined(TRROJAN_FOR_UWP) */
-        inline executive(void) = default;
+        inline executive(void) : cnt_enumerated(0) { }
 #endif /* defined(TRROJAN_FOR_UWP) */
 
         executive(const executive&) = delete;
@@ -131,14 +138,16 @@ namespace trrojan {
         template<class I> void get_benchmarks(I oit) const;
 
         /// <summary>
-        /// Returns all environments to the given output iterator.
+        /// Returns all environments that have been initialised so far to the
+        /// given output iterator.
         /// </summary>
         /// <param name="oit">An output iterator like a back insert
         /// iterator.</param>
         template<class I> void get_environments(I oit) const;
 
         /// <summary>
-        /// Answer whether an environment with the given name is available.
+        /// Answer whether an environment with the given name has been
+        /// initialised.
         /// </summary>
         /// <param name="name"></param>
         /// <returns></returns>
@@ -147,17 +156,44 @@ namespace trrojan {
         }
 
         /// <summary>
-        /// Loads all plugins in the current directory, retrieves their
-        /// environments and initialises those with the given command line.
+        /// Loads all plugins in the current directory and remembers the
+        /// command line for initialising their environments.
         /// </summary>
+        /// <remarks>
+        /// <para>The environments of a plugin are not created and initialised
+        /// before a script passed to <see cref="trroll" /> requires them or
+        /// before an environment is requested by name, because initialising
+        /// the drivers of graphics APIs can take several seconds.</para>
+        /// </remarks>
         /// <param name="cmdLine">The command line arguments passed to the
         /// environments.</param>
         void load_plugins(const cmd_line& cmdLine);
 
+        /// <summary>
+        /// Registers the plugins that have been linked into the executable
+        /// and remembers the command line for initialising their
+        /// environments.
+        /// </summary>
+        /// <remarks>
+        /// This method does not search for plugin libraries. It is used if
+        /// TRRojan has been built with the plugins linked statically, in
+        /// which case the build system generates the list of entry points.
+        /// </remarks>
+        /// <param name="cmdLine">The command line arguments passed to the
+        /// environments.</param>
+        /// <param name="entry_points">The functions creating the descriptors
+        /// of the plugins.</param>
+        void load_plugins(const cmd_line& cmdLine,
+            const std::vector<plugin_entry_point>& entry_points);
+
         /// <summary>
         /// Runs the given benchmark using the given configurations.
         /// </summary>
         /// <param name="benchmark">The plugin and bechmark to be run.</param>
+        /// <remarks>
+        /// If <paramref name="output" /> appends to existing results, all
+        /// configurations that are already in the output are skipped.
+        /// </remarks>
         /// <param name="configs">The set of configurations to be tested. This
         /// parameter is passed by value because it will be modified by the
         /// method before actually starting the benchmark. For instance, all
@@ -175,6 +211,12 @@ namespace trrojan {
         /// Runs the benchmarks in the given TRROLL script writing the results
         /// to the given <paramref name="output" />.
         /// </summary>
+        /// <remarks>
+        /// If <paramref name="output" /> appends to an existing result file,
+        /// the configurations already in this file are skipped, which allows
+        /// for extending the script and running only the new
+        /// configurations.
+        /// </remarks>
         /// <param name="path">The path to the TRROLL script to be executed.
         /// </param>
         /// <param name="output">The output host where the benchmarks put their
@@ -223,7 +265,7 @@ namespace trrojan {
             /// <summary>
             /// The type of the plugin entry point retrieving the descriptor.
             /// </summary>
-            typedef trrojan::plugin_base *(*entry_point_type)(void);
+            typedef plugin_entry_point entry_point_type;
 
             /// <summary>
             /// The type of a native DLL handle.
@@ -345,6 +387,108 @@ namespace trrojan {
         /// <returns></returns>
         environment find_environment(const variant& v);
 
+        /// <summary>
+        /// Creates and initialises the environments of the given plugin.
+        /// </summary>
+        /// <remarks>
+        /// This method does not access the state of the executive and can
+        /// therefore run concurrently for different plugins.
+        /// </remarks>
+        /// <param name="plugin">The plugin to create the environments of,
+        /// which must not be <c>nullptr</c>.</param>
+        /// <param name="known">The names of the environments that have been
+        /// initialised before. Environments with these names are skipped.
+        /// </param>
+        /// <param name="cmdLine">The command line passed to the environments.
+        /// </param>
+        /// <returns>The environments that have been initialised successfully.
+        /// </returns>
+        static std::vector<environment> create_environments(
+            const plugin& plugin, const std::set<std::string>& known,
+            const cmd_line& cmdLine);
+
+        /// <summary>
+        /// Creates and initialises the environments of all plugins that have
+        /// not yet been initialised.
+        /// </summary>
+        void initialise_environments(void);
+
+        /// <summary>
+        /// Creates and initialises the environments of the given plugin
+        /// unless this has already been done before.
+        /// </summary>
+        /// <param name="plugin">The plugin to initialise the environments
+        /// of. It is safe to pass <c>nullptr</c>.</param>
+        void initialise_environments(const plugin& plugin);
+
+        /// <summary>
+        /// Creates and initialises the environments of the given plugins
+        /// unless this has already been done before.
+        /// </summary>
+        /// <remarks>
+        /// The plugins do not depend on each other, so their environments are
+        /// initialised concurrently. If two plugins provide an environment of
+        /// the same name, the one of the plugin first in
+        /// <paramref name="plugins" /> is used.
+        /// </remarks>
+        /// <param name="plugins">The plugins to initialise the environments
+        /// of. It is safe to pass <c>nullptr</c> elements.</param>
+        void initialise_environments(const std::vector<plugin>& plugins);
+
+        /// <summary>
+        /// Creates and initialises all environments required by the given
+        /// benchmark configurations before any of them is run.
+        /// </summary>
+        /// <remarks>
+        /// These are the environments of all plugins providing the benchmarks
+        /// and the environments requested by name. Benchmarks that do not
+        /// restrict the environment run in the environments of these plugins.
+        /// </remarks>
+        /// <param name="configs">The parsed script.</param>
+        void initialise_environments(
+            const std::vector<trroll_parser::benchmark_configs>& configs);
+
+        /// <summary>
+        /// Finds the environment with the given name, initialising the
+        /// environments of all plugins if it has not been found among the
+        /// ones initialised before.
+        /// </summary>
+        /// <param name="name">The name of the environment.</param>
+        /// <returns>An iterator to the environment or the end of
+        /// <see cref="environments" /> if no such environment exists.
+        /// </returns>
+        std::map<std::string, environment>::iterator lookup_environment(
+            const std::string& name);
+
+        /// <summary>
+        /// Assigns the next enumeration indices to all configurations that
+        /// <paramref name="benchmark" /> will enumerate for the given
+        /// combinations of environments and devices.
+        /// </summary>
+        /// <remarks>
+        /// The indices continue over all benchmarks run by the executive such
+        /// that they identify a configuration within the whole run. If
+        /// <paramref name="resumed" /> is not <c>nullptr</c>, the
+        /// configuration at the index completed last by the interrupted run
+        /// must have the recorded hash.
+        /// </remarks>
+        /// <returns>The enumeration indices of the configurations, indexed by
+        /// their <see cref="journal::hash" />.</returns>
+        /// <exception cref="std::runtime_error">If the interrupted run has
+        /// enumerated another configuration at the index it has completed
+        /// last, in which case it cannot be resumed.</exception>
+        std::unordered_map<journal::hash_type, std::size_t>
+        number_configurations(const configuration_set& configs,
+            const benchmark_base& benchmark,
+            const std::vector<env_dev_set>& eds,
+            const journal::state *resumed);
+
+        /// <summary>
+        /// Clears the environments and remembers the command line for
+        /// initialising them before plugins are loaded.
+        /// </summary>
+        void prepare_plugins(const cmd_line& cmdLine);
+
         /// <summary>
         /// Prepare all possible combinations of <see cref="environment" /> and
         /// <see cref="device"> honouring any restrictions make in in
@@ -354,6 +498,27 @@ namespace trrojan {
             const std::string& factorEnv = environment_base::factor_name,
             const std::string& factorDev = device_base::factor_name);
 
+        /// <summary>
+        /// Adds a constraint to <paramref name="configs" /> that excludes all
+        /// configurations of <paramref name="benchmark" /> which are in
+        /// <paramref name="completed" />.
+        /// </summary>
+        /// <remarks>
+        /// The configurations are identified by all of their factors except
+        /// for the system factors and the ones injected by the executive.
+        /// </remarks>
+        /// <exception cref="std::runtime_error">If any of these factors is
+        /// not a column of <paramref name="completed" />, in which case the
+        /// results could not be appended.</exception>
+        void skip_completed(configuration_set& configs,
+            const benchmark_base& benchmark, const result_index& completed);
+
+        /// <summary>
+        /// The number of configurations that have been enumerated by all
+        /// benchmarks so far.
+        /// </summary>
+        std::size_t cnt_enumerated;
+
         /// <summary>
         /// Stores the currently active environment.
         /// </summary>
@@ -364,6 +529,18 @@ namespace trrojan {
         /// </summary>
         std::map<std::string, environment> environments;
 
+        /// <summary>
+        /// The command line that is passed to the environments once they are
+        /// initialised.
+        /// </summary>
+        trrojan::cmd_line environment_cmd_line;
+
+        /// <summary>
+        /// The names of the plugins whose environments have already been
+        /// initialised.
+        /// </summary>
+        std::set<std::string> initialised_plugins;
+
         /// <summary>
         /// Holds the libraries of all plugins that the application has found.
         /// </summary>
@@ -489,6 +489,20 @@ namespace trrojan {
         return read_text_file(path.c_str());
     }
 
+    /// <summary>
+    /// Makes sure that everything that has been written to the file at the
+    /// given location is on stable storage.
+    /// </summary>
+    /// <remarks>
+    /// The file must have been flushed by the process before, ie the method
+    /// only flushes the buffers of the operating system, not the ones of any
+    /// stream that is still open.
+    /// </remarks>
+    /// <param name="path">The path to the file to be synchronised.</param>
+    /// <exception cref="std::system_error">If the file could not be opened
+    /// or synchronised.</exception>
+    void TRROJANCORE_API sync_file(const std::string& path);
+
 #if defined(_WIN32)
     /// <summary>
     /// Write all of the given bytes to the given file.
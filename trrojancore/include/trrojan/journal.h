@@ -0,0 +1,192 @@
+﻿// <copyright file="journal.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cinttypes>
+#include <fstream>
+#include <string>
+
+#include "trrojan/configuration.h"
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// An append-only journal next to an output file, which records the
+    /// configurations that have been started and completed such that an
+    /// interrupted run can be resumed.
+    /// </summary>
+    /// <remarks>
+    /// <para>The journal is a text file with one record per line. Before the
+    /// results of a configuration are written, a line
+    /// &quot;begin &lt;index&gt; &lt;hash&gt;&quot; is appended, where the
+    /// index is the position of the configuration in the enumeration of the
+    /// executive and the hash identifies its factors. Once the
+    /// results have been flushed, the line
+    /// &quot;end &lt;index&gt; &lt;hash&gt; &lt;size&gt;&quot; marks the
+    /// configuration as completed, where the size is the size of the output
+    /// file in bytes after the results have been written. If all benchmarks
+    /// have run successfully, the journal ends with the line
+    /// &quot;finished&quot;.</para>
+    /// <para>Every record is flushed to the operating system immediately,
+    /// which is sufficient to survive the process being killed. The output
+    /// and the journal are synchronised with the disk every
+    /// <see cref="sync_interval" /> completed configurations, which protects
+    /// the data against a crash of the whole system.</para>
+    /// </remarks>
+    class TRROJANCORE_API journal {
+
+    public:
+
+        /// <summary>
+        /// The type of the hash identifying a configuration.
+        /// </summary>
+        typedef std::uint64_t hash_type;
+
+        /// <summary>
+        /// The state of a journal as it has been found on disk.
+        /// </summary>
+        struct state {
+
+            /// <summary>
+            /// The number of configurations that have been completed.
+            /// </summary>
+            std::size_t completed;
+
+            /// <summary>
+            /// Indicates whether the output has been closed properly.
+            /// </summary>
+            bool finished;
+
+            /// <summary>
+            /// The hash of the configuration that has been completed last,
+            /// which is only valid if <see cref="completed" /> is not zero.
+            /// </summary>
+            hash_type last_hash;
+
+            /// <summary>
+            /// The enumeration index of the configuration that has been
+            /// completed last, which is only valid if
+            /// <see cref="completed" /> is not zero.
+            /// </summary>
+            std::size_t last_index;
+
+            /// <summary>
+            /// The size of the output after the last completed configuration.
+            /// </summary>
+            std::uint64_t output_size;
+
+            /// <summary>
+            /// Indicates whether any configuration has been begun.
+            /// </summary>
+            bool started;
+
+            /// <summary>
+            /// Answer whether the run recorded in the journal has been
+            /// interrupted.
+            /// </summary>
+            inline bool interrupted(void) const {
+                return (this->started && !this->finished);
+            }
+        };
+
+        /// <summary>
+        /// Computes the hash of all factors of <paramref name="config" />
+        /// except for the system factors.
+        /// </summary>
+        static hash_type hash(const configuration& config);
+
+        /// <summary>
+        /// Answer the path of the journal of the given output file.
+        /// </summary>
+        static std::string path(const std::string& output);
+
+        /// <summary>
+        /// Reads the journal of the given output file.
+        /// </summary>
+        /// <remarks>
+        /// If the journal does not exist, an empty state is returned.
+        /// Incomplete lines at the end of the journal are ignored.
+        /// </remarks>
+        /// <param name="output">The path to the output file.</param>
+        /// <returns>The state recorded in the journal.</returns>
+        static state read(const std::string& output);
+
+        /// <summary>
+        /// Opens the journal of the given output file.
+        /// </summary>
+        /// <param name="output">The path to the output file.</param>
+        /// <param name="sync_interval">The number of completed configurations
+        /// after which the output and the journal are synchronised with the
+        /// disk. This must be at least one.</param>
+        /// <param name="append">If <c>true</c>, continue an existing journal,
+        /// which must be done if the output is appended to. Otherwise, the
+        /// journal is started from scratch.</param>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="sync_interval" /> is zero.</exception>
+        /// <exception cref="std::runtime_error">If the journal could not be
+        /// opened.</exception>
+        journal(const std::string& output, const std::size_t sync_interval,
+            const bool append);
+
+        journal(const journal&) = delete;
+
+        /// <summary>
+        /// Finalises the instance.
+        /// </summary>
+        /// <remarks>
+        /// The journal is not marked as finished, because the destructor is
+        /// also reached if the run has been aborted by an exception.
+        /// </remarks>
+        ~journal(void) = default;
+
+        /// <summary>
+        /// Records that the results of the configuration with the given
+        /// enumeration index and hash are about to be written.
+        /// </summary>
+        void begin(const std::size_t index, const hash_type hash);
+
+        /// <summary>
+        /// Records that the results of the configuration passed to
+        /// <see cref="begin" /> have been written and the output has grown to
+        /// <paramref name="output_size" /> bytes.
+        /// </summary>
+        void complete(const std::size_t index, const hash_type hash,
+            const std::uint64_t output_size);
+
+        /// <summary>
+        /// Records that all benchmarks have run successfully and synchronises
+        /// the journal with the disk.
+        /// </summary>
+        /// <remarks>
+        /// A finished journal is not resumed, so this must not be called if
+        /// the run has been aborted.
+        /// </remarks>
+        void finish(void);
+
+        /// <summary>
+        /// Answer the number of completed configurations between two
+        /// synchronisations with the disk.
+        /// </summary>
+        inline std::size_t sync_interval(void) const {
+            return this->_sync_interval;
+        }
+
+        journal& operator =(const journal&) = delete;
+
+    private:
+
+        void sync(void);
+
+        std::size_t _cnt_unsynced;
+        std::ofstream _file;
+        std::string _output;
+        std::string _path;
+        std::size_t _sync_interval;
+    };
+}
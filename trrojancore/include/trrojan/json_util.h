@@ -0,0 +1,37 @@
+﻿// <copyright file="json_util.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <iostream>
+#include <string>
+
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// Print the given string as quoted JSON string, which includes escaping
+    /// quotes, backslashes and control characters, to the given stream.
+    /// </summary>
+    /// <param name="stream"></param>
+    /// <param name="str"></param>
+    /// <returns></returns>
+    TRROJANCORE_API std::ostream& print_json_string(std::ostream& stream,
+        const std::string& str);
+
+    /// <summary>
+    /// Print the given string as quoted JSON string, which includes escaping
+    /// quotes, backslashes and control characters, to the given stream.
+    /// </summary>
+    /// <param name="stream"></param>
+    /// <param name="str">The string to be printed. It is safe to pass
+    /// <c>nullptr</c>, which yields an empty string.</param>
+    /// <returns></returns>
+    TRROJANCORE_API std::ostream& print_json_string(std::ostream& stream,
+        const char *str);
+}
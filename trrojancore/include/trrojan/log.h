@@ -11,6 +11,7 @@
 #include <mutex>
 #include <sstream>
 
+#include <spdlog/async.h>
 #include <spdlog/spdlog.h>
 #include <spdlog/sinks/basic_file_sink.h>
 #include <spdlog/sinks/ostream_sink.h>
@@ -21,6 +22,8 @@
 
 namespace trrojan {
 
+    namespace detail { class deferring_sink; }
+
     /// <summary>
     /// Defines possible log levels which can be filtered.
     /// </summary>
@@ -36,10 +39,26 @@ namespace trrojan {
     /// <summary>
     /// Implements a central logging facility for the TRRojan.
     /// </summary>
+    /// <remarks>
+    /// <para>While a measurement scope is active, all messages below
+    /// <see cref="log_level::error" /> are held back and written once the
+    /// last scope has been left, such that writing the log does not interfere
+    /// with the measurement.
+    /// <see cref="trrojan::benchmark_base::power_scope" /> enters and leaves
+    /// a measurement scope automatically.</para>
+    /// <para>In asynchronous mode, the messages are only formatted on the
+    /// calling thread and written to the sinks by a background thread.</para>
+    /// </remarks>
     class TRROJANCORE_API log {
 
     public:
 
+        /// <summary>
+        /// The number of messages that can be queued in asynchronous mode if
+        /// the user does not specify anything else.
+        /// </summary>
+        static const std::size_t default_queue_size;
+
         /// <summary>
         /// Answer the only instance of the <see cref="trrojan::log" />.
         /// </summary>
@@ -47,9 +66,15 @@ namespace trrojan {
         /// the very first call to the method. If the parameter is
         /// <c>nullptr</c>, which is the default, the console will be used for
         /// logging.</param>
+        /// <param name="queue_size">If not zero, the log is written
+        /// asynchronously using a queue for the specified number of messages.
+        /// If the queue is full, the caller blocks until there is space. This
+        /// parameter is only honoured in the very first call to the method.
+        /// </param>
         /// <returns>An instance of the logger.</returns>
-        static inline log& instance(const char *file = nullptr) {
-            static log l(file);
+        static inline log& instance(const char *file = nullptr,
+                const std::size_t queue_size = 0) {
+            static log l(file, queue_size);
             return l;
         }
 
@@ -58,6 +83,36 @@ namespace trrojan {
         /// </summary>
         ~log(void);
 
+        /// <summary>
+        /// Enters a measurement scope, which defers all messages below
+        /// <see cref="log_level::error" /> until the scope is left.
+        /// </summary>
+        /// <remarks>
+        /// Measurement scopes can be nested. The deferred messages are written
+        /// when the outermost scope is left. Callers must make sure to leave
+        /// the scope even if an exception is thrown, for instance using
+        /// <see cref="on_exit" />.
+        /// </remarks>
+        void enter_measurement_scope(void);
+
+        /// <summary>
+        /// Writes all pending messages to the sinks and waits for this to
+        /// complete.
+        /// </summary>
+        /// <remarks>
+        /// Messages deferred by an active measurement scope are not written.
+        /// Messages that other threads log while the method is waiting are
+        /// waited for, too.
+        /// </remarks>
+        void flush(void);
+
+        /// <summary>
+        /// Answer whether the log is written asynchronously.
+        /// </summary>
+        inline bool is_async(void) const {
+            return (this->_thread_pool != nullptr);
+        }
+
         /// <summary>
         /// Get the <paramref name="cnt" /> last log entries on UWP.
         /// </summary>
@@ -78,8 +133,11 @@ namespace trrojan {
         template<class... TParams>
         inline void write(const log_level level, const char *fmt,
                 TParams&&... params) {
-            this->_logger->log(static_cast<spdlog::level::level_enum>(level),
-                fmt, std::forward<TParams>(params)...);
+            if (this->enqueue(level)) {
+                this->_logger->log(
+                    static_cast<spdlog::level::level_enum>(level),
+                    fmt, std::forward<TParams>(params)...);
+            }
         }
 
         inline void write(const log_level level, const std::exception& ex) {
@@ -97,16 +155,22 @@ namespace trrojan {
             f += "\n";
             // TODO: calls deprecated spdlog function
             // this is only a problem for d3d12, but why?
-            this->_logger->log(static_cast<spdlog::level::level_enum>(level),
-                f.c_str(), std::forward<TParams>(params)...);
+            if (this->enqueue(level)) {
+                this->_logger->log(
+                    static_cast<spdlog::level::level_enum>(level),
+                    f.c_str(), std::forward<TParams>(params)...);
+            }
         }
 
         template<class... TParams>
         inline void write_line(const log_level level, std::string fmt,
                 TParams&&... params) {
             fmt += "\n";
-            this->_logger->log(static_cast<spdlog::level::level_enum>(level),
-                fmt.c_str(), std::forward< TParams>(params)...);
+            if (this->enqueue(level)) {
+                this->_logger->log(
+                    static_cast<spdlog::level::level_enum>(level),
+                    fmt.c_str(), std::forward< TParams>(params)...);
+            }
         }
 
         inline void write_line(const log_level level, std::string fmt) {
@@ -127,6 +191,18 @@ namespace trrojan {
             this->write_line(log_level::error, ex);
         }
 
+        /// <summary>
+        /// Leaves a measurement scope entered by
+        /// <see cref="enter_measurement_scope" />.
+        /// </summary>
+        /// <remarks>
+        /// If the outermost scope is left, all deferred messages are passed on
+        /// to the sinks in the order they have been logged.
+        /// </remarks>
+        /// <exception cref="std::logic_error">If no measurement scope is
+        /// active.</exception>
+        void leave_measurement_scope(void);
+
     private:
 
         typedef spdlog::sinks::ringbuffer_sink_mt ring_sink_type;
@@ -134,12 +210,24 @@ namespace trrojan {
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
-        log(const char *file);
+        log(const char *file, const std::size_t queue_size);
+
+        /// <summary>
+        /// Answer whether a message of the given level will be written and
+        /// register it as pending with the worker in asynchronous mode.
+        /// </summary>
+        /// <remarks>
+        /// The pending messages allow <see cref="flush" /> to wait until the
+        /// worker has actually written them.
+        /// </remarks>
+        bool enqueue(const log_level level);
 
 #if defined(TRROJAN_FOR_UWP)
         std::shared_ptr<ring_sink_type> _buffer_sink;
 #endif /* defined(TRROJAN_FOR_UWP) */
 
+        std::shared_ptr<detail::deferring_sink> _deferring_sink;
         std::shared_ptr<spdlog::logger> _logger;
+        std::shared_ptr<spdlog::details::thread_pool> _thread_pool;
     };
 }
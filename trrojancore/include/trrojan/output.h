@@ -10,8 +10,10 @@
 
 #include "trrojan/configuration.h"
 #include "trrojan/export.h"
+#include "trrojan/journal.h"
 #include "trrojan/output_params.h"
 #include "trrojan/result.h"
+#include "trrojan/result_index.h"
 #include "trrojan/result_set.h"
 
 
@@ -34,11 +36,66 @@ namespace trrojan {
         /// </summary>
         virtual void close(void) = 0;
 
+        /// <summary>
+        /// Answer the results that were already in the output when it was
+        /// opened and to which the output is appending.
+        /// </summary>
+        /// <remarks>
+        /// The default implementation returns <c>nullptr</c>, which indicates
+        /// that the output does not support appending to existing results.
+        /// </remarks>
+        /// <returns>The index of the existing results or <c>nullptr</c>.
+        /// The callee remains owner of the object being returned.</returns>
+        virtual const result_index *completed(void) const;
+
+        /// <summary>
+        /// Marks the results written so far as complete.
+        /// </summary>
+        /// <remarks>
+        /// <para>This must only be called once all benchmarks have run
+        /// successfully, because an output that keeps a
+        /// <see cref="trrojan::journal" /> will not resume the run any more
+        /// afterwards. Neither <see cref="close" /> nor the destructor does
+        /// this, because both are also reached if the run has been
+        /// aborted.</para>
+        /// <para>The default implementation does nothing.</para>
+        /// </remarks>
+        virtual void finish(void);
+
         /// <summary>
         /// Opens the output channel for writing.
         /// </summary>
         virtual void open(const output_params& params) = 0;
 
+        /// <summary>
+        /// Answer the state of the interrupted run that the output resumes.
+        /// </summary>
+        /// <remarks>
+        /// The executive uses the state to make sure that the interrupted run
+        /// has enumerated the same configurations before continuing it. The
+        /// default implementation returns <c>nullptr</c>, which indicates
+        /// that the output does not resume anything.
+        /// </remarks>
+        /// <returns>The state recorded in the journal of the interrupted run
+        /// or <c>nullptr</c>. The callee remains owner of the object being
+        /// returned.</returns>
+        virtual const journal::state *resumed(void) const;
+
+        /// <summary>
+        /// Stores the given benchmark <see cref="trrojan::result" /> of the
+        /// configuration at the given position in the enumeration of the
+        /// executive in the output.
+        /// </summary>
+        /// <remarks>
+        /// The default implementation ignores the index and writes the result
+        /// via the output operator.
+        /// </remarks>
+        /// <param name="result"></param>
+        /// <param name="index"></param>
+        /// <returns><c>*this</c></returns>
+        virtual output_base& write(const basic_result& result,
+            const std::size_t index);
+
         /// <summary>
         /// Stores the given benchmark <see cref="trrojan::result" /> in the
         /// output.
@@ -11,17 +11,32 @@
 #include <atomic>
 #include <chrono>
 #include <fstream>
+#include <limits>
+#include <memory>
 #include <mutex>
+#include <string>
 #include <thread>
 #include <vector>
 
 #if defined(TRROJAN_WITH_POWER_OVERWHELMING)
 #include "power_overwhelming/collector.h"
 #endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#if defined(TRROJAN_WITH_POWERCAP)
+#include "trrojan/powercap_sensor.h"
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
 
 #include "trrojan/export.h"
 
 
+#if (defined(TRROJAN_WITH_POWER_OVERWHELMING) || defined(TRROJAN_WITH_POWERCAP))
+/// <summary>
+/// Indicates that <see cref="trrojan::power_collector" /> has at least one
+/// backend and can therefore be instantiated.
+/// </summary>
+#define TRROJAN_WITH_POWER_COLLECTOR
+#endif /* (defined(TRROJAN_WITH_POWER_OVERWHELMING) || ... */
+
+
 namespace trrojan {
 
     /* Forward declarations. */
@@ -30,6 +45,15 @@ namespace trrojan {
     /// <summary>
     /// A utility class for sampling power sensors.
     /// </summary>
+    /// <remarks>
+    /// <para>The collector uses power_overwhelming for the GPU and external
+    /// sensors and the RAPL energy counters of the CPU and the DRAM, which are
+    /// exposed via the powercap interface on Linux, if these backends are
+    /// enabled. If both are enabled, the RAPL samples are written to a
+    /// separate file, which is named like the log file with
+    /// &quot;.rapl&quot; inserted before the extension, because their
+    /// columns differ from the ones of power_overwhelming.</para>
+    /// </remarks>
     class TRROJANCORE_API power_collector final {
 
     public:
@@ -55,7 +79,7 @@ namespace trrojan {
         /// </summary>
         static const char *factor_name;
 
-#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+#if defined(TRROJAN_WITH_POWER_COLLECTOR)
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
@@ -74,6 +98,22 @@ namespace trrojan {
             return this->_file;
         }
 
+        /// <summary>
+        /// Gets the energy in Joules that has been consumed while the most
+        /// recent non-empty description was active.
+        /// </summary>
+        /// <remarks>
+        /// <para>The energy is only available for sensors with energy
+        /// counters, which is currently the powercap backend. For all other
+        /// sensors, the value is a quiet NaN.</para>
+        /// <para>The value comprises all packages and the DRAM.</para>
+        /// </remarks>
+        /// <returns>The energy consumed in the last measurement scope.
+        /// </returns>
+        inline double last_energy(void) const {
+            return this->_last_energy.load(std::memory_order_acquire);
+        }
+
         /// <summary>
         /// Create and return the next unique benchmark identifier.
         /// </summary>
@@ -147,17 +187,20 @@ namespace trrojan {
 
     private:
 
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
         static void on_measurement(
             const visus::power_overwhelming::measurement& m,
             void *context);
 
         static void start_hmc8015_sensor(
             visus::power_overwhelming::hmc8015_sensor& sensor);
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
 
         void flush_buffer(void);
 
         void sample(const interval_type sampling_interval);
 
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
         void setup_adl_sensors(void);
 
         void setup_hmc8015_sensors(void);
@@ -167,22 +210,49 @@ namespace trrojan {
         void setup_tinkerforge_sensors(void);
 
         std::vector<visus::power_overwhelming::adl_sensor> _adl_sensors;
+        std::vector<visus::power_overwhelming::hmc8015_sensor> _hmc8015_sensors;
+        std::vector<visus::power_overwhelming::nvml_sensor> _nvml_sensors;
+        std::vector<visus::power_overwhelming::tinkerforge_sensor> _tinkerforge_sensors;
         std::vector<visus::power_overwhelming::measurement> _buffer;
+        std::ofstream _stream;
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+
+#if defined(TRROJAN_WITH_POWERCAP)
+        /// <summary>
+        /// Samples all powercap sensors and answers the total energy they
+        /// have accumulated.
+        /// </summary>
+        /// <remarks>
+        /// The caller must hold <see cref="_lock" />.
+        /// </remarks>
+        /// <param name="buffer">If <c>true</c>, the samples are added to
+        /// <see cref="_powercap_buffer" />. Otherwise, the sensors are only updated,
+        /// which is required to detect the wrap-around of their counters.
+        /// </param>
+        /// <returns>The energy in Joules accumulated by all sensors that
+        /// count towards the total energy.</returns>
+        double sample_powercap_sensors(const bool buffer);
+
+        void setup_powercap_sensors(void);
+
+        std::vector<powercap_sensor::measurement> _powercap_buffer;
+        std::vector<powercap_sensor> _powercap_sensors;
+        std::ofstream _powercap_stream;
+        double _scope_energy;
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
+
         std::string _description;
         std::string _file;
         std::string _header;
-        std::vector<visus::power_overwhelming::hmc8015_sensor> _hmc8015_sensors;
         std::atomic<bool> _is_collecting;
         std::atomic<bool> _is_running;
+        std::atomic<double> _last_energy;
         std::mutex _lock;
-        std::vector<visus::power_overwhelming::nvml_sensor> _nvml_sensors;
         std::thread _sampler;
-        std::ofstream _stream;
-        std::vector<visus::power_overwhelming::tinkerforge_sensor> _tinkerforge_sensors;
         std::atomic<std::uint64_t> _unique_identifier;
-#else /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#else /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
         power_collector(void) = delete;
-#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#endif /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
     };
 
 } /* end namespace trrojan */
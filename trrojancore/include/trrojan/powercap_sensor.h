@@ -0,0 +1,184 @@
+﻿// <copyright file="powercap_sensor.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <chrono>
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// Reads the energy counter of a single RAPL domain exposed via the Linux
+    /// powercap interface.
+    /// </summary>
+    /// <remarks>
+    /// <para>The powercap framework exposes running energy counters for the
+    /// package, core, uncore and DRAM domains of Intel and AMD processors in
+    /// micro Joules. These counters wrap around at
+    /// <c>max_energy_range_uj</c>, wherefore the sensor must be sampled at
+    /// least once per wrap-around period in order to accumulate the energy
+    /// correctly.</para>
+    /// <para>Starting with Linux 5.10, the counters are only readable by
+    /// root unless the permissions of <c>energy_uj</c> have been changed.
+    /// </para>
+    /// </remarks>
+    class TRROJANCORE_API powercap_sensor final {
+
+    public:
+
+        /// <summary>
+        /// The type of the raw energy counters, which are in micro Joules.
+        /// </summary>
+        typedef std::uint64_t counter_type;
+
+        /// <summary>
+        /// A single sample of the sensor.
+        /// </summary>
+        struct measurement {
+
+            /// <summary>
+            /// The name of the sensor that produced the sample.
+            /// </summary>
+            std::string sensor;
+
+            /// <summary>
+            /// The time of the sample in milliseconds since the epoch.
+            /// </summary>
+            std::int64_t timestamp;
+
+            /// <summary>
+            /// The energy in Joules that has been consumed since the sensor
+            /// was created or reset.
+            /// </summary>
+            double energy;
+
+            /// <summary>
+            /// The average power in Watts since the previous sample.
+            /// </summary>
+            double power;
+        };
+
+        /// <summary>
+        /// The directory where the powercap zones are located, which is
+        /// &quot;/sys/class/powercap&quot;.
+        /// </summary>
+        static const std::string default_root;
+
+        /// <summary>
+        /// Creates sensors for all readable RAPL zones in
+        /// <paramref name="root" />.
+        /// </summary>
+        /// <remarks>
+        /// Zones which cannot be read, for instance due to missing
+        /// permissions, are skipped with a warning in the log.
+        /// </remarks>
+        /// <param name="root">The directory to search for zones.</param>
+        /// <returns>The sensors for all zones that could be opened.</returns>
+        static std::vector<powercap_sensor> for_all(
+            const std::string& root = default_root);
+
+        /// <summary>
+        /// Initialises a new instance for the zone at the given location.
+        /// </summary>
+        /// <param name="root">The directory where the zones are located.
+        /// </param>
+        /// <param name="zone">The name of the zone directory, for instance
+        /// &quot;intel-rapl:0&quot;.</param>
+        /// <exception cref="std::runtime_error">If the energy counter of the
+        /// zone could not be read.</exception>
+        powercap_sensor(const std::string& root, const std::string& zone);
+
+        /// <summary>
+        /// Answer whether the energy of the domain is not part of any other
+        /// domain, ie whether it must be included when summing up the total
+        /// energy of the system.
+        /// </summary>
+        /// <remarks>
+        /// This is the case for the packages and the DRAM, whereas the core
+        /// and uncore domains are part of their package and the platform
+        /// domain covers everything.
+        /// </remarks>
+        bool counts_towards_total(void) const;
+
+        /// <summary>
+        /// Gets the name of the domain as reported by the driver, for instance
+        /// &quot;package-0&quot; or &quot;dram&quot;.
+        /// </summary>
+        inline const std::string& domain(void) const {
+            return this->_domain;
+        }
+
+        /// <summary>
+        /// Gets the energy in Joules that has been accumulated since the
+        /// sensor was created or reset.
+        /// </summary>
+        inline double energy(void) const {
+            return static_cast<double>(this->_energy) / 1000000.0;
+        }
+
+        /// <summary>
+        /// Gets the value at which the energy counter wraps around.
+        /// </summary>
+        inline counter_type max_energy_range(void) const {
+            return this->_max_energy_range;
+        }
+
+        /// <summary>
+        /// Gets the unique name of the sensor, which includes the domain of the
+        /// parent zone for subzones, for instance &quot;package-0/dram&quot;.
+        /// </summary>
+        inline const std::string& name(void) const {
+            return this->_name;
+        }
+
+        /// <summary>
+        /// Reads the current value of the energy counter.
+        /// </summary>
+        /// <exception cref="std::runtime_error">If the counter could not be
+        /// read.</exception>
+        counter_type read_counter(void) const;
+
+        /// <summary>
+        /// Restarts accumulating the energy at zero.
+        /// </summary>
+        void reset(void);
+
+        /// <summary>
+        /// Reads the counter, accumulates the energy consumed since the
+        /// previous sample and returns the current state.
+        /// </summary>
+        /// <returns>The sample.</returns>
+        measurement sample(void);
+
+        /// <summary>
+        /// Gets the name of the zone directory, for instance
+        /// &quot;intel-rapl:0:1&quot;.
+        /// </summary>
+        inline const std::string& zone(void) const {
+            return this->_zone;
+        }
+
+    private:
+
+        typedef std::chrono::steady_clock clock_type;
+
+        std::string _domain;
+        counter_type _energy;
+        counter_type _last_counter;
+        clock_type::time_point _last_time;
+        counter_type _max_energy_range;
+        std::string _name;
+        std::string _path;
+        std::string _zone;
+    };
+
+} /* end namespace trrojan */
@@ -0,0 +1,186 @@
+﻿// <copyright file="prefetch_cache.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cassert>
+#include <cinttypes>
+#include <condition_variable>
+#include <deque>
+#include <functional>
+#include <mutex>
+#include <stdexcept>
+#include <thread>
+#include <unordered_map>
+
+#include "trrojan/log.h"
+#include "trrojan/prefetch_gate.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// A bounded cache of data sets that are prepared on a background thread
+    /// while the benchmark is still measuring the previous configuration.
+    /// </summary>
+    /// <remarks>
+    /// <para>A benchmark usually owns an instance of the cache and fills it
+    /// from <see cref="trrojan::benchmark_base::prefetch" />, which is called
+    /// for the upcoming configurations before the current one is run. Once
+    /// the benchmark actually needs the data, it calls <see cref="get" /> with
+    /// the same key, which returns the prepared data, waits for the
+    /// preparation to complete if it is still running or prepares the data on
+    /// the calling thread if it has not been requested before.</para>
+    /// <para>The background thread does not start any work while the
+    /// <see cref="trrojan::prefetch_gate" /> is suspended, ie while a
+    /// benchmark is in a timed region.</para>
+    /// <para>The cache holds at most <see cref="capacity" /> entries. If it
+    /// is full, the least recently used data set that has already been
+    /// prepared is evicted. If all entries are still being prepared, requests
+    /// for prefetching are ignored.</para>
+    /// </remarks>
+    /// <typeparam name="TKey">The key identifying a data set, which must be
+    /// usable with <see cref="std::unordered_map" />.</typeparam>
+    /// <typeparam name="TValue">The type of the cached data, which must be
+    /// default-constructible and cheap to copy. A
+    /// <see cref="std::shared_ptr" /> is therefore preferable for large data.
+    /// </typeparam>
+    template<class TKey, class TValue>
+    class prefetch_cache final {
+
+    public:
+
+        /// <summary>
+        /// The key identifying a data set.
+        /// </summary>
+        typedef TKey key_type;
+
+        /// <summary>
+        /// The type of the cached data.
+        /// </summary>
+        typedef TValue value_type;
+
+        /// <summary>
+        /// A function that prepares the data for a key.
+        /// </summary>
+        typedef std::function<value_type(void)> producer_type;
+
+        /// <summary>
+        /// Initialises a new instance.
+        /// </summary>
+        /// <remarks>
+        /// The background thread is only started once the first data set is
+        /// prefetched.
+        /// </remarks>
+        /// <param name="capacity">The maximum number of data sets held in the
+        /// cache, which must be at least one.</param>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="capacity" /> is zero.</exception>
+        explicit prefetch_cache(const std::size_t capacity = 2);
+
+        prefetch_cache(const prefetch_cache&) = delete;
+
+        /// <summary>
+        /// Finalises the instance.
+        /// </summary>
+        /// <remarks>
+        /// Pending requests are discarded, but the destructor waits for the
+        /// data set being prepared on the background thread.
+        /// </remarks>
+        ~prefetch_cache(void);
+
+        /// <summary>
+        /// Answer the maximum number of data sets in the cache.
+        /// </summary>
+        inline std::size_t capacity(void) const {
+            return this->_capacity;
+        }
+
+        /// <summary>
+        /// Discards all pending requests and all prepared data sets.
+        /// </summary>
+        /// <remarks>
+        /// If a data set is being prepared on the background thread, the
+        /// method waits for it to complete.
+        /// </remarks>
+        void clear(void);
+
+        /// <summary>
+        /// Retrieves the data set for the given key.
+        /// </summary>
+        /// <remarks>
+        /// The data set remains in the cache, such that subsequent
+        /// configurations using the same data can retrieve it, too.
+        /// </remarks>
+        /// <param name="key">The key identifying the data set.</param>
+        /// <param name="producer">The function used to prepare the data on
+        /// the calling thread if it has not been prefetched. Exceptions thrown
+        /// by the producer are propagated to the caller.</param>
+        /// <returns>The data set.</returns>
+        value_type get(const key_type& key, const producer_type& producer);
+
+        /// <summary>
+        /// Requests the data set for the given key to be prepared on the
+        /// background thread.
+        /// </summary>
+        /// <remarks>
+        /// If the producer fails, the error is logged and the data set is
+        /// dropped, such that <see cref="get" /> will retry on the calling
+        /// thread and report the error to the benchmark.
+        /// </remarks>
+        /// <param name="key">The key identifying the data set.</param>
+        /// <param name="producer">The function preparing the data.</param>
+        /// <returns><c>true</c> if the data set is in the cache or has been
+        /// queued, <c>false</c> if the cache is full.</returns>
+        bool prefetch(const key_type& key, const producer_type& producer);
+
+        prefetch_cache& operator =(const prefetch_cache&) = delete;
+
+    private:
+
+        /// <summary>
+        /// The possible states of an entry.
+        /// </summary>
+        enum class entry_state {
+            pending,
+            running,
+            ready
+        };
+
+        /// <summary>
+        /// An entry in the cache.
+        /// </summary>
+        struct entry {
+            producer_type producer;
+            entry_state state;
+            std::uint64_t used;
+            value_type value;
+        };
+
+        /// <summary>
+        /// Makes sure that there is space for another entry, which requires
+        /// <see cref="_lock" /> being held.
+        /// </summary>
+        bool make_room(void);
+
+        /// <summary>
+        /// The body of the background thread.
+        /// </summary>
+        void work(void);
+
+        std::size_t _capacity;
+        std::condition_variable _cv;
+        std::unordered_map<key_type, entry> _entries;
+        std::mutex _lock;
+        std::deque<key_type> _queue;
+        bool _running;
+        std::uint64_t _time;
+        std::thread _worker;
+    };
+
+}
+
+#include "trrojan/prefetch_cache.inl"
@@ -0,0 +1,237 @@
+﻿// <copyright file="prefetch_cache.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+
+/*
+ * trrojan::prefetch_cache<TKey, TValue>::prefetch_cache
+ */
+template<class TKey, class TValue>
+trrojan::prefetch_cache<TKey, TValue>::prefetch_cache(
+        const std::size_t capacity)
+        : _capacity(capacity), _running(true), _time(0) {
+    if (this->_capacity < 1) {
+        throw std::invalid_argument("The capacity of a prefetch cache must be "
+            "at least one.");
+    }
+}
+
+
+/*
+ * trrojan::prefetch_cache<TKey, TValue>::~prefetch_cache
+ */
+template<class TKey, class TValue>
+trrojan::prefetch_cache<TKey, TValue>::~prefetch_cache(void) {
+    {
+        std::lock_guard<std::mutex> l(this->_lock);
+        this->_running = false;
+        this->_queue.clear();
+    }
+    this->_cv.notify_all();
+
+    if (this->_worker.joinable()) {
+        this->_worker.join();
+    }
+}
+
+
+/*
+ * trrojan::prefetch_cache<TKey, TValue>::clear
+ */
+template<class TKey, class TValue>
+void trrojan::prefetch_cache<TKey, TValue>::clear(void) {
+    std::unique_lock<std::mutex> l(this->_lock);
+    this->_queue.clear();
+    this->_cv.wait(l, [this](void) {
+        for (auto& e : this->_entries) {
+            if (e.second.state == entry_state::running) {
+                return false;
+            }
+        }
+        return true;
+    });
+    this->_entries.clear();
+}
+
+
+/*
+ * trrojan::prefetch_cache<TKey, TValue>::get
+ */
+template<class TKey, class TValue>
+typename trrojan::prefetch_cache<TKey, TValue>::value_type
+trrojan::prefetch_cache<TKey, TValue>::get(const key_type& key,
+        const producer_type& producer) {
+    std::unique_lock<std::mutex> l(this->_lock);
+
+    for (auto it = this->_entries.find(key); it != this->_entries.end();
+            it = this->_entries.find(key)) {
+        if (it->second.state == entry_state::ready) {
+            it->second.used = ++this->_time;
+            return it->second.value;
+
+        } else if (it->second.state == entry_state::running) {
+            // Wait for the background thread, which either completes or drops
+            // the entry.
+            this->_cv.wait(l);
+
+        } else {
+            // The background thread has not yet started, so it is faster to
+            // prepare the data here. The stale key in the queue is skipped
+            // by the background thread.
+            this->_entries.erase(it);
+            break;
+        }
+    }
+
+    l.unlock();
+    auto retval = producer();
+    l.lock();
+
+    if ((this->_entries.find(key) == this->_entries.end())
+            && this->make_room()) {
+        this->_entries[key] = entry { producer_type(), entry_state::ready,
+            ++this->_time, retval };
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::prefetch_cache<TKey, TValue>::prefetch
+ */
+template<class TKey, class TValue>
+bool trrojan::prefetch_cache<TKey, TValue>::prefetch(const key_type& key,
+        const producer_type& producer) {
+    {
+        std::lock_guard<std::mutex> l(this->_lock);
+
+        auto it = this->_entries.find(key);
+        if (it != this->_entries.end()) {
+            it->second.used = ++this->_time;
+            return true;
+        }
+
+        if (!this->make_room()) {
+            log::instance().write_line(log_level::debug, "The prefetch cache "
+                "is full of pending data sets. Ignoring the request.");
+            return false;
+        }
+
+        this->_entries[key] = entry { producer, entry_state::pending,
+            ++this->_time, value_type() };
+        this->_queue.push_back(key);
+
+        if (!this->_worker.joinable()) {
+            this->_worker = std::thread(&prefetch_cache::work, this);
+        }
+    }
+
+    this->_cv.notify_all();
+    return true;
+}
+
+
+/*
+ * trrojan::prefetch_cache<TKey, TValue>::make_room
+ */
+template<class TKey, class TValue>
+bool trrojan::prefetch_cache<TKey, TValue>::make_room(void) {
+    if (this->_entries.size() < this->_capacity) {
+        return true;
+    }
+
+    auto victim = this->_entries.end();
+    for (auto it = this->_entries.begin(); it != this->_entries.end(); ++it) {
+        if ((it->second.state == entry_state::ready)
+                && ((victim == this->_entries.end())
+                || (it->second.used < victim->second.used))) {
+            victim = it;
+        }
+    }
+
+    if (victim == this->_entries.end()) {
+        return false;
+    }
+
+    this->_entries.erase(victim);
+    return true;
+}
+
+
+/*
+ * trrojan::prefetch_cache<TKey, TValue>::work
+ */
+template<class TKey, class TValue>
+void trrojan::prefetch_cache<TKey, TValue>::work(void) {
+    std::unique_lock<std::mutex> l(this->_lock);
+
+    while (true) {
+        this->_cv.wait(l, [this](void) {
+            return (!this->_running || !this->_queue.empty());
+        });
+        if (!this->_running) {
+            break;
+        }
+
+        // Do not start anything while a benchmark is measuring. The gate
+        // must not be waited for while holding the lock, because the
+        // benchmark might need the cache during its timed region.
+        l.unlock();
+        prefetch_gate::enter();
+        l.lock();
+
+        auto it = this->_entries.end();
+        while ((it == this->_entries.end()) && !this->_queue.empty()) {
+            it = this->_entries.find(this->_queue.front());
+            this->_queue.pop_front();
+            if ((it != this->_entries.end())
+                    && (it->second.state != entry_state::pending)) {
+                it = this->_entries.end();
+            }
+        }
+
+        if (it == this->_entries.end()) {
+            l.unlock();
+            prefetch_gate::leave();
+            l.lock();
+            continue;
+        }
+
+        const auto key = it->first;
+        const auto producer = std::move(it->second.producer);
+        it->second.state = entry_state::running;
+        l.unlock();
+
+        value_type value;
+        auto succeeded = false;
+        try {
+            value = producer();
+            succeeded = true;
+        } catch (const std::exception& ex) {
+            log::instance().write_line(log_level::warning, "Prefetching a "
+                "data set failed: {0}", ex.what());
+        } catch (...) {
+            log::instance().write_line(log_level::warning, "Prefetching a "
+                "data set failed with an unexpected exception.");
+        }
+
+        prefetch_gate::leave();
+        l.lock();
+
+        // Running entries are never removed by other threads, but the map
+        // might have been rehashed in the meantime.
+        it = this->_entries.find(key);
+        assert(it != this->_entries.end());
+        if (succeeded) {
+            it->second.state = entry_state::ready;
+            it->second.value = std::move(value);
+        } else {
+            this->_entries.erase(it);
+        }
+
+        this->_cv.notify_all();
+    }
+}
@@ -0,0 +1,69 @@
+﻿// <copyright file="prefetch_gate.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cstddef>
+
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// A process-wide gate that keeps background preparation work from
+    /// interfering with timed regions of the benchmarks.
+    /// </summary>
+    /// <remarks>
+    /// <para>Background jobs, like the ones of
+    /// <see cref="trrojan::prefetch_cache" />, must bracket their work with
+    /// <see cref="enter" /> and <see cref="leave" />. A benchmark that is about
+    /// to start a measurement calls <see cref="suspend" />, which blocks until
+    /// all running jobs have completed and prevents new ones from starting
+    /// until <see cref="resume" /> is called. Suspensions can be nested.</para>
+    /// <para><see cref="trrojan::benchmark_base::enter_power_scope" /> and
+    /// <see cref="trrojan::benchmark_base::leave_power_scope" /> suspend and
+    /// resume the gate, wherefore benchmarks using these do not need to care
+    /// about the gate themselves.</para>
+    /// </remarks>
+    class TRROJANCORE_API prefetch_gate final {
+
+    public:
+
+        /// <summary>
+        /// Blocks the calling background job while the gate is suspended and
+        /// registers it as running afterwards.
+        /// </summary>
+        static void enter(void);
+
+        /// <summary>
+        /// Marks a job that has been registered by <see cref="enter" /> as
+        /// completed.
+        /// </summary>
+        static void leave(void);
+
+        /// <summary>
+        /// Undoes one call to <see cref="suspend" />.
+        /// </summary>
+        /// <exception cref="std::logic_error">If the gate has not been
+        /// suspended.</exception>
+        static void resume(void);
+
+        /// <summary>
+        /// Prevents background jobs from starting and waits for the running
+        /// ones to complete.
+        /// </summary>
+        static void suspend(void);
+
+        /// <summary>
+        /// Answer whether the gate is currently suspended.
+        /// </summary>
+        static bool suspended(void);
+
+        prefetch_gate(void) = delete;
+    };
+
+}
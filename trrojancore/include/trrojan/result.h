@@ -82,6 +82,21 @@ namespace trrojan {
             this->_results.insert(this->_results.end(), results);
         }
 
+        /// <summary>
+        /// Append a new result column which has the same value for all
+        /// measurements.
+        /// </summary>
+        /// <remarks>
+        /// This is intended for values which are recorded by the framework
+        /// rather than the benchmark itself, for instance the thermal state
+        /// of the machine before and after the measurements.
+        /// </remarks>
+        /// <param name="name">The name of the new result column.</param>
+        /// <param name="value">The value of the new column.</param>
+        /// <exception cref="std::invalid_argument">If a result with the given
+        /// name already exists.</exception>
+        void add_column(const std::string& name, const variant& value);
+
         /// <summary>
         /// Ensure that this result and <paramref name="other" /> contain
         /// the same configuration and result names or throw an exception.
@@ -0,0 +1,263 @@
+﻿// <copyright file="result_comparison.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cstddef>
+#include <ostream>
+#include <string>
+#include <vector>
+
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// Compares the samples of a metric in two result files configuration by
+    /// configuration and decides whether the differences are significant.
+    /// </summary>
+    /// <remarks>
+    /// <para>The files must have been written by
+    /// <see cref="trrojan::csv_output" />. The rows of both files are joined
+    /// on the values of the factors, and all rows of a configuration form
+    /// the samples of the metric. The files are read line by line and only
+    /// the samples are retained, wherefore large files can be compared.
+    /// </para>
+    /// <para>For each configuration, the relative change of the median is
+    /// computed along with a bootstrapped confidence interval of this
+    /// change. A two-sided Mann-Whitney U test decides whether the samples
+    /// differ. A change is flagged if the test is significant and the
+    /// change exceeds the threshold.</para>
+    /// </remarks>
+    class TRROJANCORE_API result_comparison {
+
+    public:
+
+        /// <summary>
+        /// The outcome of the comparison of a configuration.
+        /// </summary>
+        enum class verdict {
+            /// <summary>
+            /// The configuration has become significantly worse.
+            /// </summary>
+            regression,
+
+            /// <summary>
+            /// The configuration has become significantly better.
+            /// </summary>
+            improvement,
+
+            /// <summary>
+            /// The change is not significant or below the threshold.
+            /// </summary>
+            unchanged,
+
+            /// <summary>
+            /// The configuration is only in one of the files or has too few
+            /// samples for the test.
+            /// </summary>
+            incomparable
+        };
+
+        /// <summary>
+        /// The comparison of a single configuration.
+        /// </summary>
+        struct entry {
+
+            /// <summary>
+            /// The values of the factors of the configuration.
+            /// </summary>
+            std::string configuration;
+
+            /// <summary>
+            /// The median of the metric in the baseline.
+            /// </summary>
+            double baseline;
+
+            /// <summary>
+            /// The number of samples in the baseline.
+            /// </summary>
+            std::size_t baseline_samples;
+
+            /// <summary>
+            /// The relative change of the median from the baseline to the
+            /// current results.
+            /// </summary>
+            double change;
+
+            /// <summary>
+            /// The lower bound of the confidence interval of
+            /// <see cref="change" />.
+            /// </summary>
+            double change_lower;
+
+            /// <summary>
+            /// The upper bound of the confidence interval of
+            /// <see cref="change" />.
+            /// </summary>
+            double change_upper;
+
+            /// <summary>
+            /// The median of the metric in the current results.
+            /// </summary>
+            double current;
+
+            /// <summary>
+            /// The number of samples in the current results.
+            /// </summary>
+            std::size_t current_samples;
+
+            /// <summary>
+            /// The p-value of the Mann-Whitney U test.
+            /// </summary>
+            double p_value;
+
+            /// <summary>
+            /// The outcome of the comparison.
+            /// </summary>
+            trrojan::result_comparison::verdict verdict;
+        };
+
+        /// <summary>
+        /// The number of resamples used to bootstrap the confidence interval
+        /// of the change.
+        /// </summary>
+        static const std::size_t default_resamples;
+
+        /// <summary>
+        /// The significance level of the test if not set otherwise.
+        /// </summary>
+        static const double default_significance;
+
+        /// <summary>
+        /// The relative change below which differences are ignored if not
+        /// set otherwise.
+        /// </summary>
+        static const double default_threshold;
+
+        /// <summary>
+        /// Answer a human-readable name of the given verdict.
+        /// </summary>
+        static const char *to_string(const verdict verdict);
+
+        /// <summary>
+        /// Writes a report of the given comparisons to a stream.
+        /// </summary>
+        /// <remarks>
+        /// The entries are reported in the order they are passed, which is
+        /// the order in which <see cref="compare" /> returns them.
+        /// </remarks>
+        static void write_report(std::ostream& stream,
+            const std::vector<entry>& entries);
+
+        /// <summary>
+        /// Initialises a new instance.
+        /// </summary>
+        /// <param name="metric">The name of the column holding the samples
+        /// to compare.</param>
+        /// <param name="separator">The separator of the columns in the
+        /// files.</param>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="metric" /> or <paramref name="separator" /> is
+        /// empty.</exception>
+        result_comparison(const std::string& metric,
+            const std::string& separator);
+
+        /// <summary>
+        /// Compares the results in the given files.
+        /// </summary>
+        /// <param name="baseline">The path to the file holding the reference
+        /// results.</param>
+        /// <param name="current">The path to the file holding the results to
+        /// be checked.</param>
+        /// <returns>The comparisons of all configurations, regressions first,
+        /// followed by the improvements, the unchanged and the incomparable
+        /// configurations. Within each group, larger changes come first.
+        /// </returns>
+        /// <exception cref="std::invalid_argument">If no factors have been
+        /// set.</exception>
+        /// <exception cref="std::runtime_error">If any of the files could
+        /// not be read or does not contain the metric or one of the factors,
+        /// or if no configuration has more than one sample in both files.
+        /// </exception>
+        std::vector<entry> compare(const std::string& baseline,
+            const std::string& current) const;
+
+        /// <summary>
+        /// Gets the names of the columns the results are joined on.
+        /// </summary>
+        /// <remarks>
+        /// The factors must be set before comparing, because the result
+        /// files do not distinguish between the columns of the configuration
+        /// and the results.
+        /// </remarks>
+        inline const std::vector<std::string>& factors(void) const {
+            return this->_factors;
+        }
+
+        /// <summary>
+        /// Sets the names of the columns the results are joined on.
+        /// </summary>
+        inline void factors(const std::vector<std::string>& factors) {
+            this->_factors = factors;
+        }
+
+        /// <summary>
+        /// Answer whether larger values of the metric are better.
+        /// </summary>
+        inline bool higher_is_better(void) const {
+            return this->_higher_is_better;
+        }
+
+        /// <summary>
+        /// Sets whether larger values of the metric are better, which is
+        /// not the case for times.
+        /// </summary>
+        inline void higher_is_better(const bool higher_is_better) {
+            this->_higher_is_better = higher_is_better;
+        }
+
+        /// <summary>
+        /// Gets the significance level of the test.
+        /// </summary>
+        inline double significance(void) const {
+            return this->_significance;
+        }
+
+        /// <summary>
+        /// Sets the significance level of the test, which also determines
+        /// the confidence level of the intervals.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="significance" /> is not within (0, 1).</exception>
+        void significance(const double significance);
+
+        /// <summary>
+        /// Gets the relative change below which differences are ignored.
+        /// </summary>
+        inline double threshold(void) const {
+            return this->_threshold;
+        }
+
+        /// <summary>
+        /// Sets the relative change below which differences are ignored.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="threshold" /> is negative.</exception>
+        void threshold(const double threshold);
+
+    private:
+
+        std::vector<std::string> _factors;
+        bool _higher_is_better;
+        std::string _metric;
+        std::string _separator;
+        double _significance;
+        double _threshold;
+    };
+
+}
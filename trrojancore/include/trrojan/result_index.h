@@ -0,0 +1,112 @@
+﻿// <copyright file="result_index.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <string>
+#include <unordered_set>
+#include <vector>
+
+#include "trrojan/configuration.h"
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// An index of the configurations that are already present in an
+    /// existing result file, which allows for skipping these when the
+    /// benchmarks are run again.
+    /// </summary>
+    /// <remarks>
+    /// <para>The index stores the textual representation of all rows as they
+    /// have been written by the output. As the result files do not
+    /// distinguish between factors, system factors and results, the columns
+    /// to compare must be selected by the caller, which usually knows the
+    /// factors of the configuration set it is going to run. The system
+    /// factors, which might change between the runs, are therefore never part
+    /// of the comparison.</para>
+    /// </remarks>
+    class TRROJANCORE_API result_index {
+
+    public:
+
+        /// <summary>
+        /// The type of the set of keys of the completed configurations.
+        /// </summary>
+        typedef std::unordered_set<std::string> key_set;
+
+        /// <summary>
+        /// Reads the CSV file at the given location.
+        /// </summary>
+        /// <remarks>
+        /// If the file does not exist, an empty index is returned.
+        /// </remarks>
+        /// <param name="path">The path to the CSV file, which must have been
+        /// written by <see cref="trrojan::csv_output" />.</param>
+        /// <param name="separator">The separator of the columns.</param>
+        /// <returns>The index of the rows in the file.</returns>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="separator" /> is empty.</exception>
+        static result_index from_csv(const std::string& path,
+            const std::string& separator);
+
+        /// <summary>
+        /// Computes the key of <paramref name="config" /> with respect to the
+        /// given factors, which can be searched in the keys returned by
+        /// <see cref="keys" />.
+        /// </summary>
+        /// <param name="config">The configuration to compute the key of.
+        /// </param>
+        /// <param name="factors">The names of the factors that form the key.
+        /// </param>
+        /// <returns>The key of the configuration.</returns>
+        static std::string key(const configuration& config,
+            const std::vector<std::string>& factors);
+
+        /// <summary>
+        /// Initialises a new, empty instance.
+        /// </summary>
+        inline result_index(void) = default;
+
+        /// <summary>
+        /// Gets the names of the columns of the result file.
+        /// </summary>
+        inline const std::vector<std::string>& columns(void) const {
+            return this->_columns;
+        }
+
+        /// <summary>
+        /// Answer whether the index does not contain any row.
+        /// </summary>
+        inline bool empty(void) const {
+            return this->_rows.empty();
+        }
+
+        /// <summary>
+        /// Computes the keys of all rows with respect to the given factors.
+        /// </summary>
+        /// <param name="factors">The names of the factors that form the key.
+        /// </param>
+        /// <returns>The keys of all rows, which are empty if any of the
+        /// <paramref name="factors" /> is not a column of the file, because
+        /// none of the configurations can have been completed in this case.
+        /// </returns>
+        key_set keys(const std::vector<std::string>& factors) const;
+
+        /// <summary>
+        /// Answer the number of rows in the index.
+        /// </summary>
+        inline std::size_t size(void) const {
+            return this->_rows.size();
+        }
+
+    private:
+
+        std::vector<std::string> _columns;
+        std::vector<std::vector<std::string>> _rows;
+    };
+}
@@ -6,8 +6,14 @@
 
 #pragma once
 
+#include <algorithm>
+#include <cassert>
+#include <memory>
+#include <mutex>
 #include <string>
 #include <unordered_map>
+#include <utility>
+#include <vector>
 
 #include "trrojan/export.h"
 #include "trrojan/named_variant.h"
@@ -26,6 +32,17 @@ namespace trrojan {
     /// This class provides factors defined by the system the programme is
     /// currently running on.
     /// </summary>
+    /// <remarks>
+    /// <para>Probing the system is expensive, wherefore all factors that do
+    /// not change while the programme is running are captured once in an
+    /// immutable <see cref="snapshot" />. Only the dynamic factors, which are
+    /// identified by <see cref="is_dynamic_factor" />, are retrieved whenever
+    /// the factors are requested.</para>
+    /// <para>The snapshot can optionally be persisted to a cache file, which
+    /// is reused as long as the system has not been rebooted. On Linux, the
+    /// boot is identified by <c>/proc/sys/kernel/random/boot_id</c>. On all
+    /// other platforms, the cache file is not used.</para>
+    /// </remarks>
     class TRROJANCORE_API system_factors {
 
     public:
@@ -36,6 +53,12 @@ namespace trrojan {
         /// </summary>
         typedef variant(trrojan::system_factors::*retriever_type)(void) const;
 
+        /// <summary>
+        /// The type of the immutable snapshot of the static factors.
+        /// </summary>
+        typedef std::shared_ptr<const std::vector<named_variant>>
+            snapshot_type;
+
         /// <summary>
         /// Answer the only instance of this class.
         /// </summary>
@@ -44,17 +67,54 @@ namespace trrojan {
             return instance;
         }
 
+        /// <summary>
+        /// Answer whether <paramref name="factor" /> designates a system
+        /// factor that may change while the programme is running and must
+        /// therefore not be cached.
+        /// </summary>
+        static bool is_dynamic_factor(const std::string& factor);
+
         /// <summary>
         /// Answer whether <paramref name="factor" /> designates a system
         /// factor.
         /// </summary>
         static bool is_system_factor(const std::string& factor);
 
+        /// <summary>
+        /// Instructs the system factors to load the snapshot from or persist
+        /// it to the given file.
+        /// </summary>
+        /// <remarks>
+        /// This method must be called before the snapshot is created for the
+        /// first time in order to have any effect.
+        /// </remarks>
+        /// <param name="path">The path to the cache file. If empty, no cache
+        /// is used.</param>
+        static void use_cache_file(const std::string& path);
+
         /// <summary>
         /// Name of the built-in factor describing the BIOS.
         /// </summary>
         static const std::string factor_bios;
 
+        /// <summary>
+        /// Name of the built-in factor describing the size of the level 1 data
+        /// cache of a single core in bytes.
+        /// </summary>
+        static const std::string factor_cache_l1;
+
+        /// <summary>
+        /// Name of the built-in factor describing the size of a single level 2
+        /// cache in bytes.
+        /// </summary>
+        static const std::string factor_cache_l2;
+
+        /// <summary>
+        /// Name of the built-in factor describing the size of a single level 3
+        /// cache in bytes.
+        /// </summary>
+        static const std::string factor_cache_l3;
+
         /// <summary>
         /// Name of the built-in factor describing the host name.
         /// </summary>
@@ -65,6 +125,23 @@ namespace trrojan {
         /// </summary>
         static const std::string factor_cpu;
 
+        /// <summary>
+        /// Name of the built-in factor describing the cpufreq governor(s).
+        /// </summary>
+        static const std::string factor_cpu_governor;
+
+        /// <summary>
+        /// Name of the built-in factor describing the number of processor
+        /// packages (sockets).
+        /// </summary>
+        static const std::string factor_cpu_packages;
+
+        /// <summary>
+        /// Name of the built-in factor describing whether the processors may
+        /// boost their clock.
+        /// </summary>
+        static const std::string factor_cpu_turbo;
+
         /// <summary>
         /// Name of the factor that indicates whether TRRojan was running as a
         /// debug build.
@@ -77,6 +154,12 @@ namespace trrojan {
         /// </summary>
         static const std::string factor_gaming_device;
 
+        /// <summary>
+        /// Name of the built-in factor describing the free and total number
+        /// of pre-allocated huge pages and their size.
+        /// </summary>
+        static const std::string factor_huge_pages;
+
         /// <summary>
         /// Name of the built-in factor descrbing the amount of RAM installed.
         /// </summary>
@@ -93,6 +176,17 @@ namespace trrojan {
         /// </summary>
         static const std::string factor_mainboard;
 
+        /// <summary>
+        /// Name of the built-in factor describing the relative distances
+        /// between all NUMA nodes.
+        /// </summary>
+        static const std::string factor_numa_distances;
+
+        /// <summary>
+        /// Name of the built-in factor describing the number of NUMA nodes.
+        /// </summary>
+        static const std::string factor_numa_nodes;
+
         /// <summary>
         /// Name of the built-in factor describing the operating system.
         /// </summary>
@@ -103,6 +197,12 @@ namespace trrojan {
         /// </summary>
         static const std::string factor_os_version;
 
+        /// <summary>
+        /// Name of the built-in factor describing the number of physical CPU
+        /// cores.
+        /// </summary>
+        static const std::string factor_physical_cores;
+
         /// <summary>
         /// Name of the built-in factor describing whether the current process
         /// is elevated.
@@ -114,6 +214,18 @@ namespace trrojan {
         /// </summary>
         static const std::string factor_ram;
 
+        /// <summary>
+        /// Name of the built-in factor describing the configured speed of the
+        /// memory in MT/s.
+        /// </summary>
+        static const std::string factor_ram_speed;
+
+        /// <summary>
+        /// Name of the built-in factor describing the number of hardware
+        /// threads per physical core.
+        /// </summary>
+        static const std::string factor_smt_threads;
+
         /// <summary>
         /// Name of the built-in factor describing the system (if the OEM
         /// set the information in SMBIOS).
@@ -132,11 +244,35 @@ namespace trrojan {
         /// </summary>
         static const std::string factor_tdr_level;
 
+        /// <summary>
+        /// Name of the built-in factor holding the average time in
+        /// nanoseconds it takes to read the <see cref="trrojan::timer" />.
+        /// </summary>
+        static const std::string factor_timer_overhead;
+
+        /// <summary>
+        /// Name of the built-in factor holding the smallest difference in
+        /// nanoseconds the <see cref="trrojan::timer" /> can measure.
+        /// </summary>
+        static const std::string factor_timer_resolution;
+
+        /// <summary>
+        /// Name of the built-in factor describing the source of the time used
+        /// by the <see cref="trrojan::timer" />.
+        /// </summary>
+        static const std::string factor_timer_source;
+
         /// <summary>
         /// Gets a string representation of the current date and time.
         /// </summary>
         static const std::string factor_timestamp;
 
+        /// <summary>
+        /// Name of the built-in factor describing the mode of transparent
+        /// huge pages.
+        /// </summary>
+        static const std::string factor_transparent_huge_pages;
+
         /// <summary>
         /// Name of the built-in factor describing the user name.
         /// </summary>
@@ -144,10 +280,22 @@ namespace trrojan {
 
         variant bios(void) const;
 
+        variant cache_l1(void) const;
+
+        variant cache_l2(void) const;
+
+        variant cache_l3(void) const;
+
         variant computer_name(void) const;
 
         variant cpu(void) const;
 
+        variant cpu_governor(void) const;
+
+        variant cpu_packages(void) const;
+
+        variant cpu_turbo(void) const;
+
         variant debug_build(void) const;
 
         variant gaming_device(void) const;
@@ -157,32 +305,90 @@ namespace trrojan {
         /// <summary>
         /// Answer all system factors.
         /// </summary>
+        /// <remarks>
+        /// The static factors are copied from the <see cref="snapshot" />,
+        /// only the dynamic ones are retrieved on each call. The factors are
+        /// produced in the order of the retrievers, which the snapshot
+        /// preserves.
+        /// </remarks>
         template<class I> inline void get(I oit) const {
-            for (auto r : system_factors::get_retrievers()) {
-                *oit++ = named_variant(r.first, (this->*(r.second))());
+            auto snapshot = this->snapshot();
+            auto it = snapshot->begin();
+            for (auto& r : system_factors::get_retrievers()) {
+                if (system_factors::is_dynamic_factor(r.first)) {
+                    *oit++ = named_variant(r.first, (this->*(r.second))());
+                } else {
+                    assert(it != snapshot->end());
+                    assert(it->name() == r.first);
+                    *oit++ = *it++;
+                }
             }
         }
 
+        /// <summary>
+        /// Answer only the dynamic system factors along with their position
+        /// among all factors <see cref="get" /> produces.
+        /// </summary>
+        /// <remarks>
+        /// Together with the <see cref="snapshot" />, the output allows for
+        /// reconstructing the result of <see cref="get" /> without copying
+        /// the static factors.
+        /// </remarks>
+        template<class I> inline void get_dynamic(I oit) const {
+            std::size_t position = 0;
+            for (auto& r : system_factors::get_retrievers()) {
+                if (system_factors::is_dynamic_factor(r.first)) {
+                    *oit++ = std::make_pair(position, named_variant(r.first,
+                        (this->*(r.second))()));
+                }
+                ++position;
+            }
+        }
+
+        variant huge_pages(void) const;
+
         variant installed_memory(void) const;
 
         variant mainboard(void) const;
 
+        variant numa_distances(void) const;
+
+        variant numa_nodes(void) const;
+
         variant os(void) const;
 
         variant os_version(void) const;
 
+        variant physical_cores(void) const;
+
         variant process_elevated(void) const;
 
         variant logical_cores(void) const;
 
         variant ram(void) const;
 
+        variant ram_speed(void) const;
+
+        variant smt_threads(void) const;
+
+        /// <summary>
+        /// Answer the immutable snapshot of all static system factors.
+        /// </summary>
+        /// <remarks>
+        /// The snapshot is created on first use, either from the cache file
+        /// or by probing the system. Callers should retrieve the snapshot
+        /// once before running any benchmark in order to prevent the probing
+        /// from interfering with the measurements.
+        /// </remarks>
+        snapshot_type snapshot(void) const;
+
         variant system_desc(void) const;
 
         inline variant tdr_delay(void) const {
 #if defined(TRROJAN_FOR_UWP)
             return static_cast<std::uint32_t>(0);
 #else /* defined(TRROJAN_FOR_UWP) */
+            this->probe();
             return static_cast<std::uint32_t>(this->osinfo.tdr_delay());
 #endif  /* defined(TRROJAN_FOR_UWP) */
         }
@@ -191,12 +397,21 @@ namespace trrojan {
 #if defined(TRROJAN_FOR_UWP)
             return static_cast<std::uint32_t>(0);
 #else /* defined(TRROJAN_FOR_UWP) */
+            this->probe();
             return static_cast<std::uint32_t>(this->osinfo.tdr_level());
 #endif  /* defined(TRROJAN_FOR_UWP) */
         }
 
+        variant timer_overhead(void) const;
+
+        variant timer_resolution(void) const;
+
+        variant timer_source(void) const;
+
         variant timestamp(void) const;
 
+        variant transparent_huge_pages(void) const;
+
         variant user_name(void) const;
 
     private:
@@ -210,10 +425,20 @@ namespace trrojan {
 
         system_factors& operator =(const system_factors&) = delete;
 
+        /// <summary>
+        /// Collects the hardware, OS and SMBIOS information if this has not
+        /// yet been done.
+        /// </summary>
+        void probe(void) const;
+
+        mutable std::once_flag probe_once;
+        mutable snapshot_type snapshot_data;
+        mutable std::once_flag snapshot_once;
+
 #if !defined(TRROJAN_FOR_UWP)
-        sysinfo::hardware_info hwinfo;
-        sysinfo::os_info osinfo;
-        sysinfo::smbios_information smbios;
+        mutable sysinfo::hardware_info hwinfo;
+        mutable sysinfo::os_info osinfo;
+        mutable sysinfo::smbios_information smbios;
 #endif /* !defined(TRROJAN_FOR_UWP) */
 
     };
@@ -0,0 +1,332 @@
+﻿// <copyright file="system_topology.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// Describes the processor, cache and memory topology of the machine,
+    /// which benchmarks can use to size their problems and to place their
+    /// threads.
+    /// </summary>
+    /// <remarks>
+    /// <para>On Linux, the topology is discovered from
+    /// <c>/sys/devices/system/cpu</c>, <c>/sys/devices/system/node</c>,
+    /// <c>/sys/kernel/mm/transparent_hugepage</c> and <c>/proc/meminfo</c>.
+    /// On all other platforms, and if sysfs is not available, the topology
+    /// consists of a single package and NUMA node with one core per logical
+    /// processor and no information about the caches.</para>
+    /// </remarks>
+    class TRROJANCORE_API system_topology {
+
+    public:
+
+        /// <summary>
+        /// The type used to identify logical processors, which is the number
+        /// the operating system uses for the processor.
+        /// </summary>
+        typedef std::uint32_t processor_id_type;
+
+        /// <summary>
+        /// A list of logical processors.
+        /// </summary>
+        typedef std::vector<processor_id_type> processor_list;
+
+        /// <summary>
+        /// The type used to express sizes in bytes.
+        /// </summary>
+        typedef std::uint64_t size_type;
+
+        /// <summary>
+        /// Describes a single cache instance.
+        /// </summary>
+        struct cache {
+
+            /// <summary>
+            /// The level of the cache, starting at 1.
+            /// </summary>
+            std::uint32_t level;
+
+            /// <summary>
+            /// The size of a cache line in bytes.
+            /// </summary>
+            std::uint32_t line_size;
+
+            /// <summary>
+            /// The logical processors sharing the cache.
+            /// </summary>
+            processor_list processors;
+
+            /// <summary>
+            /// The size of the cache in bytes.
+            /// </summary>
+            size_type size;
+
+            /// <summary>
+            /// The type of the cache, which is one of &quot;Data&quot;,
+            /// &quot;Instruction&quot; or &quot;Unified&quot;.
+            /// </summary>
+            std::string type;
+        };
+
+        /// <summary>
+        /// Describes a NUMA node.
+        /// </summary>
+        struct numa_node {
+
+            /// <summary>
+            /// The relative distances from this node to all nodes in the order
+            /// of <see cref="system_topology::nodes" />. As the IDs of the
+            /// nodes are not necessarily contiguous, the distances must be
+            /// addressed by the position of the target node rather than by its
+            /// ID. The local distance is typically 10.
+            /// </summary>
+            std::vector<std::uint32_t> distances;
+
+            /// <summary>
+            /// The ID of the node.
+            /// </summary>
+            std::uint32_t id;
+
+            /// <summary>
+            /// The total amount of memory attached to the node in bytes.
+            /// </summary>
+            size_type memory;
+
+            /// <summary>
+            /// The logical processors local to the node.
+            /// </summary>
+            processor_list processors;
+        };
+
+        /// <summary>
+        /// Describes a logical processor.
+        /// </summary>
+        struct processor {
+
+            /// <summary>
+            /// The ID of the physical core within its package.
+            /// </summary>
+            std::uint32_t core;
+
+            /// <summary>
+            /// The ID of the die within its package, which is zero if the
+            /// package consists of a single die or if the die is unknown.
+            /// </summary>
+            std::uint32_t die;
+
+            /// <summary>
+            /// The ID of the logical processor.
+            /// </summary>
+            processor_id_type id;
+
+            /// <summary>
+            /// The ID of the NUMA node the processor belongs to.
+            /// </summary>
+            std::uint32_t node;
+
+            /// <summary>
+            /// The ID of the physical package (socket).
+            /// </summary>
+            std::uint32_t package;
+
+            /// <summary>
+            /// All logical processors on the same physical core, including
+            /// the processor itself.
+            /// </summary>
+            processor_list siblings;
+        };
+
+        /// <summary>
+        /// Possible states of frequency boosting.
+        /// </summary>
+        enum class turbo_state {
+            unknown,
+            disabled,
+            enabled
+        };
+
+        /// <summary>
+        /// Answer the topology of the machine, which is discovered on first
+        /// use.
+        /// </summary>
+        static const system_topology& instance(void);
+
+        /// <summary>
+        /// Initialises a new instance by discovering the topology of the
+        /// machine.
+        /// </summary>
+        system_topology(void);
+
+        /// <summary>
+        /// Answer the size of a single instance of the data or unified cache
+        /// at the given level.
+        /// </summary>
+        /// <param name="level">The cache level, starting at 1.</param>
+        /// <returns>The size of the cache in bytes, or zero if the cache
+        /// level does not exist or is unknown.</returns>
+        size_type cache_size(const std::uint32_t level) const;
+
+        /// <summary>
+        /// Gets all cache instances in the system.
+        /// </summary>
+        inline const std::vector<cache>& caches(void) const {
+            return this->_caches;
+        }
+
+        /// <summary>
+        /// Answer the names of the cpufreq governors in use, which is a
+        /// comma-separated list if the processors use different governors.
+        /// </summary>
+        inline const std::string& governor(void) const {
+            return this->_governor;
+        }
+
+        /// <summary>
+        /// Gets the number of huge pages that are currently free.
+        /// </summary>
+        inline size_type huge_pages_free(void) const {
+            return this->_huge_pages_free;
+        }
+
+        /// <summary>
+        /// Gets the number of pre-allocated huge pages.
+        /// </summary>
+        inline size_type huge_pages_total(void) const {
+            return this->_huge_pages_total;
+        }
+
+        /// <summary>
+        /// Gets the size of a huge page in bytes, or zero if unknown.
+        /// </summary>
+        inline size_type huge_page_size(void) const {
+            return this->_huge_page_size;
+        }
+
+        /// <summary>
+        /// Answer the level of the outermost cache.
+        /// </summary>
+        std::uint32_t last_level_cache(void) const;
+
+        /// <summary>
+        /// Answer whether the given logical processors share the data or
+        /// unified cache at the given level.
+        /// </summary>
+        /// <param name="level">The cache level, starting at 1.</param>
+        /// <param name="first">The first logical processor.</param>
+        /// <param name="second">The second logical processor.</param>
+        /// <returns><c>true</c> if both processors use the same cache
+        /// instance, <c>false</c> otherwise or if the cache is unknown.
+        /// </returns>
+        bool shares_cache(const std::uint32_t level,
+            const processor_id_type first,
+            const processor_id_type second) const;
+
+        /// <summary>
+        /// Answer the number of logical processors.
+        /// </summary>
+        inline std::uint32_t logical_cores(void) const {
+            return static_cast<std::uint32_t>(this->_processors.size());
+        }
+
+        /// <summary>
+        /// Gets the NUMA nodes, ordered by their ID.
+        /// </summary>
+        inline const std::vector<numa_node>& nodes(void) const {
+            return this->_nodes;
+        }
+
+        /// <summary>
+        /// Answer the number of physical packages (sockets).
+        /// </summary>
+        std::uint32_t packages(void) const;
+
+        /// <summary>
+        /// Answer the number of physical cores.
+        /// </summary>
+        std::uint32_t physical_cores(void) const;
+
+        /// <summary>
+        /// Answer the order in which threads should be placed on the logical
+        /// processors in order to maximise the available memory bandwidth.
+        /// </summary>
+        /// <remarks>
+        /// The list starts with one logical processor of each physical core,
+        /// alternating between the packages, and continues with the remaining
+        /// SMT siblings in the same order. Rank <c>i</c> of a parallel
+        /// benchmark should therefore run on the processor at index
+        /// <c>i % logical_cores()</c>.
+        /// </remarks>
+        processor_list placement(void) const;
+
+        /// <summary>
+        /// Gets all logical processors, ordered by their ID.
+        /// </summary>
+        inline const std::vector<processor>& processors(void) const {
+            return this->_processors;
+        }
+
+        /// <summary>
+        /// Answer the maximum number of hardware threads per physical core.
+        /// </summary>
+        std::uint32_t smt_threads(void) const;
+
+        /// <summary>
+        /// Answer the total size of all instances of the data or unified
+        /// cache at the given level.
+        /// </summary>
+        /// <param name="level">The cache level, starting at 1.</param>
+        /// <returns>The aggregated size of the caches in bytes, or zero if the
+        /// cache level does not exist or is unknown.</returns>
+        size_type total_cache_size(const std::uint32_t level) const;
+
+        /// <summary>
+        /// Gets the mode of transparent huge pages, which is one of
+        /// &quot;always&quot;, &quot;madvise&quot; or &quot;never&quot; or
+        /// empty if unknown.
+        /// </summary>
+        inline const std::string& transparent_huge_pages(void) const {
+            return this->_transparent_huge_pages;
+        }
+
+        /// <summary>
+        /// Answer whether the processors may boost their clock beyond the
+        /// nominal frequency.
+        /// </summary>
+        inline turbo_state turbo(void) const {
+            return this->_turbo;
+        }
+
+    private:
+
+        void discover_caches(void);
+
+        void discover_memory(void);
+
+        void discover_nodes(void);
+
+        void discover_processors(void);
+
+        std::vector<cache> _caches;
+        std::string _governor;
+        size_type _huge_page_size;
+        size_type _huge_pages_free;
+        size_type _huge_pages_total;
+        std::vector<numa_node> _nodes;
+        std::vector<processor> _processors;
+        std::string _transparent_huge_pages;
+        turbo_state _turbo;
+    };
+
+} /* end namespace trrojan */
@@ -0,0 +1,105 @@
+﻿// <copyright file="thermal_monitor.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// Provides access to the temperature and clock state of the machine,
+    /// which is used to determine whether the system has cooled down enough
+    /// for the next measurement.
+    /// </summary>
+    /// <remarks>
+    /// <para>On Linux, the monitor reads the thermal zones in
+    /// <c>/sys/class/thermal</c> and the cpufreq state of all processors in
+    /// <c>/sys/devices/system/cpu</c>. On all other platforms, the monitor has
+    /// no sensors and all values are reported as NaN.</para>
+    /// </remarks>
+    class TRROJANCORE_API thermal_monitor {
+
+    public:
+
+        /// <summary>
+        /// The thermal state of the system at a specific point in time.
+        /// </summary>
+        struct state {
+
+            /// <summary>
+            /// The ratio between the lowest allowed maximum clock of any
+            /// processor and its hardware maximum clock.
+            /// </summary>
+            /// <remarks>
+            /// If this value is less than one, the clocks are capped, which
+            /// is typically the result of thermal throttling.
+            /// </remarks>
+            float clock_ratio;
+
+            /// <summary>
+            /// The average current clock of all processors in MHz.
+            /// </summary>
+            float frequency;
+
+            /// <summary>
+            /// The temperature of the hottest thermal zone in degrees Celsius.
+            /// </summary>
+            float temperature;
+
+            /// <summary>
+            /// The total number of thermal throttling events reported by all
+            /// processors.
+            /// </summary>
+            std::uint64_t throttle_count;
+        };
+
+        /// <summary>
+        /// Initialises a new instance and enumerates all sensors that are
+        /// available on the system.
+        /// </summary>
+        thermal_monitor(void);
+
+        /// <summary>
+        /// Answer whether there is at least one sensor providing the clock
+        /// state.
+        /// </summary>
+        inline bool has_clocks(void) const {
+            return !this->_cur_freqs.empty();
+        }
+
+        /// <summary>
+        /// Answer whether there is at least one temperature sensor.
+        /// </summary>
+        inline bool has_temperatures(void) const {
+            return !this->_temperatures.empty();
+        }
+
+        /// <summary>
+        /// Reads the current thermal state of the system.
+        /// </summary>
+        /// <remarks>
+        /// Sensors that cannot be read are ignored. Values for which no
+        /// sensor could be read are NaN.
+        /// </remarks>
+        /// <returns>The current state.</returns>
+        state sample(void) const;
+
+    private:
+
+        std::vector<std::string> _cur_freqs;
+        std::vector<float> _hw_max_freqs;
+        std::vector<std::string> _max_freqs;
+        std::vector<std::string> _temperatures;
+        std::vector<std::string> _throttle_counts;
+    };
+
+} /* end namespace trrojan */
@@ -11,22 +11,68 @@
 #include <chrono>
 #include <cstdint>
 #include <stdexcept>
+#include <string>
 #include <system_error>
 
 #ifdef _WIN32
 #include <Windows.h>
 #endif /* _WIN32 */
 
+#if (defined(_M_X64) || defined(_M_IX86) || defined(__x86_64__) \
+    || defined(__i386__))
+#define TRROJAN_TIMER_WITH_TSC
+#if defined(_MSC_VER)
+#include <intrin.h>
+#else /* defined(_MSC_VER) */
+#include <x86intrin.h>
+#endif /* defined(_MSC_VER) */
+#endif /* (defined(_M_X64) || defined(_M_IX86) || ... */
+
 
 namespace trrojan {
 
     /// <summary>
     /// A utility class for measuring wall clock times.
     /// </summary>
+    /// <remarks>
+    /// <para>By default, the timer uses the performance counter on Windows
+    /// and <see cref="std::chrono::high_resolution_clock" /> on all other
+    /// platforms. On x86 processors with an invariant time stamp counter,
+    /// <see cref="select_source" /> can switch all timers of the process to
+    /// read the time stamp counter instead, which has a lower overhead. The
+    /// rate of the counter is calibrated against
+    /// <see cref="std::chrono::steady_clock" /> when it is selected. On
+    /// Windows, the timer then yields the counter in its own units, which
+    /// <see cref="to_millis" /> converts using the calibrated rate. On all
+    /// other platforms, the counter is mapped to the native clock. In either
+    /// case, values obtained from different sources must not be
+    /// mixed.</para>
+    /// <para>Whenever a source is selected, the overhead of reading the timer
+    /// and its resolution are measured, which are reported as the system
+    /// factors <see cref="system_factors::factor_timer_overhead" /> and
+    /// <see cref="system_factors::factor_timer_resolution" />.</para>
+    /// </remarks>
     class TRROJANCORE_API timer {
 
     public:
 
+        /// <summary>
+        /// The possible sources of the time.
+        /// </summary>
+        enum class source_type {
+
+            /// <summary>
+            /// The performance counter on Windows or the high-resolution clock
+            /// of the STL otherwise.
+            /// </summary>
+            native,
+
+            /// <summary>
+            /// The invariant time stamp counter of the processor.
+            /// </summary>
+            tsc
+        };
+
         /// <summary>
         /// Represents the difference between two points in time.
         /// </summary>
@@ -51,30 +97,83 @@ namespace trrojan {
 #endif /* (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK)) */
 
         /// <summary>
-        /// Answer the times's current native value.
+        /// Answer whether the processor has a time stamp counter that runs at
+        /// a constant rate regardless of power states and frequency changes.
+        /// </summary>
+        static bool has_invariant_tsc(void);
+
+        /// <summary>
+        /// Converts a point in time to milliseconds since the epoch.
+        /// </summary>
+        /// <param name="value">The value to be converted.</param>
+        /// <returns>The value as milliseconds</returns>
+        static millis_type millis_since_epoch(const value_type value);
+
+        /// <summary>
+        /// Answer the time's current value.
         /// </summary>
         /// <returns>The current timer value.</returns>
         static inline value_type now(void) {
+#if defined(TRROJAN_TIMER_WITH_TSC)
+            if (timer::_tsc.nanos_per_tick > 0.0) {
 #if (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK))
-            LARGE_INTEGER retval;
-            if (::QueryPerformanceCounter(&retval)) {
-                return retval.QuadPart;
-            } else {
-                std::error_code ec(::GetLastError(), std::system_category());
-                throw std::system_error(ec, "Failed to query performance "
-                    "counter.");
-            }
+                // The counter is used in its own units, which avoids losing
+                // precision by converting it to the coarser performance
+                // counter.
+                return timer::read_tsc();
 #else /* (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK)) */
-            return std::chrono::high_resolution_clock::now();
+                auto d = static_cast<double>(timer::read_tsc()
+                    - timer::_tsc.origin);
+                return timer::_tsc.native_origin + difference_type(
+                    static_cast<std::int64_t>(d * timer::_tsc.scale));
 #endif /* (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK)) */
+            }
+#endif /* defined(TRROJAN_TIMER_WITH_TSC) */
+
+            return timer::native_now();
         }
 
         /// <summary>
-        /// Converts a point in time to milliseconds since the epoch.
+        /// Answer the average time it takes to read the timer in nanoseconds,
+        /// which has been measured when the current source was selected.
         /// </summary>
-        /// <param name="value">The value to be converted.</param>
-        /// <returns>The value as milliseconds</returns>
-        static millis_type millis_since_epoch(const value_type value);
+        static double overhead(void);
+
+        /// <summary>
+        /// Parses the name of a source of the time.
+        /// </summary>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="source" /> is not a valid name.</exception>
+        static source_type parse_source(const std::string& source);
+
+        /// <summary>
+        /// Answer the smallest non-zero difference in nanoseconds that has been
+        /// observed between two consecutive readings of the timer when the
+        /// current source was selected.
+        /// </summary>
+        static double resolution(void);
+
+        /// <summary>
+        /// Selects the source of the time for all timers in the process.
+        /// </summary>
+        /// <remarks>
+        /// <para>This method must be called before any measurement is started,
+        /// because values obtained from different sources cannot be mixed
+        /// reliably. It is not thread-safe with respect to reading the timer.
+        /// </para>
+        /// <para>If the time stamp counter is requested, but the processor
+        /// does not have an invariant one or the counter could not be
+        /// calibrated, a warning stating the cause is logged and the native
+        /// source is used.</para>
+        /// </remarks>
+        /// <param name="source">The requested source.</param>
+        /// <returns>The source that is actually used.</returns>
+        static source_type select_source(const source_type source);
+
+        /// <summary>
+        /// Answer the currently active source of the time.
+        /// </summary>
+        static source_type source(void);
 
         /// <summary>
         /// Converts a time difference to milliseconds.
@@ -83,6 +182,11 @@ namespace trrojan {
         /// <returns>The value as milliseconds</returns>
         static millis_type to_millis(const difference_type value);
 
+        /// <summary>
+        /// Answer the name of the given source of the time.
+        /// </summary>
+        static const char *to_string(const source_type source);
+
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
@@ -120,6 +224,79 @@ namespace trrojan {
 
     private:
 
+        /// <summary>
+        /// The calibration of the time stamp counter.
+        /// </summary>
+        struct tsc_calibration {
+
+            /// <summary>
+            /// The native time at <see cref="origin" />, which is only used if
+            /// the counter is mapped to the native clock.
+            /// </summary>
+            value_type native_origin;
+
+            /// <summary>
+            /// The number of nanoseconds per tick of the time stamp counter,
+            /// which is zero if the counter is not used.
+            /// </summary>
+            double nanos_per_tick;
+
+            /// <summary>
+            /// The time stamp counter at <see cref="native_origin" />.
+            /// </summary>
+            std::uint64_t origin;
+
+            /// <summary>
+            /// The number of native ticks per tick of the time stamp counter,
+            /// which is only used if the counter is mapped to the native
+            /// clock.
+            /// </summary>
+            double scale;
+        };
+
+        /// <summary>
+        /// Answer the time's current native value.
+        /// </summary>
+        static inline value_type native_now(void) {
+#if (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK))
+            LARGE_INTEGER retval;
+            if (::QueryPerformanceCounter(&retval)) {
+                return retval.QuadPart;
+            } else {
+                std::error_code ec(::GetLastError(), std::system_category());
+                throw std::system_error(ec, "Failed to query performance "
+                    "counter.");
+            }
+#else /* (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK)) */
+            return std::chrono::high_resolution_clock::now();
+#endif /* (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK)) */
+        }
+
+#if defined(TRROJAN_TIMER_WITH_TSC)
+        /// <summary>
+        /// Reads the time stamp counter such that neither earlier nor later
+        /// instructions are reordered across the read.
+        /// </summary>
+        static inline std::uint64_t read_tsc(void) {
+            unsigned int aux;
+            _mm_lfence();
+            auto retval = __rdtscp(&aux);
+            _mm_lfence();
+            return retval;
+        }
+#endif /* defined(TRROJAN_TIMER_WITH_TSC) */
+
+        /// <summary>
+        /// Measures the overhead and the resolution of the current source.
+        /// </summary>
+        static void self_test(void);
+
+        /// <summary>
+        /// The calibration of the time stamp counter, which is shared by all
+        /// timers of the process.
+        /// </summary>
+        static tsc_calibration _tsc;
+
         /// <summary>
         /// The mark, i.e. the clock value when the last measurement was
         /// started.
@@ -0,0 +1,160 @@
+﻿// <copyright file="trace.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <atomic>
+#include <ostream>
+#include <string>
+
+#include "trrojan/export.h"
+
+
+namespace trrojan {
+
+    /// <summary>
+    /// A process-wide recorder of hierarchical trace zones, which shows
+    /// where the wall-clock time of a benchmark campaign is spent.
+    /// </summary>
+    /// <remarks>
+    /// <para>Zones are opened by <see cref="begin" /> and closed by
+    /// <see cref="end" /> on the same thread, which should be done via
+    /// <see cref="trrojan::trace_zone" /> or
+    /// <see cref="TRROJAN_TRACE_ZONE" />. Each thread records into its own
+    /// buffer, wherefore threads do not contend while recording. The buffers
+    /// remain valid after their thread has exited.</para>
+    /// <para>Tracing is disabled by default. In this case, opening a zone
+    /// costs a single relaxed load of an atomic flag.</para>
+    /// <para>The names and categories of the zones are not copied, wherefore
+    /// they must be string literals or otherwise live until the trace has
+    /// been written.</para>
+    /// </remarks>
+    class TRROJANCORE_API trace final {
+
+    public:
+
+        /// <summary>
+        /// Opens a new zone on the calling thread, which is nested into the
+        /// zone that is currently open on this thread.
+        /// </summary>
+        /// <remarks>
+        /// If tracing is disabled, nothing happens.
+        /// </remarks>
+        /// <param name="name">The name of the zone.</param>
+        /// <param name="category">The phase of the campaign the zone belongs
+        /// to, like &quot;data&quot; or &quot;output&quot;.</param>
+        static void begin(const char *name, const char *category);
+
+        /// <summary>
+        /// Discards all zones that have been recorded so far.
+        /// </summary>
+        static void clear(void);
+
+        /// <summary>
+        /// Enables or disables the recording of zones.
+        /// </summary>
+        /// <remarks>
+        /// Zones that are open when tracing is disabled are still closed
+        /// properly.
+        /// </remarks>
+        static void enable(const bool enabled);
+
+        /// <summary>
+        /// Answer whether zones are being recorded.
+        /// </summary>
+        static inline bool enabled(void) {
+            return trace::_enabled.load(std::memory_order_relaxed);
+        }
+
+        /// <summary>
+        /// Closes the innermost zone that is open on the calling thread.
+        /// </summary>
+        /// <remarks>
+        /// If no zone is open, nothing happens.
+        /// </remarks>
+        static void end(void);
+
+        /// <summary>
+        /// Writes all recorded zones in the trace event format of Chrome to
+        /// the given file, which can be opened in chrome://tracing or in
+        /// Perfetto.
+        /// </summary>
+        /// <remarks>
+        /// Zones that are still open are written as if they ended now.
+        /// </remarks>
+        /// <param name="path">The path to the output file, which will be
+        /// overwritten if it exists.</param>
+        /// <exception cref="std::runtime_error">If the file could not be
+        /// written.</exception>
+        static void write_json(const std::string& path);
+
+        /// <summary>
+        /// Writes a table of the total and the exclusive time spent in each
+        /// kind of zone to the given stream.
+        /// </summary>
+        /// <remarks>
+        /// The exclusive (self) time of a zone is its duration minus the
+        /// duration of the zones directly nested into it. The self times of
+        /// all zones of a thread therefore add up to the time covered by its
+        /// outermost zones. The table is sorted by descending self time.
+        /// </remarks>
+        static void write_summary(std::ostream& stream);
+
+        trace(void) = delete;
+
+    private:
+
+        static std::atomic<bool> _enabled;
+    };
+
+
+    /// <summary>
+    /// A trace zone that is open for the lifetime of the object.
+    /// </summary>
+    class trace_zone final {
+
+    public:
+
+        /// <summary>
+        /// Opens the zone if tracing is enabled.
+        /// </summary>
+        inline trace_zone(const char *name, const char *category)
+                : _active(trace::enabled()) {
+            if (this->_active) {
+                trace::begin(name, category);
+            }
+        }
+
+        trace_zone(const trace_zone&) = delete;
+
+        /// <summary>
+        /// Closes the zone if it has been opened.
+        /// </summary>
+        inline ~trace_zone(void) {
+            if (this->_active) {
+                trace::end();
+            }
+        }
+
+        trace_zone& operator =(const trace_zone&) = delete;
+
+    private:
+
+        bool _active;
+    };
+
+}
+
+#define TRROJAN_TRACE_CONCAT0(l, r) l##r
+#define TRROJAN_TRACE_CONCAT(l, r) TRROJAN_TRACE_CONCAT0(l, r)
+
+/// <summary>
+/// Opens a trace zone with the given name and category, which lasts until
+/// the end of the enclosing block.
+/// </summary>
+#define TRROJAN_TRACE_ZONE(name, category) \
+    trrojan::trace_zone TRROJAN_TRACE_CONCAT(trrojan_trace_zone_, \
+        __LINE__)(name, category)
@@ -9,16 +9,26 @@
 
 #include <algorithm>
 #include <cassert>
+#include <deque>
+#include <limits>
 #include <sstream>
 #include <stdexcept>
 #include <system_error>
 
 #include "trrojan/com_error_category.h"
 #include "trrojan/log.h"
+#include "trrojan/prefetch_gate.h"
 #include "trrojan/system_factors.h"
+#include "trrojan/trace.h"
 
 
 
+/*
+ * trrojan::benchmark_base::default_prefetch_depth
+ */
+const std::size_t trrojan::benchmark_base::default_prefetch_depth = 1;
+
+
 /*
  * trrojan::benchmark_base::check_consistency
  */
@@ -120,6 +130,8 @@ size_t trrojan::benchmark_base::run(const configuration_set& configs,
         const on_result_callback& resultCallback,
         const cool_down& coolDown,
         const std::size_t continue_at) {
+    TRROJAN_TRACE_ZONE("benchmark_base::run", "benchmark");
+
     // Check that caller has provided all required factors.
     this->check_required_factors(configs);
 
@@ -127,21 +139,80 @@ size_t trrojan::benchmark_base::run(const configuration_set& configs,
     auto c = configs;
     c.merge(this->_default_configs, false);
 
-    // Invoke each configuration.
+    // Skip combinations of environment and device the benchmark cannot run
+    // on before the other factors are enumerated for them.
+    c.add_constraint({ environment_base::factor_name,
+            device_base::factor_name },
+            [this](const configuration& c) {
+        auto e = c.find(environment_base::factor_name);
+        auto d = c.find(device_base::factor_name);
+
+        if ((e == c.end()) || (d == c.end())) {
+            // Leave reporting the missing factors to the actual run.
+            return true;
+        }
+
+        return this->can_run(e->value().as<trrojan::environment>(),
+            d->value().as<trrojan::device>());
+    });
+
+    // Invoke each configuration. The enumeration runs ahead of the
+    // measurements by _prefetch_depth configurations, which are announced to
+    // the benchmark such that it can prepare them while measuring.
     cool_down_evaluator cde(coolDown);
+    std::deque<configuration> queue;
     size_t retval = 0;
-    c.foreach_configuration([&](configuration& c) -> bool {
+    size_t cntEnumerated = 0;
+
+    auto invoke = [&](configuration& c) -> bool {
+        TRROJAN_TRACE_ZONE("configuration", "benchmark");
+
         try {
             auto e = c.get<trrojan::environment>(environment_base::factor_name);
             auto d = c.get<trrojan::device>(device_base::factor_name);
 
-            cde.check();
+            {
+                TRROJAN_TRACE_ZONE("cool_down_evaluator::check", "cool-down");
+                cde.check();
+            }
 
             if (this->can_run(e, d)) {
                 if (retval >= continue_at) {
-                    c.add_system_factors();
+                    {
+                        TRROJAN_TRACE_ZONE("configuration::add_system_factors",
+                            "benchmark");
+                        c.add_system_factors();
+                    }
                     this->log_run(c);
-                    auto r = resultCallback(std::move(this->run(c)));
+
+                    for (unsigned int i = 0; ; ++i) {
+                        const auto start = cde.sample();
+                        auto r = [this, &c](void) {
+                            TRROJAN_TRACE_ZONE("run", "measurement");
+                            return this->run(c);
+                        }();
+                        const auto end = cde.sample();
+
+                        if (cde.is_throttled(start, end)
+                                && (i < coolDown.retries)) {
+                            log::instance().write_line(log_level::warning,
+                                "The processors have been throttled while "
+                                "measuring the configuration. Repeating it "
+                                "after a cool-down period ({0}/{1}) ...",
+                                i + 1, coolDown.retries);
+                            TRROJAN_TRACE_ZONE("cool_down_evaluator::check",
+                                "cool-down");
+                            cde.check();
+                            continue;
+                        }
+
+                        if (r != nullptr) {
+                            cde.record(*r, start, end);
+                        }
+
+                        resultCallback(std::move(r));
+                        break;
+                    }
                 }
                 ++retval;
                 log::instance().write_line(log_level::information, "Completed "
@@ -169,8 +240,36 @@ size_t trrojan::benchmark_base::run(const configuration_set& configs,
                 "exception was encountered while running a benchmark.");
             return false;
         }
+    };
+
+    auto isRunning = c.foreach_configuration([&](configuration& c) -> bool {
+        // Configurations before the one to continue at are not run, so there
+        // is no need to prepare them.
+        if (cntEnumerated++ >= continue_at) {
+            try {
+                TRROJAN_TRACE_ZONE("benchmark_base::prefetch", "data");
+                this->prefetch(c);
+            } catch (const std::exception& ex) {
+                log::instance().write_line(log_level::warning, "Prefetching "
+                    "a configuration failed: {0}", ex.what());
+            }
+        }
+
+        queue.push_back(c);
+        if (queue.size() <= this->_prefetch_depth) {
+            return true;
+        }
+
+        auto retval = invoke(queue.front());
+        queue.pop_front();
+        return retval;
     });
 
+    while (isRunning && !queue.empty()) {
+        isRunning = invoke(queue.front());
+        queue.pop_front();
+    }
+
     log::instance().write_line(log_level::information, "Completed benchmarking "
         "of {0} individual configuration(s). ", retval);
     return retval;
@@ -182,12 +281,31 @@ size_t trrojan::benchmark_base::run(const configuration_set& configs,
  */
 std::string trrojan::benchmark_base::enter_power_scope(
         const power_collector::pointer& collector) {
-#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
-    if (powerCollector != nullptr) {
-        // If we have a power sensor, we want to record data now.
-        powerUid = powerCollector->set_next_unique_description();
+    // Neither background preparation nor writing the log must interfere with
+    // the measurement.
+    prefetch_gate::suspend();
+
+    try {
+        log::instance().enter_measurement_scope();
+    } catch (...) {
+        // Background jobs would be blocked forever if the gate remained
+        // suspended.
+        prefetch_gate::resume();
+        throw;
     }
-#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+
+#if defined(TRROJAN_WITH_POWER_COLLECTOR)
+    if (collector != nullptr) {
+        try {
+            // If we have a power sensor, we want to record data now.
+            return collector->set_next_unique_description();
+        } catch (...) {
+            // Likewise, the log would hold back all messages forever.
+            benchmark_base::leave_power_scope(nullptr);
+            throw;
+        }
+    }
+#endif /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
 
     return "";
 }
@@ -201,7 +319,7 @@ trrojan::benchmark_base::initialise_power_collector(
         const trrojan::configuration& c) {
     power_collector::pointer retval;
 
-#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+#if defined(TRROJAN_WITH_POWER_COLLECTOR)
     auto it = c.find(power_collector::factor_name);
     if (it != c.end()) {
         retval = it->value().as<power_collector::pointer>();
@@ -210,7 +328,7 @@ trrojan::benchmark_base::initialise_power_collector(
     if (retval != nullptr) {
         retval->set_header();
     }
-#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#endif /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
 
     return retval;
 }
@@ -219,13 +337,68 @@ trrojan::benchmark_base::initialise_power_collector(
 /*
  * trrojan::benchmark_base::leave_power_scope
  */
-void trrojan::benchmark_base::leave_power_scope(
+double trrojan::benchmark_base::leave_power_scope(
         const power_collector::pointer& collector) {
-#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
-    if (powerCollector != nullptr) {
-        powerCollector->set_description("");
+    try {
+        log::instance().leave_measurement_scope();
+    } catch (...) {
+        prefetch_gate::resume();
+        throw;
     }
-#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+
+    prefetch_gate::resume();
+
+#if defined(TRROJAN_WITH_POWER_COLLECTOR)
+    if (collector != nullptr) {
+        collector->set_description("");
+        return collector->last_energy();
+    }
+#endif /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
+
+    return std::numeric_limits<double>::quiet_NaN();
+}
+
+
+/*
+ * trrojan::benchmark_base::power_scope::power_scope
+ */
+trrojan::benchmark_base::power_scope::power_scope(
+        const power_collector::pointer& collector)
+    : _collector(collector), _left(false),
+    _uid(benchmark_base::enter_power_scope(collector)) { }
+
+
+/*
+ * trrojan::benchmark_base::power_scope::~power_scope
+ */
+trrojan::benchmark_base::power_scope::~power_scope(void) {
+    try {
+        this->leave();
+    } catch (...) {
+        // Destructors must not throw. leave_power_scope resumes the gate even
+        // if it fails, which is what matters most here.
+    }
+}
+
+
+/*
+ * trrojan::benchmark_base::power_scope::leave
+ */
+double trrojan::benchmark_base::power_scope::leave(void) {
+    if (this->_left) {
+        return std::numeric_limits<double>::quiet_NaN();
+    }
+
+    this->_left = true;
+    return benchmark_base::leave_power_scope(this->_collector);
+}
+
+
+/*
+ * trrojan::benchmark_base::prefetch
+ */
+void trrojan::benchmark_base::prefetch(const trrojan::configuration& config) {
+    // Nothing to prepare by default.
 }
 
 
@@ -7,6 +7,8 @@
 #include "trrojan/configuration.h"
 
 #include <algorithm>
+#include <cassert>
+#include <iterator>
 #include <sstream>
 #include <stdexcept>
 
@@ -18,7 +20,11 @@
  * trrojan::configuration::add_system_factors
  */
 void trrojan::configuration::add_system_factors(void) {
-    system_factors::instance().get(std::back_inserter(this->_factors));
+    auto& factors = system_factors::instance();
+    this->_system_offset = this->_factors.size();
+    this->_system = factors.snapshot();
+    this->_dynamic.clear();
+    factors.get_dynamic(std::back_inserter(this->_dynamic));
 }
 
 
@@ -27,11 +33,11 @@ void trrojan::configuration::add_system_factors(void) {
  */
 void trrojan::configuration::check_consistency(
         const configuration& other) const {
-    if (this->_factors.size() != other._factors.size()) {
+    if (this->size() != other.size()) {
         throw std::runtime_error("The configurations contain a different "
             "number of factors.");
     }
-    for (auto& l : this->_factors) {
+    for (auto& l : *this) {
         if (other.contains(l.name())) {
             throw std::runtime_error("The configurations contain different "
                 "factors.");
@@ -46,7 +52,7 @@ void trrojan::configuration::check_consistency(
 bool trrojan::configuration::contains(const std::string& factor,
         const variant_type type) const {
     auto it = this->find(factor);
-    if (it != this->_factors.end()) {
+    if (it != this->end()) {
         return (it->value().type() == type);
     } else {
         return false;
@@ -59,8 +65,47 @@ bool trrojan::configuration::contains(const std::string& factor,
  */
 trrojan::configuration::iterator_type trrojan::configuration::find(
         const std::string& factor) const {
-    return std::find_if(this->_factors.cbegin(), this->_factors.cend(),
-        [&factor](const named_variant& v) { return (v.name() == factor); });
+    auto isFactor = [&factor](const named_variant& v) {
+        return (v.name() == factor);
+    };
+
+    // Search the explicit factors first, which are most likely requested.
+    {
+        auto it = std::find_if(this->_factors.cbegin(), this->_factors.cend(),
+            isFactor);
+        if (it != this->_factors.cend()) {
+            auto i = static_cast<std::size_t>(std::distance(
+                this->_factors.cbegin(), it));
+            if (i >= this->_system_offset) {
+                i += this->system_size();
+            }
+            return iterator_type(this, i);
+        }
+    }
+
+    for (auto& d : this->_dynamic) {
+        if (isFactor(d.second)) {
+            return iterator_type(this, this->_system_offset + d.first);
+        }
+    }
+
+    if (this->_system != nullptr) {
+        auto it = std::find_if(this->_system->cbegin(), this->_system->cend(),
+            isFactor);
+        if (it != this->_system->cend()) {
+            // Skip the dynamic factors that precede the static one.
+            auto i = static_cast<std::size_t>(std::distance(
+                this->_system->cbegin(), it));
+            for (auto& d : this->_dynamic) {
+                if (d.first <= i) {
+                    ++i;
+                }
+            }
+            return iterator_type(this, this->_system_offset + i);
+        }
+    }
+
+    return this->end();
 }
 
 
@@ -124,3 +169,24 @@ trrojan::configuration::container_type::iterator trrojan::configuration::find0(
     return std::find_if(this->_factors.begin(), this->_factors.end(),
         [&factor](const named_variant& v) { return (v.name() == factor); });
 }
+
+
+/*
+ * trrojan::configuration::system_factor
+ */
+const trrojan::configuration::value_type&
+trrojan::configuration::system_factor(const std::size_t i) const {
+    assert(i < this->system_size());
+    auto cntDynamic = static_cast<std::size_t>(0);
+
+    for (auto& d : this->_dynamic) {
+        if (d.first == i) {
+            return d.second;
+        } else if (d.first < i) {
+            ++cntDynamic;
+        }
+    }
+
+    assert(this->_system != nullptr);
+    return (*this->_system)[i - cntDynamic];
+}
@@ -7,10 +7,27 @@
 
 #include "trrojan/configuration_set.h"
 
+#include <algorithm>
 #include <cassert>
 #include <stdexcept>
 
 #include "trrojan/log.h"
+#include "trrojan/trace.h"
+
+
+/*
+ * trrojan::configuration_set::add_constraint
+ */
+void trrojan::configuration_set::add_constraint(
+        const std::vector<std::string>& factors,
+        const constraint_type& predicate) {
+    if (!predicate) {
+        throw std::invalid_argument("The predicate of a constraint must be "
+            "valid.");
+    }
+
+    this->_constraints.push_back(constraint { factors, predicate });
+}
 
 
 /*
@@ -53,6 +70,28 @@ void trrojan::configuration_set::replace_factor(const factor& factor) {
     }
 }
 
+/*
+ * trrojan::configuration_set::add_only_if
+ */
+void trrojan::configuration_set::add_only_if(const std::string& factor,
+        const trrojan::variant& value,
+        const std::string& condition,
+        const std::vector<trrojan::variant>& values) {
+    this->add_constraint({ factor, condition },
+            [factor, value, condition, values](const configuration& c) {
+        auto f = c.find(factor);
+        auto d = c.find(condition);
+
+        if ((f == c.end()) || (d == c.end()) || !(f->value() == value)) {
+            return true;
+        }
+
+        return std::any_of(values.begin(), values.end(),
+            [d](const trrojan::variant& v) { return (d->value() == v); });
+    });
+}
+
+
 /*
  * trrojan::configuration_set::find_factor
  */
@@ -68,32 +107,80 @@ const trrojan::factor *trrojan::configuration_set::find_factor(
  */
 bool trrojan::configuration_set::foreach_configuration(
         std::function<bool(configuration&)> cb) const {
+    TRROJAN_TRACE_ZONE("configuration_set::foreach_configuration",
+        "enumeration");
     bool retval = true;
 
     if (!this->_factors.empty() && cb) {
+        const auto cntFactors = this->_factors.size();
+        check_list checks(cntFactors);
         size_t cntTests = 1;
         configuration config;
-        std::vector<size_t> frequencies;
+        std::vector<size_t> indices(cntFactors);
+        auto last = cntFactors - 1;
 
-        config.reserve(this->_factors.size());
-        for (auto& f : this->_factors) {
-            frequencies.push_back(cntTests);
-            cntTests *= f.size();
+        // The first factor changes fastest, so the last one is fixed first.
+        // Each constraint can therefore be decided at the level of the first
+        // factor it depends on.
+        for (auto& c : this->_constraints) {
+            auto level = last;
+            for (auto& n : c.factors) {
+                auto it = this->findFactor(n);
+                if (it != this->_factors.cend()) {
+                    level = (std::min)(level, static_cast<size_t>(
+                        std::distance(this->_factors.cbegin(), it)));
+                }
+            }
+            checks[level].push_back(&c);
+        }
+
+        // Count the configurations passing the constraints. Below the level
+        // of the first factor having a constraint, all combinations are
+        // valid and need not be enumerated.
+        auto lowest = std::find_if(checks.cbegin(), checks.cend(),
+            [](const std::vector<const constraint *>& c) {
+                return !c.empty();
+            });
+        if (lowest == checks.cend()) {
+            TRROJAN_TRACE_ZONE("configuration_set::count", "enumeration");
+            for (auto& f : this->_factors) {
+                cntTests *= f.size();
+            }
+
+        } else {
+            const auto level = static_cast<size_t>(
+                std::distance(checks.cbegin(), lowest));
+            size_t cntBelow = 1;
+            for (size_t i = 0; i < level; ++i) {
+                cntBelow *= this->_factors[i].size();
+            }
+
+            TRROJAN_TRACE_ZONE("configuration_set::count", "enumeration");
+            cntTests = 0;
+            this->enumerate(indices, last, level, checks,
+                    [&cntTests, cntBelow](const std::vector<size_t>&) {
+                cntTests += cntBelow;
+                return true;
+            });
         }
 
         log::instance().write_line(log_level::information, "The configuration "
             "set comprises {0} individual configuration(s).", cntTests);
 
-        for (size_t i = 0; (i < cntTests) && retval; ++i) {
-            config.clear();
-            for (size_t j = 0; j < this->_factors.size(); ++j) {
-                auto& f = this->_factors[j];
-                auto ij = (i / frequencies[j]) % f.size();
-                config.add(this->_factors[j].name(),
-                    std::move(this->_factors[j][ij]));
+        config.reserve(cntFactors);
+        retval = this->enumerate(indices, last, 0, checks,
+                [this, &cb, &config](const std::vector<size_t>& indices) {
+            {
+                TRROJAN_TRACE_ZONE("configuration_set::make_configuration",
+                    "enumeration");
+                config.clear();
+                for (size_t j = 0; j < this->_factors.size(); ++j) {
+                    auto& f = this->_factors[j];
+                    config.add(f.name(), f[indices[j]]);
+                }
             }
-            retval = cb(config);
-        }
+            return cb(config);
+        });
     } /* end if (!this->factors.empty()) */
 
     return retval;
@@ -114,6 +201,9 @@ void trrojan::configuration_set::merge(const configuration_set& other,
             this->_factors.push_back(f);
         }
     }
+
+    this->_constraints.insert(this->_constraints.end(),
+        other._constraints.begin(), other._constraints.end());
 }
 
 
@@ -139,3 +229,48 @@ void trrojan::configuration_set::optimise_order(
         }
     }
 }
+
+
+/*
+ * trrojan::configuration_set::enumerate
+ */
+bool trrojan::configuration_set::enumerate(std::vector<std::size_t>& indices,
+        const std::size_t level, const std::size_t last,
+        const check_list& checks,
+        const std::function<bool(const std::vector<std::size_t>&)>& cb)
+        const {
+    auto& checksHere = checks[level];
+    auto& factor = this->_factors[level];
+    configuration partial;
+
+    for (indices[level] = 0; indices[level] < factor.size();
+            ++indices[level]) {
+        if (!checksHere.empty()) {
+            // Build the part of the configuration fixed so far in the same
+            // order as the complete one.
+            partial.clear();
+            for (auto i = level; i < this->_factors.size(); ++i) {
+                auto& f = this->_factors[i];
+                partial.add(f.name(), f[indices[i]]);
+            }
+
+            auto isValid = std::all_of(checksHere.begin(), checksHere.end(),
+                [&partial](const constraint *c) {
+                    return c->predicate(partial);
+                });
+            if (!isValid) {
+                continue;
+            }
+        }
+
+        if (level == last) {
+            if (!cb(indices)) {
+                return false;
+            }
+        } else if (!this->enumerate(indices, level - 1, last, checks, cb)) {
+            return false;
+        }
+    }
+
+    return true;
+}
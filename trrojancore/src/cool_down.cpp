@@ -6,9 +6,47 @@
 
 #include "trrojan/cool_down.h"
 
+#include <limits>
 #include <thread>
 
 #include "trrojan/log.h"
+#include "trrojan/result.h"
+
+
+#define _COOL_DOWN_DEFINE_RES_NAME(r)                                          \
+const std::string trrojan::cool_down_evaluator::result_name_##r(#r)
+
+_COOL_DOWN_DEFINE_RES_NAME(frequency_end);
+_COOL_DOWN_DEFINE_RES_NAME(frequency_start);
+_COOL_DOWN_DEFINE_RES_NAME(temperature_end);
+_COOL_DOWN_DEFINE_RES_NAME(temperature_start);
+_COOL_DOWN_DEFINE_RES_NAME(throttled);
+
+#undef _COOL_DOWN_DEFINE_RES_NAME
+
+
+/*
+ * trrojan::cool_down_evaluator::cool_down_evaluator
+ */
+trrojan::cool_down_evaluator::cool_down_evaluator(const cool_down& config)
+        : config(config), last(std::chrono::system_clock::now()) {
+    if (this->config.adaptive()) {
+        if ((this->config.temperature > 0.0f)
+                && !this->monitor.has_temperatures()) {
+            log::instance().write_line(log_level::warning, "An adaptive "
+                "cool-down based on the temperature was requested, but no "
+                "thermal zone could be read. The temperature will not be "
+                "checked.");
+        }
+        if ((this->config.clock_ratio > 0.0f)
+                && !this->monitor.has_clocks()) {
+            log::instance().write_line(log_level::warning, "An adaptive "
+                "cool-down based on the processor clocks was requested, but "
+                "the clocks could not be read. The clocks will not be "
+                "checked.");
+        }
+    }
+}
 
 
 /*
@@ -25,4 +63,119 @@ void trrojan::cool_down_evaluator::check(void) {
             this->last = std::chrono::system_clock::now();
         }
     }
+
+    if (this->config.adaptive()) {
+        this->wait_for_nominal();
+    }
+}
+
+
+/*
+ * trrojan::cool_down_evaluator::is_throttled
+ */
+bool trrojan::cool_down_evaluator::is_throttled(const state_type& start,
+        const state_type& end) const {
+    if (!this->config.adaptive()) {
+        return false;
+    }
+
+    if (end.throttle_count > start.throttle_count) {
+        // The processor reported a thermal event during the measurement.
+        return true;
+    }
+
+    if ((this->config.clock_ratio > 0.0f)
+            && (end.clock_ratio < this->config.clock_ratio)) {
+        // The clocks have been capped during the measurement. Note that the
+        // comparison is false if the clocks are not available.
+        return true;
+    }
+
+    return false;
+}
+
+
+/*
+ * trrojan::cool_down_evaluator::record
+ */
+void trrojan::cool_down_evaluator::record(basic_result& result,
+        const state_type& start, const state_type& end) const {
+    if (this->config.adaptive()) {
+        result.add_column(result_name_temperature_start, start.temperature);
+        result.add_column(result_name_temperature_end, end.temperature);
+        result.add_column(result_name_frequency_start, start.frequency);
+        result.add_column(result_name_frequency_end, end.frequency);
+        result.add_column(result_name_throttled,
+            this->is_throttled(start, end));
+    }
+}
+
+
+/*
+ * trrojan::cool_down_evaluator::sample
+ */
+trrojan::cool_down_evaluator::state_type
+trrojan::cool_down_evaluator::sample(void) const {
+    if (this->config.adaptive()) {
+        return this->monitor.sample();
+    } else {
+        static constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+        return state_type { nan, nan, nan, 0 };
+    }
+}
+
+
+/*
+ * trrojan::cool_down_evaluator::is_nominal
+ */
+bool trrojan::cool_down_evaluator::is_nominal(const state_type& state) const {
+    if ((this->config.temperature > 0.0f)
+            && (state.temperature >= this->config.temperature)) {
+        return false;
+    }
+
+    if ((this->config.clock_ratio > 0.0f)
+            && (state.clock_ratio < this->config.clock_ratio)) {
+        return false;
+    }
+
+    return true;
+}
+
+
+/*
+ * trrojan::cool_down_evaluator::wait_for_nominal
+ */
+void trrojan::cool_down_evaluator::wait_for_nominal(void) {
+    static const auto poll_interval = std::chrono::seconds(1);
+    const auto begin = std::chrono::system_clock::now();
+    const auto deadline = begin + this->config.timeout;
+
+    auto state = this->monitor.sample();
+    if (this->is_nominal(state)) {
+        return;
+    }
+
+    log::instance().write_line(log_level::information, "Waiting for the "
+        "system to cool down (temperature: {0} degrees Celsius, clock "
+        "ratio: {1}) ...", state.temperature, state.clock_ratio);
+
+    while (!this->is_nominal(state)) {
+        if (std::chrono::system_clock::now() >= deadline) {
+            log::instance().write_line(log_level::warning, "The system did not "
+                "cool down within {0} seconds (temperature: {1} degrees "
+                "Celsius, clock ratio: {2}). Resuming anyway ...",
+                this->config.timeout.count(), state.temperature,
+                state.clock_ratio);
+            return;
+        }
+
+        std::this_thread::sleep_for(poll_interval);
+        state = this->monitor.sample();
+    }
+
+    const auto dt = std::chrono::duration_cast<std::chrono::seconds>(
+        std::chrono::system_clock::now() - begin);
+    log::instance().write_line(log_level::information, "The system cooled down "
+        "within {0} seconds.", dt.count());
 }
@@ -6,17 +6,23 @@
 
 #include "trrojan/csv_output.h"
 
+#include <algorithm>
+#include <filesystem>
 #include <sstream>
 #include <stdexcept>
+#include <vector>
 
 #include "trrojan/csv_util.h"
+#include "trrojan/log.h"
 
 
 
 /*
  * trrojan::csv_output::csv_output
  */
-trrojan::csv_output::csv_output(void) : first_line(false) { }
+trrojan::csv_output::csv_output(void) : appending(false),
+    check_columns(false), first_line(false), interrupted(),
+    next_index(0), resuming(false) { }
 
 
 /*
@@ -34,6 +40,28 @@ void trrojan::csv_output::close(void) {
     if (this->file.is_open()) {
         this->file.close();
     }
+
+    // Note: The journal must not be marked as finished here, because we also
+    // get here if the run has been aborted.
+    this->checkpoints.reset();
+}
+
+
+/*
+ * trrojan::csv_output::completed
+ */
+const trrojan::result_index *trrojan::csv_output::completed(void) const {
+    return this->appending ? &this->existing : nullptr;
+}
+
+
+/*
+ * trrojan::csv_output::finish
+ */
+void trrojan::csv_output::finish(void) {
+    if (this->checkpoints != nullptr) {
+        this->checkpoints->finish();
+    }
 }
 
 
@@ -50,9 +78,30 @@ void trrojan::csv_output::open(const output_params& params) {
         this->params = std::make_shared<csv_output_params>(*params);
     }
 
+    this->appending = this->params->append();
+    this->next_index = 0;
+    this->resuming = false;
+
+    // If the journal shows that the last run has been interrupted, continue
+    // where it stopped.
+    if (this->params->journal_interval() > 0) {
+        auto state = journal::read(this->params->path());
+        if (state.interrupted()) {
+            this->resume(state);
+        }
+    }
+
+    // Remember what is already in the file if we append to it such that the
+    // configurations therein can be skipped.
+    this->existing = this->appending
+        ? result_index::from_csv(this->params->path(),
+            this->params->separator())
+        : result_index();
+
     // Note: We use the binary mode such that we can control the type of line
     // break being generated.
-    this->file.open(this->params->path(), std::ios::trunc | std::ios::binary);
+    auto mode = this->appending ? std::ios::app : std::ios::trunc;
+    this->file.open(this->params->path(), mode | std::ios::binary);
     if (!this->file) {
         std::stringstream msg;
         msg << "Failed to open output file \"" << this->params->path() << "\""
@@ -60,24 +109,65 @@ void trrojan::csv_output::open(const output_params& params) {
         throw std::runtime_error(msg.str());
     }
 
-    this->first_line = true;
+    this->check_columns = !this->existing.columns().empty();
+    this->first_line = !this->check_columns;
+
+    if (this->params->journal_interval() > 0) {
+        this->checkpoints.reset(new journal(this->params->path(),
+            this->params->journal_interval(), this->appending));
+    }
 }
 
 
 /*
- * trrojan::csv_output::operator <<
+ * trrojan::csv_output::resumed
  */
-trrojan::output_base& trrojan::csv_output::operator <<(
-        const basic_result& result) {
+const trrojan::journal::state *trrojan::csv_output::resumed(void) const {
+    return (this->resuming && !this->params->append())
+        ? &this->interrupted
+        : nullptr;
+}
+
+
+/*
+ * trrojan::csv_output::write
+ */
+trrojan::output_base& trrojan::csv_output::write(const basic_result& result,
+        const std::size_t index) {
     if ((this->params == nullptr) || !this->file) {
         throw std::logic_error("The output must be opened before data can be "
             "written.");
     }
 
+    auto hash = journal::hash(result.configuration());
     auto isFirst = true;
     auto nl = this->params->line_break();
     auto sep = this->params->separator();
 
+    if (this->check_columns) {
+        // Appending rows with different columns would make the file bogus.
+        std::vector<std::string> columns;
+        for (auto& c : result.configuration()) {
+            columns.push_back(c.name());
+        }
+        columns.insert(columns.end(), result.result_names().begin(),
+            result.result_names().end());
+
+        if (columns != this->existing.columns()) {
+            std::stringstream msg;
+            msg << "The columns of the results do not match the ones in the "
+                "existing output file \"" << this->params->path() << "\"."
+                << std::ends;
+            throw std::runtime_error(msg.str());
+        }
+
+        this->check_columns = false;
+    }
+
+    if (this->checkpoints != nullptr) {
+        this->checkpoints->begin(index, hash);
+    }
+
     if (this->first_line) {
         for (auto& c : result.configuration()) {
             if (isFirst) {
@@ -126,19 +216,71 @@ trrojan::output_base& trrojan::csv_output::operator <<(
 
     this->file.flush();
 
+    if (this->checkpoints != nullptr) {
+        this->checkpoints->complete(index, hash,
+            static_cast<std::uint64_t>(this->file.tellp()));
+    }
+
+    this->next_index = index + 1;
     return *this;
 }
 
 
+/*
+ * trrojan::csv_output::operator <<
+ */
+trrojan::output_base& trrojan::csv_output::operator <<(
+        const basic_result& result) {
+    return this->write(result, this->next_index);
+}
+
+
+/*
+ * trrojan::csv_output::resume
+ */
+void trrojan::csv_output::resume(const journal::state& state) {
+    auto& path = this->params->path();
+    std::uint64_t size = std::filesystem::exists(path)
+        ? std::filesystem::file_size(path)
+        : 0;
+
+    log::instance().write_line(log_level::warning, "The previous run writing "
+        "to \"{0}\" has been interrupted after {1} configuration(s). "
+        "Resuming it ...", path, state.completed);
+
+    if (size > state.output_size) {
+        // Remove everything after the last row that has been completed.
+        std::filesystem::resize_file(path, state.output_size);
+
+    } else if (size < state.output_size) {
+        // The system crashed before the output has been synchronised, so
+        // the journal is ahead of the file. Remove any incomplete row at its
+        // end and rely on the rows that are in the file.
+        std::string content;
+        {
+            std::ifstream file(path, std::ios::binary);
+            content.assign(std::istreambuf_iterator<char>(file),
+                std::istreambuf_iterator<char>());
+        }
+
+        auto end = content.find_last_of('\n');
+        end = (end == std::string::npos) ? 0 : end + 1;
+        if (end < content.size()) {
+            std::filesystem::resize_file(path, end);
+        }
+    }
+
+    this->appending = true;
+    this->interrupted = state;
+    this->resuming = true;
+}
+
+
 /*
  * trrojan::csv_output::print
  */
 void trrojan::csv_output::print(const std::string& str) {
-    if (this->params->quote_string()) {
-        this->file << "\"" << str << "\"";
-    } else {
-        this->file << str;
-    }
+    print_csv_string(this->file, str, this->params->quote_string());
 }
 
 
@@ -7,6 +7,12 @@
 #include "trrojan/csv_output_params.h"
 
 
+/*
+ * trrojan::csv_output_params::default_journal_interval
+ */
+const std::size_t trrojan::csv_output_params::default_journal_interval = 1;
+
+
 /*
  * trrojan::csv_output_params::default_line_break
  */
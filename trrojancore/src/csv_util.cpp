@@ -6,16 +6,37 @@
 
 #include "trrojan/csv_util.h"
 
+#include <algorithm>
+#include <sstream>
+
 
 /*
  * trrojan::print_csv_header
  */
 std::ostream& trrojan::print_csv_header(std::ostream& stream,
         const named_variant& variant, const bool quote) {
+    return print_csv_string(stream, variant.name(), quote);
+}
+
+
+/*
+ * trrojan::print_csv_string
+ */
+std::ostream& trrojan::print_csv_string(std::ostream& stream,
+        const std::string& str, const bool quote) {
     if (quote) {
-        stream << "\"" << variant.name() << "\"";
+        // Double the quotes in the string such that split_csv_line can
+        // restore them.
+        stream << "\"";
+        for (auto c : str) {
+            if (c == '"') {
+                stream << c;
+            }
+            stream << c;
+        }
+        stream << "\"";
     } else {
-        stream << variant.name();
+        stream << str;
     }
 
     return stream;
@@ -43,7 +64,9 @@ std::ostream& trrojan::print_csv_value(std::ostream& stream,
     }
 
     if (quote && isString) {
-        stream << "\"" << variant << "\"";
+        std::stringstream str;
+        str << variant;
+        print_csv_string(stream, str.str(), true);
     } else {
         stream << variant;
     }
@@ -59,3 +82,47 @@ std::ostream& trrojan::print_csv_value(std::ostream& stream,
         const named_variant& variant, const bool quote) {
     return print_csv_value(stream, variant.value(), quote);
 }
+
+
+/*
+ * trrojan::split_csv_line
+ */
+std::vector<std::string> trrojan::split_csv_line(const std::string& line,
+        const std::string& separator) {
+    std::vector<std::string> retval;
+    std::string value;
+    auto it = line.begin();
+
+    while (true) {
+        value.clear();
+
+        if ((it != line.end()) && (*it == '"')) {
+            // A quoted string lasts until the next quote that is not
+            // doubled.
+            for (++it; it != line.end(); ++it) {
+                if (*it == '"') {
+                    if (((it + 1) != line.end()) && (*(it + 1) == '"')) {
+                        ++it;
+                    } else {
+                        ++it;
+                        break;
+                    }
+                }
+                value += *it;
+            }
+        }
+
+        auto end = std::search(it, line.end(), separator.begin(),
+            separator.end());
+        value.append(it, end);
+        retval.push_back(value);
+
+        if (end == line.end()) {
+            break;
+        }
+
+        it = end + separator.size();
+    }
+
+    return retval;
+}
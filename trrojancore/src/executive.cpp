@@ -8,11 +8,16 @@
 #include "trrojan/executive.h"
 
 #include <algorithm>
+#include <cassert>
+#include <chrono>
 #include <fstream>
+#include <future>
 #include <iostream>
 #include <iterator>
+#include <sstream>
 #include <stdexcept>
 #include <system_error>
+#include <utility>
 
 #if defined(_WIN32)
 #include <Windows.h>
@@ -24,6 +29,7 @@
 #include "trrojan/on_exit.h"
 #include "trrojan/log.h"
 #include "trrojan/text.h"
+#include "trrojan/trace.h"
 
 
 #if defined(_WIN32)
@@ -81,7 +87,8 @@ _EXECUTIVE_DEFINE_FACTOR(data_folder);
 /*
  * trrojan::executive::executive
  */
-trrojan::executive::executive(window_type core_window) : window(core_window) {
+trrojan::executive::executive(window_type core_window)
+        : cnt_enumerated(0), window(core_window) {
     if (!this->window) {
         throw std::invalid_argument("The valid core window of the UWP "
             "application must be passed to the TRRojan executive.");
@@ -130,15 +137,13 @@ trrojan::plugin trrojan::executive::find_plugin(const std::string& name) {
  * trrojan::executive::load_plugins
  */
 void trrojan::executive::load_plugins(const cmd_line& cmdLine) {
+    typedef std::chrono::steady_clock clock_type;
+
     try {
         std::vector<std::string> paths;
+        auto phaseStart = clock_type::now();
 
-        log::instance().write_line(log_level::verbose, "Clearing old "
-            "environments and adding the \"none\" environment before loading "
-            "plugins ...");
-        this->environments.clear();
-        this->environments[environment_base::none_name]
-            = trrojan::environment();
+        this->prepare_plugins(cmdLine);
 
         log::instance().write(log_level::verbose, "Considering plugins "
             "from the current working directory.\n");
@@ -159,12 +164,16 @@ void trrojan::executive::load_plugins(const cmd_line& cmdLine) {
         }
 #endif /* (defined(_WIN32) && !defined(TRROJAN_FOR_UWP)) */
 
-        log::instance().write(log_level::verbose, "Found {} potential "
-            "plugin(s).\n", paths.size());
+        log::instance().write_line(log_level::information, "Found {0} "
+            "potential plugin(s) in {1} ms.", paths.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+            clock_type::now() - phaseStart).count());
 
+        phaseStart = clock_type::now();
         for (auto& path : paths) {
             try {
                 auto dll = plugin_dll::open(path);
+
                 auto ep = dll.find_entry_point();
                 if (ep == nullptr) {
                     log::instance().write_line(log_level::warning, "Plugin "
@@ -174,71 +183,52 @@ void trrojan::executive::load_plugins(const cmd_line& cmdLine) {
 
                 log::instance().write(log_level::verbose, "Found a plugin "
                     "entry point in \"{}\".\n", path.c_str());
-                auto plugin = trrojan::plugin(ep());
-                if (plugin != nullptr) {
-                    log::instance().write(log_level::verbose, "Found plugin "
-                        "\"{}\" in \"{}\".\n", plugin->name().c_str(),
-                        path.c_str());
-                    this->plugins.push_back(std::move(plugin));
-                    this->plugin_dlls.push_back(std::move(dll));
-                }
+                auto p = trrojan::plugin(ep());
+                log::instance().write(log_level::verbose, "Found plugin "
+                    "\"{}\" in \"{}\".\n", p->name().c_str(), path.c_str());
+                this->plugins.push_back(std::move(p));
+                this->plugin_dlls.push_back(std::move(dll));
+
             } catch (std::exception& ex) {
                 log::instance().write_line(ex);
             }
         }
 
-        log::instance().write(log_level::verbose, "{} plugin(s) have been "
-            "loaded. Retrieving execution environments from them ...\n", 
-            this->plugins.size());
-
-        for (auto p : this->plugins) {
-            std::vector<environment> envs;
-            p->create_environments(envs);
+        log::instance().write_line(log_level::information, "{0} plugin(s) "
+            "have been loaded in {1} ms. Their environments will be "
+            "initialised before they are used.", this->plugins.size(),
+            std::chrono::duration_cast<std::chrono::milliseconds>(
+            clock_type::now() - phaseStart).count());
 
-            log::instance().write_line(log_level::verbose, "Plugin \"{0}\" "
-                "contains {1} environment(s)", p->name(), envs.size());
-
-            for (auto e : envs) {
-                // First, handle potential violations of the contract with the
-                // plugin. If the plugin returns invalid stuff, just skip it.
-                if (e == nullptr) {
-                    log::instance().write(log_level::debug, "The plugin \"{}\" "
-                        "returned a nullptr as environment.\n",
-                        p->name().c_str());
-                    continue;
-                }
+    } catch (std::exception& ex) {
+        log::instance().write_line(ex);
+    }
+}
 
-                auto name = e->name();
-                if (this->environments.find(name) != this->environments.end()) {
-                    log::instance().write(log_level::debug, "The plugin \"{}\" "
-                        "returned the environment \"{}\", which conflicts with "
-                        "an already loaded environment. The new environment "
-                        "will be ignored.\n", p->name().c_str(), name.c_str());
-                    continue;
-                }
 
-                // Second, initialise the plugin and add it to the map.
-                try {
-                    e->on_initialise(cmdLine);
-                    this->environments.insert(std::make_pair(name, e));
-                    log::instance().write(log_level::verbose, "The "
-                        "environment \"{}\", provided by plugin \"{}\", was "
-                        "successfully initialised.\n", name.c_str(),
-                        p->name().c_str());
-
-                } catch (std::exception& ex) {
-                    log::instance().write_line(ex);
-                    log::instance().write(log_level::verbose, "The "
-                        "environment \"{}\", provided by plugin \"{}\", failed "
-                        "to initialise. The environment will be ignored.\n",
-                        name.c_str(), p->name().c_str());
-                }
+/*
+ * trrojan::executive::load_plugins
+ */
+void trrojan::executive::load_plugins(const cmd_line& cmdLine,
+        const std::vector<plugin_entry_point>& entry_points) {
+    this->prepare_plugins(cmdLine);
+
+    for (auto ep : entry_points) {
+        try {
+            if (ep != nullptr) {
+                auto p = trrojan::plugin(ep());
+                log::instance().write(log_level::verbose, "Found statically "
+                    "linked plugin \"{}\".\n", p->name().c_str());
+                this->plugins.push_back(std::move(p));
             }
+        } catch (std::exception& ex) {
+            log::instance().write_line(ex);
         }
-
-    } catch (std::exception& ex) {
-        log::instance().write_line(ex);
     }
+
+    log::instance().write_line(log_level::information, "{0} statically "
+        "linked plugin(s) have been registered. Their environments will be "
+        "initialised before they are used.", this->plugins.size());
 }
 
 
@@ -250,12 +240,28 @@ void trrojan::executive::run(benchmark_base& benchmark,
         output_base& output,
         const cool_down& cool_down,
         const std::size_t continue_at) {
+    TRROJAN_TRACE_ZONE("executive::run", "executive");
+
     // Note: This method is called from the scripting interface and possibly
     // from other places we do not yet know. Therefore, we do not optimise
     // the order of the parameters, but keep them as they have been passed
     // to the method.
 
     auto eds = this->prepare_env_devs(configs);
+
+    // Number the configurations before any of them is skipped such that the
+    // journal of the output identifies them in the same way on every run.
+    auto indices = this->number_configurations(configs, benchmark, eds,
+        output.resumed());
+
+    // If the output appends to existing results, skip all configurations
+    // that are already in there. This also checks that the existing file can
+    // take the results before anything is run.
+    auto completed = output.completed();
+    if ((completed != nullptr) && !completed->columns().empty()) {
+        this->skip_completed(configs, benchmark, *completed);
+    }
+
     for (auto e : eds) {
         this->enable_environment(e.environment);
         configs.replace_factor(factor::from_manifestations(
@@ -267,8 +273,15 @@ void trrojan::executive::run(benchmark_base& benchmark,
             configs.replace_factor(factor::from_manifestations(
                 device_base::factor_name, d));
 
-            benchmark.run(configs, [&output](result&& r) {
-                output << r;
+            benchmark.run(configs, [&output, &indices](result&& r) {
+                if (r != nullptr) {
+                    auto it = indices.find(journal::hash(r->configuration()));
+                    if (it != indices.end()) {
+                        output.write(*r, it->second);
+                    } else {
+                        output << r;
+                    }
+                }
                 return true;
             }, cool_down, continue_at);
         }
@@ -326,7 +339,12 @@ void trrojan::executive::trroll(const troll_input_type& path,
         const std::size_t continue_at,
         power_collector::pointer power_collector) {
     typedef trroll_parser::benchmark_configs bcs;
-    auto bcss = trroll_parser::parse(path);
+    TRROJAN_TRACE_ZONE("executive::trroll", "executive");
+
+    auto bcss = [&path](void) {
+        TRROJAN_TRACE_ZONE("trroll_parser::parse", "enumeration");
+        return trroll_parser::parse(path);
+    }();
     std::vector<benchmark> benchmarks;
     plugin curPlugin;
 
@@ -340,6 +358,14 @@ void trrojan::executive::trroll(const troll_input_type& path,
         return (l.plugin.compare(r.plugin) < 0);
     });
 
+    // Resolve all environments the script needs before the first benchmark
+    // runs such that the environments do not depend on the order of the
+    // blocks in the script.
+    {
+        TRROJAN_TRACE_ZONE("executive::initialise_environments", "executive");
+        this->initialise_environments(bcss);
+    }
+
     for (auto& b : bcss) {
         // Inject the power collector into all configurations.
         b.configs.replace_factor(factor::from_manifestations(
@@ -397,7 +423,7 @@ void trrojan::executive::trroll(const troll_input_type& path,
  * trrojan::executive::enable_environment
  */
 void trrojan::executive::enable_environment(const std::string& name) {
-    auto it = this->environments.find(name);
+    auto it = this->lookup_environment(name);
     if (it != this->environments.end()) {
         this->enable_environment(it->second);
 
@@ -444,7 +470,7 @@ trrojan::environment trrojan::executive::find_environment(const variant& v) {
 
     if (v.type() == variant_type::string) {
         auto name = v.as<std::string>();
-        retval = this->environments.find(name);
+        retval = this->lookup_environment(name);
         if (retval == this->environments.end()) {
             log::instance().write(log_level::error, "The environment "
                 "\"{}\" does not exist.\n", name.c_str());
@@ -453,7 +479,7 @@ trrojan::environment trrojan::executive::find_environment(const variant& v) {
     } else if (v.type() == variant_type::wstring) {
         auto name = trrojan::to_utf8(v.as<std::wstring>());
 
-        retval = this->environments.find(name);
+        retval = this->lookup_environment(name);
         if (retval == this->environments.end()) {
             log::instance().write(log_level::error, "The environment "
                 "\"{}\" does not exist.\n", name.c_str());
@@ -472,6 +498,263 @@ trrojan::environment trrojan::executive::find_environment(const variant& v) {
 }
 
 
+/*
+ * trrojan::executive::create_environments
+ */
+std::vector<trrojan::environment> trrojan::executive::create_environments(
+        const plugin& plugin, const std::set<std::string>& known,
+        const cmd_line& cmdLine) {
+    typedef std::chrono::steady_clock clock_type;
+    assert(plugin != nullptr);
+
+    const auto start = clock_type::now();
+    std::vector<environment> envs;
+    std::vector<environment> retval;
+    plugin->create_environments(envs);
+
+    log::instance().write_line(log_level::verbose, "Plugin \"{0}\" "
+        "contains {1} environment(s)", plugin->name(), envs.size());
+
+    for (auto e : envs) {
+        // First, handle potential violations of the contract with the
+        // plugin. If the plugin returns invalid stuff, just skip it.
+        if (e == nullptr) {
+            log::instance().write(log_level::debug, "The plugin \"{}\" "
+                "returned a nullptr as environment.\n",
+                plugin->name().c_str());
+            continue;
+        }
+
+        auto name = e->name();
+        if (known.find(name) != known.end()) {
+            log::instance().write(log_level::debug, "The plugin \"{}\" "
+                "returned the environment \"{}\", which conflicts with "
+                "an already loaded environment. The new environment "
+                "will be ignored.\n", plugin->name().c_str(), name.c_str());
+            continue;
+        }
+
+        // Second, initialise the plugin and add it to the map.
+        try {
+            e->on_initialise(cmdLine);
+            retval.push_back(e);
+            log::instance().write(log_level::verbose, "The "
+                "environment \"{}\", provided by plugin \"{}\", was "
+                "successfully initialised.\n", name.c_str(),
+                plugin->name().c_str());
+
+        } catch (std::exception& ex) {
+            log::instance().write_line(ex);
+            log::instance().write(log_level::verbose, "The "
+                "environment \"{}\", provided by plugin \"{}\", failed "
+                "to initialise. The environment will be ignored.\n",
+                name.c_str(), plugin->name().c_str());
+        }
+    }
+
+    log::instance().write_line(log_level::information, "The environments of "
+        "plugin \"{0}\" have been initialised in {1} ms.", plugin->name(),
+        std::chrono::duration_cast<std::chrono::milliseconds>(
+        clock_type::now() - start).count());
+
+    return retval;
+}
+
+
+/*
+ * trrojan::executive::initialise_environments
+ */
+void trrojan::executive::initialise_environments(void) {
+    this->initialise_environments(this->plugins);
+}
+
+
+/*
+ * trrojan::executive::initialise_environments
+ */
+void trrojan::executive::initialise_environments(const plugin& plugin) {
+    this->initialise_environments(std::vector<trrojan::plugin> { plugin });
+}
+
+
+/*
+ * trrojan::executive::initialise_environments
+ */
+void trrojan::executive::initialise_environments(
+        const std::vector<plugin>& plugins) {
+    std::vector<std::future<std::vector<environment>>> envs;
+    std::set<std::string> known;
+    std::vector<plugin> pending;
+
+    for (auto& p : plugins) {
+        if ((p != nullptr)
+                && this->initialised_plugins.insert(p->name()).second) {
+            pending.push_back(p);
+        }
+    }
+
+    for (auto& e : this->environments) {
+        known.insert(e.first);
+    }
+
+    // The plugins do not depend on each other, so their environments are
+    // initialised on one thread per plugin.
+    envs.reserve(pending.size());
+    for (auto& p : pending) {
+        envs.push_back(std::async(std::launch::async,
+            &executive::create_environments, std::cref(p), std::cref(known),
+            std::cref(this->environment_cmd_line)));
+    }
+
+    // Register the environments in the order of the plugins such that
+    // conflicting names are resolved in a reproducible manner.
+    for (std::size_t i = 0; i < pending.size(); ++i) {
+        try {
+            for (auto& e : envs[i].get()) {
+                auto name = e->name();
+                if (!this->environments.emplace(name, e).second) {
+                    log::instance().write(log_level::debug, "The plugin "
+                        "\"{}\" returned the environment \"{}\", which "
+                        "conflicts with an already loaded environment. The "
+                        "new environment will be ignored.\n",
+                        pending[i]->name().c_str(), name.c_str());
+                    e->on_finalise();
+                }
+            }
+
+        } catch (std::exception& ex) {
+            log::instance().write_line(ex);
+            log::instance().write(log_level::verbose, "The environments of "
+                "plugin \"{}\" failed to initialise and will be ignored.\n",
+                pending[i]->name().c_str());
+        }
+    }
+}
+
+
+/*
+ * trrojan::executive::initialise_environments
+ */
+void trrojan::executive::initialise_environments(
+        const std::vector<trroll_parser::benchmark_configs>& configs) {
+    std::vector<plugin> used;
+
+    // Only the plugins providing the benchmarks of the script are initialised
+    // in the order they have been loaded, regardless of the order of the
+    // blocks in the script.
+    for (auto& p : this->plugins) {
+        auto isUsed = std::any_of(configs.begin(), configs.end(),
+            [&p](const trroll_parser::benchmark_configs& c) {
+                return (c.plugin == p->name());
+            });
+        if (isUsed) {
+            used.push_back(p);
+        }
+    }
+
+    this->initialise_environments(used);
+
+    // Resolving the names initialises all plugins if one is unknown.
+    for (auto& c : configs) {
+        auto restrictions = c.configs.find_factor(
+            environment_base::factor_name);
+        if (restrictions != nullptr) {
+            for (std::size_t i = 0; i < restrictions->size(); ++i) {
+                this->find_environment((*restrictions)[i]);
+            }
+        }
+    }
+}
+
+
+/*
+ * trrojan::executive::lookup_environment
+ */
+std::map<std::string, trrojan::environment>::iterator
+trrojan::executive::lookup_environment(const std::string& name) {
+    auto retval = this->environments.find(name);
+
+    if ((retval == this->environments.end())
+            && (this->initialised_plugins.size() < this->plugins.size())) {
+        // We do not know which plugin provides the environment, so we need
+        // to initialise all of them.
+        log::instance().write_line(log_level::verbose, "The environment "
+            "\"{0}\" is not known yet, so the environments of all plugins "
+            "are initialised ...", name);
+        this->initialise_environments();
+        retval = this->environments.find(name);
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::executive::number_configurations
+ */
+std::unordered_map<trrojan::journal::hash_type, std::size_t>
+trrojan::executive::number_configurations(const configuration_set& configs,
+        const benchmark_base& benchmark,
+        const std::vector<env_dev_set>& eds,
+        const journal::state *resumed) {
+    TRROJAN_TRACE_ZONE("executive::number_configurations", "enumeration");
+    std::unordered_map<journal::hash_type, std::size_t> retval;
+    auto all = configs;
+
+    for (auto& e : eds) {
+        all.replace_factor(factor::from_manifestations(
+            environment_base::factor_name, e.environment));
+
+        for (auto& d : e.devices) {
+            all.replace_factor(factor::from_manifestations(
+                device_base::factor_name, d));
+
+            // Enumerate in the same way as the benchmark does.
+            auto c = all;
+            c.merge(benchmark.default_configs(), false);
+
+            c.foreach_configuration([&](const configuration& c) {
+                auto hash = journal::hash(c);
+                auto index = this->cnt_enumerated++;
+
+                if ((resumed != nullptr) && (resumed->completed > 0)
+                        && (resumed->last_index == index)
+                        && (resumed->last_hash != hash)) {
+                    std::stringstream msg;
+                    msg << "The interrupted run has completed another "
+                        "configuration at position " << index << " than the "
+                        "benchmark \"" << benchmark.name() << "\" would "
+                        "run, so it cannot be resumed. Use \"--append\" to "
+                        "keep the existing results nevertheless."
+                        << std::ends;
+                    throw std::runtime_error(msg.str());
+                }
+
+                retval.emplace(hash, index);
+                return true;
+            });
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::executive::prepare_plugins
+ */
+void trrojan::executive::prepare_plugins(const cmd_line& cmdLine) {
+    log::instance().write_line(log_level::verbose, "Clearing old "
+        "environments and adding the \"none\" environment before loading "
+        "plugins ...");
+    this->environments.clear();
+    this->environments[environment_base::none_name]
+        = trrojan::environment();
+    this->initialised_plugins.clear();
+    this->environment_cmd_line = cmdLine;
+}
+
+
 /*
  * trrojan::executive::prepare_env_devs
  */
@@ -497,7 +780,13 @@ trrojan::executive::prepare_env_devs(const configuration_set& cs,
         }
 
     } else {
-        // No environments are given, so use all we know.
+        // No environments are given, so use all of the plugins that have
+        // been initialised for the script. If the caller has not
+        // initialised any, fall back to all plugins.
+        if (this->initialised_plugins.empty()) {
+            this->initialise_environments();
+        }
+
         environments.reserve(this->environments.size());
         for (auto& e : this->environments) {
             environments.push_back(e.second);
@@ -547,6 +836,75 @@ trrojan::executive::prepare_env_devs(const configuration_set& cs,
 }
 
 
+/*
+ * trrojan::executive::skip_completed
+ */
+void trrojan::executive::skip_completed(configuration_set& configs,
+        const benchmark_base& benchmark, const result_index& completed) {
+    std::vector<std::string> factors;
+
+    // The key comprises all factors the benchmark will see except for the
+    // ones we inject, which do not affect the results.
+    auto add_factors = [&factors](const configuration_set& cs) {
+        for (auto& f : cs.factors()) {
+            auto isInjected = (f.name() == power_collector::factor_name)
+                || (f.name() == factor_core_window);
+            auto isKnown = (std::find(factors.begin(), factors.end(), f.name())
+                != factors.end());
+            if (!isInjected && !isKnown) {
+                factors.push_back(f.name());
+            }
+        }
+    };
+    add_factors(configs);
+    add_factors(benchmark.default_configs());
+
+    // Rows lacking any of the factors could not be appended, so fail before
+    // the first configuration has been run rather than when its results are
+    // written.
+    for (auto& f : factors) {
+        auto& columns = completed.columns();
+        if (std::find(columns.begin(), columns.end(), f) == columns.end()) {
+            std::stringstream msg;
+            msg << "The existing output lacks a column for the factor \""
+                << f << "\" of the benchmark \"" << benchmark.name()
+                << "\", wherefore the results cannot be appended to it."
+                << std::ends;
+            throw std::runtime_error(msg.str());
+        }
+    }
+
+    auto keys = std::make_shared<const result_index::key_set>(
+        completed.keys(factors));
+
+    // The file might contain rows of other benchmarks or of configurations
+    // that are not requested any more, so count the ones that are actually
+    // skipped.
+    std::size_t cntSkipped = 0;
+    if (!keys->empty()) {
+        auto all = configs;
+        all.merge(benchmark.default_configs(), false);
+        all.foreach_configuration([&](const configuration& c) {
+            if (keys->find(result_index::key(c, factors)) != keys->end()) {
+                ++cntSkipped;
+            }
+            return true;
+        });
+    }
+
+    log::instance().write_line(log_level::information, "The output already "
+        "contains {0} of the configurations of the benchmark \"{1}\", which "
+        "will be skipped.", cntSkipped, benchmark.name());
+
+    if (!keys->empty()) {
+        configs.add_constraint(factors,
+                [factors, keys](const configuration& c) {
+            return (keys->find(result_index::key(c, factors)) == keys->end());
+        });
+    }
+}
+
+
 /*
  * trrojan::executive::plugin_dll::entry_point_name
  */
@@ -15,6 +15,11 @@
 #include <streambuf>
 #include <system_error>
 
+#if !defined(_WIN32)
+#include <fcntl.h>
+#include <unistd.h>
+#endif /* !defined(_WIN32) */
+
 #if defined(TRROJAN_FOR_UWP)
 #include <winrt/windows.foundation.h>
 #include <winrt/windows.applicationModel.core.h>
@@ -23,6 +28,7 @@
 #endif /* defined(TRROJAN_FOR_UWP) */
 
 #include "trrojan/com_error_category.h"
+#include "trrojan/trace.h"
 #include "trrojan/executive.h"
 #include "trrojan/on_exit.h"
 
@@ -185,6 +191,8 @@ std::string trrojan::get_temp_folder(void) {
  */
 std::vector<std::uint8_t> TRROJANCORE_API trrojan::read_binary_file(
         const char *path) {
+    TRROJAN_TRACE_ZONE("read_binary_file", "data");
+
     if (path == nullptr) {
         throw std::invalid_argument("'path' must not be nullptr.");
     }
@@ -214,6 +222,8 @@ std::vector<std::uint8_t> TRROJANCORE_API trrojan::read_binary_file(
  * trrojan::read_text_file
  */
 std::string TRROJANCORE_API trrojan::read_text_file(const char *path) {
+    TRROJAN_TRACE_ZONE("read_text_file", "data");
+
     if (path == nullptr) {
         throw std::invalid_argument("'path' must not be nullptr.");
     }
@@ -295,6 +305,43 @@ std::string trrojan::read_text_file(
 #endif /* defined(TRROJAN_FOR_UWP) */
 
 
+/*
+ * trrojan::sync_file
+ */
+void trrojan::sync_file(const std::string& path) {
+#if defined(TRROJAN_FOR_UWP)
+    auto handle = ::CreateFile2(from_utf8(path).c_str(), GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE, OPEN_EXISTING, nullptr);
+#elif defined(_WIN32)
+    auto handle = ::CreateFileA(path.c_str(), GENERIC_WRITE,
+        FILE_SHARE_READ | FILE_SHARE_WRITE, nullptr, OPEN_EXISTING,
+        FILE_ATTRIBUTE_NORMAL, NULL);
+#endif /* defined(TRROJAN_FOR_UWP) */
+
+#if defined(_WIN32)
+    if (handle == INVALID_HANDLE_VALUE) {
+        throw std::system_error(::GetLastError(), std::system_category());
+    }
+    on_exit([handle](void) { ::CloseHandle(handle); });
+
+    if (!::FlushFileBuffers(handle)) {
+        throw std::system_error(::GetLastError(), std::system_category());
+    }
+
+#else /* defined(_WIN32) */
+    auto handle = ::open(path.c_str(), O_WRONLY);
+    if (handle == -1) {
+        throw std::system_error(errno, std::system_category());
+    }
+    on_exit([handle](void) { ::close(handle); });
+
+    if (::fsync(handle) != 0) {
+        throw std::system_error(errno, std::system_category());
+    }
+#endif /* defined(_WIN32) */
+}
+
+
 #if defined(_WIN32)
 /*
  * trrojan::write_all_bytes
@@ -0,0 +1,190 @@
+﻿// <copyright file="journal.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/journal.h"
+
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "trrojan/csv_util.h"
+#include "trrojan/io.h"
+#include "trrojan/system_factors.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    static const std::string journal_begin("begin");
+    static const std::string journal_end("end");
+    static const std::string journal_finished("finished");
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::journal::hash
+ */
+trrojan::journal::hash_type trrojan::journal::hash(
+        const configuration& config) {
+    // FNV-1a over the names and values of all factors, which is stable
+    // between runs as opposed to std::hash.
+    hash_type retval = 14695981039346656037ull;
+    auto add = [&retval](const std::string& str) {
+        for (auto c : str) {
+            retval ^= static_cast<unsigned char>(c);
+            retval *= 1099511628211ull;
+        }
+        retval ^= 0x1f;
+        retval *= 1099511628211ull;
+    };
+
+    for (auto& f : config) {
+        if (!system_factors::is_system_factor(f.name())) {
+            std::stringstream value;
+            print_csv_value(value, f.value(), false);
+            add(f.name());
+            add(value.str());
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::journal::path
+ */
+std::string trrojan::journal::path(const std::string& output) {
+    return output + ".journal";
+}
+
+
+/*
+ * trrojan::journal::read
+ */
+trrojan::journal::state trrojan::journal::read(const std::string& output) {
+    state retval { 0, false, 0, 0, 0, false };
+    std::ifstream file(journal::path(output), std::ios::binary);
+    std::string line;
+
+    // Note: std::getline also returns an incomplete last line, which we
+    // must not trust, because it might have been written partially.
+    while (std::getline(file, line) && !file.eof()) {
+        std::istringstream record(line);
+        std::string type;
+        std::size_t index;
+        std::uint64_t size;
+        hash_type hash;
+
+        record >> type;
+        if (type == detail::journal_begin) {
+            if (record >> index) {
+                retval.started = true;
+                retval.finished = false;
+            }
+
+        } else if (type == detail::journal_end) {
+            if (record >> index >> std::hex >> hash >> std::dec >> size) {
+                ++retval.completed;
+                retval.last_hash = hash;
+                retval.last_index = index;
+                retval.output_size = size;
+            }
+
+        } else if (type == detail::journal_finished) {
+            retval.finished = true;
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::journal::journal
+ */
+trrojan::journal::journal(const std::string& output,
+        const std::size_t sync_interval, const bool append)
+        : _cnt_unsynced(0), _output(output),
+        _path(journal::path(output)), _sync_interval(sync_interval) {
+    if (this->_sync_interval < 1) {
+        throw std::invalid_argument("The synchronisation interval of a "
+            "journal must be at least one.");
+    }
+
+    auto mode = append ? std::ios::app : std::ios::trunc;
+    this->_file.open(this->_path, mode | std::ios::binary);
+    if (!this->_file) {
+        std::stringstream msg;
+        msg << "Failed to open journal \"" << this->_path << "\""
+            << std::ends;
+        throw std::runtime_error(msg.str());
+    }
+
+    if (append) {
+        // Terminate a line that has been written partially before the last
+        // run was interrupted.
+        std::ifstream file(this->_path, std::ios::binary | std::ios::ate);
+        if (file && (file.tellg() > 0)) {
+            file.seekg(-1, std::ios::end);
+            if (file.get() != '\n') {
+                this->_file << "\n";
+            }
+        }
+    }
+}
+
+
+/*
+ * trrojan::journal::begin
+ */
+void trrojan::journal::begin(const std::size_t index,
+        const hash_type hash) {
+    this->_file << detail::journal_begin << " " << index << " "
+        << std::hex << std::setw(16) << std::setfill('0') << hash
+        << std::dec << "\n";
+    this->_file.flush();
+}
+
+
+/*
+ * trrojan::journal::complete
+ */
+void trrojan::journal::complete(const std::size_t index,
+        const hash_type hash, const std::uint64_t output_size) {
+    this->_file << detail::journal_end << " " << index << " "
+        << std::hex << std::setw(16) << std::setfill('0') << hash
+        << std::dec << " " << output_size << "\n";
+    this->_file.flush();
+
+    if (++this->_cnt_unsynced >= this->_sync_interval) {
+        this->sync();
+    }
+}
+
+
+/*
+ * trrojan::journal::finish
+ */
+void trrojan::journal::finish(void) {
+    this->_file << detail::journal_finished << "\n";
+    this->_file.flush();
+    this->sync();
+}
+
+
+/*
+ * trrojan::journal::sync
+ */
+void trrojan::journal::sync(void) {
+    // The output must be on disk before the journal claims that it is
+    // complete.
+    sync_file(this->_output);
+    sync_file(this->_path);
+    this->_cnt_unsynced = 0;
+}
@@ -0,0 +1,50 @@
+﻿// <copyright file="json_util.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/json_util.h"
+
+#include <cstdio>
+
+
+/*
+ * trrojan::print_json_string
+ */
+std::ostream& trrojan::print_json_string(std::ostream& stream,
+        const std::string& str) {
+    return print_json_string(stream, str.c_str());
+}
+
+
+/*
+ * trrojan::print_json_string
+ */
+std::ostream& trrojan::print_json_string(std::ostream& stream,
+        const char *str) {
+    stream << '"';
+    for (; (str != nullptr) && (*str != 0); ++str) {
+        switch (*str) {
+            case '"': stream << "\\\""; break;
+            case '\\': stream << "\\\\"; break;
+            case '\n': stream << "\\n"; break;
+            case '\r': stream << "\\r"; break;
+            case '\t': stream << "\\t"; break;
+            default:
+                if (static_cast<unsigned char>(*str) < 0x20) {
+                    char buffer[8];
+                    std::snprintf(buffer, sizeof(buffer), "\\u%04x",
+                        static_cast<unsigned int>(
+                        static_cast<unsigned char>(*str)));
+                    stream << buffer;
+                } else {
+                    stream << *str;
+                }
+                break;
+        }
+    }
+    stream << '"';
+
+    return stream;
+}
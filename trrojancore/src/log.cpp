@@ -6,28 +6,241 @@
 
 #include "trrojan/log.h"
 
+#include <condition_variable>
+#include <stdexcept>
+#include <vector>
+
+#include <spdlog/details/log_msg_buffer.h>
+#include <spdlog/pattern_formatter.h>
+#include <spdlog/sinks/base_sink.h>
 #include <spdlog/sinks/msvc_sink.h>
 #include <spdlog/sinks/stdout_color_sinks.h>
 
+#include "trrojan/on_exit.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// A sink that distributes the messages to the actual sinks unless a
+    /// measurement scope is active, in which case all messages below
+    /// <see cref="log_level::error" /> are held back.
+    /// </summary>
+    /// <remarks>
+    /// If the sink is fed by the worker of an asynchronous logger, it tracks
+    /// the messages that have been queued, but not yet processed, such that
+    /// the caller can wait for the worker.
+    /// </remarks>
+    class deferring_sink final : public spdlog::sinks::base_sink<std::mutex> {
+
+    public:
+
+        template<class I>
+        inline deferring_sink(I begin, I end, const bool track_pending)
+            : _cnt_pending(0), _cnt_scopes(0), _sinks(begin, end),
+            _track_pending(track_pending) { }
+
+        /// <summary>
+        /// Enters a new measurement scope.
+        /// </summary>
+        void enter(void) {
+            std::lock_guard<std::mutex> l(this->mutex_);
+            ++this->_cnt_scopes;
+        }
+
+        /// <summary>
+        /// Leaves a measurement scope and writes all deferred messages if it
+        /// was the outermost one.
+        /// </summary>
+        void leave(void) {
+            std::lock_guard<std::mutex> l(this->mutex_);
+            if (this->_cnt_scopes == 0) {
+                throw std::logic_error("A measurement scope cannot be left, "
+                    "because none is active.");
+            }
+
+            if (--this->_cnt_scopes == 0) {
+                this->release();
+            }
+        }
+
+        /// <summary>
+        /// Registers a message that has been queued for the worker.
+        /// </summary>
+        void queue(void) {
+            std::lock_guard<std::mutex> l(this->_lock_pending);
+            ++this->_cnt_pending;
+        }
+
+        /// <summary>
+        /// Writes all deferred messages regardless of whether a measurement
+        /// scope is active.
+        /// </summary>
+        void release_all(void) {
+            std::lock_guard<std::mutex> l(this->mutex_);
+            this->release();
+        }
+
+        /// <summary>
+        /// Blocks until the worker has processed all messages registered via
+        /// <see cref="queue" />.
+        /// </summary>
+        void wait_pending(void) {
+            std::unique_lock<std::mutex> l(this->_lock_pending);
+            this->_pending_processed.wait(l, [this](void) {
+                return (this->_cnt_pending == 0);
+            });
+        }
+
+    protected:
+
+        void flush_(void) override {
+            for (auto& s : this->_sinks) {
+                s->flush();
+            }
+        }
+
+        void set_formatter_(
+                std::unique_ptr<spdlog::formatter> formatter) override {
+            for (auto& s : this->_sinks) {
+                s->set_formatter(formatter->clone());
+            }
+        }
+
+        void set_pattern_(const std::string& pattern) override {
+            this->set_formatter_(std::unique_ptr<spdlog::formatter>(
+                new spdlog::pattern_formatter(pattern)));
+        }
+
+        void sink_it_(const spdlog::details::log_msg& msg) override {
+            // The message counts as processed even if a sink fails, because
+            // the worker will not retry it.
+            on_exit([this](void) { this->processed(); });
+
+            if ((this->_cnt_scopes > 0) && (msg.level < spdlog::level::err)) {
+                // The buffer copies the payload, which otherwise is only valid
+                // during this call.
+                this->_deferred.emplace_back(msg);
+            } else {
+                this->forward(msg);
+            }
+        }
+
+    private:
+
+        void forward(const spdlog::details::log_msg& msg) {
+            for (auto& s : this->_sinks) {
+                if (s->should_log(msg.level)) {
+                    s->log(msg);
+                }
+            }
+        }
+
+        void processed(void) {
+            if (this->_track_pending) {
+                std::lock_guard<std::mutex> l(this->_lock_pending);
+                if ((this->_cnt_pending > 0) && (--this->_cnt_pending == 0)) {
+                    this->_pending_processed.notify_all();
+                }
+            }
+        }
+
+        void release(void) {
+            for (auto& m : this->_deferred) {
+                this->forward(m);
+            }
+            this->_deferred.clear();
+        }
+
+        std::size_t _cnt_pending;
+        std::size_t _cnt_scopes;
+        std::vector<spdlog::details::log_msg_buffer> _deferred;
+        std::mutex _lock_pending;
+        std::condition_variable _pending_processed;
+        std::vector<spdlog::sink_ptr> _sinks;
+        bool _track_pending;
+    };
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::log::default_queue_size
+ */
+const std::size_t trrojan::log::default_queue_size = 8192;
+
 
 /*
  * trrojan::log::~log
  */
-trrojan::log::~log(void) { }
+trrojan::log::~log(void) {
+    // Do not lose the messages of a measurement that has been aborted.
+    this->_deferring_sink->release_all();
+}
+
+
+/*
+ * trrojan::log::enqueue
+ */
+bool trrojan::log::enqueue(const log_level level) {
+    auto retval = this->_logger->should_log(
+        static_cast<spdlog::level::level_enum>(level));
+
+    if (retval && (this->_thread_pool != nullptr)) {
+        this->_deferring_sink->queue();
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::log::enter_measurement_scope
+ */
+void trrojan::log::enter_measurement_scope(void) {
+    this->_deferring_sink->enter();
+}
+
+
+/*
+ * trrojan::log::flush
+ */
+void trrojan::log::flush(void) {
+    if (this->_thread_pool != nullptr) {
+        // The queue being empty is not sufficient, because the worker might
+        // still be writing the message it has dequeued last.
+        this->_deferring_sink->wait_pending();
+    }
+
+    this->_deferring_sink->flush();
+}
+
+
+/*
+ * trrojan::log::leave_measurement_scope
+ */
+void trrojan::log::leave_measurement_scope(void) {
+    this->_deferring_sink->leave();
+}
 
 
 /*
  * trrojan::log::write
  */
 void trrojan::log::write(const log_level level, const char *str) {
-    this->_logger->log(static_cast<spdlog::level::level_enum>(level), str);
+    if (this->enqueue(level)) {
+        this->_logger->log(static_cast<spdlog::level::level_enum>(level),
+            str);
+    }
 }
 
 
 /*
  * trrojan::log::log
  */
-trrojan::log::log(const char *file) {
+trrojan::log::log(const char *file, const std::size_t queue_size) {
     std::vector<spdlog::sink_ptr> sinks;
 
     if (file != nullptr) {
@@ -46,8 +259,22 @@ trrojan::log::log(const char *file) {
     sinks.push_back(std::make_shared<spdlog::sinks::msvc_sink_mt>());
 #endif /* (defined(_WIN32) && (defined(DEBUG) || defined(_DEBUG))) */
 
-    this->_logger = std::make_shared<spdlog::logger>("logger",
-        sinks.begin(), sinks.end());
+    // All sinks are wrapped such that messages can be deferred while
+    // measuring.
+    this->_deferring_sink = std::make_shared<detail::deferring_sink>(
+        sinks.begin(), sinks.end(), (queue_size > 0));
+
+    if (queue_size > 0) {
+        // Use a single worker, because more would reorder the messages.
+        this->_thread_pool = std::make_shared<spdlog::details::thread_pool>(
+            queue_size, 1);
+        this->_logger = std::make_shared<spdlog::async_logger>("logger",
+            this->_deferring_sink, this->_thread_pool,
+            spdlog::async_overflow_policy::block);
+    } else {
+        this->_logger = std::make_shared<spdlog::logger>("logger",
+            this->_deferring_sink);
+    }
 
 #if (defined(DEBUG) || defined(_DEBUG))
     this->_logger->set_level(spdlog::level::trace);
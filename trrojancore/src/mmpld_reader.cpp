@@ -13,6 +13,7 @@
 #include <stdexcept>
 
 #include "trrojan/log.h"
+#include "trrojan/trace.h"
 
 
 /*
@@ -112,6 +113,7 @@ void trrojan::mmpld_reader::parse_version(int& outMajor, int& outMinor,
  */
 std::ifstream& trrojan::mmpld_reader::read_file_header(std::ifstream& outStream,
         file_header& outHeader, seek_table& outSeekTable, const char *path) {
+    TRROJAN_TRACE_ZONE("mmpld_reader::read_file_header", "data");
     std::uint64_t offset = 0;
 
     if (path == nullptr) {
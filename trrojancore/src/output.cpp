@@ -16,6 +16,7 @@
 #include "trrojan/r_output.h"
 #include "trrojan/r_output_params.h"
 #include "trrojan/text.h"
+#include "trrojan/trace.h"
 
 
 /*
@@ -24,10 +25,42 @@
 trrojan::output_base::~output_base(void) { }
 
 
+/*
+ * trrojan::output_base::completed
+ */
+const trrojan::result_index *trrojan::output_base::completed(void) const {
+    return nullptr;
+}
+
+
+/*
+ * trrojan::output_base::finish
+ */
+void trrojan::output_base::finish(void) { }
+
+
+/*
+ * trrojan::output_base::resumed
+ */
+const trrojan::journal::state *trrojan::output_base::resumed(void) const {
+    return nullptr;
+}
+
+
+/*
+ * trrojan::output_base::write
+ */
+trrojan::output_base& trrojan::output_base::write(const basic_result& result,
+        const std::size_t) {
+    return (*this << result);
+}
+
+
 /*
  * trrojan::output_base::operator <<
  */
 trrojan::output_base& trrojan::output_base::operator <<(const result result) {
+    TRROJAN_TRACE_ZONE("output_base::operator <<", "output");
     return (result) ? (*this << *result) : *this;
 }
 
@@ -16,6 +16,31 @@
 #include "trrojan/text.h"
 
 
+#if (defined(TRROJAN_WITH_POWER_OVERWHELMING) && defined(TRROJAN_WITH_POWERCAP))
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// Derives the path of the RAPL log from the path of the log of
+    /// power_overwhelming by inserting &quot;.rapl&quot; before the
+    /// extension.
+    /// </summary>
+    static std::string powercap_path(const std::string& file) {
+        auto dir = file.find_last_of("/\\");
+        auto ext = file.find_last_of('.');
+        if ((ext == std::string::npos)
+                || ((dir != std::string::npos) && (ext < dir))) {
+            return file + ".rapl";
+        } else {
+            return file.substr(0, ext) + ".rapl" + file.substr(ext);
+        }
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+#endif /* (defined(TRROJAN_WITH_POWER_OVERWHELMING) && ... */
+
+
 /*
  * trrojan::power_collector::delimiter
  */
@@ -28,16 +53,23 @@ const char trrojan::power_collector::delimiter = ';';
 const char *trrojan::power_collector::factor_name = "powerlog";
 
 
-#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+#if defined(TRROJAN_WITH_POWER_COLLECTOR)
 /*
  * trrojan::power_collector::power_collector
  */
 trrojan::power_collector::power_collector(void)
-        : _is_collecting(false), _is_running(false), _unique_identifier(0) {
+        : _is_collecting(false), _is_running(false),
+        _last_energy(std::numeric_limits<double>::quiet_NaN()),
+        _unique_identifier(0) {
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
     this->setup_adl_sensors();
     this->setup_hmc8015_sensors();
     this->setup_nvml_sensors();
     this->setup_tinkerforge_sensors();
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#if defined(TRROJAN_WITH_POWERCAP)
+    this->setup_powercap_sensors();
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
 }
 
 
@@ -63,6 +95,21 @@ std::string trrojan::power_collector::next_unique_identifier(void) {
 void trrojan::power_collector::set_description(const std::string& description) {
     std::lock_guard<decltype(this->_lock)> l(this->_lock);
 
+#if defined(TRROJAN_WITH_POWERCAP)
+    // Sample the energy counters at the boundary of the scope such that the
+    // energy consumed in the scope does not depend on the sampling interval.
+    // The sample is attributed to the old description.
+    {
+        auto energy = this->sample_powercap_sensors(this->_is_collecting.load(
+            std::memory_order::memory_order_acquire));
+        if (!this->_description.empty()) {
+            this->_last_energy.store(energy - this->_scope_energy,
+                std::memory_order_release);
+        }
+        this->_scope_energy = energy;
+    }
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
+
     // Start/stop/continue logging based on whether we have a valid description.
     this->_is_collecting.store(!description.empty(),
         std::memory_order::memory_order_release);
@@ -122,9 +169,11 @@ void trrojan::power_collector::set_header(const std::string& uid) {
  */
 void trrojan::power_collector::start(const std::string& file,
         const interval_type sampling_interval) {
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
     using namespace visus::power_overwhelming;
     const auto si = std::chrono::duration_cast<std::chrono::microseconds>(
         sampling_interval).count();
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
 
     auto expected = false;
     if (!this->_is_running.compare_exchange_strong(expected, true)) {
@@ -132,8 +181,10 @@ void trrojan::power_collector::start(const std::string& file,
             "already running and cannot be restarted.");
     }
 
-    // Prepare the output file.
     this->_file = file;
+
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+    // Prepare the output file.
     this->_stream = std::ofstream(this->_file, std::ios::trunc);
     if (!this->_stream.is_open()) {
         throw std::invalid_argument("Failed to open output stream.");
@@ -174,6 +225,37 @@ void trrojan::power_collector::start(const std::string& file,
         log::instance().write_line(log_level::information, "Power sensor "
             "\"{0}\" started.", convert_string<char>(s.name()));
     }
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+
+#if defined(TRROJAN_WITH_POWERCAP)
+    // Prepare the output file, which is a separate one if power_overwhelming
+    // is used, too.
+    {
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+        const auto path = detail::powercap_path(this->_file);
+#else /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+        const auto& path = this->_file;
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+        this->_powercap_stream = std::ofstream(path, std::ios::trunc);
+        if (!this->_powercap_stream.is_open()) {
+            throw std::invalid_argument("Failed to open output stream.");
+        }
+
+        if (path != this->_file) {
+            log::instance().write_line(log_level::information, "Logging "
+                "RAPL energy counters to \"{0}\".", path);
+        }
+    }
+
+    // The energy counters are free-running, so we only need to make sure that
+    // we start accumulating now.
+    for (auto& s : this->_powercap_sensors) {
+        s.reset();
+        log::instance().write_line(log_level::information, "Power sensor "
+            "\"{0}\" started.", s.name());
+    }
+    this->_scope_energy = 0.0;
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
 
     log::instance().write_line(log_level::information, "Logging power usage to "
         "\"{0}\" at an {1} ms interval.", this->_file,
@@ -187,11 +269,12 @@ void trrojan::power_collector::start(const std::string& file,
  * trrojan::power_collector::stop
  */
 void trrojan::power_collector::stop(void) {
-    using namespace visus::power_overwhelming;
-
     // Tell the thread to exit.
     this->_is_running = false;
 
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+    using namespace visus::power_overwhelming;
+
     // Stop all ADL sensors., because these are collecting asynchronously
     // although we collect the data manually.
     for (auto& s : this->_adl_sensors) {
@@ -224,6 +307,7 @@ void trrojan::power_collector::stop(void) {
             log::instance().write_line(ex);
         }
     }
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
 
     // Wait for the thread to exit.
     if (this->_sampler.joinable()) {
@@ -231,11 +315,20 @@ void trrojan::power_collector::stop(void) {
     }
 
     // Log all remaining data.
-    this->flush_buffer();
-    this->_stream.close();
+    {
+        std::lock_guard<decltype(this->_lock)> l(this->_lock);
+        this->flush_buffer();
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+        this->_stream.close();
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#if defined(TRROJAN_WITH_POWERCAP)
+        this->_powercap_stream.close();
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
+    }
 }
 
 
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
 /*
  * trrojan::power_collector::on_measurement
  */
@@ -284,6 +377,7 @@ void trrojan::power_collector::start_hmc8015_sensor(
     sensor.log(true);
     assert(sensor.is_log());
 }
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
 
 
 /*
@@ -291,24 +385,59 @@ void trrojan::power_collector::start_hmc8015_sensor(
  */
 void trrojan::power_collector::flush_buffer(void) {
     // We assume that the caller already holds the lock.
-    if ((this->_stream.tellp() == 0) && !this->_buffer.empty()) {
-        // If this is the first line, print the CSV header.
-        this->_stream << visus::power_overwhelming::csvheader
-            << this->_buffer.front() << delimiter
-            << this->_header
-            << std::endl
-            << visus::power_overwhelming::csvdata;
-    }
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+    if (this->_stream.is_open()) {
+        if ((this->_stream.tellp() == 0) && !this->_buffer.empty()) {
+            // If this is the first line, print the CSV header.
+            this->_stream << visus::power_overwhelming::csvheader
+                << this->_buffer.front() << delimiter
+                << this->_header
+                << std::endl
+                << visus::power_overwhelming::csvdata;
+        }
 
-    for (auto& m : this->_buffer) {
-        this->_stream
-            << m << delimiter
-            << this->_description
-            << std::endl;
+        for (auto& m : this->_buffer) {
+            this->_stream
+                << m << delimiter
+                << this->_description
+                << std::endl;
+        }
+
+        this->_stream.flush();
     }
 
     this->_buffer.clear();
-    this->_stream.flush();
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+
+#if defined(TRROJAN_WITH_POWERCAP)
+    if (this->_powercap_stream.is_open()) {
+        auto& stream = this->_powercap_stream;
+
+        if ((stream.tellp() == 0) && !this->_powercap_buffer.empty()) {
+            // If this is the first line, print the CSV header.
+            stream << "\"timestamp\"" << delimiter
+                << "\"sensor\"" << delimiter
+                << "\"energy\"" << delimiter
+                << "\"power\"" << delimiter
+                << this->_header
+                << std::endl;
+        }
+
+        for (auto& m : this->_powercap_buffer) {
+            stream
+                << m.timestamp << delimiter
+                << "\"" << m.sensor << "\"" << delimiter
+                << m.energy << delimiter
+                << m.power << delimiter
+                << this->_description
+                << std::endl;
+        }
+
+        stream.flush();
+    }
+
+    this->_powercap_buffer.clear();
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
 }
 
 
@@ -316,11 +445,14 @@ void trrojan::power_collector::flush_buffer(void) {
  * trrojan::power_collector::sample
  */
 void trrojan::power_collector::sample(const interval_type sampling_interval) {
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
     static constexpr auto timestamp_resolution
         = visus::power_overwhelming::timestamp_resolution::milliseconds;
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
     while (this->_is_running.load()) {
         auto now = std::chrono::high_resolution_clock::now();
 
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
         if (this->_is_collecting.load(std::memory_order::memory_order_acquire)) {
             // We sample the sensors only if we have a valid description such
             // that we know the situation for which we sample.
@@ -340,6 +472,17 @@ void trrojan::power_collector::sample(const interval_type sampling_interval) {
                 }
             }
         }
+#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+
+#if defined(TRROJAN_WITH_POWERCAP)
+        {
+            // The energy counters must be sampled regardless of whether we
+            // are collecting, because we would miss wrap-arounds otherwise.
+            std::lock_guard<decltype(this->_lock)> l(this->_lock);
+            this->sample_powercap_sensors(this->_is_collecting.load(
+                std::memory_order::memory_order_acquire));
+        }
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
         // Note: we must not hold '_lock' while sleeping!
 
         std::this_thread::sleep_until(now + sampling_interval);
@@ -347,6 +490,7 @@ void trrojan::power_collector::sample(const interval_type sampling_interval) {
 }
 
 
+#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
 /*
  * trrojan::power_collector::setup_adl_sensors
  */
@@ -447,3 +591,48 @@ void trrojan::power_collector::setup_tinkerforge_sensors(void) {
     }
 }
 #endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+
+
+#if defined(TRROJAN_WITH_POWERCAP)
+/*
+ * trrojan::power_collector::sample_powercap_sensors
+ */
+double trrojan::power_collector::sample_powercap_sensors(const bool buffer) {
+    // We assume that the caller already holds the lock.
+    auto retval = 0.0;
+
+    for (auto& s : this->_powercap_sensors) {
+        try {
+            auto m = s.sample();
+
+            if (s.counts_towards_total()) {
+                retval += m.energy;
+            }
+
+            if (buffer) {
+                this->_powercap_buffer.push_back(std::move(m));
+            }
+        } catch (std::exception& ex) {
+            log::instance().write_line(ex);
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::power_collector::setup_powercap_sensors
+ */
+void trrojan::power_collector::setup_powercap_sensors(void) {
+    this->_powercap_sensors = powercap_sensor::for_all();
+    this->_scope_energy = 0.0;
+
+    if (this->_powercap_sensors.empty()) {
+        log::instance().write_line(log_level::warning, "No RAPL domains could "
+            "be opened via the powercap interface. The power log will remain "
+            "empty.");
+    }
+}
+#endif /* defined(TRROJAN_WITH_POWERCAP) */
+#endif /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
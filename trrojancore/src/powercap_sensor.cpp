@@ -0,0 +1,223 @@
+﻿// <copyright file="powercap_sensor.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/powercap_sensor.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+#include <system_error>
+
+#include "trrojan/io.h"
+#include "trrojan/log.h"
+#include "trrojan/text.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// Reads the first line of the powercap attribute at the given location.
+    /// </summary>
+    static std::string read_powercap_attribute(const std::string& path) {
+        std::ifstream file(path);
+        std::string retval;
+
+        if (!file || !std::getline(file, retval)) {
+            std::stringstream msg;
+            msg << "Failed to read the powercap attribute \"" << path << "\"."
+                << std::ends;
+            throw std::runtime_error(msg.str());
+        }
+
+        return trim(retval);
+    }
+
+    /// <summary>
+    /// Reads a numeric powercap attribute.
+    /// </summary>
+    static powercap_sensor::counter_type read_powercap_counter(
+            const std::string& path) {
+        auto value = read_powercap_attribute(path);
+        try {
+            return std::stoull(value);
+        } catch (std::exception&) {
+            std::stringstream msg;
+            msg << "The powercap attribute \"" << path << "\" holds the "
+                "non-numeric value \"" << value << "\"." << std::ends;
+            throw std::runtime_error(msg.str());
+        }
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::powercap_sensor::default_root
+ */
+const std::string trrojan::powercap_sensor::default_root(
+    "/sys/class/powercap");
+
+
+/*
+ * trrojan::powercap_sensor::for_all
+ */
+std::vector<trrojan::powercap_sensor> trrojan::powercap_sensor::for_all(
+        const std::string& root) {
+    static const std::string prefix("intel-rapl:");
+    std::vector<std::string> zones;
+    std::vector<powercap_sensor> retval;
+
+    try {
+        get_file_system_entries(std::back_inserter(zones), root, false);
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::verbose, "The powercap "
+            "interface at \"{0}\" is not available: {1}", root, ex.what());
+        return retval;
+    }
+
+    // Note: the AMD driver reuses the Intel name, and we deliberately do not
+    // match "intel-rapl-mmio", which reports the same package domain via a
+    // different interface.
+    std::transform(zones.begin(), zones.end(), zones.begin(),
+        [](const std::string& z) { return get_file_name(z); });
+    zones.erase(std::remove_if(zones.begin(), zones.end(),
+        [](const std::string& z) { return !starts_with(z, prefix); }),
+        zones.end());
+
+    // Sort the zones such that sub-zones follow their parent.
+    std::sort(zones.begin(), zones.end());
+
+    retval.reserve(zones.size());
+    for (auto& z : zones) {
+        try {
+            retval.emplace_back(root, z);
+            log::instance().write_line(log_level::verbose, "Found powercap "
+                "domain \"{0}\" in zone \"{1}\".", retval.back().name(), z);
+        } catch (std::exception& ex) {
+            log::instance().write_line(log_level::warning, "The powercap zone "
+                "\"{0}\" cannot be used, which is most likely caused by "
+                "missing permissions to read the energy counter: {1}", z,
+                ex.what());
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::powercap_sensor::powercap_sensor
+ */
+trrojan::powercap_sensor::powercap_sensor(const std::string& root,
+        const std::string& zone)
+        : _energy(0), _last_counter(0), _max_energy_range(0),
+        _path(combine_path(root, zone)), _zone(zone) {
+    this->_domain = detail::read_powercap_attribute(
+        combine_path(this->_path, "name"));
+    this->_name = this->_domain;
+
+    // Sub-zones are named like "intel-rapl:0:1" and report only generic
+    // domain names like "dram", so we prefix them with their parent.
+    {
+        auto colon = this->_zone.find(':');
+        auto last = this->_zone.find_last_of(':');
+        if ((colon != std::string::npos) && (colon != last)) {
+            try {
+                auto parent = detail::read_powercap_attribute(combine_path(
+                    root, this->_zone.substr(0, last), "name"));
+                this->_name = parent + "/" + this->_domain;
+            } catch (std::exception& ex) {
+                log::instance().write_line(ex);
+            }
+        }
+    }
+
+    try {
+        this->_max_energy_range = detail::read_powercap_counter(
+            combine_path(this->_path, "max_energy_range_uj"));
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::warning, "The wrap-around range "
+            "of the powercap zone \"{0}\" is unknown, wherefore overflows of "
+            "the energy counter cannot be detected: {1}", this->_zone,
+            ex.what());
+    }
+
+    // This will throw if we cannot read the counter, which is what we want.
+    this->reset();
+}
+
+
+/*
+ * trrojan::powercap_sensor::counts_towards_total
+ */
+bool trrojan::powercap_sensor::counts_towards_total(void) const {
+    static const std::string dram("dram");
+    static const std::string package("package-");
+    return (starts_with(this->_domain, package) || (this->_domain == dram));
+}
+
+
+/*
+ * trrojan::powercap_sensor::read_counter
+ */
+trrojan::powercap_sensor::counter_type
+trrojan::powercap_sensor::read_counter(void) const {
+    return detail::read_powercap_counter(combine_path(this->_path,
+        "energy_uj"));
+}
+
+
+/*
+ * trrojan::powercap_sensor::reset
+ */
+void trrojan::powercap_sensor::reset(void) {
+    this->_last_counter = this->read_counter();
+    this->_last_time = clock_type::now();
+    this->_energy = 0;
+}
+
+
+/*
+ * trrojan::powercap_sensor::sample
+ */
+trrojan::powercap_sensor::measurement trrojan::powercap_sensor::sample(void) {
+    const auto counter = this->read_counter();
+    const auto now = clock_type::now();
+    counter_type delta = 0;
+
+    if (counter >= this->_last_counter) {
+        delta = counter - this->_last_counter;
+    } else {
+        // The counter wrapped around at its maximum range. If we do not know
+        // the range, we can only count the part after the overflow.
+        delta = counter;
+        if (this->_max_energy_range > this->_last_counter) {
+            delta += this->_max_energy_range - this->_last_counter;
+        }
+    }
+
+    const auto dt = std::chrono::duration_cast<std::chrono::duration<double>>(
+        now - this->_last_time).count();
+
+    this->_energy += delta;
+    this->_last_counter = counter;
+    this->_last_time = now;
+
+    measurement retval;
+    retval.sensor = this->_name;
+    retval.timestamp = std::chrono::duration_cast<std::chrono::milliseconds>(
+        std::chrono::system_clock::now().time_since_epoch()).count();
+    retval.energy = this->energy();
+    retval.power = (dt > 0.0)
+        ? static_cast<double>(delta) / 1000000.0 / dt
+        : 0.0;
+
+    return retval;
+}
@@ -0,0 +1,101 @@
+﻿// <copyright file="prefetch_gate.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/prefetch_gate.h"
+
+#include <cassert>
+#include <condition_variable>
+#include <mutex>
+#include <stdexcept>
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// The state of the gate shared by all threads.
+    /// </summary>
+    struct prefetch_gate_state {
+        std::size_t active = 0;
+        std::condition_variable cv;
+        std::mutex lock;
+        std::size_t suspended = 0;
+    };
+
+    /// <summary>
+    /// Answer the only instance of the state, which is created on first use
+    /// to avoid depending on the initialisation order of statics.
+    /// </summary>
+    static prefetch_gate_state& get_prefetch_gate_state(void) {
+        static prefetch_gate_state retval;
+        return retval;
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::prefetch_gate::enter
+ */
+void trrojan::prefetch_gate::enter(void) {
+    auto& s = detail::get_prefetch_gate_state();
+    std::unique_lock<std::mutex> l(s.lock);
+    s.cv.wait(l, [&s](void) { return (s.suspended == 0); });
+    ++s.active;
+}
+
+
+/*
+ * trrojan::prefetch_gate::leave
+ */
+void trrojan::prefetch_gate::leave(void) {
+    auto& s = detail::get_prefetch_gate_state();
+    {
+        std::lock_guard<std::mutex> l(s.lock);
+        assert(s.active > 0);
+        --s.active;
+    }
+    s.cv.notify_all();
+}
+
+
+/*
+ * trrojan::prefetch_gate::resume
+ */
+void trrojan::prefetch_gate::resume(void) {
+    auto& s = detail::get_prefetch_gate_state();
+    {
+        std::lock_guard<std::mutex> l(s.lock);
+        if (s.suspended == 0) {
+            throw std::logic_error("The prefetch gate cannot be resumed, "
+                "because it has not been suspended.");
+        }
+        --s.suspended;
+    }
+    s.cv.notify_all();
+}
+
+
+/*
+ * trrojan::prefetch_gate::suspend
+ */
+void trrojan::prefetch_gate::suspend(void) {
+    auto& s = detail::get_prefetch_gate_state();
+    std::unique_lock<std::mutex> l(s.lock);
+    ++s.suspended;
+    s.cv.wait(l, [&s](void) { return (s.active == 0); });
+}
+
+
+/*
+ * trrojan::prefetch_gate::suspended
+ */
+bool trrojan::prefetch_gate::suspended(void) {
+    auto& s = detail::get_prefetch_gate_state();
+    std::lock_guard<std::mutex> l(s.lock);
+    return (s.suspended > 0);
+}
@@ -14,6 +14,7 @@
 #include "trrojan/io.h"
 #include "trrojan/log.h"
 #include "trrojan/text.h"
+#include "trrojan/trace.h"
 
 
 #define _ADD_SPHERE_TYPE(n) \
@@ -56,6 +57,8 @@ std::size_t trrojan::random_sphere_generator::create(void *dst,
         throw std::invalid_argument("The specified buffer is too small.");
     }
 
+    TRROJAN_TRACE_ZONE("random_sphere_generator::create", "data");
+
     const auto avg_sphere_size
         = std::abs(description.sphere_size[1] - description.sphere_size[0])
         * 0.5f + (std::min)(description.sphere_size[0],
@@ -16,6 +16,33 @@
 trrojan::basic_result::~basic_result(void) { }
 
 
+/*
+ * trrojan::basic_result::add_column
+ */
+void trrojan::basic_result::add_column(const std::string& name,
+        const variant& value) {
+    auto it = std::find(this->_result_names.cbegin(),
+        this->_result_names.cend(), name);
+    if (it != this->_result_names.cend()) {
+        throw std::invalid_argument("The given result name already exists.");
+    }
+
+    const auto cntMeasurements = this->measurements();
+    const auto cntValues = this->values_per_measurement();
+
+    result_type results;
+    results.reserve(cntMeasurements * (cntValues + 1));
+    for (size_t m = 0; m < cntMeasurements; ++m) {
+        auto begin = this->_results.cbegin() + m * cntValues;
+        results.insert(results.end(), begin, begin + cntValues);
+        results.push_back(value);
+    }
+
+    this->_result_names.push_back(name);
+    this->_results = std::move(results);
+}
+
+
 /*
  * trrojan::basic_result::check_consistency
  */
@@ -0,0 +1,513 @@
+﻿// <copyright file="result_comparison.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/result_comparison.h"
+
+#include <algorithm>
+#include <cmath>
+#include <cstdlib>
+#include <fstream>
+#include <iomanip>
+#include <iterator>
+#include <limits>
+#include <map>
+#include <random>
+#include <sstream>
+#include <stdexcept>
+
+#include "trrojan/csv_util.h"
+#include "trrojan/log.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// The samples of the metric per configuration.
+    /// </summary>
+    typedef std::map<std::string, std::vector<double>> comparison_samples;
+
+    /// <summary>
+    /// Opens the given result file or throws.
+    /// </summary>
+    static std::ifstream open_comparison_file(const std::string& path) {
+        std::ifstream retval(path, std::ios::binary);
+        if (!retval) {
+            std::stringstream msg;
+            msg << "Failed to open result file \"" << path << "\"."
+                << std::ends;
+            throw std::runtime_error(msg.str());
+        }
+        return retval;
+    }
+
+    /// <summary>
+    /// Reads the next non-empty line of <paramref name="file" /> and splits
+    /// it into its values.
+    /// </summary>
+    static bool read_comparison_line(std::ifstream& file,
+            const std::string& separator, std::vector<std::string>& values) {
+        std::string line;
+
+        while (std::getline(file, line)) {
+            if (!line.empty() && (line.back() == '\r')) {
+                line.pop_back();
+            }
+            if (!line.empty()) {
+                values = split_csv_line(line, separator);
+                return true;
+            }
+        }
+
+        return false;
+    }
+
+    /// <summary>
+    /// Answer the index of the column <paramref name="name" /> or throws.
+    /// </summary>
+    static std::size_t find_comparison_column(
+            const std::vector<std::string>& columns, const std::string& name,
+            const std::string& path) {
+        auto it = std::find(columns.begin(), columns.end(), name);
+        if (it == columns.end()) {
+            std::stringstream msg;
+            msg << "The column \"" << name << "\" does not exist in the result "
+                "file \"" << path << "\"." << std::ends;
+            throw std::runtime_error(msg.str());
+        }
+        return std::distance(columns.begin(), it);
+    }
+
+    /// <summary>
+    /// Reads the samples of <paramref name="metric" /> for all
+    /// configurations in the given file.
+    /// </summary>
+    /// <remarks>
+    /// Only a single line of the file is held in memory at any time. Rows
+    /// with a different number of columns than the header or with a
+    /// non-numeric value of the metric are skipped.
+    /// </remarks>
+    static comparison_samples read_comparison_samples(const std::string& path,
+            const std::string& separator, const std::string& metric,
+            const std::vector<std::string>& factors) {
+        auto file = open_comparison_file(path);
+        std::vector<std::string> values;
+        std::vector<std::size_t> indices;
+        comparison_samples retval;
+        std::size_t skipped = 0;
+
+        if (!read_comparison_line(file, separator, values)) {
+            return retval;
+        }
+
+        const auto columns = values.size();
+        const auto m = find_comparison_column(values, metric, path);
+        for (auto& f : factors) {
+            indices.push_back(find_comparison_column(values, f, path));
+        }
+
+        while (read_comparison_line(file, separator, values)) {
+            if (values.size() != columns) {
+                ++skipped;
+                continue;
+            }
+
+            auto& v = values[m];
+            char *end = nullptr;
+            auto sample = std::strtod(v.c_str(), &end);
+            if (v.empty() || (end != v.c_str() + v.size())
+                    || !std::isfinite(sample)) {
+                ++skipped;
+                continue;
+            }
+
+            std::string key;
+            for (std::size_t i = 0; i < indices.size(); ++i) {
+                if (i > 0) {
+                    key += ", ";
+                }
+                key += factors[i];
+                key += '=';
+                key += values[indices[i]];
+            }
+
+            retval[key].push_back(sample);
+        }
+
+        if (skipped > 0) {
+            log::instance().write_line(log_level::warning, "{0} row(s) of "
+                "\"{1}\" have been skipped, because they are incomplete or do "
+                "not contain a number in the column \"{2}\".", skipped, path,
+                metric);
+        }
+
+        return retval;
+    }
+
+    /// <summary>
+    /// Computes the median of the given samples, which are reordered.
+    /// </summary>
+    static double comparison_median(std::vector<double>& samples) {
+        if (samples.empty()) {
+            return std::numeric_limits<double>::quiet_NaN();
+        }
+
+        const auto h = samples.size() / 2;
+        std::nth_element(samples.begin(), samples.begin() + h, samples.end());
+        auto retval = samples[h];
+
+        if ((samples.size() % 2) == 0) {
+            auto l = *std::max_element(samples.begin(), samples.begin() + h);
+            retval = 0.5 * (l + retval);
+        }
+
+        return retval;
+    }
+
+    /// <summary>
+    /// Computes the two-sided p-value of the Mann-Whitney U test using the
+    /// normal approximation with correction for ties and continuity.
+    /// </summary>
+    static double mann_whitney(const std::vector<double>& lhs,
+            const std::vector<double>& rhs) {
+        std::vector<std::pair<double, bool>> all;
+        all.reserve(lhs.size() + rhs.size());
+        for (auto v : lhs) {
+            all.emplace_back(v, true);
+        }
+        for (auto v : rhs) {
+            all.emplace_back(v, false);
+        }
+        std::sort(all.begin(), all.end());
+
+        // Sum the ranks of the left samples, assigning the average rank to
+        // ties, and accumulate the tie correction.
+        const auto n = static_cast<double>(all.size());
+        double ranks = 0.0;
+        double ties = 0.0;
+        for (std::size_t i = 0; i < all.size();) {
+            auto j = i + 1;
+            while ((j < all.size()) && (all[j].first == all[i].first)) {
+                ++j;
+            }
+
+            const auto t = static_cast<double>(j - i);
+            const auto rank = 0.5 * static_cast<double>(i + j + 1);
+            for (auto k = i; k < j; ++k) {
+                if (all[k].second) {
+                    ranks += rank;
+                }
+            }
+            ties += t * t * t - t;
+            i = j;
+        }
+
+        const auto n1 = static_cast<double>(lhs.size());
+        const auto n2 = static_cast<double>(rhs.size());
+        const auto u = ranks - 0.5 * n1 * (n1 + 1.0);
+        const auto mean = 0.5 * n1 * n2;
+        const auto var = n1 * n2 / 12.0 * ((n + 1.0) - ties / (n * (n - 1.0)));
+
+        if (var <= 0.0) {
+            return 1.0;
+        }
+
+        const auto d = (std::max)(std::abs(u - mean) - 0.5, 0.0);
+        return std::erfc(d / std::sqrt(2.0 * var));
+    }
+
+    /// <summary>
+    /// Computes a percentile bootstrap confidence interval of the relative
+    /// change of the median from <paramref name="lhs" /> to
+    /// <paramref name="rhs" />.
+    /// </summary>
+    static void bootstrap_change(const std::vector<double>& lhs,
+            const std::vector<double>& rhs, const std::size_t resamples,
+            const double significance, std::mt19937& rng,
+            double& out_lower, double& out_upper) {
+        std::uniform_int_distribution<std::size_t> dl(0, lhs.size() - 1);
+        std::uniform_int_distribution<std::size_t> dr(0, rhs.size() - 1);
+        std::vector<double> changes;
+        std::vector<double> l(lhs.size());
+        std::vector<double> r(rhs.size());
+
+        changes.reserve(resamples);
+        for (std::size_t i = 0; i < resamples; ++i) {
+            for (auto& v : l) {
+                v = lhs[dl(rng)];
+            }
+            for (auto& v : r) {
+                v = rhs[dr(rng)];
+            }
+
+            auto ml = comparison_median(l);
+            if (ml != 0.0) {
+                changes.push_back(comparison_median(r) / ml - 1.0);
+            }
+        }
+
+        if (changes.empty()) {
+            out_lower = out_upper = std::numeric_limits<double>::quiet_NaN();
+            return;
+        }
+
+        std::sort(changes.begin(), changes.end());
+        auto at = [&changes](const double q) {
+            auto i = static_cast<std::size_t>(q * (changes.size() - 1) + 0.5);
+            return changes[(std::min)(i, changes.size() - 1)];
+        };
+        out_lower = at(0.5 * significance);
+        out_upper = at(1.0 - 0.5 * significance);
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::result_comparison::default_resamples
+ */
+const std::size_t trrojan::result_comparison::default_resamples = 1000;
+
+
+/*
+ * trrojan::result_comparison::default_significance
+ */
+const double trrojan::result_comparison::default_significance = 0.05;
+
+
+/*
+ * trrojan::result_comparison::default_threshold
+ */
+const double trrojan::result_comparison::default_threshold = 0.05;
+
+
+/*
+ * trrojan::result_comparison::to_string
+ */
+const char *trrojan::result_comparison::to_string(const verdict verdict) {
+    switch (verdict) {
+        case verdict::regression: return "regression";
+        case verdict::improvement: return "improvement";
+        case verdict::unchanged: return "unchanged";
+        default: return "incomparable";
+    }
+}
+
+
+/*
+ * trrojan::result_comparison::write_report
+ */
+void trrojan::result_comparison::write_report(std::ostream& stream,
+        const std::vector<entry>& entries) {
+    std::size_t counts[4] = { 0 };
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+
+    auto percent = [](const double value) {
+        std::stringstream retval;
+        if (std::isnan(value)) {
+            retval << "-";
+        } else {
+            retval << std::showpos << std::fixed << std::setprecision(1)
+                << 100.0 * value << "%";
+        }
+        return retval.str();
+    };
+
+    stream << std::left << std::setw(14) << "Verdict" << std::right
+        << std::setw(9) << "Change"
+        << std::setw(20) << "Confidence"
+        << std::setw(10) << "p"
+        << std::setw(12) << "Samples"
+        << "  " << "Configuration" << std::endl;
+
+    for (auto& e : entries) {
+        ++counts[static_cast<std::size_t>(e.verdict)];
+
+        std::stringstream ci;
+        if (!std::isnan(e.change_lower)) {
+            ci << "[" << percent(e.change_lower) << ", "
+                << percent(e.change_upper) << "]";
+        } else {
+            ci << "-";
+        }
+
+        std::stringstream p;
+        if (!std::isnan(e.p_value)) {
+            p << std::setprecision(3) << e.p_value;
+        } else {
+            p << "-";
+        }
+
+        std::stringstream n;
+        n << e.baseline_samples << "/" << e.current_samples;
+
+        stream << std::left << std::setw(14) << to_string(e.verdict)
+            << std::right
+            << std::setw(9) << percent(e.change)
+            << std::setw(20) << ci.str()
+            << std::setw(10) << p.str()
+            << std::setw(12) << n.str()
+            << "  " << e.configuration << std::endl;
+    }
+
+    stream << std::endl
+        << counts[static_cast<std::size_t>(verdict::regression)]
+        << " regression(s), "
+        << counts[static_cast<std::size_t>(verdict::improvement)]
+        << " improvement(s), "
+        << counts[static_cast<std::size_t>(verdict::unchanged)]
+        << " unchanged, "
+        << counts[static_cast<std::size_t>(verdict::incomparable)]
+        << " incomparable configuration(s)." << std::endl;
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+
+/*
+ * trrojan::result_comparison::result_comparison
+ */
+trrojan::result_comparison::result_comparison(const std::string& metric,
+        const std::string& separator)
+        : _higher_is_better(false), _metric(metric), _separator(separator),
+        _significance(default_significance), _threshold(default_threshold) {
+    if (metric.empty()) {
+        throw std::invalid_argument("The metric to compare must not be "
+            "empty.");
+    }
+    if (separator.empty()) {
+        throw std::invalid_argument("The separator of a CSV file must not be "
+            "empty.");
+    }
+}
+
+
+/*
+ * trrojan::result_comparison::compare
+ */
+std::vector<trrojan::result_comparison::entry>
+trrojan::result_comparison::compare(const std::string& baseline,
+        const std::string& current) const {
+    static const auto nan = std::numeric_limits<double>::quiet_NaN();
+    std::vector<entry> retval;
+
+    // The header of a result file does not tell the configuration from the
+    // results, so we cannot guess the factors without risking to join on
+    // measured values, which would make every row its own configuration.
+    if (this->_factors.empty()) {
+        throw std::invalid_argument("The factors to join the results on must "
+            "be specified.");
+    }
+
+    auto bs = detail::read_comparison_samples(baseline, this->_separator,
+        this->_metric, this->_factors);
+    auto cs = detail::read_comparison_samples(current, this->_separator,
+        this->_metric, this->_factors);
+
+    // The generator is seeded with a constant such that the report is
+    // reproducible.
+    std::mt19937 rng(1);
+
+    auto add = [&](const std::string& key, std::vector<double> *b,
+            std::vector<double> *c) {
+        entry e;
+        e.configuration = key;
+        e.baseline_samples = (b != nullptr) ? b->size() : 0;
+        e.current_samples = (c != nullptr) ? c->size() : 0;
+        e.baseline = (b != nullptr) ? detail::comparison_median(*b) : nan;
+        e.current = (c != nullptr) ? detail::comparison_median(*c) : nan;
+        e.change = (e.baseline != 0.0) ? e.current / e.baseline - 1.0 : nan;
+        e.change_lower = e.change_upper = nan;
+        e.p_value = nan;
+        e.verdict = verdict::incomparable;
+
+        if ((e.baseline_samples > 1) && (e.current_samples > 1)) {
+            e.p_value = detail::mann_whitney(*b, *c);
+            detail::bootstrap_change(*b, *c, default_resamples,
+                this->_significance, rng, e.change_lower, e.change_upper);
+
+            if (std::isnan(e.change)) {
+                e.verdict = verdict::incomparable;
+            } else if ((e.p_value < this->_significance)
+                    && (std::abs(e.change) >= this->_threshold)) {
+                auto worse = this->_higher_is_better
+                    ? (e.change < 0.0)
+                    : (e.change > 0.0);
+                e.verdict = worse ? verdict::regression : verdict::improvement;
+            } else {
+                e.verdict = verdict::unchanged;
+            }
+        }
+
+        retval.push_back(std::move(e));
+    };
+
+    for (auto& b : bs) {
+        auto c = cs.find(b.first);
+        add(b.first, &b.second, (c != cs.end()) ? &c->second : nullptr);
+    }
+    for (auto& c : cs) {
+        if (bs.find(c.first) == bs.end()) {
+            add(c.first, nullptr, &c.second);
+        }
+    }
+
+    // If no configuration could be tested, the factors most likely include
+    // a column that differs between repetitions of the same configuration.
+    const auto isTestable = [](const entry& e) {
+        return ((e.baseline_samples > 1) && (e.current_samples > 1));
+    };
+    if (!retval.empty() && std::none_of(retval.begin(), retval.end(),
+            isTestable)) {
+        std::stringstream msg;
+        msg << "None of the " << retval.size() << " configuration(s) has more "
+            "than one sample of \"" << this->_metric << "\" in both files. "
+            "Make sure that the factors do not include any result column "
+            "and that the benchmarks have been repeated." << std::ends;
+        throw std::runtime_error(msg.str());
+    }
+
+    std::stable_sort(retval.begin(), retval.end(),
+            [](const entry& l, const entry& r) {
+        if (l.verdict != r.verdict) {
+            return (l.verdict < r.verdict);
+        }
+        auto lc = std::isnan(l.change) ? -1.0 : std::abs(l.change);
+        auto rc = std::isnan(r.change) ? -1.0 : std::abs(r.change);
+        return (lc > rc);
+    });
+
+    return retval;
+}
+
+
+/*
+ * trrojan::result_comparison::significance
+ */
+void trrojan::result_comparison::significance(const double significance) {
+    if (!(significance > 0.0) || !(significance < 1.0)) {
+        throw std::invalid_argument("The significance level must be within "
+            "(0, 1).");
+    }
+
+    this->_significance = significance;
+}
+
+
+/*
+ * trrojan::result_comparison::threshold
+ */
+void trrojan::result_comparison::threshold(const double threshold) {
+    if (!(threshold >= 0.0)) {
+        throw std::invalid_argument("The threshold of relative changes must "
+            "not be negative.");
+    }
+
+    this->_threshold = threshold;
+}
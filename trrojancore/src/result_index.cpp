@@ -0,0 +1,110 @@
+﻿// <copyright file="result_index.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/result_index.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+#include <sstream>
+#include <stdexcept>
+
+#include "trrojan/csv_util.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// The character separating the values in a key, which is the ASCII
+    /// unit separator that is not expected in any factor.
+    /// </summary>
+    static const char key_separator = '\x1f';
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::result_index::from_csv
+ */
+trrojan::result_index trrojan::result_index::from_csv(const std::string& path,
+        const std::string& separator) {
+    if (separator.empty()) {
+        throw std::invalid_argument("The separator of a CSV file must not be "
+            "empty.");
+    }
+
+    result_index retval;
+    std::ifstream file(path, std::ios::binary);
+    std::string line;
+
+    while (std::getline(file, line)) {
+        if (!line.empty() && (line.back() == '\r')) {
+            line.pop_back();
+        }
+        if (line.empty()) {
+            continue;
+        }
+
+        auto values = split_csv_line(line, separator);
+        if (retval._columns.empty()) {
+            retval._columns = std::move(values);
+        } else if (values.size() == retval._columns.size()) {
+            retval._rows.push_back(std::move(values));
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::result_index::key
+ */
+std::string trrojan::result_index::key(const configuration& config,
+        const std::vector<std::string>& factors) {
+    std::stringstream retval;
+
+    for (auto& f : factors) {
+        auto it = config.find(f);
+        if (it != config.end()) {
+            print_csv_value(retval, it->value(), false);
+        }
+        retval << detail::key_separator;
+    }
+
+    return retval.str();
+}
+
+
+/*
+ * trrojan::result_index::keys
+ */
+trrojan::result_index::key_set trrojan::result_index::keys(
+        const std::vector<std::string>& factors) const {
+    std::vector<std::size_t> columns;
+    key_set retval;
+
+    for (auto& f : factors) {
+        auto it = std::find(this->_columns.begin(), this->_columns.end(), f);
+        if (it == this->_columns.end()) {
+            return retval;
+        }
+        columns.push_back(std::distance(this->_columns.begin(), it));
+    }
+
+    for (auto& r : this->_rows) {
+        std::string key;
+        for (auto c : columns) {
+            key += r[c];
+            key += detail::key_separator;
+        }
+        retval.insert(std::move(key));
+    }
+
+    return retval;
+}
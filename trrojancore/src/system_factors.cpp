@@ -7,8 +7,11 @@
 
 #include "trrojan/system_factors.h"
 
+#include <algorithm>
 #include <cerrno>
+#include <chrono>
 #include <cinttypes>
+#include <cstddef>
 #include <ctime>
 #include <fstream>
 #include <iterator>
@@ -81,7 +84,9 @@ static_cast<GAMING_DEVICE_DEVICE_ID>(0xDE8A5661)
 
 #include "trrojan/io.h"
 #include "trrojan/log.h"
+#include "trrojan/system_topology.h"
 #include "trrojan/text.h"
+#include "trrojan/timer.h"
 
 
 /// <summary>
@@ -95,6 +100,149 @@ static std::unordered_map<std::string, trrojan::system_factors::retriever_type>
 retrievers;
 
 
+/// <summary>
+/// The path to the file where the snapshot of the static factors is cached.
+/// </summary>
+static std::string cache_file_path;
+
+
+/// <summary>
+/// The first line of a cache file, which identifies its format.
+/// </summary>
+static const std::string cache_file_magic("trrojan-system-factors 1");
+
+
+/// <summary>
+/// Answer the ID of the current boot of the system, which is used to determine
+/// whether a cache file is still valid, or an empty string if the boot cannot
+/// be identified.
+/// </summary>
+static std::string get_boot_id(void) {
+#if defined(_WIN32)
+    return std::string();
+#else /* defined(_WIN32) */
+    try {
+        return trrojan::trim(trrojan::read_text_file(
+            "/proc/sys/kernel/random/boot_id"));
+    } catch (...) {
+        return std::string();
+    }
+#endif /* defined(_WIN32) */
+}
+
+
+/// <summary>
+/// Loads the snapshot from the given cache file if it has been written during
+/// the current boot and contains exactly the given factors in this order.
+/// </summary>
+static bool load_snapshot(std::vector<trrojan::named_variant>& dst,
+        const std::string& path, const std::string& bootId,
+        const std::vector<std::string>& factors) {
+    using namespace trrojan;
+    std::ifstream file(path, std::ios::in);
+    std::string line;
+
+    if (!file || !std::getline(file, line) || (line != ::cache_file_magic)) {
+        return false;
+    }
+    if (!std::getline(file, line) || (line != bootId)) {
+        log::instance().write_line(log_level::verbose, "The system factors in "
+            "\"{0}\" have been cached during a different boot.", path);
+        return false;
+    }
+
+    // The factors are stored as "name\ttype\tvalue".
+    while (std::getline(file, line)) {
+        auto t1 = line.find('\t');
+        auto t2 = line.find('\t', t1 + 1);
+        if ((t1 == std::string::npos) || (t2 == std::string::npos)) {
+            return false;
+        }
+
+        auto name = line.substr(0, t1);
+        auto type = line.substr(t1 + 1, t2 - t1 - 1);
+        auto value = line.substr(t2 + 1);
+
+        if (type == "empty") {
+            dst.emplace_back(name, variant());
+        } else if (type == variant_type_traits<variant_type::boolean>::name()) {
+            dst.emplace_back(name, variant(value == "1"));
+        } else if (type == variant_type_traits<variant_type::uint32>::name()) {
+            dst.emplace_back(name, variant(static_cast<std::uint32_t>(
+                std::stoul(value))));
+        } else if (type == variant_type_traits<variant_type::uint64>::name()) {
+            dst.emplace_back(name, variant(static_cast<std::uint64_t>(
+                std::stoull(value))));
+        } else if (type == variant_type_traits<variant_type::string>::name()) {
+            dst.emplace_back(name, variant(value));
+        } else {
+            return false;
+        }
+    }
+
+    // Discard the cache if it has been written by a different version that
+    // supported other factors or ordered them differently.
+    std::vector<std::string> names;
+    std::transform(dst.begin(), dst.end(), std::back_inserter(names),
+        [](const named_variant& v) { return v.name(); });
+    return (names == factors);
+}
+
+
+/// <summary>
+/// Writes the snapshot to the given cache file.
+/// </summary>
+static bool save_snapshot(const std::string& path, const std::string& bootId,
+        const std::vector<trrojan::named_variant>& snapshot) {
+    using namespace trrojan;
+    std::stringstream content;
+    content << ::cache_file_magic << "\n" << bootId << "\n";
+
+    for (auto& f : snapshot) {
+        auto& v = f.value();
+        content << f.name() << "\t";
+
+        switch (v.type()) {
+            case variant_type::empty:
+                content << "empty\t";
+                break;
+
+            case variant_type::boolean:
+                content << variant_type_traits<variant_type::boolean>::name()
+                    << "\t" << (v.get<bool>() ? 1 : 0);
+                break;
+
+            case variant_type::uint32:
+                content << variant_type_traits<variant_type::uint32>::name()
+                    << "\t" << v.get<std::uint32_t>();
+                break;
+
+            case variant_type::uint64:
+                content << variant_type_traits<variant_type::uint64>::name()
+                    << "\t" << v.get<std::uint64_t>();
+                break;
+
+            case variant_type::string: {
+                auto& s = v.get<std::string>();
+                if (s.find_first_of("\t\r\n") != std::string::npos) {
+                    return false;
+                }
+                content << variant_type_traits<variant_type::string>::name()
+                    << "\t" << s;
+                } break;
+
+            default:
+                return false;
+        }
+
+        content << "\n";
+    }
+
+    std::ofstream file(path, std::ios::out | std::ios::trunc);
+    return static_cast<bool>(file << content.str());
+}
+
+
 /// <summary>
 /// Registers a system factor for retrieval by name.
 /// </summary>
@@ -105,6 +253,21 @@ static const std::string& register_retriever(const std::string& name,
 }
 
 
+/*
+ * trrojan::system_factors::is_dynamic_factor
+ */
+bool trrojan::system_factors::is_dynamic_factor(const std::string& factor) {
+    // Note: the installed memory is dynamic, because the Linux implementation
+    // reports the free memory. The properties of the timer depend on the
+    // source selected for the process and must therefore not be cached.
+    return ((factor == factor_installed_memory)
+        || (factor == factor_timer_overhead)
+        || (factor == factor_timer_resolution)
+        || (factor == factor_timer_source)
+        || (factor == factor_timestamp));
+}
+
+
 /*
  * trrojan::system_factors::is_system_factor
  */
@@ -125,21 +288,37 @@ const std::string trrojan::system_factors::factor_##n                          \
 = ::register_retriever(#n, &system_factors::n)
 
 __TRROJAN_DEFINE_FACTOR(bios);
+__TRROJAN_DEFINE_FACTOR(cache_l1);
+__TRROJAN_DEFINE_FACTOR(cache_l2);
+__TRROJAN_DEFINE_FACTOR(cache_l3);
 __TRROJAN_DEFINE_FACTOR(computer_name);
 __TRROJAN_DEFINE_FACTOR(cpu);
+__TRROJAN_DEFINE_FACTOR(cpu_governor);
+__TRROJAN_DEFINE_FACTOR(cpu_packages);
+__TRROJAN_DEFINE_FACTOR(cpu_turbo);
 __TRROJAN_DEFINE_FACTOR(debug_build);
 __TRROJAN_DEFINE_FACTOR(gaming_device);
+__TRROJAN_DEFINE_FACTOR(huge_pages);
 __TRROJAN_DEFINE_FACTOR(installed_memory);
 __TRROJAN_DEFINE_FACTOR(logical_cores);
 __TRROJAN_DEFINE_FACTOR(mainboard);
+__TRROJAN_DEFINE_FACTOR(numa_distances);
+__TRROJAN_DEFINE_FACTOR(numa_nodes);
 __TRROJAN_DEFINE_FACTOR(os);
 __TRROJAN_DEFINE_FACTOR(os_version);
+__TRROJAN_DEFINE_FACTOR(physical_cores);
 __TRROJAN_DEFINE_FACTOR(process_elevated);
 __TRROJAN_DEFINE_FACTOR(ram);
+__TRROJAN_DEFINE_FACTOR(ram_speed);
+__TRROJAN_DEFINE_FACTOR(smt_threads);
 __TRROJAN_DEFINE_FACTOR(system_desc);
 __TRROJAN_DEFINE_FACTOR(tdr_delay);
 __TRROJAN_DEFINE_FACTOR(tdr_level);
+__TRROJAN_DEFINE_FACTOR(timer_overhead);
+__TRROJAN_DEFINE_FACTOR(timer_resolution);
+__TRROJAN_DEFINE_FACTOR(timer_source);
 __TRROJAN_DEFINE_FACTOR(timestamp);
+__TRROJAN_DEFINE_FACTOR(transparent_huge_pages);
 __TRROJAN_DEFINE_FACTOR(user_name);
 
 #undef __TRROJAN_DEFINE_FACTOR
@@ -152,6 +331,7 @@ trrojan::variant trrojan::system_factors::bios(void) const {
 #if !defined(TRROJAN_FOR_UWP)
     typedef sysinfo::smbios_information::bios_information_type entry_type;
     std::vector<const entry_type *> entries;
+    this->probe();
     smbios.entries_by_type<entry_type>(std::back_inserter(entries));
 
     if (entries.empty()) {
@@ -175,6 +355,30 @@ trrojan::variant trrojan::system_factors::bios(void) const {
 }
 
 
+/*
+ * trrojan::system_factors::cache_l1
+ */
+trrojan::variant trrojan::system_factors::cache_l1(void) const {
+    return system_topology::instance().cache_size(1);
+}
+
+
+/*
+ * trrojan::system_factors::cache_l2
+ */
+trrojan::variant trrojan::system_factors::cache_l2(void) const {
+    return system_topology::instance().cache_size(2);
+}
+
+
+/*
+ * trrojan::system_factors::cache_l3
+ */
+trrojan::variant trrojan::system_factors::cache_l3(void) const {
+    return system_topology::instance().cache_size(3);
+}
+
+
 /*
 * trrojan::system_factors::computer_name
 */
@@ -236,6 +440,7 @@ trrojan::variant trrojan::system_factors::cpu(void) const {
 #else /* defined(TRROJAN_FOR_UWP) */
     typedef sysinfo::smbios_information::processor_information_type entry_type;
     std::vector<const entry_type *> entries;
+    this->probe();
     smbios.entries_by_type<entry_type>(std::back_inserter(entries));
 
     if (entries.empty()) {
@@ -310,6 +515,35 @@ trrojan::variant trrojan::system_factors::cpu(void) const {
 }
 
 
+/*
+ * trrojan::system_factors::cpu_governor
+ */
+trrojan::variant trrojan::system_factors::cpu_governor(void) const {
+    auto& retval = system_topology::instance().governor();
+    return retval.empty() ? variant() : variant(retval);
+}
+
+
+/*
+ * trrojan::system_factors::cpu_packages
+ */
+trrojan::variant trrojan::system_factors::cpu_packages(void) const {
+    return system_topology::instance().packages();
+}
+
+
+/*
+ * trrojan::system_factors::cpu_turbo
+ */
+trrojan::variant trrojan::system_factors::cpu_turbo(void) const {
+    switch (system_topology::instance().turbo()) {
+        case system_topology::turbo_state::enabled: return true;
+        case system_topology::turbo_state::disabled: return false;
+        default: return variant();
+    }
+}
+
+
 /*
  * trrojan::system_factors::debug_build
  */
@@ -365,11 +599,38 @@ trrojan::variant trrojan::system_factors::gaming_device(void) const {
  */
 trrojan::variant trrojan::system_factors::get(const std::string& factor) const {
     auto it = ::retrievers.find(factor);
-    if (it != ::retrievers.end()) {
-        return (this->*(it->second))();
-    } else {
+    if (it == ::retrievers.end()) {
         return variant();
     }
+
+    if (!system_factors::is_dynamic_factor(factor)) {
+        auto snapshot = this->snapshot();
+        auto jt = std::find_if(snapshot->begin(), snapshot->end(),
+            [&factor](const named_variant& v) { return (v.name() == factor); });
+        if (jt != snapshot->end()) {
+            return jt->value();
+        }
+    }
+
+    return (this->*(it->second))();
+}
+
+
+/*
+ * trrojan::system_factors::huge_pages
+ */
+trrojan::variant trrojan::system_factors::huge_pages(void) const {
+    auto& topology = system_topology::instance();
+
+    if (topology.huge_page_size() == 0) {
+        return variant();
+    }
+
+    std::stringstream value;
+    value << topology.huge_pages_free() << "/"
+        << topology.huge_pages_total() << " x "
+        << topology.huge_page_size();
+    return variant(value.str());
 }
 
 
@@ -433,6 +694,7 @@ trrojan::variant trrojan::system_factors::mainboard(void) const {
 #if !defined(TRROJAN_FOR_UWP)
     typedef sysinfo::smbios_information::baseboard_information_type entry_type;
     std::vector<const entry_type *> entries;
+    this->probe();
     smbios.entries_by_type<entry_type>(std::back_inserter(entries));
 
     if (entries.empty()) {
@@ -456,6 +718,42 @@ trrojan::variant trrojan::system_factors::mainboard(void) const {
 }
 
 
+/*
+ * trrojan::system_factors::numa_distances
+ */
+trrojan::variant trrojan::system_factors::numa_distances(void) const {
+    bool isFirst = true;
+    std::stringstream value;
+
+    // The distance matrix is formatted row by row like "10 21; 21 10".
+    for (auto& n : system_topology::instance().nodes()) {
+        if (isFirst) {
+            isFirst = false;
+        } else {
+            value << "; ";
+        }
+
+        for (std::size_t i = 0; i < n.distances.size(); ++i) {
+            if (i > 0) {
+                value << " ";
+            }
+            value << n.distances[i];
+        }
+    }
+
+    return variant(value.str());
+}
+
+
+/*
+ * trrojan::system_factors::numa_nodes
+ */
+trrojan::variant trrojan::system_factors::numa_nodes(void) const {
+    return static_cast<std::uint32_t>(
+        system_topology::instance().nodes().size());
+}
+
+
 /*
  * trrojan::system_factors::os
  */
@@ -466,6 +764,7 @@ trrojan::variant trrojan::system_factors::os(void) const {
     return winrt::to_string(versionInfo.DeviceFamily());
 
 #else /* defined(TRROJAN_FOR_UWP) */
+    this->probe();
     return std::string(this->osinfo.name());
 #endif /*  defined(TRROJAN_FOR_UWP) */
 }
@@ -491,11 +790,20 @@ trrojan::variant trrojan::system_factors::os_version(void) const {
     return winrt::to_string(buff);
 
 #else /* defined(TRROJAN_FOR_UWP) */
+    this->probe();
     return std::string(this->osinfo.version());
 #endif /* defined(TRROJAN_FOR_UWP) */
 }
 
 
+/*
+ * trrojan::system_factors::physical_cores
+ */
+trrojan::variant trrojan::system_factors::physical_cores(void) const {
+    return system_topology::instance().physical_cores();
+}
+
+
 /*
  * trrojan::system_factors::process_elevated
  */
@@ -552,6 +860,7 @@ trrojan::variant trrojan::system_factors::ram(void) const {
 #else /* defined(TRROJAN_FOR_UWP) */
     typedef sysinfo::smbios_information::memory_device_type entry_type;
     std::vector<const entry_type *> entries;
+    this->probe();
     smbios.entries_by_type<entry_type>(std::back_inserter(entries));
 
     if (entries.empty()) {
@@ -598,6 +907,117 @@ trrojan::variant trrojan::system_factors::ram(void) const {
 }
 
 
+/*
+ * trrojan::system_factors::ram_speed
+ */
+trrojan::variant trrojan::system_factors::ram_speed(void) const {
+#if defined(TRROJAN_FOR_UWP)
+    return variant();
+#else /* defined(TRROJAN_FOR_UWP) */
+    typedef sysinfo::smbios_information::memory_device_type entry_type;
+    std::vector<const entry_type *> entries;
+    this->probe();
+    smbios.entries_by_type<entry_type>(std::back_inserter(entries));
+    std::uint32_t retval = 0;
+
+    // Report the slowest module, because it determines the speed of the
+    // whole memory system. The configured speed was added in SMBIOS 2.7,
+    // wherefore we fall back to the maximum speed of the module.
+    for (auto e : entries) {
+        if (e->size != 0) {
+            std::uint32_t speed = e->speed;
+            if ((e->header.length >= offsetof(entry_type,
+                    configured_memory_clock_speed) + sizeof(std::uint16_t))
+                    && (e->configured_memory_clock_speed != 0)) {
+                speed = e->configured_memory_clock_speed;
+            }
+
+            if ((speed != 0) && ((retval == 0) || (speed < retval))) {
+                retval = speed;
+            }
+        }
+    }
+
+    return (retval != 0) ? variant(retval) : variant();
+#endif /* defined(TRROJAN_FOR_UWP) */
+}
+
+
+/*
+ * trrojan::system_factors::smt_threads
+ */
+trrojan::variant trrojan::system_factors::smt_threads(void) const {
+    return system_topology::instance().smt_threads();
+}
+
+
+/*
+ * trrojan::system_factors::snapshot
+ */
+trrojan::system_factors::snapshot_type
+trrojan::system_factors::snapshot(void) const {
+    std::call_once(this->snapshot_once, [this](void) {
+        const auto begin = std::chrono::high_resolution_clock::now();
+        const auto bootId = ::get_boot_id();
+        auto factors = std::make_shared<std::vector<named_variant>>();
+
+        // Keep the order of the retrievers, which is the order the factors
+        // have been written in before the snapshot was introduced, such that
+        // results can still be appended to existing files.
+        std::vector<std::string> names;
+        for (auto& r : ::retrievers) {
+            if (!system_factors::is_dynamic_factor(r.first)) {
+                names.push_back(r.first);
+            }
+        }
+
+        auto isCached = false;
+        if (!::cache_file_path.empty() && !bootId.empty()) {
+            try {
+                isCached = ::load_snapshot(*factors, ::cache_file_path,
+                    bootId, names);
+            } catch (std::exception& ex) {
+                log::instance().write_line(log_level::verbose, "The cached "
+                    "system factors in \"{0}\" could not be read: {1}",
+                    ::cache_file_path, ex.what());
+                isCached = false;
+            }
+        }
+
+        if (!isCached) {
+            factors->clear();
+            factors->reserve(names.size());
+            for (auto& n : names) {
+                factors->emplace_back(n, (this->*(::retrievers[n]))());
+            }
+
+            if (!::cache_file_path.empty()) {
+                if (bootId.empty()) {
+                    log::instance().write_line(log_level::warning, "The "
+                        "system factors cannot be cached, because the boot "
+                        "of the system cannot be identified.");
+                } else if (!::save_snapshot(::cache_file_path, bootId,
+                        *factors)) {
+                    log::instance().write_line(log_level::warning, "The "
+                        "system factors could not be cached in \"{0}\".",
+                        ::cache_file_path);
+                }
+            }
+        }
+
+        const auto end = std::chrono::high_resolution_clock::now();
+        log::instance().write_line(log_level::verbose, "{0} {1} static system "
+            "factor(s) in {2} ms.", isCached ? "Loaded" : "Captured",
+            factors->size(), std::chrono::duration_cast<
+            std::chrono::milliseconds>(end - begin).count());
+
+        this->snapshot_data = std::move(factors);
+    });
+
+    return this->snapshot_data;
+}
+
+
 /*
  * trrojan::system_factors::system_desc
  */
@@ -610,6 +1030,7 @@ trrojan::variant trrojan::system_factors::system_desc(void) const {
 #else /* defined(TRROJAN_FOR_UWP) */
     typedef sysinfo::smbios_information::system_information_type entry_type;
     std::vector<const entry_type *> entries;
+    this->probe();
     smbios.entries_by_type<entry_type>(std::back_inserter(entries));
 
     if (entries.empty()) {
@@ -629,6 +1050,30 @@ trrojan::variant trrojan::system_factors::system_desc(void) const {
 }
 
 
+/*
+ * trrojan::system_factors::timer_overhead
+ */
+trrojan::variant trrojan::system_factors::timer_overhead(void) const {
+    return timer::overhead();
+}
+
+
+/*
+ * trrojan::system_factors::timer_resolution
+ */
+trrojan::variant trrojan::system_factors::timer_resolution(void) const {
+    return timer::resolution();
+}
+
+
+/*
+ * trrojan::system_factors::timer_source
+ */
+trrojan::variant trrojan::system_factors::timer_source(void) const {
+    return std::string(timer::to_string(timer::source()));
+}
+
+
 /*
  * trrojan::system_factors::timestamp
  */
@@ -637,6 +1082,15 @@ trrojan::variant trrojan::system_factors::timestamp(void) const {
 }
 
 
+/*
+ * trrojan::system_factors::transparent_huge_pages
+ */
+trrojan::variant trrojan::system_factors::transparent_huge_pages(void) const {
+    auto& retval = system_topology::instance().transparent_huge_pages();
+    return retval.empty() ? variant() : variant(retval);
+}
+
+
 /*
  * trrojan::system_factors::user_name
  */
@@ -789,25 +1243,42 @@ trrojan::system_factors::get_retrievers(void) {
 }
 
 
+/*
+ * trrojan::system_factors::use_cache_file
+ */
+void trrojan::system_factors::use_cache_file(const std::string& path) {
+    ::cache_file_path = path;
+}
+
+
 /*
  * trrojan::system_factors::system_factors
  */
-trrojan::system_factors::system_factors(void) {
+trrojan::system_factors::system_factors(void) { }
+
+
+/*
+ * trrojan::system_factors::probe
+ */
+void trrojan::system_factors::probe(void) const {
 #if !defined(TRROJAN_FOR_UWP)
-    try {
-        this->hwinfo = sysinfo::hardware_info::collect();
-    } catch (std::exception ex) {
-        log::instance().write(log_level::warning, ex);
-    }
-    try {
-        this->osinfo = sysinfo::os_info::collect();
-    } catch (std::exception ex) {
-        log::instance().write(log_level::warning, ex);
-    }
-    try {
-        this->smbios = sysinfo::smbios_information::read();
-    } catch (std::exception ex) {
-        log::instance().write(log_level::warning, ex);
-    }
+    std::call_once(this->probe_once, [this](void) {
+        try {
+            this->hwinfo = sysinfo::hardware_info::collect();
+        } catch (std::exception ex) {
+            log::instance().write(log_level::warning, ex);
+        }
+        try {
+            this->osinfo = sysinfo::os_info::collect();
+        } catch (std::exception ex) {
+            log::instance().write(log_level::warning, ex);
+        }
+        try {
+            this->smbios = sysinfo::smbios_information::read();
+        } catch (std::exception ex) {
+            log::instance().write(log_level::warning, ex);
+        }
+    });
 #endif /* !defined(TRROJAN_FOR_UWP) */
 }
+
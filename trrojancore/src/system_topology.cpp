@@ -0,0 +1,577 @@
+﻿// <copyright file="system_topology.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/system_topology.h"
+
+#include <algorithm>
+#include <cctype>
+#include <fstream>
+#include <iterator>
+#include <map>
+#include <set>
+#include <sstream>
+#include <thread>
+#include <tuple>
+
+#include "trrojan/io.h"
+#include "trrojan/log.h"
+#include "trrojan/text.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// Answer whether <paramref name="name" /> has the form of
+    /// <paramref name="prefix" /> followed by a decimal number, which is how
+    /// the processors and NUMA nodes are named in sysfs.
+    /// </summary>
+    static bool is_numbered_entry(const std::string& name,
+            const std::string& prefix) {
+        return (starts_with(name, prefix)
+            && (name.size() > prefix.size())
+            && std::all_of(name.begin() + prefix.size(), name.end(),
+                [](const char c) { return (std::isdigit(c) != 0); }));
+    }
+
+    /// <summary>
+    /// Parses a list of processors like &quot;0-3,8-11&quot; as used in
+    /// sysfs.
+    /// </summary>
+    static system_topology::processor_list parse_processor_list(
+            const std::string& list) {
+        system_topology::processor_list retval;
+        std::istringstream is(list);
+        std::string range;
+
+        while (std::getline(is, range, ',')) {
+            range = trim(range);
+            if (range.empty()) {
+                continue;
+            }
+
+            auto dash = range.find('-');
+            auto begin = std::stoul(range.substr(0, dash));
+            auto end = (dash != std::string::npos)
+                ? std::stoul(range.substr(dash + 1))
+                : begin;
+            for (auto i = begin; i <= end; ++i) {
+                retval.push_back(static_cast<
+                    system_topology::processor_id_type>(i));
+            }
+        }
+
+        return retval;
+    }
+
+    /// <summary>
+    /// Parses a size like &quot;32K&quot; or &quot;1024 kB&quot; as used in
+    /// sysfs and procfs.
+    /// </summary>
+    static system_topology::size_type parse_size(const std::string& str) {
+        std::size_t end = 0;
+        system_topology::size_type retval = std::stoull(str, &end);
+
+        auto unit = trim(str.substr(end));
+        if (!unit.empty()) {
+            switch (std::toupper(unit.front())) {
+                case 'K': retval <<= 10; break;
+                case 'M': retval <<= 20; break;
+                case 'G': retval <<= 30; break;
+                default: break;
+            }
+        }
+
+        return retval;
+    }
+
+    /// <summary>
+    /// Reads a sysfs attribute and removes the trailing line break.
+    /// </summary>
+    static std::string read_topology_attribute(const std::string& path) {
+        return trim(read_text_file(path));
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::system_topology::instance
+ */
+const trrojan::system_topology& trrojan::system_topology::instance(void) {
+    static const system_topology instance;
+    return instance;
+}
+
+
+/*
+ * trrojan::system_topology::system_topology
+ */
+trrojan::system_topology::system_topology(void)
+        : _huge_page_size(0), _huge_pages_free(0), _huge_pages_total(0),
+        _turbo(turbo_state::unknown) {
+    this->discover_processors();
+    this->discover_caches();
+    this->discover_nodes();
+    this->discover_memory();
+
+    log::instance().write_line(log_level::verbose, "The system has {0} "
+        "package(s) with {1} physical core(s), {2} logical processor(s), "
+        "{3} NUMA node(s) and {4} cache instance(s).", this->packages(),
+        this->physical_cores(), this->logical_cores(), this->_nodes.size(),
+        this->_caches.size());
+}
+
+
+/*
+ * trrojan::system_topology::cache_size
+ */
+trrojan::system_topology::size_type trrojan::system_topology::cache_size(
+        const std::uint32_t level) const {
+    auto it = std::find_if(this->_caches.begin(), this->_caches.end(),
+        [level](const cache& c) {
+            return ((c.level == level) && (c.type != "Instruction"));
+        });
+    return (it != this->_caches.end()) ? it->size : 0;
+}
+
+
+/*
+ * trrojan::system_topology::last_level_cache
+ */
+std::uint32_t trrojan::system_topology::last_level_cache(void) const {
+    std::uint32_t retval = 0;
+
+    for (auto& c : this->_caches) {
+        if ((c.type != "Instruction") && (c.level > retval)) {
+            retval = c.level;
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::system_topology::packages
+ */
+std::uint32_t trrojan::system_topology::packages(void) const {
+    std::set<std::uint32_t> packages;
+    for (auto& p : this->_processors) {
+        packages.insert(p.package);
+    }
+    return static_cast<std::uint32_t>(packages.size());
+}
+
+
+/*
+ * trrojan::system_topology::physical_cores
+ */
+std::uint32_t trrojan::system_topology::physical_cores(void) const {
+    // The core ID is only unique within a die on multi-die packages.
+    std::set<std::tuple<std::uint32_t, std::uint32_t, std::uint32_t>> cores;
+    for (auto& p : this->_processors) {
+        cores.emplace(p.package, p.die, p.core);
+    }
+    return static_cast<std::uint32_t>(cores.size());
+}
+
+
+/*
+ * trrojan::system_topology::placement
+ */
+trrojan::system_topology::processor_list
+trrojan::system_topology::placement(void) const {
+    typedef std::tuple<std::uint32_t, std::uint32_t, std::uint32_t> core_type;
+    std::map<std::uint32_t, std::vector<core_type>> packages;
+    std::map<core_type, processor_list> cores;
+    processor_list retval;
+
+    for (auto& p : this->_processors) {
+        core_type core(p.package, p.die, p.core);
+        auto& siblings = cores[core];
+        if (siblings.empty()) {
+            packages[p.package].push_back(core);
+        }
+        siblings.push_back(p.id);
+    }
+
+    // Interleave the physical cores of all packages such that consecutive
+    // ranks are distributed among the packages.
+    std::vector<core_type> order;
+    order.reserve(cores.size());
+    for (std::size_t i = 0; order.size() < cores.size(); ++i) {
+        for (auto& p : packages) {
+            if (i < p.second.size()) {
+                order.push_back(p.second[i]);
+            }
+        }
+    }
+
+    // Use the first hardware thread of all cores before using their SMT
+    // siblings.
+    retval.reserve(this->_processors.size());
+    for (std::size_t i = 0; retval.size() < this->_processors.size(); ++i) {
+        for (auto& c : order) {
+            auto& siblings = cores[c];
+            if (i < siblings.size()) {
+                retval.push_back(siblings[i]);
+            }
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::system_topology::shares_cache
+ */
+bool trrojan::system_topology::shares_cache(const std::uint32_t level,
+        const processor_id_type first,
+        const processor_id_type second) const {
+    return std::any_of(this->_caches.begin(), this->_caches.end(),
+        [&](const cache& c) {
+            auto& p = c.processors;
+            return ((c.level == level) && (c.type != "Instruction")
+                && (std::find(p.begin(), p.end(), first) != p.end())
+                && (std::find(p.begin(), p.end(), second) != p.end()));
+        });
+}
+
+
+/*
+ * trrojan::system_topology::smt_threads
+ */
+std::uint32_t trrojan::system_topology::smt_threads(void) const {
+    std::size_t retval = 1;
+    for (auto& p : this->_processors) {
+        retval = (std::max)(retval, p.siblings.size());
+    }
+    return static_cast<std::uint32_t>(retval);
+}
+
+
+/*
+ * trrojan::system_topology::total_cache_size
+ */
+trrojan::system_topology::size_type
+trrojan::system_topology::total_cache_size(const std::uint32_t level) const {
+    size_type retval = 0;
+
+    for (auto& c : this->_caches) {
+        if ((c.level == level) && (c.type != "Instruction")) {
+            retval += c.size;
+        }
+    }
+
+    return retval;
+}
+
+
+/*
+ * trrojan::system_topology::discover_caches
+ */
+void trrojan::system_topology::discover_caches(void) {
+#if !defined(_WIN32)
+    static const std::string cpu_root("/sys/devices/system/cpu");
+    std::set<std::tuple<std::uint32_t, std::string, processor_id_type>> known;
+
+    for (auto& p : this->_processors) {
+        auto root = combine_path(cpu_root, "cpu" + std::to_string(p.id),
+            "cache");
+        std::vector<std::string> indices;
+
+        try {
+            get_file_system_entries(std::back_inserter(indices), root, false);
+        } catch (...) {
+            continue;
+        }
+
+        for (auto& i : indices) {
+            if (!detail::is_numbered_entry(get_file_name(i), "index")) {
+                continue;
+            }
+
+            try {
+                cache c;
+                c.level = static_cast<std::uint32_t>(std::stoul(
+                    detail::read_topology_attribute(combine_path(i, "level"))));
+                c.type = detail::read_topology_attribute(
+                    combine_path(i, "type"));
+                c.size = detail::parse_size(detail::read_topology_attribute(
+                    combine_path(i, "size")));
+                c.processors = detail::parse_processor_list(
+                    detail::read_topology_attribute(
+                    combine_path(i, "shared_cpu_list")));
+
+                try {
+                    c.line_size = static_cast<std::uint32_t>(std::stoul(
+                        detail::read_topology_attribute(
+                        combine_path(i, "coherency_line_size"))));
+                } catch (...) {
+                    c.line_size = 0;
+                }
+
+                // Each cache instance is reported by all processors sharing
+                // it, so we only add it for the first one.
+                auto first = c.processors.empty() ? p.id : c.processors.front();
+                if (known.emplace(c.level, c.type, first).second) {
+                    this->_caches.push_back(std::move(c));
+                }
+            } catch (std::exception& ex) {
+                log::instance().write_line(log_level::verbose, "The cache "
+                    "\"{0}\" could not be read: {1}", i, ex.what());
+            }
+        }
+    }
+
+    std::sort(this->_caches.begin(), this->_caches.end(),
+        [](const cache& l, const cache& r) {
+            return std::tie(l.level, l.type, l.processors)
+                < std::tie(r.level, r.type, r.processors);
+        });
+#endif /* !defined(_WIN32) */
+}
+
+
+/*
+ * trrojan::system_topology::discover_memory
+ */
+void trrojan::system_topology::discover_memory(void) {
+#if !defined(_WIN32)
+    try {
+        std::ifstream meminfo("/proc/meminfo", std::ios::in);
+        std::string line;
+
+        while (std::getline(meminfo, line)) {
+            auto colon = line.find(':');
+            if (colon == std::string::npos) {
+                continue;
+            }
+
+            auto key = line.substr(0, colon);
+            auto value = line.substr(colon + 1);
+            if (key == "HugePages_Total") {
+                this->_huge_pages_total = detail::parse_size(value);
+            } else if (key == "HugePages_Free") {
+                this->_huge_pages_free = detail::parse_size(value);
+            } else if (key == "Hugepagesize") {
+                this->_huge_page_size = detail::parse_size(value);
+            }
+        }
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::verbose, "The huge page "
+            "configuration is not available: {0}", ex.what());
+    }
+
+    // The active mode of transparent huge pages is marked like
+    // "always [madvise] never".
+    try {
+        auto modes = detail::read_topology_attribute(
+            "/sys/kernel/mm/transparent_hugepage/enabled");
+        auto begin = modes.find('[');
+        auto end = modes.find(']');
+        if ((begin != std::string::npos) && (end > begin)) {
+            this->_transparent_huge_pages = modes.substr(begin + 1,
+                end - begin - 1);
+        }
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::verbose, "The mode of "
+            "transparent huge pages is not available: {0}", ex.what());
+    }
+#endif /* !defined(_WIN32) */
+}
+
+
+/*
+ * trrojan::system_topology::discover_nodes
+ */
+void trrojan::system_topology::discover_nodes(void) {
+#if !defined(_WIN32)
+    static const std::string node_root("/sys/devices/system/node");
+    static const std::string prefix("node");
+    std::vector<std::string> nodes;
+
+    try {
+        get_file_system_entries(std::back_inserter(nodes), node_root, false);
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::verbose, "The NUMA topology is "
+            "not available: {0}", ex.what());
+    }
+
+    for (auto& n : nodes) {
+        auto name = get_file_name(n);
+        if (!detail::is_numbered_entry(name, prefix)) {
+            continue;
+        }
+
+        try {
+            numa_node node;
+            node.id = static_cast<std::uint32_t>(std::stoul(
+                name.substr(prefix.size())));
+            node.memory = 0;
+            node.processors = detail::parse_processor_list(
+                detail::read_topology_attribute(combine_path(n, "cpulist")));
+
+            {
+                std::istringstream is(detail::read_topology_attribute(
+                    combine_path(n, "distance")));
+                std::copy(std::istream_iterator<std::uint32_t>(is),
+                    std::istream_iterator<std::uint32_t>(),
+                    std::back_inserter(node.distances));
+            }
+
+            // The lines have the form "Node 0 MemTotal: 32768000 kB".
+            try {
+                std::ifstream meminfo(combine_path(n, "meminfo"));
+                std::string line;
+                while (std::getline(meminfo, line)) {
+                    static const std::string key("MemTotal:");
+                    auto pos = line.find(key);
+                    if (pos != std::string::npos) {
+                        node.memory = detail::parse_size(
+                            line.substr(pos + key.size()));
+                        break;
+                    }
+                }
+            } catch (...) { /* The memory is unknown. */ }
+
+            this->_nodes.push_back(std::move(node));
+        } catch (std::exception& ex) {
+            log::instance().write_line(log_level::verbose, "The NUMA node "
+                "\"{0}\" could not be read: {1}", n, ex.what());
+        }
+    }
+
+    std::sort(this->_nodes.begin(), this->_nodes.end(),
+        [](const numa_node& l, const numa_node& r) { return l.id < r.id; });
+#endif /* !defined(_WIN32) */
+
+    if (this->_nodes.empty()) {
+        // Without NUMA, all processors belong to a single node.
+        numa_node node;
+        node.distances.push_back(10);
+        node.id = 0;
+        node.memory = 0;
+        for (auto& p : this->_processors) {
+            node.processors.push_back(p.id);
+        }
+        this->_nodes.push_back(std::move(node));
+    }
+
+    for (auto& n : this->_nodes) {
+        for (auto i : n.processors) {
+            auto it = std::find_if(this->_processors.begin(),
+                this->_processors.end(),
+                [i](const processor& p) { return (p.id == i); });
+            if (it != this->_processors.end()) {
+                it->node = n.id;
+            }
+        }
+    }
+}
+
+
+/*
+ * trrojan::system_topology::discover_processors
+ */
+void trrojan::system_topology::discover_processors(void) {
+#if !defined(_WIN32)
+    static const std::string cpu_root("/sys/devices/system/cpu");
+    static const std::string prefix("cpu");
+    std::set<std::string> governors;
+    std::vector<std::string> cpus;
+
+    try {
+        get_file_system_entries(std::back_inserter(cpus), cpu_root, false);
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::verbose, "The processor "
+            "topology is not available: {0}", ex.what());
+    }
+
+    for (auto& c : cpus) {
+        auto name = get_file_name(c);
+        if (!detail::is_numbered_entry(name, prefix)) {
+            continue;
+        }
+
+        // Offline processors have no topology, which is what we want.
+        try {
+            processor p;
+            p.id = static_cast<processor_id_type>(std::stoul(
+                name.substr(prefix.size())));
+            p.node = 0;
+            p.package = static_cast<std::uint32_t>(std::stoul(
+                detail::read_topology_attribute(combine_path(c, "topology",
+                "physical_package_id"))));
+            p.core = static_cast<std::uint32_t>(std::stoul(
+                detail::read_topology_attribute(combine_path(c, "topology",
+                "core_id"))));
+            try {
+                p.die = static_cast<std::uint32_t>(std::stoul(
+                    detail::read_topology_attribute(combine_path(c,
+                    "topology", "die_id"))));
+            } catch (...) {
+                // Older kernels do not know about dies.
+                p.die = 0;
+            }
+            p.siblings = detail::parse_processor_list(
+                detail::read_topology_attribute(combine_path(c, "topology",
+                "thread_siblings_list")));
+            this->_processors.push_back(std::move(p));
+        } catch (...) {
+            continue;
+        }
+
+        try {
+            governors.insert(detail::read_topology_attribute(combine_path(c,
+                "cpufreq", "scaling_governor")));
+        } catch (...) { /* cpufreq is not available for the core. */ }
+    }
+
+    this->_governor = join(std::string(","), governors.begin(),
+        governors.end());
+
+    // intel_pstate has its own switch, all other drivers use the generic
+    // boost attribute of cpufreq.
+    try {
+        auto noTurbo = detail::read_topology_attribute(
+            combine_path(cpu_root, "intel_pstate", "no_turbo"));
+        this->_turbo = (noTurbo == "0")
+            ? turbo_state::enabled
+            : turbo_state::disabled;
+    } catch (...) {
+        try {
+            auto boost = detail::read_topology_attribute(
+                combine_path(cpu_root, "cpufreq", "boost"));
+            this->_turbo = (boost == "0")
+                ? turbo_state::disabled
+                : turbo_state::enabled;
+        } catch (...) { /* The turbo state is unknown. */ }
+    }
+
+    std::sort(this->_processors.begin(), this->_processors.end(),
+        [](const processor& l, const processor& r) { return l.id < r.id; });
+#endif /* !defined(_WIN32) */
+
+    if (this->_processors.empty()) {
+        // If we do not know better, treat all logical processors as
+        // independent cores on the same package.
+        auto cnt = (std::max)(1u, std::thread::hardware_concurrency());
+        for (processor_id_type i = 0; i < cnt; ++i) {
+            processor p;
+            p.core = i;
+            p.die = 0;
+            p.id = i;
+            p.node = 0;
+            p.package = 0;
+            p.siblings.push_back(i);
+            this->_processors.push_back(std::move(p));
+        }
+    }
+}
@@ -0,0 +1,165 @@
+﻿// <copyright file="thermal_monitor.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/thermal_monitor.h"
+
+#include <algorithm>
+#include <cctype>
+#include <iterator>
+#include <limits>
+
+#include "trrojan/io.h"
+#include "trrojan/log.h"
+#include "trrojan/text.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// Reads a numeric sysfs attribute.
+    /// </summary>
+    template<class T> static T read_sysfs_value(const std::string& path) {
+        return static_cast<T>(std::stoll(trim(read_text_file(path))));
+    }
+
+    /// <summary>
+    /// Answer whether <paramref name="name" /> designates a processor in
+    /// <c>/sys/devices/system/cpu</c>, ie has the form &quot;cpu[0-9]+&quot;.
+    /// </summary>
+    static bool is_cpu_directory(const std::string& name) {
+        static const std::string prefix("cpu");
+        return (starts_with(name, prefix)
+            && (name.size() > prefix.size())
+            && std::all_of(name.begin() + prefix.size(), name.end(),
+                [](const char c) { return (std::isdigit(c) != 0); }));
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::thermal_monitor::thermal_monitor
+ */
+trrojan::thermal_monitor::thermal_monitor(void) {
+#if !defined(_WIN32)
+    static const std::string cpu_root("/sys/devices/system/cpu");
+    static const std::string thermal_root("/sys/class/thermal");
+    static const std::string zone_prefix("thermal_zone");
+
+    // Find all thermal zones that we can read.
+    try {
+        std::vector<std::string> zones;
+        get_file_system_entries(std::back_inserter(zones), thermal_root,
+            false);
+
+        for (auto& z : zones) {
+            if (starts_with(get_file_name(z), zone_prefix)) {
+                auto path = combine_path(z, "temp");
+                try {
+                    detail::read_sysfs_value<std::int64_t>(path);
+                    this->_temperatures.push_back(std::move(path));
+                } catch (...) { /* Zone is not usable. */ }
+            }
+        }
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::verbose, "Thermal zones are not "
+            "available: {0}", ex.what());
+    }
+
+    // Find the cpufreq and thermal throttling state of all processors.
+    try {
+        std::vector<std::string> cpus;
+        get_file_system_entries(std::back_inserter(cpus), cpu_root, false);
+
+        for (auto& c : cpus) {
+            if (!detail::is_cpu_directory(get_file_name(c))) {
+                continue;
+            }
+
+            try {
+                auto cur = combine_path(c, "cpufreq", "scaling_cur_freq");
+                auto max = combine_path(c, "cpufreq", "scaling_max_freq");
+                auto hw = detail::read_sysfs_value<float>(
+                    combine_path(c, "cpufreq", "cpuinfo_max_freq"));
+                detail::read_sysfs_value<float>(cur);
+                detail::read_sysfs_value<float>(max);
+                this->_cur_freqs.push_back(std::move(cur));
+                this->_max_freqs.push_back(std::move(max));
+                this->_hw_max_freqs.push_back(hw);
+            } catch (...) { /* cpufreq is not available for the core. */ }
+
+            for (auto f : { "core_throttle_count", "package_throttle_count" }) {
+                auto path = combine_path(c, "thermal_throttle", f);
+                try {
+                    detail::read_sysfs_value<std::uint64_t>(path);
+                    this->_throttle_counts.push_back(std::move(path));
+                } catch (...) { /* Counter is not available. */ }
+            }
+        }
+    } catch (std::exception& ex) {
+        log::instance().write_line(log_level::verbose, "The clock state of the "
+            "processors is not available: {0}", ex.what());
+    }
+#endif /* !defined(_WIN32) */
+
+    log::instance().write_line(log_level::verbose, "The thermal monitor found "
+        "{0} thermal zone(s), {1} processor clock(s) and {2} throttling "
+        "counter(s).", this->_temperatures.size(), this->_cur_freqs.size(),
+        this->_throttle_counts.size());
+}
+
+
+/*
+ * trrojan::thermal_monitor::sample
+ */
+trrojan::thermal_monitor::state trrojan::thermal_monitor::sample(void) const {
+    static constexpr auto nan = std::numeric_limits<float>::quiet_NaN();
+    state retval { nan, nan, nan, 0 };
+
+    for (auto& t : this->_temperatures) {
+        try {
+            // Thermal zones report millidegrees Celsius.
+            auto value = detail::read_sysfs_value<std::int64_t>(t) / 1000.0f;
+            if (!(retval.temperature >= value)) {
+                retval.temperature = value;
+            }
+        } catch (...) { /* Ignore the sensor. */ }
+    }
+
+    {
+        auto cnt = 0;
+        auto sum = 0.0f;
+
+        for (std::size_t i = 0; i < this->_cur_freqs.size(); ++i) {
+            try {
+                // cpufreq reports kHz.
+                sum += detail::read_sysfs_value<float>(this->_cur_freqs[i])
+                    / 1000.0f;
+                ++cnt;
+
+                auto ratio = detail::read_sysfs_value<float>(
+                    this->_max_freqs[i]) / this->_hw_max_freqs[i];
+                if (!(retval.clock_ratio <= ratio)) {
+                    retval.clock_ratio = ratio;
+                }
+            } catch (...) { /* Ignore the processor. */ }
+        }
+
+        if (cnt > 0) {
+            retval.frequency = sum / cnt;
+        }
+    }
+
+    for (auto& t : this->_throttle_counts) {
+        try {
+            retval.throttle_count += detail::read_sysfs_value<std::uint64_t>(t);
+        } catch (...) { /* Ignore the counter. */ }
+    }
+
+    return retval;
+}
@@ -6,7 +6,75 @@
 
 #include "trrojan/timer.h"
 
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <mutex>
+#include <vector>
+
+#if (defined(TRROJAN_TIMER_WITH_TSC) && !defined(_MSC_VER))
+#include <cpuid.h>
+#endif /* (defined(TRROJAN_TIMER_WITH_TSC) && !defined(_MSC_VER)) */
+
 #include "trrojan/constants.h"
+#include "trrojan/log.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// The source of the time and its measured properties.
+    /// </summary>
+    struct timer_state {
+        std::mutex lock;
+        double overhead = std::numeric_limits<double>::quiet_NaN();
+        double resolution = std::numeric_limits<double>::quiet_NaN();
+        timer::source_type source = timer::source_type::native;
+    };
+
+    /// <summary>
+    /// Answer the only instance of the <see cref="timer_state" />.
+    /// </summary>
+    static timer_state& get_timer_state(void) {
+        static timer_state retval;
+        return retval;
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::timer::has_invariant_tsc
+ */
+bool trrojan::timer::has_invariant_tsc(void) {
+#if defined(TRROJAN_TIMER_WITH_TSC)
+    // The invariant TSC is advertised in bit 8 of EDX of the extended leaf
+    // 0x80000007, which must be checked to exist first.
+    unsigned int regs[4] = { 0 };
+
+#if defined(_MSC_VER)
+    int r[4];
+    ::__cpuid(r, 0x80000000);
+    if (static_cast<unsigned int>(r[0]) < 0x80000007) {
+        return false;
+    }
+    ::__cpuid(r, 0x80000007);
+    std::copy(r, r + 4, regs);
+#else /* defined(_MSC_VER) */
+    if (::__get_cpuid_max(0x80000000, nullptr) < 0x80000007) {
+        return false;
+    }
+    ::__get_cpuid(0x80000007, regs + 0, regs + 1, regs + 2, regs + 3);
+#endif /* defined(_MSC_VER) */
+
+    return ((regs[3] & (1 << 8)) != 0);
+
+#else /* defined(TRROJAN_TIMER_WITH_TSC) */
+    return false;
+#endif /* defined(TRROJAN_TIMER_WITH_TSC) */
+}
 
 
 /*
@@ -30,6 +98,14 @@ trrojan::timer::millis_type trrojan::timer::to_millis(
 #if (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK))
     LARGE_INTEGER frequency;
 
+#if defined(TRROJAN_TIMER_WITH_TSC)
+    if (timer::_tsc.nanos_per_tick > 0.0) {
+        // The value is in ticks of the time stamp counter.
+        return static_cast<millis_type>(value) * timer::_tsc.nanos_per_tick
+            / 1000000.0;
+    }
+#endif /* defined(TRROJAN_TIMER_WITH_TSC) */
+
     if (::QueryPerformanceFrequency(&frequency)) {
         auto v = static_cast<millis_type>(value);
         auto s = trrojan::constants<millis_type>::millis_per_second;
@@ -47,3 +123,223 @@ trrojan::timer::millis_type trrojan::timer::to_millis(
     return v.count();
 #endif /* (defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK)) */
 }
+
+
+/*
+ * trrojan::timer::overhead
+ */
+double trrojan::timer::overhead(void) {
+    auto& state = detail::get_timer_state();
+    {
+        std::lock_guard<std::mutex> l(state.lock);
+        if (!std::isnan(state.overhead)) {
+            return state.overhead;
+        }
+    }
+
+    timer::self_test();
+    std::lock_guard<std::mutex> l(state.lock);
+    return state.overhead;
+}
+
+
+/*
+ * trrojan::timer::parse_source
+ */
+trrojan::timer::source_type trrojan::timer::parse_source(
+        const std::string& source) {
+    for (auto s : { source_type::native, source_type::tsc }) {
+        if (source == timer::to_string(s)) {
+            return s;
+        }
+    }
+
+    throw std::invalid_argument("\"" + source + "\" is not a valid source of "
+        "the time. Valid sources are \"native\" and \"tsc\".");
+}
+
+
+/*
+ * trrojan::timer::resolution
+ */
+double trrojan::timer::resolution(void) {
+    auto& state = detail::get_timer_state();
+    {
+        std::lock_guard<std::mutex> l(state.lock);
+        if (!std::isnan(state.resolution)) {
+            return state.resolution;
+        }
+    }
+
+    timer::self_test();
+    std::lock_guard<std::mutex> l(state.lock);
+    return state.resolution;
+}
+
+
+/*
+ * trrojan::timer::select_source
+ */
+trrojan::timer::source_type trrojan::timer::select_source(
+        const source_type source) {
+    auto& state = detail::get_timer_state();
+
+    {
+        std::lock_guard<std::mutex> l(state.lock);
+        const char *cause = "the processor does not have a time stamp counter";
+        timer::_tsc.nanos_per_tick = 0.0;
+        timer::_tsc.scale = 0.0;
+        state.source = source_type::native;
+
+#if defined(TRROJAN_TIMER_WITH_TSC)
+        if (source != source_type::tsc) {
+            cause = "";
+
+        } else if (!timer::has_invariant_tsc()) {
+            cause = "the processor does not have an invariant time stamp "
+                "counter";
+
+        } else {
+            typedef std::chrono::steady_clock clock_type;
+
+            // Calibrate the rate of the counter against the steady clock over
+            // a period that is long enough to make the error of reading the
+            // clocks negligible. Each reading of the clock is bracketed by two
+            // reads of the counter, the mean of which is attributed to it.
+            auto calibrate = [](std::uint64_t& tsc, auto& value, auto now) {
+                auto before = timer::read_tsc();
+                value = now();
+                auto after = timer::read_tsc();
+                tsc = before + (after - before) / 2;
+            };
+
+            const auto duration = std::chrono::milliseconds(100);
+            std::uint64_t tsc0, tsc1;
+            clock_type::time_point steady0, steady1;
+            calibrate(tsc0, steady0, clock_type::now);
+            while (clock_type::now() - steady0 < duration) {
+                /* Busy waiting keeps the processor from sleeping. */
+            }
+            calibrate(tsc1, steady1, clock_type::now);
+
+            auto dn = std::chrono::duration<double, std::nano>(
+                steady1 - steady0).count();
+            auto dt = static_cast<double>(tsc1 - tsc0);
+
+            if ((dn > 0.0) && (dt > 0.0)) {
+                timer::_tsc.nanos_per_tick = dn / dt;
+
+#if !(defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK))
+                // Map the counter to the native clock, which only requires a
+                // common origin as the rate is known.
+                typedef difference_type::period period;
+                calibrate(timer::_tsc.origin, timer::_tsc.native_origin,
+                    timer::native_now);
+                timer::_tsc.scale = timer::_tsc.nanos_per_tick
+                    * static_cast<double>(period::den)
+                    / (1000000000.0 * static_cast<double>(period::num));
+#endif /* !(defined(_WIN32) && !defined(TRROJAN_FORCE_STL_CLOCK)) */
+
+                state.source = source_type::tsc;
+                log::instance().write_line(log_level::verbose, "The time "
+                    "stamp counter runs at {0:.3f} MHz.",
+                    1000.0 / timer::_tsc.nanos_per_tick);
+
+            } else {
+                cause = "the time stamp counter could not be calibrated "
+                    "against the steady clock";
+            }
+        }
+#endif /* defined(TRROJAN_TIMER_WITH_TSC) */
+
+        if (state.source != source) {
+            log::instance().write_line(log_level::warning, "The timer cannot "
+                "use \"{0}\" as source, because {1}. Using \"{2}\" "
+                "instead.", timer::to_string(source), cause,
+                timer::to_string(state.source));
+        }
+    }
+
+    timer::self_test();
+
+    {
+        std::lock_guard<std::mutex> l(state.lock);
+        log::instance().write_line(log_level::information, "The timer uses "
+            "\"{0}\" with an overhead of {1:.1f} ns and a resolution of "
+            "{2:.1f} ns.", timer::to_string(state.source), state.overhead,
+            state.resolution);
+        return state.source;
+    }
+}
+
+
+/*
+ * trrojan::timer::source
+ */
+trrojan::timer::source_type trrojan::timer::source(void) {
+    auto& state = detail::get_timer_state();
+    std::lock_guard<std::mutex> l(state.lock);
+    return state.source;
+}
+
+
+/*
+ * trrojan::timer::to_string
+ */
+const char *trrojan::timer::to_string(const source_type source) {
+    switch (source) {
+        case source_type::tsc: return "tsc";
+        default: return "native";
+    }
+}
+
+
+/*
+ * trrojan::timer::self_test
+ */
+void trrojan::timer::self_test(void) {
+    static const std::size_t cntReads = 1000;
+    static const std::size_t cntRepetitions = 101;
+    std::vector<double> overheads;
+    overheads.reserve(cntRepetitions);
+    auto resolution = std::numeric_limits<double>::max();
+
+    for (std::size_t r = 0; r < cntRepetitions; ++r) {
+        // The overhead is the mean time of back-to-back reads.
+        auto begin = timer::now();
+        for (std::size_t i = 0; i < cntReads; ++i) {
+            timer::now();
+        }
+        auto end = timer::now();
+        overheads.push_back(timer::to_millis(end - begin) * 1000000.0
+            / static_cast<double>(cntReads + 1));
+
+        // The resolution is the smallest step that can be observed.
+        auto last = timer::now();
+        for (std::size_t i = 0; i < cntReads; ++i) {
+            auto current = timer::now();
+            if (current != last) {
+                auto d = timer::to_millis(current - last) * 1000000.0;
+                resolution = (std::min)(resolution, d);
+                last = current;
+            }
+        }
+    }
+
+    // Use the median, because the test might have been interrupted.
+    std::nth_element(overheads.begin(),
+        overheads.begin() + overheads.size() / 2, overheads.end());
+
+    auto& state = detail::get_timer_state();
+    std::lock_guard<std::mutex> l(state.lock);
+    state.overhead = overheads[overheads.size() / 2];
+    state.resolution = (resolution < std::numeric_limits<double>::max())
+        ? resolution
+        : std::numeric_limits<double>::quiet_NaN();
+}
+
+
+/*
+ * trrojan::timer::_tsc
+ */
+trrojan::timer::tsc_calibration trrojan::timer::_tsc = { };
@@ -0,0 +1,316 @@
+﻿// <copyright file="trace.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/trace.h"
+
+#include <algorithm>
+#include <fstream>
+#include <iomanip>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <sstream>
+#include <stdexcept>
+#include <utility>
+#include <vector>
+
+#include "trrojan/json_util.h"
+#include "trrojan/timer.h"
+
+
+namespace trrojan {
+namespace detail {
+
+    /// <summary>
+    /// A zone that has been recorded by a thread.
+    /// </summary>
+    struct trace_event {
+        timer::value_type begin;
+        const char *category;
+        std::size_t depth;
+        timer::value_type end;
+        const char *name;
+    };
+
+    /// <summary>
+    /// The zones recorded by a single thread.
+    /// </summary>
+    /// <remarks>
+    /// The lock only protects against concurrent exports and calls to
+    /// <see cref="trrojan::trace::clear" />, wherefore it is never
+    /// contended while recording.
+    /// </remarks>
+    struct trace_buffer {
+        std::vector<trace_event> events;
+        std::mutex lock;
+        std::vector<std::size_t> open;
+        std::size_t thread;
+    };
+
+    /// <summary>
+    /// The buffers of all threads that have ever recorded a zone.
+    /// </summary>
+    struct trace_state {
+        std::vector<std::shared_ptr<trace_buffer>> buffers;
+        std::mutex lock;
+    };
+
+    /// <summary>
+    /// The aggregated duration of all zones with the same name and category.
+    /// </summary>
+    struct trace_summary {
+        std::size_t count = 0;
+        timer::millis_type self = 0.0;
+        timer::millis_type total = 0.0;
+    };
+
+    /// <summary>
+    /// Answer the only instance of the state, which is created on first use
+    /// to avoid depending on the initialisation order of statics.
+    /// </summary>
+    static trace_state& get_trace_state(void) {
+        static trace_state retval;
+        return retval;
+    }
+
+    /// <summary>
+    /// Answer the buffer of the calling thread, which is registered in the
+    /// state on first use.
+    /// </summary>
+    static trace_buffer& get_trace_buffer(void) {
+        thread_local std::shared_ptr<trace_buffer> retval;
+
+        if (retval == nullptr) {
+            auto& s = get_trace_state();
+            std::lock_guard<std::mutex> l(s.lock);
+            retval = std::make_shared<trace_buffer>();
+            retval->thread = s.buffers.size();
+            s.buffers.push_back(retval);
+        }
+
+        return *retval;
+    }
+
+    /// <summary>
+    /// Copies the zones of all threads, closing the ones that are still
+    /// open at <paramref name="now" />.
+    /// </summary>
+    static std::vector<std::vector<trace_event>> snapshot_trace(
+            const timer::value_type now) {
+        std::vector<std::shared_ptr<trace_buffer>> buffers;
+        std::vector<std::vector<trace_event>> retval;
+
+        {
+            auto& s = get_trace_state();
+            std::lock_guard<std::mutex> l(s.lock);
+            buffers = s.buffers;
+        }
+
+        retval.reserve(buffers.size());
+        for (auto& b : buffers) {
+            std::lock_guard<std::mutex> l(b->lock);
+            retval.push_back(b->events);
+            for (auto i : b->open) {
+                retval.back()[i].end = now;
+            }
+        }
+
+        return retval;
+    }
+
+} /* end namespace detail */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::trace::begin
+ */
+void trrojan::trace::begin(const char *name, const char *category) {
+    if (!trace::enabled()) {
+        return;
+    }
+
+    auto& b = detail::get_trace_buffer();
+    std::lock_guard<std::mutex> l(b.lock);
+    b.open.push_back(b.events.size());
+    b.events.push_back({ timer::now(), category, b.open.size() - 1,
+        timer::value_type(), name });
+}
+
+
+/*
+ * trrojan::trace::clear
+ */
+void trrojan::trace::clear(void) {
+    auto& s = detail::get_trace_state();
+    std::lock_guard<std::mutex> l(s.lock);
+    for (auto& b : s.buffers) {
+        std::lock_guard<std::mutex> lb(b->lock);
+        b->events.clear();
+        b->open.clear();
+    }
+}
+
+
+/*
+ * trrojan::trace::enable
+ */
+void trrojan::trace::enable(const bool enabled) {
+    trace::_enabled.store(enabled, std::memory_order_relaxed);
+}
+
+
+/*
+ * trrojan::trace::end
+ */
+void trrojan::trace::end(void) {
+    const auto now = timer::now();
+    auto& b = detail::get_trace_buffer();
+    std::lock_guard<std::mutex> l(b.lock);
+
+    if (!b.open.empty()) {
+        b.events[b.open.back()].end = now;
+        b.open.pop_back();
+    }
+}
+
+
+/*
+ * trrojan::trace::write_json
+ */
+void trrojan::trace::write_json(const std::string& path) {
+    const auto threads = detail::snapshot_trace(timer::now());
+
+    std::ofstream stream(path, std::ios::trunc | std::ios::binary);
+    if (!stream) {
+        std::stringstream msg;
+        msg << "Failed to open trace file \"" << path << "\"" << std::ends;
+        throw std::runtime_error(msg.str());
+    }
+
+    // The trace starts with the earliest zone of any thread.
+    auto origin = timer::now();
+    for (auto& t : threads) {
+        for (auto& e : t) {
+            origin = (std::min)(origin, e.begin);
+        }
+    }
+
+    stream << std::fixed;
+    stream.precision(3);
+
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":"
+        << "{\"name\":\"trrojan\"}}";
+
+    for (std::size_t t = 0; t < threads.size(); ++t) {
+        stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+            << "\"tid\":" << t << ",\"args\":{\"name\":\"thread " << t
+            << "\"}}";
+    }
+
+    // The trace event format expects microseconds.
+    for (std::size_t t = 0; t < threads.size(); ++t) {
+        for (auto& e : threads[t]) {
+            auto start = timer::to_millis(e.begin - origin);
+            auto duration = timer::to_millis(e.end - e.begin);
+            stream << ",\n{\"name\":";
+            print_json_string(stream, e.name);
+            stream << ",\"cat\":";
+            print_json_string(stream, e.category);
+            stream << ",\"ph\":\"X\",\"pid\":0,\"tid\":" << t
+                << ",\"ts\":" << start * 1000.0
+                << ",\"dur\":" << duration * 1000.0 << "}";
+        }
+    }
+
+    stream << "\n]}\n";
+
+    if (!stream) {
+        throw std::runtime_error("Failed to write the trace.");
+    }
+}
+
+
+/*
+ * trrojan::trace::write_summary
+ */
+void trrojan::trace::write_summary(std::ostream& stream) {
+    typedef std::pair<std::string, std::string> key_type;
+    const auto threads = detail::snapshot_trace(timer::now());
+    std::map<key_type, detail::trace_summary> summaries;
+    timer::millis_type total = 0.0;
+
+    for (auto& t : threads) {
+        // The zones are stored in the order they have been opened, so the
+        // parent of a zone is the last one before it having a lower depth.
+        std::vector<detail::trace_summary *> parents;
+
+        for (auto& e : t) {
+            const key_type key(e.name ? e.name : "", e.category
+                ? e.category : "");
+            auto& s = summaries[key];
+            auto duration = timer::to_millis(e.end - e.begin);
+
+            if (parents.size() > e.depth) {
+                parents.resize(e.depth);
+            }
+            if (parents.empty()) {
+                total += duration;
+            } else {
+                parents.back()->self -= duration;
+            }
+
+            ++s.count;
+            s.self += duration;
+            s.total += duration;
+            parents.push_back(&s);
+        }
+    }
+
+    std::vector<std::pair<key_type, detail::trace_summary>> rows(
+        summaries.begin(), summaries.end());
+    std::stable_sort(rows.begin(), rows.end(),
+            [](const decltype(rows)::value_type& l,
+            const decltype(rows)::value_type& r) {
+        return (l.second.self > r.second.self);
+    });
+
+    std::size_t width = 4;
+    for (auto& r : rows) {
+        width = (std::max)(width, r.first.first.size());
+    }
+
+    const auto flags = stream.flags();
+    const auto precision = stream.precision();
+    stream << std::left << std::setw(width) << "Zone" << "  "
+        << std::setw(12) << "Category" << std::right
+        << std::setw(8) << "Count"
+        << std::setw(14) << "Total [ms]"
+        << std::setw(14) << "Self [ms]"
+        << std::setw(8) << "Self %" << std::endl;
+
+    stream << std::fixed << std::setprecision(3);
+    for (auto& r : rows) {
+        auto share = (total > 0.0) ? 100.0 * r.second.self / total : 0.0;
+        stream << std::left << std::setw(width) << r.first.first << "  "
+            << std::setw(12) << r.first.second << std::right
+            << std::setw(8) << r.second.count
+            << std::setw(14) << r.second.total
+            << std::setw(14) << r.second.self
+            << std::setw(8) << std::setprecision(1) << share
+            << std::setprecision(3) << std::endl;
+    }
+
+    stream.flags(flags);
+    stream.precision(precision);
+}
+
+
+/*
+ * trrojan::trace::_enabled
+ */
+std::atomic<bool> trrojan::trace::_enabled(false);
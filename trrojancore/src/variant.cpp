@@ -55,11 +55,11 @@ TRROJANCORE_API std::ostream& trrojan::detail::operator <<(std::ostream& lhs,
  */
 TRROJANCORE_API std::ostream& trrojan::detail::operator <<(std::ostream &lhs,
         const power_collector::pointer& rhs) {
-#if defined(TRROJAN_WITH_POWER_OVERWHELMING)
+#if defined(TRROJAN_WITH_POWER_COLLECTOR)
     lhs << ((rhs != nullptr) ? rhs->file() : "null");
-#else /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#else /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
     lhs << "null";
-#endif /* defined(TRROJAN_WITH_POWER_OVERWHELMING) */
+#endif /* defined(TRROJAN_WITH_POWER_COLLECTOR) */
     return lhs;
 }
 
@@ -29,7 +29,8 @@ namespace d3d11 {
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
-        inline environment(void) : environment_base("d3d11") { }
+        inline environment(void) : environment_base("d3d11"),
+            _com_initialised(false) { }
 
         /// <summary>
         /// Finalises the instance.
@@ -53,6 +54,12 @@ namespace d3d11 {
 
     private:
 
+        /// <summary>
+        /// Remembers whether <see cref="on_activate" /> has initialised COM,
+        /// which must be undone in <see cref="on_finalise" />.
+        /// </summary>
+        bool _com_initialised;
+
         std::vector<device::pointer> _devices;
 
     };
@@ -6,9 +6,14 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "trrojan/d3d11/sphere_data_set.h"
 
 #include "trrojan/mmpld_reader.h"
+#include "trrojan/prefetch_cache.h"
 
 
 
@@ -37,6 +42,21 @@ namespace d3d11 {
         /// </summary>
         typedef mmpld_reader::vertex_type sphere_type;
 
+        /// <summary>
+        /// The first particle list of a frame as read from disk before it is
+        /// uploaded to the GPU.
+        /// </summary>
+        struct frame_data {
+            std::vector<char> data;
+            mmpld_reader::list_header list;
+        };
+
+        /// <summary>
+        /// A cache of frames that have been read in the background.
+        /// </summary>
+        typedef prefetch_cache<std::string, std::shared_ptr<const frame_data>>
+            frame_cache;
+
         static const frame_load_flags load_flag_fit_bounding_box;
         static const frame_load_flags load_flag_float_colour;
         static const frame_load_flags load_flag_structured_resource;
@@ -73,6 +93,30 @@ namespace d3d11 {
         static sphere_data_set_base::properties_type get_properties(
             const mmpld_reader::list_header& header);
 
+        /// <summary>
+        /// Answer the key of the given frame of the MMPLD file at
+        /// <paramref name="path" /> in a <see cref="frame_cache" />.
+        /// </summary>
+        static std::string frame_key(const std::string& path,
+            const unsigned int frame);
+
+        /// <summary>
+        /// Opens the MMPLD file at the specified location and reads the first
+        /// particle list of the given frame.
+        /// </summary>
+        /// <remarks>
+        /// This method does not require a device and can therefore be used to
+        /// fill a <see cref="frame_cache" /> in the background.
+        /// </remarks>
+        /// <param name="path">The path to the MMPLD file.</param>
+        /// <param name="frame">The zero-based index of the frame to read.
+        /// </param>
+        /// <returns>The particle list header and the particle data.</returns>
+        /// <exception cref="std::invalid_argument">If the requested frame
+        /// does not exist.</exception>
+        static std::shared_ptr<const frame_data> read_frame_data(
+            const std::string& path, const unsigned int frame);
+
         virtual ~mmpld_data_set(void) = default;
 
         /// <inheritdoc />
@@ -102,9 +146,14 @@ namespace d3d11 {
         /// <see cref="sphere_data_set::property_structured_resource" /> for
         /// creating a structured resource buffer instead of a vertex buffer.
         /// </param>
+        /// <param name="cache">An optional cache of frames, which is searched
+        /// for frames that have been read in the background using
+        /// <see cref="read_frame_data" /> and <see cref="frame_key" />.
+        /// </param>
         /// <returns></returns>
         rendering_technique::buffer_type read_frame(ID3D11Device *device,
-            const unsigned int frame, const frame_load_flags options);
+            const unsigned int frame, const frame_load_flags options,
+            frame_cache *cache = nullptr);
 
         /// <inheritdoc />
         virtual size_type size(void) const;
@@ -136,6 +185,16 @@ namespace d3d11 {
         /// </summary>
         static bool is_non_float_colour(const mmpld_reader::list_header& list);
 
+        /// <summary>
+        /// Reads the first particle list of the given frame from an MMPLD
+        /// stream which has been opened using
+        /// <see cref="mmpld_reader::read_file_header" />.
+        /// </summary>
+        static std::shared_ptr<const frame_data> read_frame_data(
+            std::ifstream& stream, const mmpld_reader::file_header& header,
+            const mmpld_reader::seek_table& seekTable,
+            const unsigned int frame);
+
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
@@ -175,6 +234,11 @@ namespace d3d11 {
         /// </summary>
         float _max_radius;
 
+        /// <summary>
+        /// The path of the currently opened MMPLD file.
+        /// </summary>
+        std::string _path;
+
         /// <summary>
         /// The seek table for the currently opened MMPLD file.
         /// </summary>
@@ -6,7 +6,12 @@
 
 #pragma once
 
+#include <memory>
+#include <string>
+#include <vector>
+
 #include "trrojan/configuration.h"
+#include "trrojan/prefetch_cache.h"
 #include "trrojan/random_sphere_generator.h"
 
 #include "trrojan/d3d11/sphere_data_set.h"
@@ -35,6 +40,21 @@ namespace d3d11 {
         typedef sphere_data_set_base::point_type point_type;
         typedef sphere_data_set_base::size_type size_type;
 
+        /// <summary>
+        /// The particles generated on the CPU before they are uploaded to the
+        /// GPU.
+        /// </summary>
+        struct particles {
+            std::vector<std::uint8_t> data;
+            float max_radius;
+        };
+
+        /// <summary>
+        /// A cache of particles that have been generated in the background.
+        /// </summary>
+        typedef prefetch_cache<std::string, std::shared_ptr<const particles>>
+            particle_cache;
+
         /// <summary>
         /// Creates a data set of random spheres with the specified properties.
         /// </summary>
@@ -68,10 +88,31 @@ namespace d3d11 {
         /// <see cref="sphere_data_set_base::property_float_colour" /> to force
         /// colours using <c>float</c> channels instead of 8-bit.</param>
         /// <param name="configuration"></param>
+        /// <param name="cache">An optional cache of particles, which is
+        /// searched for particles that have been generated in the background
+        /// using <see cref="generate" /> and <see cref="particle_key" />.
+        /// </param>
         /// </returns></returns>
         static sphere_data_set create(ID3D11Device *device,
             const create_flags flags,
-            const std::string& configuration);
+            const std::string& configuration,
+            particle_cache *cache = nullptr);
+
+        /// <summary>
+        /// Generates the particles described in the given
+        /// <paramref name="configuration" /> string on the CPU.
+        /// </summary>
+        /// <remarks>
+        /// This method does not need a device and can therefore be used to
+        /// prepare the data on a background thread.
+        /// </remarks>
+        /// <param name="flags">The flags that will be passed to
+        /// <see cref="create" />.</param>
+        /// <param name="configuration">The description of the random spheres.
+        /// </param>
+        /// <returns>The generated particles.</returns>
+        static std::shared_ptr<const particles> generate(
+            const create_flags flags, const std::string& configuration);
 
         /// <summary>
         /// Creates a vector format descriptor for the random spheres.
@@ -93,6 +134,13 @@ namespace d3d11 {
             return static_cast<size_type>(retval);
         }
 
+        /// <summary>
+        /// Answer the key of the particles generated for the given flags and
+        /// configuration in a <see cref="particle_cache" />.
+        /// </summary>
+        static std::string particle_key(const create_flags flags,
+            const std::string& configuration);
+
         virtual ~random_sphere_data_set(void) = default;
 
         /// <inheritdoc />
@@ -117,11 +165,29 @@ namespace d3d11 {
         static void minmax(point_type& i, point_type& a,
             const DirectX::XMFLOAT4& v);
 
+        /// <summary>
+        /// Allocates a data set with the given properties, which does not yet
+        /// have a buffer.
+        /// </summary>
+        static std::shared_ptr<random_sphere_data_set> allocate(
+            const sphere_type sphereType,
+            const size_type cntParticles,
+            const std::array<float, 3>& domainSize,
+            const std::array<float, 2>& sphereSize,
+            const std::uint32_t seed);
+
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
         random_sphere_data_set(void);
 
+        /// <summary>
+        /// Creates the buffer holding the given particles using the given set
+        /// of flags.
+        /// </summary>
+        void upload(ID3D11Device *device, const create_flags flags,
+            const std::vector<std::uint8_t>& particles);
+
         /// <summary>
         /// Stores the bounding box of the data set.
         /// </summary>
@@ -12,6 +12,8 @@
 #include "trrojan/timer.h"
 
 #include "trrojan/d3d11/benchmark_base.h"
+#include "trrojan/d3d11/mmpld_data_set.h"
+#include "trrojan/d3d11/random_sphere_data_set.h"
 #include "trrojan/d3d11/rendering_technique.h"
 #include "trrojan/d3d11/sphere_data_set.h"
 
@@ -83,6 +85,9 @@ namespace d3d11 {
             power_collector::pointer& powerCollector,
             const std::vector<std::string>& changed);
 
+        /// <inheritdoc />
+        virtual void prefetch(const configuration& config);
+
     private:
 
         /// <summary>
@@ -254,6 +259,18 @@ namespace d3d11 {
         /// </summary>
         technique_map_type technique_cache;
 
+        /// <summary>
+        /// Caches random spheres that have been generated in the background
+        /// while the previous configuration was being measured.
+        /// </summary>
+        random_sphere_data_set::particle_cache random_spheres;
+
+        /// <summary>
+        /// Caches MMPLD frames that have been read in the background while the
+        /// previous configuration was being measured.
+        /// </summary>
+        mmpld_data_set::frame_cache mmpld_frames;
+
         /// <summary>
         /// Constant buffer holding parameters for GPU tessellation.
         /// </summary>
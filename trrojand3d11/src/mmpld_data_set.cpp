@@ -196,7 +196,8 @@ float trrojan::d3d11::mmpld_data_set::max_radius(void) const {
  */
 trrojan::d3d11::rendering_technique::buffer_type
 trrojan::d3d11::mmpld_data_set::read_frame(ID3D11Device *device,
-        const unsigned int frame, const frame_load_flags options) {
+        const unsigned int frame, const frame_load_flags options,
+        frame_cache *cache) {
     assert(this->_stream.good());
     assert(device != nullptr);
     static const frame_load_flags VALID_INPUT_FLAGS // Flags directly copied from user input.
@@ -204,7 +205,7 @@ trrojan::d3d11::mmpld_data_set::read_frame(ID3D11Device *device,
 
     D3D11_BUFFER_DESC bufferDesc;
     std::vector<char> data;
-    mmpld_reader::frame_header frameHeader;
+    std::shared_ptr<const frame_data> frameData;
     D3D11_SUBRESOURCE_DATA id;
     rendering_technique::buffer_type retval;
 
@@ -212,34 +213,28 @@ trrojan::d3d11::mmpld_data_set::read_frame(ID3D11Device *device,
     this->_layout.clear();
     ::memset(&this->_list, 0, sizeof(this->_list));
 
-    // Basic sanity check.
-    if (frame >= this->_seek_table.size()) {
-        std::stringstream msg;
-        msg << "The requested frame #" << frame << " does not exists. The file "
-            << "comprises only " << this->_seek_table.size()
-            << " frame(s)." << std::ends;
-        throw std::invalid_argument(msg.str());
-    }
-
-    // Read the list header and determine the layout using the header.
-    this->_stream.seekg(this->_seek_table[frame]);
-    mmpld_reader::read_frame_header(frameHeader, this->_stream,
-        this->_header.version);
-
-    if (frameHeader.lists > 1) {
-        log::instance().write_line(log_level::warning, "TRRojan only supports "
-            "MMPLD files with one particle list per frame. All but the first "
-            "will be ignored.");
+    // Read the frame from the open stream unless it has already been read in
+    // the background while the previous configuration was measured.
+    if (cache == nullptr) {
+        frameData = mmpld_data_set::read_frame_data(this->_stream,
+            this->_header, this->_seek_table, frame);
+    } else {
+        frameData = cache->get(mmpld_data_set::frame_key(this->_path, frame),
+            [this, frame](void) {
+                return mmpld_data_set::read_frame_data(this->_stream,
+                    this->_header, this->_seek_table, frame);
+            });
     }
+    assert(frameData != nullptr);
 
-    // Read the list header and prepare the D3D input layout.
-    mmpld_reader::read_list_header(this->_list, this->_stream);
+    // Prepare the D3D input layout using the list header.
+    this->_list = frameData->list;
     this->_layout = mmpld_data_set::get_input_layout(this->_list);
 
-    // Read the data.
+    // Copy the data, which might be converted below.
     auto cntData = this->stride() * this->size();
-    data.resize(cntData);
-    this->_stream.read(data.data(), cntData);
+    assert(frameData->data.size() == cntData);
+    data = frameData->data;
 
     // If floating point colours are requested, but not available, add a
     // conversion step. This step copies the first part of the particle,
@@ -377,6 +372,30 @@ trrojan::d3d11::mmpld_data_set::read_frame(ID3D11Device *device,
 }
 
 
+/*
+ * trrojan::d3d11::mmpld_data_set::frame_key
+ */
+std::string trrojan::d3d11::mmpld_data_set::frame_key(const std::string& path,
+        const unsigned int frame) {
+    return std::to_string(frame) + ":" + path;
+}
+
+
+/*
+ * trrojan::d3d11::mmpld_data_set::read_frame_data
+ */
+std::shared_ptr<const trrojan::d3d11::mmpld_data_set::frame_data>
+trrojan::d3d11::mmpld_data_set::read_frame_data(const std::string& path,
+        const unsigned int frame) {
+    mmpld_reader::file_header header;
+    mmpld_reader::seek_table seekTable;
+    std::ifstream stream;
+
+    mmpld_reader::read_file_header(stream, header, seekTable, path.c_str());
+    return mmpld_data_set::read_frame_data(stream, header, seekTable, frame);
+}
+
+
 /*
  * trrojan::d3d11::mmpld_data_set::size
  */
@@ -418,6 +437,56 @@ bool trrojan::d3d11::mmpld_data_set::is_non_float_colour(
 }
 
 
+/*
+ * trrojan::d3d11::mmpld_data_set::read_frame_data
+ */
+std::shared_ptr<const trrojan::d3d11::mmpld_data_set::frame_data>
+trrojan::d3d11::mmpld_data_set::read_frame_data(std::ifstream& stream,
+        const mmpld_reader::file_header& header,
+        const mmpld_reader::seek_table& seekTable,
+        const unsigned int frame) {
+    mmpld_reader::frame_header frameHeader;
+    auto retval = std::make_shared<frame_data>();
+
+    // Basic sanity check.
+    if (frame >= seekTable.size()) {
+        std::stringstream msg;
+        msg << "The requested frame #" << frame << " does not exists. The file "
+            << "comprises only " << seekTable.size() << " frame(s)."
+            << std::ends;
+        throw std::invalid_argument(msg.str());
+    }
+
+    // Read the frame header.
+    stream.seekg(seekTable[frame]);
+    mmpld_reader::read_frame_header(frameHeader, stream, header.version);
+
+    if (frameHeader.lists > 1) {
+        log::instance().write_line(log_level::warning, "TRRojan only supports "
+            "MMPLD files with one particle list per frame. All but the first "
+            "will be ignored.");
+    }
+
+    // Read the list header, which determines the size of the data.
+    ::memset(&retval->list, 0, sizeof(retval->list));
+    mmpld_reader::read_list_header(retval->list, stream);
+
+    // Read the data.
+    auto cntData = mmpld_reader::calc_stride(retval->list)
+        * retval->list.particles;
+    retval->data.resize(cntData);
+    stream.read(retval->data.data(), cntData);
+    if (!stream) {
+        std::stringstream msg;
+        msg << "Reading the particle list of frame #" << frame << " failed."
+            << std::ends;
+        throw std::runtime_error(msg.str());
+    }
+
+    return retval;
+}
+
+
 /*
  * trrojan::d3d11::mmpld_data_set::mmpld_data_set
  */
@@ -447,6 +516,7 @@ trrojan::d3d11::mmpld_data_set::get_mmpld_input_properties(void) const  {
 bool trrojan::d3d11::mmpld_data_set::open(const char *path) {
     mmpld_reader::read_file_header(this->_stream, this->_header,
         this->_seek_table, path);
+    this->_path = path;
     return this->_stream.good();
 }
 
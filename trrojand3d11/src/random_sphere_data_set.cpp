@@ -26,25 +26,9 @@ trrojan::d3d11::random_sphere_data_set::create(ID3D11Device *device,
         const std::array<float, 3>& domainSize,
         const std::array<float, 2>& sphereSize,
         const std::uint32_t seed) {
-    static const create_flags VALID_INPUT_FLAGS // Flags directly copied from user input.
-        = sphere_data_set_base::property_structured_resource;
-    std::shared_ptr<random_sphere_data_set> retval(
-        new random_sphere_data_set());
-
-    // Compute bounding box from domain size.
-    for (size_t i = 0; i < std::size(domainSize); ++i) {
-        retval->_bbox[0][i] = -0.5f * domainSize[i];
-        retval->_bbox[1][i] = 0.5f * domainSize[i];
-    }
-
-    retval->_layout = random_sphere_data_set::get_input_layout(sphereType);
-    retval->_seed = seed;
-    retval->_sphere_size = sphereSize;
-    retval->_size = cntParticles;
-    retval->_type = sphereType;
-
+    auto retval = random_sphere_data_set::allocate(sphereType, cntParticles,
+        domainSize, sphereSize, seed);
     retval->recreate(device, flags);
-
     return retval;
 }
 
@@ -54,10 +38,43 @@ trrojan::d3d11::random_sphere_data_set::create(ID3D11Device *device,
  */
 trrojan::d3d11::sphere_data_set
 trrojan::d3d11::random_sphere_data_set::create(ID3D11Device *device,
-        const create_flags flags, const std::string& configuration) {
+        const create_flags flags, const std::string& configuration,
+        particle_cache *cache) {
     auto desc = random_sphere_generator::parse_description(configuration);
-    return random_sphere_data_set::create(device, flags, desc.type,
-        desc.number, desc.domain_size, desc.sphere_size, desc.seed);
+
+    if (cache == nullptr) {
+        return random_sphere_data_set::create(device, flags, desc.type,
+            desc.number, desc.domain_size, desc.sphere_size, desc.seed);
+    }
+
+    // Use the particles from the cache, which might already have been
+    // generated while the previous configuration was measured.
+    auto particles = cache->get(
+        random_sphere_data_set::particle_key(flags, configuration),
+        [flags, &configuration](void) {
+            return random_sphere_data_set::generate(flags, configuration);
+        });
+
+    auto retval = random_sphere_data_set::allocate(desc.type, desc.number,
+        desc.domain_size, desc.sphere_size, desc.seed);
+    retval->_max_radius = particles->max_radius;
+    retval->upload(device, flags, particles->data);
+    return retval;
+}
+
+
+/*
+ * trrojan::d3d11::random_sphere_data_set::generate
+ */
+std::shared_ptr<const trrojan::d3d11::random_sphere_data_set::particles>
+trrojan::d3d11::random_sphere_data_set::generate(const create_flags flags,
+        const std::string& configuration) {
+    auto desc = random_sphere_generator::parse_description(configuration);
+    desc.flags = static_cast<random_sphere_generator::create_flags>(flags);
+
+    auto retval = std::make_shared<particles>();
+    retval->data = random_sphere_generator::create(retval->max_radius, desc);
+    return retval;
 }
 
 
@@ -109,6 +126,15 @@ trrojan::d3d11::random_sphere_data_set::get_properties(const sphere_type type) {
 }
 
 
+/*
+ * trrojan::d3d11::random_sphere_data_set::particle_key
+ */
+std::string trrojan::d3d11::random_sphere_data_set::particle_key(
+        const create_flags flags, const std::string& configuration) {
+    return std::to_string(flags) + ":" + configuration;
+}
+
+
 /*
  * trrojan::d3d11::random_sphere_data_set::bounding_box
  */
@@ -132,10 +158,6 @@ float trrojan::d3d11::random_sphere_data_set::max_radius(void) const {
  */
 void trrojan::d3d11::random_sphere_data_set::recreate(ID3D11Device *device,
         const create_flags flags) {
-    static const create_flags VALID_INPUT_FLAGS // Flags directly copied from user input.
-        = sphere_data_set_base::property_structured_resource;
-    D3D11_BUFFER_DESC bufferDesc;
-    D3D11_SUBRESOURCE_DATA id;
     random_sphere_generator::description particleDesc;
 
     if (device == nullptr) {
@@ -143,9 +165,6 @@ void trrojan::d3d11::random_sphere_data_set::recreate(ID3D11Device *device,
             "buffer on must not be nullptr.");
     }
 
-    this->_properties = random_sphere_data_set::get_properties(this->_type);
-    this->_properties |= (flags & VALID_INPUT_FLAGS);
-
     particleDesc.domain_size = this->extents();
     particleDesc.flags = static_cast<random_sphere_generator::create_flags>(
         flags);
@@ -157,13 +176,82 @@ void trrojan::d3d11::random_sphere_data_set::recreate(ID3D11Device *device,
     auto particles = random_sphere_generator::create(this->_max_radius,
         particleDesc);
 
+    this->upload(device, flags, particles);
+}
+
+
+/*
+ * trrojan::d3d11::random_sphere_data_set::size
+ */
+trrojan::d3d11::random_sphere_data_set::size_type
+trrojan::d3d11::random_sphere_data_set::size(void) const {
+    return this->_size;
+}
+
+
+/*
+ * trrojan::d3d11::random_sphere_data_set::stride
+ */
+trrojan::d3d11::random_sphere_data_set::size_type
+trrojan::d3d11::random_sphere_data_set::stride(void) const {
+    return random_sphere_data_set::get_stride(this->_type);
+}
+
+
+/*
+ * trrojan::d3d11::random_sphere_data_set::allocate
+ */
+std::shared_ptr<trrojan::d3d11::random_sphere_data_set>
+trrojan::d3d11::random_sphere_data_set::allocate(const sphere_type sphereType,
+        const size_type cntParticles,
+        const std::array<float, 3>& domainSize,
+        const std::array<float, 2>& sphereSize,
+        const std::uint32_t seed) {
+    std::shared_ptr<random_sphere_data_set> retval(
+        new random_sphere_data_set());
+
+    // Compute bounding box from domain size.
+    for (size_t i = 0; i < std::size(domainSize); ++i) {
+        retval->_bbox[0][i] = -0.5f * domainSize[i];
+        retval->_bbox[1][i] = 0.5f * domainSize[i];
+    }
+
+    retval->_layout = random_sphere_data_set::get_input_layout(sphereType);
+    retval->_seed = seed;
+    retval->_sphere_size = sphereSize;
+    retval->_size = cntParticles;
+    retval->_type = sphereType;
+
+    return retval;
+}
+
+
+/*
+ * trrojan::d3d11::random_sphere_data_set::upload
+ */
+void trrojan::d3d11::random_sphere_data_set::upload(ID3D11Device *device,
+        const create_flags flags,
+        const std::vector<std::uint8_t>& particles) {
+    static const create_flags VALID_INPUT_FLAGS // Flags directly copied from user input.
+        = sphere_data_set_base::property_structured_resource;
+    D3D11_BUFFER_DESC bufferDesc;
+    D3D11_SUBRESOURCE_DATA id;
+
+    if (device == nullptr) {
+        throw std::invalid_argument("The Direct3D device to create the vertex "
+            "buffer on must not be nullptr.");
+    }
+
+    this->_properties = random_sphere_data_set::get_properties(this->_type);
+    this->_properties |= (flags & VALID_INPUT_FLAGS);
+
     ::ZeroMemory(&bufferDesc, sizeof(bufferDesc));
     bufferDesc.ByteWidth = static_cast<UINT>(particles.size());
     bufferDesc.Usage = D3D11_USAGE_IMMUTABLE;
     bufferDesc.CPUAccessFlags = 0;
     if ((flags & property_structured_resource) != 0) {
         bufferDesc.BindFlags = D3D11_BIND_SHADER_RESOURCE;
-        bufferDesc.StructureByteStride = get_stride(particleDesc.type);
+        bufferDesc.StructureByteStride = get_stride(this->_type);
         bufferDesc.MiscFlags = D3D11_RESOURCE_MISC_BUFFER_STRUCTURED;
     } else {
         bufferDesc.BindFlags = D3D11_BIND_VERTEX_BUFFER;
@@ -184,24 +272,6 @@ void trrojan::d3d11::random_sphere_data_set::recreate(ID3D11Device *device,
 }
 
 
-/*
- * trrojan::d3d11::random_sphere_data_set::size
- */
-trrojan::d3d11::random_sphere_data_set::size_type
-trrojan::d3d11::random_sphere_data_set::size(void) const {
-    return this->_size;
-}
-
-
-/*
- * trrojan::d3d11::random_sphere_data_set::stride
- */
-trrojan::d3d11::random_sphere_data_set::size_type
-trrojan::d3d11::random_sphere_data_set::stride(void) const {
-    return random_sphere_data_set::get_stride(this->_type);
-}
-
-
 /*
  * trrojan::d3d11::random_sphere_data_set::minmax
  */
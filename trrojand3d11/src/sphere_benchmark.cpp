@@ -560,7 +560,8 @@ trrojan::result trrojan::d3d11::sphere_benchmark::on_run(d3d11::device& device,
     // Do the wall clock measurement.
     log::instance().write_line(log_level::debug, "Measuring wall clock "
         "timings over {} iterations ...", cntCpuIterations);
-    const auto powerUid = benchmark_base::enter_power_scope(powerCollector);
+    power_scope powerScope(powerCollector);
+    const auto powerUid = powerScope.uid();
     cpuTimer.start();
     for (std::uint32_t i = 0; i < cntCpuIterations; ++i) {
         this->clear_target();
@@ -579,7 +580,7 @@ trrojan::result trrojan::d3d11::sphere_benchmark::on_run(d3d11::device& device,
     ctx->End(this->done_query.get());
     wait_for_event_query(ctx.get(), this->done_query.get());
     auto cpuTime = cpuTimer.elapsed_millis();
-    benchmark_base::leave_power_scope(powerCollector);
+    powerScope.leave();
 
     // Compute derived statistics for GPU counters.
     std::sort(gpuTimes.begin(), gpuTimes.end());
@@ -615,6 +616,46 @@ trrojan::result trrojan::d3d11::sphere_benchmark::on_run(d3d11::device& device,
 }
 
 
+/*
+ * trrojan::d3d11::sphere_benchmark::prefetch
+ */
+void trrojan::d3d11::sphere_benchmark::prefetch(
+        const configuration& config) {
+    // Random spheres and MMPLD frames can be prepared without a device.
+    // Anything else, including invalid configurations, is handled once the
+    // configuration is actually run.
+    try {
+        auto conf = config.get<std::string>(factor_data_set);
+
+        try {
+            random_sphere_generator::parse_description(conf);
+        } catch (...) {
+            // Like in on_run, anything that is not random spheres is
+            // interpreted as the path to an MMPLD file.
+            auto frame = config.get<frame_type>(factor_frame);
+            this->mmpld_frames.prefetch(
+                mmpld_data_set::frame_key(conf, frame),
+                [conf, frame](void) {
+                    return mmpld_data_set::read_frame_data(conf, frame);
+                });
+            return;
+        }
+
+        auto flags = static_cast<random_sphere_data_set::create_flags>(
+            sphere_benchmark::get_shader_id(config));
+        if (config.get<bool>(factor_force_float_colour)) {
+            flags |= random_sphere_data_set::property_float_colour;
+        }
+
+        this->random_spheres.prefetch(
+            random_sphere_data_set::particle_key(flags, conf),
+            [flags, conf](void) {
+                return random_sphere_data_set::generate(flags, conf);
+            });
+    } catch (...) { }
+}
+
+
 /*
  * trrojan::d3d11::sphere_benchmark::get_shader_file_id
  */
@@ -984,7 +1025,7 @@ void trrojan::d3d11::sphere_benchmark::load_mmpld_frame(ID3D11Device *dev,
 
     log::instance().write_line(log_level::verbose, "Loading MMPLD frame {} ...",
         f);
-    d->read_frame(dev, f, flags);
+    d->read_frame(dev, f, flags, &this->mmpld_frames);
 }
 
 
@@ -1002,5 +1043,6 @@ void trrojan::d3d11::sphere_benchmark::make_random_spheres(
         flags |= random_sphere_data_set::property_float_colour;
     }
 
-    this->data = random_sphere_data_set::create(dev, flags, conf);
+    this->data = random_sphere_data_set::create(dev, flags, conf,
+        &this->random_spheres);
 }
@@ -417,7 +417,8 @@ trrojan::result trrojan::d3d11::two_pass_volume_benchmark::on_run(
     // Do the wall clock measurement.
     log::instance().write_line(log_level::debug, "Measuring wall clock "
         "timings over {} iterations ...", cntCpuIterations);
-    const auto powerUid = benchmark_base::enter_power_scope(powerCollector);
+    power_scope powerScope(powerCollector);
+    const auto powerUid = powerScope.uid();
     cpuTimer.start();
     for (std::uint32_t i = 0; i < cntCpuIterations; ++i) {
         this->clear_target();
@@ -432,7 +433,7 @@ trrojan::result trrojan::d3d11::two_pass_volume_benchmark::on_run(
     ctx->End(this->done_query.get());
     wait_for_event_query(ctx.get(), this->done_query.get());
     auto cpuTime = cpuTimer.elapsed_millis();
-    benchmark_base::leave_power_scope(powerCollector);
+    powerScope.leave();
 
     // Compute derived statistics for GPU counters.
     std::sort(gpuTimes.begin(), gpuTimes.end());
@@ -12,6 +12,7 @@
 
 #include "trrojan/com_error_category.h"
 #include "trrojan/io.h"
+#include "trrojan/trace.h"
 
 
 /*
@@ -81,6 +82,7 @@ winrt::com_ptr<ID3D11Texture2D> trrojan::d3d11::create_compatible_surface(
  */
 winrt::com_ptr<ID3D11ComputeShader> trrojan::d3d11::create_compute_shader(
         ID3D11Device *device, const BYTE *byteCode, const size_t cntByteCode) {
+    TRROJAN_TRACE_ZONE("d3d11::create_compute_shader", "shader");
     assert(device != nullptr);
     winrt::com_ptr<ID3D11ComputeShader> retval;
 
@@ -190,6 +192,7 @@ std::vector<D3D11_INPUT_ELEMENT_DESC>  trrojan::d3d11::create_cube(
  */
 winrt::com_ptr<ID3D11DomainShader> trrojan::d3d11::create_domain_shader(
         ID3D11Device *device, const BYTE *byteCode, const size_t cntByteCode) {
+    TRROJAN_TRACE_ZONE("d3d11::create_domain_shader", "shader");
     assert(device != nullptr);
     winrt::com_ptr<ID3D11DomainShader> retval;
 
@@ -229,6 +232,7 @@ winrt::com_ptr<ID3D11Query> trrojan::d3d11::create_event_query(
 */
 winrt::com_ptr<ID3D11GeometryShader> trrojan::d3d11::create_geometry_shader(
     ID3D11Device *device, const BYTE *byteCode, const size_t cntByteCode) {
+    TRROJAN_TRACE_ZONE("d3d11::create_geometry_shader", "shader");
     assert(device != nullptr);
     winrt::com_ptr<ID3D11GeometryShader> retval;
 
@@ -261,6 +265,7 @@ winrt::com_ptr<ID3D11GeometryShader> trrojan::d3d11::create_geometry_shader(
         const D3D11_SO_DECLARATION_ENTRY * soDecls, const size_t cntSoDecls,
         const UINT *bufferStrides, const size_t cntBufferStrides,
         const UINT rasterisedStream) {
+    TRROJAN_TRACE_ZONE("d3d11::create_geometry_shader", "shader");
     assert(device != nullptr);
     winrt::com_ptr<ID3D11GeometryShader> retval;
 
@@ -284,6 +289,7 @@ winrt::com_ptr<ID3D11GeometryShader> trrojan::d3d11::create_geometry_shader(
 winrt::com_ptr<ID3D11HullShader> trrojan::d3d11::create_hull_shader(
         ID3D11Device *device, const BYTE *byteCode,
         const size_t cntByteCode) {
+    TRROJAN_TRACE_ZONE("d3d11::create_hull_shader", "shader");
     assert(device != nullptr);
     winrt::com_ptr<ID3D11HullShader> retval;
 
@@ -369,6 +375,7 @@ winrt::com_ptr<ID3D11Query> trrojan::d3d11::create_pipline_stats_query(
  */
 winrt::com_ptr<ID3D11PixelShader> trrojan::d3d11::create_pixel_shader(
         ID3D11Device *device, const BYTE *byteCode, const size_t cntByteCode) {
+    TRROJAN_TRACE_ZONE("d3d11::create_pixel_shader", "shader");
     assert(device != nullptr);
     assert(byteCode != nullptr);
     winrt::com_ptr<ID3D11PixelShader> retval;
@@ -462,6 +469,7 @@ winrt::com_ptr<ID3D11UnorderedAccessView> trrojan::d3d11::create_uav(
  */
 winrt::com_ptr<ID3D11VertexShader> trrojan::d3d11::create_vertex_shader(
         ID3D11Device *device, const BYTE *byteCode, const size_t cntByteCode) {
+    TRROJAN_TRACE_ZONE("d3d11::create_vertex_shader", "shader");
     assert(device != nullptr);
     assert(byteCode != nullptr);
     winrt::com_ptr<ID3D11VertexShader> retval;
@@ -376,7 +376,8 @@ trrojan::result trrojan::d3d12::cs_volume_benchmark::on_run(
     // Do the wall clock measurement using the prepared command lists.
     log::instance().write_line(log_level::debug, "Measuring wall clock "
         "timings over {} iterations ...", mctx.cpu_iterations);
-    const auto power_uid = benchmark_base::enter_power_scope(power_collector);
+    power_scope scope(power_collector);
+    const auto power_uid = scope.uid();
     mctx.cpu_timer.start();
     for (std::uint32_t i = 0; i < mctx.cpu_iterations; ++i) {
         auto cmd_list = cmd_lists[this->buffer_index()];
@@ -385,7 +386,7 @@ trrojan::result trrojan::d3d12::cs_volume_benchmark::on_run(
     }
     device.wait_for_gpu();
     const auto cpu_time = mctx.cpu_timer.elapsed_millis();
-    benchmark_base::leave_power_scope(power_collector);
+    scope.leave();
 #endif
 
 #if 1
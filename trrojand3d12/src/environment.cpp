@@ -49,7 +49,19 @@ size_t trrojan::d3d12::environment::get_devices(device_list& dst) {
 /*
  * trrojan::d3d12::environment::on_activate
  */
-void trrojan::d3d12::environment::on_activate(void) { }
+void trrojan::d3d12::environment::on_activate(void) {
+#if !defined(TRROJAN_FOR_UWP)
+    // Initialise COM (for WIC) on the thread running the benchmarks, which is
+    // not necessarily the one that has initialised the environment.
+    if (!this->_com_initialised) {
+        auto hr = ::CoInitialize(nullptr);
+        if (FAILED(hr)) {
+            throw std::system_error(hr, com_category());
+        }
+        this->_com_initialised = true;
+    }
+#endif /* !defined(TRROJAN_FOR_UWP) */
+}
 
 
 /*
@@ -75,7 +87,10 @@ void trrojan::d3d12::environment::on_deactivate(void) {
 void trrojan::d3d12::environment::on_finalise(void) {
     this->_devices.clear();
 #if !defined(TRROJAN_FOR_UWP)
-    ::CoUninitialize();
+    if (this->_com_initialised) {
+        ::CoUninitialize();
+        this->_com_initialised = false;
+    }
 #endif /* !defined(TRROJAN_FOR_UWP) */
 }
 
@@ -92,16 +107,6 @@ void trrojan::d3d12::environment::on_initialise(const cmd_line& cmdLine) {
         cmdLine.begin(), cmdLine.end());
     std::set<std::pair<UINT, UINT>> pciIds;
 
-#if !defined(TRROJAN_FOR_UWP)
-    // Initialise COM (for WIC).
-    {
-        auto hr = ::CoInitialize(nullptr);
-        if (FAILED(hr)) {
-            throw std::system_error(hr, com_category());
-        }
-    }
-#endif /* !defined(TRROJAN_FOR_UWP) */
-
     // Enable the debug layer in debug builds, which requires the debugging
     // layer being installed like for D3D11. Enabling the debug layer after
     // device creation will invalidate the active device.
@@ -8,6 +8,7 @@
 
 #include "trrojan/com_error_category.h"
 #include "trrojan/log.h"
+#include "trrojan/trace.h"
 
 
 /*
@@ -103,6 +104,7 @@ trrojan::d3d12::graphics_pipeline_builder::graphics_pipeline_builder(void)
  */
 winrt::com_ptr<ID3D12PipelineState>
 trrojan::d3d12::graphics_pipeline_builder::build(ID3D12Device2 *device) {
+    TRROJAN_TRACE_ZONE("d3d12::graphics_pipeline_builder::build", "shader");
     if (device == nullptr) {
         throw std::system_error(E_POINTER, com_category());
     }
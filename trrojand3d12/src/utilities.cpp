@@ -12,6 +12,7 @@
 #include "trrojan/com_error_category.h"
 #include "trrojan/log.h"
 #include "trrojan/io.h"
+#include "trrojan/trace.h"
 
 #include "trrojan/d3d12/graphics_pipeline_builder.h"
 
@@ -207,6 +208,7 @@ winrt::com_ptr<ID3D12Resource> trrojan::d3d12::create_buffer(ID3D12Device *devic
 winrt::com_ptr<ID3D12PipelineState> trrojan::d3d12::create_compute_pipeline(
         ID3D12Device *device, const BYTE *shader, const SIZE_T size,
         ID3D12RootSignature *signature) {
+    TRROJAN_TRACE_ZONE("d3d12::create_compute_pipeline", "shader");
     assert(device != nullptr);
     assert(shader != nullptr);
     assert(signature != nullptr);
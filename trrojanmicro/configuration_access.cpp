@@ -0,0 +1,127 @@
+﻿// <copyright file="configuration_access.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+#include "trrojan/configuration.h"
+#include "trrojan/configuration_set.h"
+
+#include "micro_benchmark.h"
+
+
+namespace trrojan {
+namespace micro {
+namespace detail {
+
+    /// <summary>
+    /// Creates a configuration with <paramref name="count" /> factors and the
+    /// system factors as benchmarks see it.
+    /// </summary>
+    static configuration make_configuration(const std::size_t count) {
+        configuration retval;
+        for (std::size_t i = 0; i < count; ++i) {
+            auto name = "factor" + std::to_string(i);
+            if (i % 2 == 0) {
+                retval.add(name, static_cast<std::uint32_t>(i));
+            } else {
+                retval.add(name, name);
+            }
+        }
+        retval.add_system_factors();
+        return retval;
+    }
+
+    /// <summary>
+    /// Creates a configuration set with <paramref name="size" />
+    /// configurations, which must be a power of ten.
+    /// </summary>
+    static configuration_set make_configuration_set(std::size_t size) {
+        configuration_set retval;
+        for (std::size_t f = 0; size > 1; size /= 10, ++f) {
+            std::vector<std::uint32_t> manifestations(10);
+            for (std::uint32_t m = 0; m < manifestations.size(); ++m) {
+                manifestations[m] = m;
+            }
+            retval.add_factor(factor::from_manifestations(
+                "factor" + std::to_string(f), manifestations));
+        }
+        return retval;
+    }
+
+} /* end namespace detail */
+} /* end namespace micro */
+} /* end namespace trrojan */
+
+
+/*
+ * configuration_find
+ */
+TRROJAN_MICRO_BENCHMARK(configuration_find) {
+    const auto config = trrojan::micro::detail::make_configuration(20);
+
+    // The lookup is linear, so the last factor is the worst case.
+    trrojan::micro::measure("configuration_find (first)", settings,
+        [&config](const std::size_t) {
+            auto it = config.find("factor0");
+            trrojan::micro::do_not_optimise(it);
+        });
+
+    trrojan::micro::measure("configuration_find (last)", settings,
+        [&config](const std::size_t) {
+            auto it = config.find("factor19");
+            trrojan::micro::do_not_optimise(it);
+        });
+
+    trrojan::micro::measure("configuration_find (missing)", settings,
+        [&config](const std::size_t) {
+            auto it = config.find("no_such_factor");
+            trrojan::micro::do_not_optimise(it);
+        });
+}
+
+
+/*
+ * configuration_get
+ */
+TRROJAN_MICRO_BENCHMARK(configuration_get) {
+    const auto config = trrojan::micro::detail::make_configuration(20);
+
+    trrojan::micro::measure("configuration_get (uint32)", settings,
+        [&config](const std::size_t) {
+            auto v = config.get<std::uint32_t>("factor10");
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    trrojan::micro::measure("configuration_get (string)", settings,
+        [&config](const std::size_t) {
+            auto v = config.get<std::string>("factor11");
+            trrojan::micro::do_not_optimise(v);
+        });
+}
+
+
+/*
+ * configuration_set_foreach
+ */
+TRROJAN_MICRO_BENCHMARK(configuration_set_foreach) {
+    for (auto size : trrojan::micro::problem_sizes(settings)) {
+        const auto set = trrojan::micro::detail::make_configuration_set(size);
+        const auto name = "configuration_set_foreach ("
+            + std::to_string(size) + ")";
+
+        // Reported per configuration, which includes reading one factor as
+        // every benchmark does.
+        trrojan::micro::measure_batch(name, settings, size, [&set](void) {
+            set.foreach_configuration([](trrojan::configuration& c) {
+                auto v = c.get<std::uint32_t>("factor0");
+                trrojan::micro::do_not_optimise(v);
+                return true;
+            });
+        });
+    }
+}
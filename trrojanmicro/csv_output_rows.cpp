@@ -0,0 +1,78 @@
+﻿// <copyright file="csv_output_rows.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <algorithm>
+#include <cinttypes>
+#include <memory>
+#include <string>
+
+#include "trrojan/csv_output.h"
+#include "trrojan/csv_output_params.h"
+#include "trrojan/journal.h"
+#include "trrojan/result.h"
+#include "trrojan/temp_file.h"
+
+#include "micro_benchmark.h"
+
+
+/*
+ * csv_output_rows
+ */
+TRROJAN_MICRO_BENCHMARK(csv_output_rows) {
+    auto path = trrojan::temp_file::create("trrojanmicro");
+    auto journal = trrojan::temp_file::from_path(
+        trrojan::journal::path(path));
+
+    // A configuration like the ones of the rendering benchmarks.
+    trrojan::configuration config;
+    config.add("data_set", std::string("/data/volumes/"
+        "bonsai_256x256x256_uint8.dat"));
+    config.add("device", std::string("NVIDIA GeForce RTX 4090"));
+    config.add("frame", static_cast<std::uint32_t>(0));
+    config.add("iterations", static_cast<std::uint32_t>(8));
+    config.add("method", std::string("quad_inst"));
+    config.add("step_size_factor", 0.5f);
+    config.add("use_ERT", true);
+    config.add("use_ESS", false);
+    config.add("viewport_width", static_cast<std::uint32_t>(1024));
+    config.add("viewport_height", static_cast<std::uint32_t>(1024));
+    config.add_system_factors();
+
+    trrojan::basic_result result(config, { "gpu_time_median",
+        "gpu_time_min", "gpu_time_max", "wall_time" });
+    result.add({ 1.25, 1.0, 1.5, 10.0 });
+
+    // Without the journal, which would synchronise with the disk on every
+    // row and therefore not measure the formatting.
+    {
+        trrojan::csv_output output;
+        output.open(std::make_shared<trrojan::csv_output_params>(path,
+            trrojan::csv_output_params::default_separator, true,
+            trrojan::csv_output_params::default_line_break, false, 0));
+
+        trrojan::micro::measure("csv_output_rows", settings,
+            [&output, &result](const std::size_t) {
+                output << result;
+            });
+    }
+
+    // The default setting of trrojan.exe.
+    {
+        trrojan::csv_output output;
+        output.open(std::make_shared<trrojan::csv_output_params>(path,
+            trrojan::csv_output_params::default_separator, true,
+            trrojan::csv_output_params::default_line_break, false,
+            trrojan::csv_output_params::default_journal_interval));
+
+        auto s = settings;
+        s.operations = (std::max)(settings.operations / 100,
+            static_cast<std::size_t>(1));
+        trrojan::micro::measure("csv_output_rows (journal)", s,
+            [&output, &result](const std::size_t) {
+                output << result;
+            });
+    }
+}
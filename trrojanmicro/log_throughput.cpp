@@ -0,0 +1,71 @@
+﻿// <copyright file="log_throughput.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "trrojan/log.h"
+#include "trrojan/on_exit.h"
+
+#include "micro_benchmark.h"
+
+
+/*
+ * log_write_line
+ */
+TRROJAN_MICRO_BENCHMARK(log_write_line) {
+    auto& log = trrojan::log::instance();
+    const auto mode = log.is_async() ? " (async)" : " (sync)";
+
+    // The cost on the calling thread, which is what a benchmark would see.
+    trrojan::micro::measure(std::string("log_write_line") + mode, settings,
+        [&log](const std::size_t i) {
+            log.write_line(trrojan::log_level::information, "Completed "
+                "configuration #{0}. ", i);
+        });
+    log.flush();
+
+    // The throughput of the sinks, including draining the queue.
+    trrojan::micro::measure(std::string("log_write_line_flushed") + mode,
+        settings, [&log](const std::size_t i) {
+            log.write_line(trrojan::log_level::information, "Completed "
+                "configuration #{0}. ", i);
+        }, [&log](void) { log.flush(); });
+}
+
+
+/*
+ * log_write_line_deferred
+ */
+TRROJAN_MICRO_BENCHMARK(log_write_line_deferred) {
+    auto& log = trrojan::log::instance();
+    const auto mode = log.is_async() ? " (async)" : " (sync)";
+
+    // The messages are only written when the scope is left, which is not
+    // part of the measurement.
+    {
+        log.enter_measurement_scope();
+        on_exit([&log](void) { log.leave_measurement_scope(); });
+        trrojan::micro::measure(std::string("log_write_line_deferred") + mode,
+            settings, [&log](const std::size_t i) {
+                log.write_line(trrojan::log_level::information, "Completed "
+                    "configuration #{0}. ", i);
+            });
+    }
+    log.flush();
+}
+
+
+/*
+ * log_filtered
+ */
+TRROJAN_MICRO_BENCHMARK(log_filtered) {
+    auto& log = trrojan::log::instance();
+
+    // Messages below the level of the logger, which are debug messages in
+    // release builds, should be almost free.
+    trrojan::micro::measure("log_filtered", settings,
+        [&log](const std::size_t i) {
+            log.write_line(trrojan::log_level::debug, "Iteration {0}.", i);
+        });
+}
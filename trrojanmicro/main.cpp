@@ -0,0 +1,108 @@
+﻿// <copyright file="main.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <iostream>
+
+#include "trrojan/cmd_line.h"
+#include "trrojan/csv_output_params.h"
+#include "trrojan/log.h"
+#include "trrojan/text.h"
+
+#include "micro_benchmark.h"
+
+
+/// <summary>
+/// Entry point of the micro-benchmarks of the TRRojan core.
+/// </summary>
+/// <remarks>
+/// The program accepts <c>--log &lt;path&gt;</c> and <c>--async-log</c> like
+/// trrojan.exe, <c>--operations &lt;count&gt;</c>,
+/// <c>--repetitions &lt;count&gt;</c> and
+/// <c>--configurations &lt;count&gt;</c> to control the measurements and
+/// <c>--filter &lt;string&gt;</c> to run only the benchmarks whose name
+/// contains the given string. If <c>--output &lt;path&gt;</c> is given, all
+/// repetitions are written to the given CSV file, which honours the same
+/// options as the CSV output of trrojan.exe.
+/// </remarks>
+/// <param name="argc"></param>
+/// <param name="argv"></param>
+/// <returns>Zero in case of success, -1 in case of an uncaught exception.
+/// </returns>
+int main(const int argc, const char **argv) {
+    const trrojan::cmd_line cmdLine(argv, argv + argc);
+    trrojan::micro::settings settings { 1000000, 10000, 11 };
+    std::string filter;
+
+    try {
+        {
+            auto it = trrojan::find_argument("--log", cmdLine.begin(),
+                cmdLine.end());
+            auto queueSize = trrojan::contains_switch("--async-log",
+                cmdLine.begin(), cmdLine.end())
+                ? trrojan::log::default_queue_size
+                : 0;
+            if ((it != cmdLine.end()) || (queueSize > 0)) {
+                auto& l = trrojan::log::instance((it != cmdLine.end())
+                    ? it->c_str()
+                    : nullptr, queueSize);
+            }
+        }
+
+        {
+            auto it = trrojan::find_argument("--configurations",
+                cmdLine.begin(), cmdLine.end());
+            if (it != cmdLine.end()) {
+                settings.configurations = trrojan::parse<std::size_t>(*it);
+            }
+        }
+
+        {
+            auto it = trrojan::find_argument("--operations", cmdLine.begin(),
+                cmdLine.end());
+            if (it != cmdLine.end()) {
+                settings.operations = trrojan::parse<std::size_t>(*it);
+            }
+        }
+
+        {
+            auto it = trrojan::find_argument("--repetitions", cmdLine.begin(),
+                cmdLine.end());
+            if (it != cmdLine.end()) {
+                settings.repetitions = trrojan::parse<std::size_t>(*it);
+            }
+        }
+
+        {
+            auto it = trrojan::find_argument("--filter", cmdLine.begin(),
+                cmdLine.end());
+            if (it != cmdLine.end()) {
+                filter = *it;
+            }
+        }
+
+        {
+            auto it = trrojan::find_argument("--output", cmdLine.begin(),
+                cmdLine.end());
+            if (it != cmdLine.end()) {
+                trrojan::micro::open_output(std::make_shared<
+                    trrojan::csv_output_params>(*it, cmdLine.begin(),
+                    cmdLine.end()));
+            }
+        }
+
+        for (auto& b : trrojan::micro::registered_benchmarks()) {
+            if (b.name.find(filter) != std::string::npos) {
+                b.benchmark(settings);
+            }
+        }
+
+        trrojan::micro::close_output();
+        return 0;
+    } catch (std::exception& ex) {
+        std::cerr << ex.what() << std::endl;
+        return -1;
+    }
+}
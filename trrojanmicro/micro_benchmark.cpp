@@ -0,0 +1,140 @@
+﻿// <copyright file="micro_benchmark.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include "micro_benchmark.h"
+
+#include <cmath>
+#include <cstdio>
+#include <memory>
+
+#include "trrojan/csv_output.h"
+#include "trrojan/result.h"
+
+
+namespace trrojan {
+namespace micro {
+namespace detail {
+
+    /// <summary>
+    /// The output the repetitions are written to if any.
+    /// </summary>
+    static std::unique_ptr<csv_output>& output(void) {
+        static std::unique_ptr<csv_output> retval;
+        return retval;
+    }
+
+    /// <summary>
+    /// The sink of <see cref="trrojan::micro::detail::publish" />, which the
+    /// compiler cannot prove to be unused.
+    /// </summary>
+    static const void *volatile sink = nullptr;
+
+} /* end namespace detail */
+} /* end namespace micro */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::micro::close_output
+ */
+void trrojan::micro::close_output(void) {
+    auto& output = detail::output();
+    if (output != nullptr) {
+        output->close();
+        output.reset();
+    }
+}
+
+
+/*
+ * trrojan::micro::detail::publish
+ */
+void trrojan::micro::detail::publish(const void *value) {
+    detail::sink = value;
+}
+
+
+/*
+ * trrojan::micro::open_output
+ */
+void trrojan::micro::open_output(const output_params& params) {
+    close_output();
+    auto& output = detail::output();
+    output.reset(new csv_output());
+    output->open(params);
+}
+
+
+/*
+ * trrojan::micro::problem_sizes
+ */
+std::vector<std::size_t> trrojan::micro::problem_sizes(
+        const settings& settings) {
+    std::vector<std::size_t> retval;
+    for (std::size_t s = 1000; s <= settings.configurations; s *= 10) {
+        retval.push_back(s);
+    }
+    return retval;
+}
+
+
+/*
+ * trrojan::micro::registered_benchmarks
+ */
+std::vector<trrojan::micro::registered_benchmark>&
+trrojan::micro::registered_benchmarks(void) {
+    // Function-local, because the registrars run during static
+    // initialisation.
+    static std::vector<registered_benchmark> retval;
+    return retval;
+}
+
+
+/*
+ * trrojan::micro::report
+ */
+void trrojan::micro::report(const std::string& name,
+        const std::size_t operations,
+        std::vector<timer::millis_type> millis) {
+    if (millis.empty() || (operations == 0)) {
+        return;
+    }
+
+    const auto toNanos = 1000000.0 / static_cast<double>(operations);
+
+    // Write the repetitions in the order they have been measured.
+    auto& output = detail::output();
+    if (output != nullptr) {
+        configuration config;
+        config.add("benchmark", name);
+        basic_result result(configuration::with_system_factors(config),
+            { "ns_per_op" });
+        for (auto m : millis) {
+            result.add({ m * toNanos });
+        }
+        *output << result;
+    }
+
+    std::sort(millis.begin(), millis.end());
+    const auto median = millis[millis.size() / 2];
+
+    std::vector<timer::millis_type> deviations;
+    deviations.reserve(millis.size());
+    for (auto m : millis) {
+        deviations.push_back(std::abs(m - median));
+    }
+    std::nth_element(deviations.begin(),
+        deviations.begin() + deviations.size() / 2, deviations.end());
+    const auto mad = deviations[deviations.size() / 2];
+
+    std::printf("%-48s %12.1f ns/op +/- %4.1f %% (min %.1f, max %.1f) "
+        "%14.0f op/s\n",
+        name.c_str(), median * toNanos,
+        (median > 0.0) ? 100.0 * mad / median : 0.0,
+        millis.front() * toNanos, millis.back() * toNanos,
+        (median > 0.0) ? operations * 1000.0 / median : 0.0);
+    std::fflush(stdout);
+}
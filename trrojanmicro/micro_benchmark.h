@@ -0,0 +1,246 @@
+﻿// <copyright file="micro_benchmark.h" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <algorithm>
+#include <functional>
+#include <string>
+#include <vector>
+
+#if defined(_MSC_VER)
+#include <intrin.h>
+#endif /* defined(_MSC_VER) */
+
+#include "trrojan/output_params.h"
+#include "trrojan/timer.h"
+
+
+namespace trrojan {
+namespace micro {
+
+    /// <summary>
+    /// The settings for running the micro-benchmarks.
+    /// </summary>
+    struct settings {
+
+        /// <summary>
+        /// The largest number of configurations the benchmarks working on
+        /// configuration sets should be run with.
+        /// </summary>
+        std::size_t configurations;
+
+        /// <summary>
+        /// The number of operations timed in one repetition.
+        /// </summary>
+        std::size_t operations;
+
+        /// <summary>
+        /// The number of times each measurement is repeated.
+        /// </summary>
+        std::size_t repetitions;
+    };
+
+    /// <summary>
+    /// The signature of a micro-benchmark.
+    /// </summary>
+    typedef std::function<void(const settings&)> benchmark_type;
+
+    /// <summary>
+    /// A named micro-benchmark.
+    /// </summary>
+    struct registered_benchmark {
+        benchmark_type benchmark;
+        std::string name;
+    };
+
+    /// <summary>
+    /// Answer all micro-benchmarks that have been registered using
+    /// <see cref="TRROJAN_MICRO_BENCHMARK" />.
+    /// </summary>
+    std::vector<registered_benchmark>& registered_benchmarks(void);
+
+    /// <summary>
+    /// Adds a micro-benchmark to <see cref="registered_benchmarks" /> when
+    /// the program is loaded.
+    /// </summary>
+    struct registrar {
+        inline registrar(const char *name, const benchmark_type& benchmark) {
+            registered_benchmarks().push_back({ benchmark, name });
+        }
+    };
+
+    /// <summary>
+    /// Closes the output opened by <see cref="open_output" /> if any.
+    /// </summary>
+    void close_output(void);
+
+namespace detail {
+
+    /// <summary>
+    /// Publishes <paramref name="value" /> in a global the compiler cannot
+    /// prove to be unused, which is only required if there is no inline
+    /// assembly.
+    /// </summary>
+    void publish(const void *value);
+
+} /* end namespace detail */
+
+    /// <summary>
+    /// Prevents the compiler from optimising away the computation of the
+    /// object at <paramref name="value" />.
+    /// </summary>
+    /// <remarks>
+    /// The empty assembly pretends to read the pointer and all of memory,
+    /// so all stores to the object must have happened before, but it does
+    /// not emit any instruction. MSVC has no inline assembly on x64, so the
+    /// pointer is published and the compiler barrier prevents reordering.
+    /// </remarks>
+    inline void escape(const void *value) {
+#if defined(__GNUC__) || defined(__clang__)
+        asm volatile("" : : "g"(value) : "memory");
+#elif defined(_MSC_VER)
+        detail::publish(value);
+        ::_ReadWriteBarrier();
+#else /* defined(__GNUC__) || defined(__clang__) */
+        detail::publish(value);
+#endif /* defined(__GNUC__) || defined(__clang__) */
+    }
+
+    /// <summary>
+    /// Prevents the compiler from optimising away the computation of
+    /// <paramref name="value" />.
+    /// </summary>
+    template<class T> inline void do_not_optimise(const T& value) {
+        escape(&value);
+    }
+
+    /// <summary>
+    /// Opens a CSV file to which <see cref="report" /> writes the time per
+    /// operation of every repetition in addition to the console.
+    /// </summary>
+    /// <remarks>
+    /// The file has a column &quot;benchmark&quot; holding the name of the
+    /// measurement, the system factors and a column &quot;ns_per_op&quot;,
+    /// such that the files of two runs can be compared using
+    /// <c>trrojan --compare</c> with <c>--factors benchmark</c>.
+    /// </remarks>
+    /// <param name="params">The parameters of the CSV output.</param>
+    void open_output(const output_params& params);
+
+    /// <summary>
+    /// Answer the problem sizes for benchmarks working on configuration sets,
+    /// which are the powers of ten starting at 10^3 and not exceeding
+    /// <see cref="settings::configurations" />.
+    /// </summary>
+    std::vector<std::size_t> problem_sizes(const settings& settings);
+
+    /// <summary>
+    /// Prints the median, minimum and maximum time per operation of the
+    /// given repetitions of a measurement.
+    /// </summary>
+    /// <remarks>
+    /// The spread is reported as the median absolute deviation relative to
+    /// the median, which is robust against the outliers caused by
+    /// interrupts and preemption.
+    /// </remarks>
+    /// <param name="name">The name of the measurement.</param>
+    /// <param name="operations">The number of operations in each
+    /// repetition.</param>
+    /// <param name="millis">The wall-clock time of each repetition in
+    /// milliseconds.</param>
+    void report(const std::string& name, const std::size_t operations,
+        std::vector<timer::millis_type> millis);
+
+    /// <summary>
+    /// Repeatedly times <paramref name="operation" /> and reports the results.
+    /// </summary>
+    /// <remarks>
+    /// An additional repetition that is not timed precedes the measurement
+    /// to warm up the caches and the allocator.
+    /// </remarks>
+    /// <param name="name">The name of the measurement.</param>
+    /// <param name="settings">The number of operations and repetitions.
+    /// </param>
+    /// <param name="operation">The operation to be measured, which is called
+    /// with the index of the operation within the repetition.</param>
+    /// <param name="epilogue">An optional function that is called after the
+    /// operations of each repetition and is part of the measurement, for
+    /// instance to wait for asynchronous work to complete.</param>
+    template<class TOperation>
+    void measure(const std::string& name, const settings& settings,
+            TOperation&& operation,
+            const std::function<void(void)>& epilogue = nullptr) {
+        std::vector<timer::millis_type> millis;
+        millis.reserve(settings.repetitions);
+
+        for (std::size_t i = 0; i < settings.operations; ++i) {
+            operation(i);
+        }
+        if (epilogue) {
+            epilogue();
+        }
+
+        for (std::size_t r = 0; r < settings.repetitions; ++r) {
+            timer t;
+            t.start();
+            for (std::size_t i = 0; i < settings.operations; ++i) {
+                operation(i);
+            }
+            if (epilogue) {
+                epilogue();
+            }
+            millis.push_back(t.elapsed_millis());
+        }
+
+        report(name, settings.operations, std::move(millis));
+    }
+
+    /// <summary>
+    /// Repeatedly times <paramref name="batch" />, which processes
+    /// <paramref name="items" /> items at once, and reports the time per item.
+    /// </summary>
+    /// <remarks>
+    /// This is used for operations that cannot be split into individual
+    /// calls, like enumerating a whole configuration set. An additional
+    /// repetition that is not timed precedes the measurement.
+    /// </remarks>
+    /// <param name="name">The name of the measurement.</param>
+    /// <param name="settings">The number of repetitions.</param>
+    /// <param name="items">The number of items processed by a single call
+    /// to <paramref name="batch" />.</param>
+    /// <param name="batch">The operation to be measured.</param>
+    template<class TBatch>
+    void measure_batch(const std::string& name, const settings& settings,
+            const std::size_t items, TBatch&& batch) {
+        std::vector<timer::millis_type> millis;
+        millis.reserve(settings.repetitions);
+
+        batch();
+
+        for (std::size_t r = 0; r < settings.repetitions; ++r) {
+            timer t;
+            t.start();
+            batch();
+            millis.push_back(t.elapsed_millis());
+        }
+
+        report(name, items, std::move(millis));
+    }
+
+} /* end namespace micro */
+} /* end namespace trrojan */
+
+
+/// <summary>
+/// Defines and registers a micro-benchmark named <paramref name="n" />, which
+/// receives the <see cref="trrojan::micro::settings" /> as
+/// <c>settings</c>.
+/// </summary>
+#define TRROJAN_MICRO_BENCHMARK(n)                                             \
+static void n(const trrojan::micro::settings& settings);                      \
+static const trrojan::micro::registrar n##_registrar(#n, n);                   \
+static void n(const trrojan::micro::settings& settings)
@@ -0,0 +1,50 @@
+﻿// <copyright file="system_factors_retrieval.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <algorithm>
+#include <iterator>
+#include <vector>
+
+#include "trrojan/configuration.h"
+#include "trrojan/named_variant.h"
+#include "trrojan/system_factors.h"
+
+#include "micro_benchmark.h"
+
+
+/*
+ * system_factors_get
+ */
+TRROJAN_MICRO_BENCHMARK(system_factors_get) {
+    auto& factors = trrojan::system_factors::instance();
+
+    // Every configuration is amended with the system factors before it is
+    // run, so this is paid once per configuration. The dynamic factors are
+    // read from the system, wherefore there are fewer operations.
+    auto s = settings;
+    s.operations = (std::max)(settings.operations / 100,
+        static_cast<std::size_t>(1));
+
+    trrojan::micro::measure("system_factors_get (all)", s,
+        [&factors](const std::size_t) {
+            std::vector<trrojan::named_variant> v;
+            factors.get(std::back_inserter(v));
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    trrojan::micro::measure("system_factors_get (os)", settings,
+        [&factors](const std::size_t) {
+            auto v = factors.get(trrojan::system_factors::factor_os);
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    trrojan::micro::measure("configuration_add_system_factors", s,
+        [](const std::size_t) {
+            trrojan::configuration c;
+            c.add_system_factors();
+            trrojan::micro::do_not_optimise(c);
+        });
+}
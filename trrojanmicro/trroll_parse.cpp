@@ -0,0 +1,82 @@
+﻿// <copyright file="trroll_parse.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <fstream>
+#include <stdexcept>
+#include <string>
+
+#include "trrojan/temp_file.h"
+#include "trrojan/trroll_parser.h"
+
+#include "micro_benchmark.h"
+
+
+namespace trrojan {
+namespace micro {
+namespace detail {
+
+    /// <summary>
+    /// Writes a trroll file with <paramref name="manifestations" />
+    /// manifestations in lines of ten, which are grouped into benchmarks of
+    /// 100 factors each.
+    /// </summary>
+    static void write_trroll(const std::string& path,
+            const std::size_t manifestations) {
+        std::ofstream file(path, std::ios::trunc | std::ios::binary);
+        const auto lines = (manifestations + 9) / 10;
+
+        for (std::size_t l = 0; l < lines; ++l) {
+            if (l % 100 == 0) {
+                file << "micro::benchmark" << (l / 100) << " {\n"
+                    << "    # generated by trrojanmicro\n";
+            }
+
+            if (l % 2 == 0) {
+                file << "    uint32 factor" << l << " =";
+                for (std::size_t m = 0; m < 10; ++m) {
+                    file << ((m > 0) ? "; " : " ") << (l + m);
+                }
+            } else {
+                file << "    string factor" << l << " =";
+                for (std::size_t m = 0; m < 10; ++m) {
+                    file << ((m > 0) ? "; " : " ") << "value" << m;
+                }
+            }
+            file << "\n";
+
+            if ((l % 100 == 99) || (l == lines - 1)) {
+                file << "}\n\n";
+            }
+        }
+
+        if (!file) {
+            throw std::runtime_error("Failed to write the trroll file.");
+        }
+    }
+
+} /* end namespace detail */
+} /* end namespace micro */
+} /* end namespace trrojan */
+
+
+/*
+ * trroll_parser_parse
+ */
+TRROJAN_MICRO_BENCHMARK(trroll_parser_parse) {
+    auto path = trrojan::temp_file::create("trrojanmicro");
+
+    for (auto size : trrojan::micro::problem_sizes(settings)) {
+        trrojan::micro::detail::write_trroll(path, size);
+        const auto name = "trroll_parser_parse (" + std::to_string(size)
+            + ")";
+
+        // Reported per manifestation, including reading the file.
+        trrojan::micro::measure_batch(name, settings, size, [&path](void) {
+            auto configs = trrojan::trroll_parser::parse(path.get());
+            trrojan::micro::do_not_optimise(configs);
+        });
+    }
+}
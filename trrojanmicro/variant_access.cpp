@@ -0,0 +1,95 @@
+﻿// <copyright file="variant_access.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+// </copyright>
+// <author>Christoph Müller</author>
+
+#include <cinttypes>
+#include <string>
+#include <vector>
+
+#include "trrojan/variant.h"
+
+#include "micro_benchmark.h"
+
+
+/*
+ * variant_construct
+ */
+TRROJAN_MICRO_BENCHMARK(variant_construct) {
+    trrojan::micro::measure("variant_construct (int32)", settings,
+        [](const std::size_t i) {
+            trrojan::variant v(static_cast<std::int32_t>(i));
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    trrojan::micro::measure("variant_construct (float64)", settings,
+        [](const std::size_t i) {
+            trrojan::variant v(static_cast<double>(i));
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    // Long enough to defeat the small string optimisation like most paths.
+    const std::string str("/data/volumes/bonsai_256x256x256_uint8.dat");
+    trrojan::micro::measure("variant_construct (string)", settings,
+        [&str](const std::size_t) {
+            trrojan::variant v(str);
+            trrojan::micro::do_not_optimise(v);
+        });
+}
+
+
+/*
+ * variant_copy
+ */
+TRROJAN_MICRO_BENCHMARK(variant_copy) {
+    const trrojan::variant num(static_cast<std::uint32_t>(42));
+    trrojan::micro::measure("variant_copy (uint32)", settings,
+        [&num](const std::size_t) {
+            trrojan::variant v(num);
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    const trrojan::variant str(std::string("/data/volumes/"
+        "bonsai_256x256x256_uint8.dat"));
+    trrojan::micro::measure("variant_copy (string)", settings,
+        [&str](const std::size_t) {
+            trrojan::variant v(str);
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    // The vector of results of a measurement is copied around as well.
+    std::vector<trrojan::variant> row(8, num);
+    trrojan::micro::measure("variant_copy (row of 8)", settings,
+        [&row](const std::size_t) {
+            std::vector<trrojan::variant> v(row);
+            trrojan::micro::do_not_optimise(v);
+        });
+}
+
+
+/*
+ * variant_as
+ */
+TRROJAN_MICRO_BENCHMARK(variant_as) {
+    const trrojan::variant num(static_cast<std::uint32_t>(42));
+    trrojan::micro::measure("variant_as (uint32)", settings,
+        [&num](const std::size_t) {
+            auto v = num.as<std::uint32_t>();
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    trrojan::micro::measure("variant_as (uint32 to float64)", settings,
+        [&num](const std::size_t) {
+            auto v = num.as<double>();
+            trrojan::micro::do_not_optimise(v);
+        });
+
+    const trrojan::variant str(std::string("/data/volumes/"
+        "bonsai_256x256x256_uint8.dat"));
+    trrojan::micro::measure("variant_as (string)", settings,
+        [&str](const std::size_t) {
+            auto v = str.as<std::string>();
+            trrojan::micro::do_not_optimise(v);
+        });
+}
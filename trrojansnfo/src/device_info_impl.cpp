@@ -5,6 +5,18 @@
 /// <author>Christoph Mller</author>
 
 #include "device_info_impl.h"
+
+#if !defined(_WIN32)
+#include <climits>
+#include <cstdlib>
+#include <iomanip>
+#include <sstream>
+#include <vector>
+
+#include <unistd.h>
+#include <sys/utsname.h>
+#endif /* !defined(_WIN32) */
+
 #include "setupapiutil.h"
 #include "utilities.h"
 
@@ -46,6 +58,121 @@ trrojan::sysinfo::detail::device_info_impl::device_info_impl(HDEVINFO hDev,
     this->_hardware_id = reinterpret_cast<char *>(hwid.data());
     this->_name = reinterpret_cast<char *>(desc.data());
 }
+
+#else /* defined(_WIN32) */
+/*
+ * trrojan::sysinfo::detail::device_info_impl::device_info_impl
+ */
+trrojan::sysinfo::detail::device_info_impl::device_info_impl(
+        const std::string& path) : _driver_date(0), _driver_version() {
+    const auto vendor = std::stoul(detail::read_first_line(
+        (path + "/vendor").c_str()), nullptr, 16);
+    const auto device = std::stoul(detail::read_first_line(
+        (path + "/device").c_str()), nullptr, 16);
+
+    // Mimic the hardware IDs reported by SetupAPI on Windows.
+    {
+        std::stringstream hwid;
+        hwid << "PCI\\VEN_" << std::hex << std::uppercase
+            << std::setw(4) << std::setfill('0') << vendor
+            << "&DEV_" << std::setw(4) << std::setfill('0') << device;
+        this->_hardware_id = hwid.str();
+    }
+
+    switch (vendor) {
+        case 0x1002: this->_manufacturer = "Advanced Micro Devices, Inc."; break;
+        case 0x10DE: this->_manufacturer = "NVIDIA Corporation"; break;
+        case 0x8086: this->_manufacturer = "Intel Corporation"; break;
+        default: this->_manufacturer = this->_hardware_id; break;
+    }
+    this->_name = this->_hardware_id;
+
+    // The driver and the PCI slot are the names of the targets of the
+    // symbolic links in sysfs.
+    std::string slot;
+    {
+        char buffer[PATH_MAX];
+        auto len = ::readlink((path + "/driver").c_str(), buffer,
+            sizeof(buffer) - 1);
+        if (len > 0) {
+            std::string driver(buffer, len);
+            this->_driver_provider = driver.substr(
+                driver.find_last_of('/') + 1);
+        }
+
+        if (::realpath(path.c_str(), buffer) != nullptr) {
+            slot = buffer;
+            slot = slot.substr(slot.find_last_of('/') + 1);
+        }
+    }
+
+    // Out-of-tree drivers like the one from NVIDIA report their version as
+    // module parameter, whereas the in-tree ones have the version of the
+    // kernel.
+    {
+        std::string version;
+
+        try {
+            version = detail::read_first_line(("/sys/module/"
+                + this->_driver_provider + "/version").c_str());
+        } catch (...) {
+            utsname names;
+            if (::uname(&names) == 0) {
+                version = names.release;
+            }
+        }
+
+        std::uint16_t *dst[] = {
+            &this->_driver_version.major,
+            &this->_driver_version.minor,
+            &this->_driver_version.build,
+            &this->_driver_version.revision
+        };
+        std::istringstream is(version);
+        for (auto d : dst) {
+            unsigned int value = 0;
+            if (!(is >> value)) {
+                break;
+            }
+            *d = static_cast<std::uint16_t>(value);
+            if ((is.peek() != '.') && (is.peek() != '-')) {
+                break;
+            }
+            is.get();
+        }
+    }
+
+    // The human-readable names are only available from the PCI ID database,
+    // which we query using lspci if it is installed. The machine-readable
+    // output has the form
+    // 01:00.0 "VGA compatible controller" "NVIDIA Corporation" "GA102" ...
+    if (!slot.empty()) {
+        try {
+            auto output = detail::invoke(("lspci -mm -s " + slot
+                + " 2>/dev/null").c_str());
+            std::vector<std::string> fields;
+            std::string::size_type end = 0;
+
+            while (true) {
+                auto begin = output.find('"', end);
+                if (begin == std::string::npos) {
+                    break;
+                }
+                end = output.find('"', ++begin);
+                if (end == std::string::npos) {
+                    break;
+                }
+                fields.push_back(output.substr(begin, end - begin));
+                ++end;
+            }
+
+            if (fields.size() >= 3) {
+                this->_manufacturer = fields[1];
+                this->_name = fields[2];
+            }
+        } catch (...) { /* Keep the IDs as fallback. */ }
+    }
+}
 #endif /* defined(_WIN32) */
 
 
@@ -32,6 +32,16 @@ namespace detail {
 
 #if defined(WIN32)
         device_info_impl(HDEVINFO hDev, SP_DEVINFO_DATA& data);
+#else /* defined(WIN32) */
+        /// <summary>
+        /// Initialises a new instance from the sysfs representation of a PCI
+        /// device.
+        /// </summary>
+        /// <param name="path">The path to the device directory, for instance
+        /// &quot;/sys/class/drm/card0/device&quot;.</param>
+        /// <exception cref="std::runtime_error">If the device is not a PCI
+        /// device, ie if its vendor could not be determined.</exception>
+        explicit device_info_impl(const std::string& path);
 #endif /* defined(WIN32) */
 
         virtual ~device_info_impl(void) = default;
@@ -10,6 +10,10 @@
 #include <iostream>
 #include <regex>
 
+#if !defined(_WIN32)
+#include <cctype>
+#endif /* !defined(_WIN32) */
+
 #include "setupapiutil.h"
 #include "utilities.h"
 
@@ -34,7 +38,42 @@ void trrojan::sysinfo::detail::hardware_info_impl::update(void) {
         }, DIGCF_PRESENT | DIGCF_PROFILE);
     }
 #else /* defined(_WIN32) */
-    // TODO: Implement
+    /* Enumerate the GPUs via the DRM subsystem. */
+    {
+        static const std::string root("/sys/class/drm/");
+        static const std::string prefix("card");
+        this->gpus.clear();
+
+        std::vector<std::string> cards;
+        try {
+            cards = detail::list_directory(root.c_str());
+        } catch (...) {
+            /* There is no DRM, so we do not know any GPUs. */
+        }
+
+        // Only "cardN" designates a GPU, whereas "cardN-HDMI-A-1" etc. are
+        // its connectors.
+        cards.erase(std::remove_if(cards.begin(), cards.end(),
+            [](const std::string& c) {
+                return ((c.compare(0, prefix.size(), prefix) != 0)
+                    || (c.size() == prefix.size())
+                    || !std::all_of(c.begin() + prefix.size(), c.end(),
+                        [](const char d) { return (std::isdigit(d) != 0); }));
+            }), cards.end());
+        std::sort(cards.begin(), cards.end(), [](const std::string& l,
+                const std::string& r) {
+            return ((l.size() < r.size())
+                || ((l.size() == r.size()) && (l < r)));
+        });
+
+        for (auto& c : cards) {
+            try {
+                this->gpus.emplace_back(root + c + "/device");
+            } catch (...) {
+                /* Not a PCI device, eg simpledrm. */
+            }
+        }
+    }
 #endif /* defined(_WIN32) */
 }
 
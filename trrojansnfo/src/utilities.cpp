@@ -12,8 +12,12 @@
 #include <fstream>
 #include <memory>
 #include <sstream>
+#include <stdexcept>
 #include <system_error>
 
+#if !defined(_WIN32)
+#include <dirent.h>
+#endif /* !defined(_WIN32) */
 
 
 /*
@@ -49,6 +53,40 @@ std::string trrojan::sysinfo::detail::invoke(const char *cmd) {
 }
 
 
+#if !defined(_WIN32)
+/*
+ * trrojan::sysinfo::detail::list_directory
+ */
+std::vector<std::string> trrojan::sysinfo::detail::list_directory(
+        const char *path) {
+    if (path == nullptr) {
+        throw std::invalid_argument("'path' must not be nullptr.");
+    }
+
+    std::shared_ptr<DIR> dir(::opendir(path), [](DIR *d) {
+        if (d != nullptr) {
+            ::closedir(d);
+        }
+    });
+    if (dir == nullptr) {
+        throw std::system_error(errno, std::system_category(),
+            "Failed to open the directory.");
+    }
+
+    std::vector<std::string> retval;
+    struct dirent *entry;
+    while ((entry = ::readdir(dir.get())) != nullptr) {
+        std::string name(entry->d_name);
+        if ((name != ".") && (name != "..")) {
+            retval.push_back(std::move(name));
+        }
+    }
+
+    return retval;
+}
+#endif /* !defined(_WIN32) */
+
+
 /*
  * trrojan::sysinfo::detail::read_all_bytes
  */
@@ -79,6 +117,31 @@ std::vector<std::uint8_t> trrojan::sysinfo::detail::read_all_bytes(
 }
 
 
+/*
+ * trrojan::sysinfo::detail::read_first_line
+ */
+std::string trrojan::sysinfo::detail::read_first_line(const char *path) {
+    if (path == nullptr) {
+        throw std::invalid_argument("'path' must not be nullptr.");
+    }
+
+    std::ifstream file(path, std::ios::in);
+    std::string retval;
+
+    if (!file || !std::getline(file, retval)) {
+        std::stringstream msg;
+        msg << "Failed to read from \"" << path << "\"" << std::ends;
+        throw std::runtime_error(msg.str());
+    }
+
+    // Remove trailing white spaces, which are common in sysfs.
+    auto end = retval.find_last_not_of(" \t\r\n");
+    retval.erase((end != std::string::npos) ? end + 1 : 0);
+
+    return retval;
+}
+
+
 #if defined(_WIN32)
 /*
  * trrojan::sysinfo::detail::read_reg_value
@@ -46,6 +46,28 @@ namespace detail {
     /// <exception cref="std::system_error"></exception>
     std::string invoke(const char *cmd);
 
+#if !defined(_WIN32)
+    /// <summary>
+    /// Answer the names of all entries in the directory
+    /// <paramref name="path" />, excluding &quot;.&quot; and &quot;..&quot;.
+    /// </summary>
+    /// <exception cref="std::system_error">If the directory could not be
+    /// opened.</exception>
+    std::vector<std::string> list_directory(const char *path);
+#endif /* !defined(_WIN32) */
+
+    /// <summary>
+    /// Reads the first line of a text file, which is typically used for the
+    /// attributes in sysfs.
+    /// </summary>
+    /// <remarks>
+    /// In contrast to <see cref="read_all_bytes" />, this function does not
+    /// rely on the file size, which is not meaningful for virtual files.
+    /// </remarks>
+    /// <exception cref="std::runtime_error">If the file could not be read.
+    /// </exception>
+    std::string read_first_line(const char *path);
+
 #if defined(_WIN32)
     /// <summary>
     /// Return the requested registry value below <paramref name="key" /> to
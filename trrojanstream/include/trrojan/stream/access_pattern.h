@@ -6,7 +6,11 @@
 
 #pragma once
 
+#include <algorithm>
+#include <numeric>
+#include <random>
 #include <string>
+#include <vector>
 
 #include "trrojan/enum_dispatch_list.h"
 
@@ -33,7 +37,105 @@ namespace stream {
         /// interleaved manner, ie all threads read in a spatially close range
         /// at approximately the same time.
         /// </summary>
-        interleaved
+        interleaved,
+
+        /// <summary>
+        /// This access pattern distributes blocks of
+        /// <see cref="access_pattern_parameters::block_size" /> elements
+        /// round-robin to the threads, ie it generalises
+        /// <see cref="interleaved" /> to coarser granularities.
+        /// </summary>
+        blocked,
+
+        /// <summary>
+        /// This access pattern instructs each thread to process its contiguous
+        /// range in blocks of
+        /// <see cref="access_pattern_parameters::block_size" /> elements, which
+        /// are visited in random order.
+        /// </summary>
+        random,
+
+        /// <summary>
+        /// This access pattern instructs each thread to visit its contiguous
+        /// range with a distance of
+        /// <see cref="access_pattern_parameters::stride" /> elements between
+        /// two accesses. The range is traversed as often as necessary to
+        /// access every element once.
+        /// </summary>
+        strided,
+
+        /// <summary>
+        /// This access pattern instructs each thread to interpret its
+        /// contiguous range as a row-major matrix with rows of
+        /// <see cref="access_pattern_parameters::row_length" /> elements and to
+        /// process it tile by tile.
+        /// </summary>
+        tiled
+    };
+
+
+    /// <summary>
+    /// The runtime parameters of the access patterns that are not fully
+    /// determined by the problem size and the number of threads.
+    /// </summary>
+    /// <remarks>
+    /// All sizes are given in number of elements rather than in bytes.
+    /// </remarks>
+    struct TRROJANSTREAM_API access_pattern_parameters {
+
+        /// <summary>
+        /// The number of elements in a block of
+        /// <see cref="access_pattern::blocked" /> and
+        /// <see cref="access_pattern::random" />.
+        /// </summary>
+        size_t block_size = 512;
+
+        /// <summary>
+        /// The number of elements in a row of the matrix that
+        /// <see cref="access_pattern::tiled" /> works on.
+        /// </summary>
+        size_t row_length = 4096;
+
+        /// <summary>
+        /// The distance between two accesses of
+        /// <see cref="access_pattern::strided" /> in number of elements.
+        /// </summary>
+        size_t stride = 16;
+
+        /// <summary>
+        /// The number of rows in a tile of
+        /// <see cref="access_pattern::tiled" />.
+        /// </summary>
+        size_t tile_height = 64;
+
+        /// <summary>
+        /// The number of elements in a row of a tile of
+        /// <see cref="access_pattern::tiled" />.
+        /// </summary>
+        size_t tile_width = 64;
+    };
+
+
+    /// <summary>
+    /// A sequence of <see cref="count" /> accesses starting at
+    /// <see cref="offset" /> with a distance of <see cref="step" /> elements.
+    /// </summary>
+    struct access_run {
+
+        /// <summary>
+        /// The index of the first element to be accessed.
+        /// </summary>
+        size_t offset;
+
+        /// <summary>
+        /// The number of elements to be accessed.
+        /// </summary>
+        size_t count;
+
+        /// <summary>
+        /// The distance between two accesses.
+        /// </summary>
+        size_t step;
     };
 
 
@@ -43,10 +145,18 @@ namespace stream {
     /// <see cref="trrojan::stream::access_pattern" /> and the problem size
     /// <tparamref name="P" />.
     /// </summary>
+    /// <remarks>
+    /// Patterns that depend on <see cref="access_pattern_parameters" /> cannot
+    /// be expressed by a constant offset and step. These patterns have the
+    /// flag <c>has_runs</c> set and provide a function <c>runs</c>, which
+    /// creates the <see cref="access_run" />s a thread must perform relative
+    /// to the begin of the arrays.
+    /// </remarks>
     template<access_pattern A, size_t P> struct access_pattern_traits { };
 
     template<size_t P>
     struct access_pattern_traits<access_pattern::contiguous, P> {
+        static constexpr bool has_runs = false;
         static inline size_t offset(const size_t rank) {
             return (rank * P);
         }
@@ -61,6 +171,7 @@ namespace stream {
 
     template<size_t P>
     struct access_pattern_traits<access_pattern::interleaved, P> {
+        static constexpr bool has_runs = false;
         static inline size_t offset(const size_t rank) {
             return rank;
         }
@@ -73,11 +184,138 @@ namespace stream {
         }
     };
 
+    template<size_t P>
+    struct access_pattern_traits<access_pattern::blocked, P> {
+        static constexpr bool has_runs = true;
+        static inline size_t offset(const size_t rank) {
+            return 0;
+        }
+        static inline size_t step(const size_t parallelism) {
+            return 1;
+        }
+        template<class I>
+        static void runs(I oit, const size_t rank, const size_t parallelism,
+                const access_pattern_parameters& params) {
+            const auto block = (std::max)(params.block_size,
+                static_cast<size_t>(1));
+            const auto total = P * parallelism;
+            for (auto o = rank * block; o < total; o += parallelism * block) {
+                *oit++ = access_run { o, (std::min)(block, total - o), 1 };
+            }
+        }
+        static inline const std::string& name(void) {
+            static const std::string name("blocked");
+            return name;
+        }
+    };
+
+    template<size_t P>
+    struct access_pattern_traits<access_pattern::random, P> {
+        static constexpr bool has_runs = true;
+        static inline size_t offset(const size_t rank) {
+            return 0;
+        }
+        static inline size_t step(const size_t parallelism) {
+            return 1;
+        }
+        template<class I>
+        static void runs(I oit, const size_t rank, const size_t parallelism,
+                const access_pattern_parameters& params) {
+            const auto block = (std::max)(params.block_size,
+                static_cast<size_t>(1));
+            std::vector<size_t> blocks((P + block - 1) / block);
+            std::iota(blocks.begin(), blocks.end(), 0);
+            // Use a fixed seed such that all iterations and repeated runs
+            // visit the blocks in the same order.
+            std::shuffle(blocks.begin(), blocks.end(),
+                std::mt19937_64(rank + 1));
+            for (auto b : blocks) {
+                const auto o = b * block;
+                *oit++ = access_run { rank * P + o, (std::min)(block, P - o),
+                    1 };
+            }
+        }
+        static inline const std::string& name(void) {
+            static const std::string name("random");
+            return name;
+        }
+    };
+
+    template<size_t P>
+    struct access_pattern_traits<access_pattern::strided, P> {
+        static constexpr bool has_runs = true;
+        static inline size_t offset(const size_t rank) {
+            return 0;
+        }
+        static inline size_t step(const size_t parallelism) {
+            return 1;
+        }
+        template<class I>
+        static void runs(I oit, const size_t rank, const size_t parallelism,
+                const access_pattern_parameters& params) {
+            const auto stride = (std::max)(params.stride,
+                static_cast<size_t>(1));
+            for (size_t p = 0; (p < stride) && (p < P); ++p) {
+                *oit++ = access_run { rank * P + p,
+                    (P - p + stride - 1) / stride, stride };
+            }
+        }
+        static inline const std::string& name(void) {
+            static const std::string name("strided");
+            return name;
+        }
+    };
+
+    template<size_t P>
+    struct access_pattern_traits<access_pattern::tiled, P> {
+        static constexpr bool has_runs = true;
+        static inline size_t offset(const size_t rank) {
+            return 0;
+        }
+        static inline size_t step(const size_t parallelism) {
+            return 1;
+        }
+        template<class I>
+        static void runs(I oit, const size_t rank, const size_t parallelism,
+                const access_pattern_parameters& params) {
+            const auto pitch = (std::max)(params.row_length,
+                static_cast<size_t>(1));
+            const auto rows = P / pitch;
+            const auto th = (std::max)(params.tile_height,
+                static_cast<size_t>(1));
+            const auto tw = (std::min)((std::max)(params.tile_width,
+                static_cast<size_t>(1)), pitch);
+            const auto base = rank * P;
+
+            for (size_t ty = 0; ty < rows; ty += th) {
+                const auto ey = (std::min)(ty + th, rows);
+                for (size_t tx = 0; tx < pitch; tx += tw) {
+                    const auto w = (std::min)(tw, pitch - tx);
+                    for (auto y = ty; y < ey; ++y) {
+                        *oit++ = access_run { base + y * pitch + tx, w, 1 };
+                    }
+                }
+            }
+
+            // Elements not forming a complete row are processed at the end.
+            if (rows * pitch < P) {
+                *oit++ = access_run { base + rows * pitch, P - rows * pitch,
+                    1 };
+            }
+        }
+        static inline const std::string& name(void) {
+            static const std::string name("tiled");
+            return name;
+        }
+    };
+
 
     template<access_pattern... V>
     using access_pattern_list_t = enum_dispatch_list<access_pattern, V...>;
 
     typedef access_pattern_list_t<access_pattern::contiguous,
-        access_pattern::interleaved> access_pattern_list;
+        access_pattern::interleaved, access_pattern::blocked,
+        access_pattern::random, access_pattern::strided,
+        access_pattern::tiled> access_pattern_list;
 }
 }
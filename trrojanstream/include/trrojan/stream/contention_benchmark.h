@@ -0,0 +1,92 @@
+/// <copyright file="contention_benchmark.h" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#pragma once
+
+#include "trrojan/benchmark.h"
+
+#include <cstdint>
+#include <string>
+#include <vector>
+
+#include "trrojan/timer.h"
+
+#include "trrojan/stream/export.h"
+
+
+namespace trrojan {
+namespace stream {
+
+    /// <summary>
+    /// Measures how the throughput of memory operations degrades if several
+    /// cores compete for the same cache line.
+    /// </summary>
+    /// <remarks>
+    /// <para>Each test is run twice, once with the contended memory layout
+    /// and once with each thread working on its own cache line. The ratio of
+    /// the run times is reported as slowdown.</para>
+    /// <para>The benchmark supports the following
+    /// <see cref="trrojan::factor" />s, which all of have reasonable default
+    /// values:</para>
+    /// <list type="bullet">
+    /// <item>
+    /// <term>iterations</term>
+    /// <description>The number of operations each thread performs.
+    /// </description>
+    /// </item>
+    /// <item>
+    /// <term>test</term>
+    /// <description>Either &quot;fetch_add&quot;, in which case all threads
+    /// atomically increment the same counter, or &quot;false_sharing&quot;,
+    /// in which case each thread increments its own counter, but the
+    /// counters are packed into as few cache lines as possible. By default,
+    /// both tests are performed.</description>
+    /// </item>
+    /// <item>
+    /// <term>threads</term>
+    /// <description>The number of threads, which are placed like the threads
+    /// of the stream benchmark. By default, all powers of two up to the
+    /// number of logical processors and the number of logical processors
+    /// itself are tested.</description>
+    /// </item>
+    /// </list>
+    /// </remarks>
+    class TRROJANSTREAM_API contention_benchmark
+            : public trrojan::benchmark_base {
+
+    public:
+
+        static const std::string factor_iterations;
+        static const std::string factor_test;
+        static const std::string factor_threads;
+
+        static const std::string result_name_latency;
+        static const std::string result_name_operations_per_second;
+        static const std::string result_name_slowdown;
+
+        static const std::string test_false_sharing;
+        static const std::string test_fetch_add;
+
+        contention_benchmark(void);
+
+        virtual ~contention_benchmark(void);
+
+        virtual trrojan::result run(const configuration& config);
+
+    private:
+
+        /// <summary>
+        /// Runs the given test on the given processors and answers the time
+        /// in milliseconds each of the threads took.
+        /// </summary>
+        static std::vector<timer::millis_type> measure(
+            const std::vector<std::uint32_t>& processors,
+            const std::string& test, const bool padded,
+            const std::uint64_t iterations);
+    };
+
+}
+}
@@ -0,0 +1,88 @@
+/// <copyright file="core_latency_benchmark.h" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#pragma once
+
+#include "trrojan/benchmark.h"
+
+#include <cstdint>
+#include <string>
+
+#include "trrojan/stream/export.h"
+
+
+namespace trrojan {
+namespace stream {
+
+    /// <summary>
+    /// Measures the latency of transferring a cache line between all pairs of
+    /// logical processors.
+    /// </summary>
+    /// <remarks>
+    /// <para>For each pair of logical processors, two pinned threads pass a
+    /// cache line back and forth by alternately incrementing an atomic
+    /// counter. The one-way latency is half of the average round-trip time.
+    /// The result of a configuration is the upper triangle of the latency
+    /// matrix, one row per pair, along with the relation of the processors,
+    /// which is one of &quot;smt&quot; for siblings on the same physical
+    /// core, &quot;shared_llc&quot; for cores sharing the last-level cache,
+    /// &quot;same_die&quot;, &quot;cross_die&quot; for different dies in the
+    /// same package and &quot;cross_package&quot;.</para>
+    /// <para>The benchmark supports the following
+    /// <see cref="trrojan::factor" />s, which all of have reasonable default
+    /// values:</para>
+    /// <list type="bullet">
+    /// <item>
+    /// <term>iterations</term>
+    /// <description>The number of round trips measured for each pair of
+    /// processors. A fixed number of warm-up round trips is performed
+    /// before the measurement.</description>
+    /// </item>
+    /// <item>
+    /// <term>processors</term>
+    /// <description>The maximum number of logical processors included in the
+    /// matrix. The processors are taken in the order of their IDs. Zero
+    /// includes all processors, which is the default.</description>
+    /// </item>
+    /// </list>
+    /// </remarks>
+    class TRROJANSTREAM_API core_latency_benchmark
+            : public trrojan::benchmark_base {
+
+    public:
+
+        static const std::string factor_iterations;
+        static const std::string factor_processors;
+
+        static const std::string result_name_first_processor;
+        static const std::string result_name_latency;
+        static const std::string result_name_relation;
+        static const std::string result_name_second_processor;
+
+        core_latency_benchmark(void);
+
+        virtual ~core_latency_benchmark(void);
+
+        virtual trrojan::result run(const configuration& config);
+
+    private:
+
+        /// <summary>
+        /// Measures the average one-way latency in nanoseconds between the
+        /// given processors.
+        /// </summary>
+        static double measure(const std::uint32_t first,
+            const std::uint32_t second, const std::uint32_t iterations);
+
+        /// <summary>
+        /// Determines how close the given logical processors are.
+        /// </summary>
+        static std::string relation(const std::uint32_t first,
+            const std::uint32_t second);
+    };
+
+}
+}
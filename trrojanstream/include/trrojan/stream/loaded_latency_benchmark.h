@@ -0,0 +1,143 @@
+/// <copyright file="loaded_latency_benchmark.h" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#pragma once
+
+#include "trrojan/benchmark.h"
+
+#include <cstdint>
+#include <string>
+
+#include "trrojan/enum_parse_helper.h"
+
+#include "trrojan/stream/export.h"
+#include "trrojan/stream/scalar_type.h"
+#include "trrojan/stream/task_type.h"
+
+
+namespace trrojan {
+namespace stream {
+
+    /// <summary>
+    /// Measures the memory latency while other cores generate a configurable
+    /// amount of memory traffic.
+    /// </summary>
+    /// <remarks>
+    /// <para>The first ranks of the benchmark chase pointers through a
+    /// randomly permuted, cyclic list of cache lines and record the time per
+    /// dependent load. All other ranks run a stream task on their own arrays
+    /// using the kernels of the stream benchmark and wait for a configurable
+    /// time after each block of 4 KiB, which throttles the injection rate.
+    /// All buffers are allocated and initialised by the threads using them
+    /// such that they are local to the thread on NUMA systems.</para>
+    /// <para>Each configuration yields the bandwidth achieved by the traffic
+    /// generators and the distribution of the latency observed at the same
+    /// time. Varying the injection delay therefore produces the
+    /// latency-versus-bandwidth curve of the system.</para>
+    /// <para>The benchmark supports the following
+    /// <see cref="trrojan::factor" />s, which all of have reasonable default
+    /// values:</para>
+    /// <list type="bullet">
+    /// <item>
+    /// <term>chase_size</term>
+    /// <description>The size of the pointer-chasing buffer of each latency
+    /// rank in bytes. The default is eight times the size of the last-level
+    /// cache, but at least 64 MiB.</description>
+    /// </item>
+    /// <item>
+    /// <term>injection_delay</term>
+    /// <description>The time in nanoseconds the traffic generators wait
+    /// after each block, which is measured with <see cref="trrojan::timer" />.
+    /// Zero generates as much traffic as possible.</description>
+    /// </item>
+    /// <item>
+    /// <term>latency_threads</term>
+    /// <description>The number of ranks measuring the latency. All other
+    /// ranks generate traffic. The default is one.</description>
+    /// </item>
+    /// <item>
+    /// <term>problem_size</term>
+    /// <description>The number of scalars in each of the arrays of a traffic
+    /// generator.</description>
+    /// </item>
+    /// <item>
+    /// <term>samples</term>
+    /// <description>The number of latency samples each latency rank takes.
+    /// Each sample is the average of 256 dependent loads.</description>
+    /// </item>
+    /// <item>
+    /// <term>scalar_type</term>
+    /// <description>The type of the scalars the traffic generators process.
+    /// The string representation of
+    /// <see cref="trrojan::stream::scalar_type" /> must be used for this
+    /// factor. The default is
+    /// <see cref="trrojan::stream::scalar_type::float64" />.</description>
+    /// </item>
+    /// <item>
+    /// <term>task_type</term>
+    /// <description>The task the traffic generators perform. The string
+    /// representation of <see cref="trrojan::stream::task_type" /> must be
+    /// used for this factor. The default is
+    /// <see cref="trrojan::stream::task_type::triad" />.</description>
+    /// </item>
+    /// <item>
+    /// <term>threads</term>
+    /// <description>The total number of ranks, which are placed like the
+    /// threads of the stream benchmark. The default is the number of
+    /// physical cores.</description>
+    /// </item>
+    /// </list>
+    /// </remarks>
+    class TRROJANSTREAM_API loaded_latency_benchmark
+            : public trrojan::benchmark_base {
+
+    public:
+
+        static const std::string factor_chase_size;
+        static const std::string factor_injection_delay;
+        static const std::string factor_latency_threads;
+        static const std::string factor_problem_size;
+        static const std::string factor_samples;
+        static const std::string factor_scalar_type;
+        static const std::string factor_task_type;
+        static const std::string factor_threads;
+
+        static const std::string result_name_bandwidth;
+        static const std::string result_name_latency_average;
+        static const std::string result_name_latency_maximum;
+        static const std::string result_name_latency_minimum;
+        static const std::string result_name_latency_p50;
+        static const std::string result_name_latency_p90;
+        static const std::string result_name_latency_p99;
+        static const std::string result_name_latency_p999;
+
+        loaded_latency_benchmark(void);
+
+        virtual ~loaded_latency_benchmark(void);
+
+        virtual trrojan::result run(const configuration& config);
+
+    private:
+
+        static inline scalar_type parse_scalar_type(
+                const trrojan::named_variant& s) {
+            typedef enum_parse_helper<scalar_type, scalar_type_traits,
+                scalar_type_list_t> parser;
+            auto value = s.value().as<std::string>();
+            return parser::parse(scalar_type_list(), value);
+        }
+
+        static inline task_type parse_task_type(
+                const trrojan::named_variant& s) {
+            typedef enum_parse_helper<task_type, task_type_traits,
+                task_type_list_t> parser;
+            auto value = s.value().as<std::string>();
+            return parser::parse(task_type_list(), value);
+        }
+    };
+
+}
+}
@@ -0,0 +1,157 @@
+/// <copyright file="numa_benchmark.h" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#pragma once
+
+#include "trrojan/benchmark.h"
+
+#include <cstdint>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "trrojan/enum_parse_helper.h"
+
+#include "trrojan/stream/export.h"
+#include "trrojan/stream/problem.h"
+#include "trrojan/stream/scalar_type.h"
+#include "trrojan/stream/task_type.h"
+#include "trrojan/stream/worker_pool.h"
+
+
+namespace trrojan {
+namespace stream {
+
+    /// <summary>
+    /// Measures the memory bandwidth between all pairs of NUMA nodes.
+    /// </summary>
+    /// <remarks>
+    /// <para>For each NUMA node i with logical processors, the worker threads
+    /// are pinned to the processors of node i while the arrays of the
+    /// <see cref="trrojan::stream::problem" /> are bound to node j, for all
+    /// nodes j. As a baseline, the arrays are also interleaved across all
+    /// nodes. The result of a configuration is the bandwidth matrix, one row
+    /// per pair of nodes plus one row per processor node for the baseline.
+    /// The result <c>memory_policy</c> is &quot;bind&quot; for the pairs of
+    /// nodes and &quot;interleave&quot; for the baseline, whose
+    /// <c>memory_node</c> is empty.</para>
+    /// <para>On Linux, the memory is bound by setting the memory policy of
+    /// the thread allocating the problem. If this is not possible, and on
+    /// all other platforms, the allocating thread is pinned to node j such
+    /// that the pages are placed by the first-touch policy, and the baseline
+    /// cannot be interleaved.</para>
+    /// <para>The benchmark supports the following
+    /// <see cref="trrojan::factor" />s, which all of have reasonable default
+    /// values:</para>
+    /// <list type="bullet">
+    /// <item>
+    /// <term>iterations</term>
+    /// <description>The number of iterations measured for each pair of nodes.
+    /// The <see cref="trrojan::stream::worker_thread" /> adds one warm-up
+    /// iteration to this number.</description>
+    /// </item>
+    /// <item>
+    /// <term>problem_size</term>
+    /// <description>The problem size in number of items per thread, which
+    /// must be one of
+    /// <see cref="trrojan::stream::worker_thread::problem_sizes" />.
+    /// </description>
+    /// </item>
+    /// <item>
+    /// <term>scalar_type</term>
+    /// <description>The type of a scalar in the tests. The default is
+    /// <see cref="trrojan::stream::scalar_type::float64" />.</description>
+    /// </item>
+    /// <item>
+    /// <term>task_type</term>
+    /// <description>The task to be performed. By default, all tasks are
+    /// tested.</description>
+    /// </item>
+    /// <item>
+    /// <term>threads</term>
+    /// <description>The number of threads pinned to the processor node.
+    /// Zero, which is the default, uses one thread per physical core of the
+    /// node.</description>
+    /// </item>
+    /// </list>
+    /// </remarks>
+    class TRROJANSTREAM_API numa_benchmark : public trrojan::benchmark_base {
+
+    public:
+
+        static const std::string factor_iterations;
+        static const std::string factor_problem_size;
+        static const std::string factor_scalar_type;
+        static const std::string factor_task_type;
+        static const std::string factor_threads;
+
+        static const std::string result_name_cpu_node;
+        static const std::string result_name_distance;
+        static const std::string result_name_memory_node;
+        static const std::string result_name_memory_policy;
+        static const std::string result_name_rate_average;
+        static const std::string result_name_rate_maximum;
+        static const std::string result_name_rate_relative;
+        static const std::string result_name_threads;
+
+        numa_benchmark(void);
+
+        virtual ~numa_benchmark(void);
+
+        virtual trrojan::result run(const configuration& config);
+
+    private:
+
+        static inline scalar_type parse_scalar_type(
+                const trrojan::named_variant& s) {
+            typedef enum_parse_helper<scalar_type, scalar_type_traits,
+                scalar_type_list_t> parser;
+            auto value = s.value().as<std::string>();
+            return parser::parse(scalar_type_list(), value);
+        }
+
+        static inline task_type parse_task_type(
+                const trrojan::named_variant& s) {
+            typedef enum_parse_helper<task_type, task_type_traits,
+                task_type_list_t> parser;
+            auto value = s.value().as<std::string>();
+            return parser::parse(task_type_list(), value);
+        }
+
+        /// <summary>
+        /// Allocates a problem whose arrays are placed on the given NUMA
+        /// nodes.
+        /// </summary>
+        /// <param name="config">The configuration describing the problem.
+        /// </param>
+        /// <param name="parallelism">The number of threads.</param>
+        /// <param name="nodes">The memory nodes. If this list has more than
+        /// one element, the memory is interleaved across the nodes.</param>
+        problem::pointer_type allocate(const configuration& config,
+            const std::size_t parallelism,
+            const std::vector<std::uint32_t>& nodes);
+
+        /// <summary>
+        /// Runs the given problem on the pool and answers the average and the
+        /// maximum bandwidth over all iterations in MB/s.
+        /// </summary>
+        std::pair<double, double> measure(problem::pointer_type problem);
+
+        /// <summary>
+        /// Remembers whether the user has been warned that the memory policy
+        /// cannot be set.
+        /// </summary>
+        bool policy_warned;
+
+        /// <summary>
+        /// The threads, which are reused as long as the processor node does
+        /// not change.
+        /// </summary>
+        worker_pool pool;
+    };
+
+}
+}
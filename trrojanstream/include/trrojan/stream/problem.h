@@ -43,6 +43,20 @@ namespace stream {
         /// </summary>
         static const size_t default_iterations = 10;
 
+        /// <summary>
+        /// The default number of blocks read by
+        /// <see cref="trrojan::stream::task_type::mix" /> for
+        /// <see cref="default_mix_writes" /> blocks written.
+        /// </summary>
+        static const size_t default_mix_reads = 2;
+
+        /// <summary>
+        /// The default number of blocks written by
+        /// <see cref="trrojan::stream::task_type::mix" /> for
+        /// <see cref="default_mix_reads" /> blocks read.
+        /// </summary>
+        static const size_t default_mix_writes = 1;
+
         /// <summary>
         /// The default value for the problem size.
         /// </summary>
@@ -51,13 +65,27 @@ namespace stream {
         /// <summary>
         /// Creates a new problem with the specified properties.
         /// </summary>
+        /// <param name="verify">Instructs the worker threads to verify the
+        /// results on their part of the arrays after the measurement.</param>
+        /// <param name="recycled">An optional problem that is not used any
+        /// more and whose arrays are taken over. As long as the arrays of the
+        /// new problem are not larger, no memory is allocated and no page
+        /// faults occur, which would otherwise accumulate over the
+        /// configurations. The arrays are initialised in any case, which
+        /// touches all pages before the measurement starts.</param>
         problem(const scalar_type_t scalar,
             const trrojan::variant& value,
             const task_type_t task,
             const access_pattern_t pattern,
             const size_t size = default_problem_size,
             const size_t iterations = default_iterations,
-            const size_t parallelism = 1);
+            const size_t parallelism = 1,
+            const size_t mix_reads = default_mix_reads,
+            const size_t mix_writes = default_mix_writes,
+            const access_pattern_parameters& pattern_parameters
+                = access_pattern_parameters(),
+            const bool verify = false,
+            problem *recycled = nullptr);
 
         /// <summary>
         /// Gets the first input array.
@@ -83,6 +111,14 @@ namespace stream {
             return this->_access_pattern;
         }
 
+        /// <summary>
+        /// Answer the parameters of the access pattern.
+        /// </summary>
+        inline const access_pattern_parameters& pattern_parameters(
+                void) const {
+            return this->_pattern_parameters;
+        }
+
         /// <summary>
         /// Gets the second input array.
         /// </summary>
@@ -117,6 +153,54 @@ namespace stream {
             return this->c<typename scalar_type_traits<T>::type>();
         }
 
+        /// <summary>
+        /// Answer the number of bytes that are transferred for each item if
+        /// the given number of memory accesses is performed on it.
+        /// </summary>
+        /// <remarks>
+        /// The conversion tasks read or write 32-bit floating point numbers
+        /// instead of one of the scalars, wherefore the number of bytes
+        /// cannot be derived from the scalar size alone.
+        /// </remarks>
+        /// <param name="cnt_accesses">The number of memory accesses (reads and
+        /// writes) per item.</param>
+        /// <returns>The number of bytes per item.</returns>
+        inline size_t bytes_per_item(const size_t cnt_accesses) const {
+            if (this->is_conversion()) {
+                return (this->_scalar_size + sizeof(float));
+            } else {
+                return (this->_scalar_size * cnt_accesses);
+            }
+        }
+
+        /// <summary>
+        /// Given the size of this problem, convert the given runtime of a
+        /// thread to items per second.
+        /// </summary>
+        /// <param name="dt">The time one thread took to complete the benchmark
+        /// (in milliseconds).</param>
+        /// <returns>The number of items processed per second.</returns>
+        inline double calc_thread_items_per_s(
+                const timer::millis_type dt) const {
+            typedef trrojan::constants<double> constants;
+            auto s = dt / constants::millis_per_second;
+            return (static_cast<double>(this->size()) / s);
+        }
+
+        /// <summary>
+        /// Given the size of this problem, convert the given total runtime to
+        /// items per second.
+        /// </summary>
+        /// <param name="dt">The time it took to complete the benchmark (in
+        /// milliseconds).</param>
+        /// <returns>The number of items processed per second.</returns>
+        inline double calc_total_items_per_s(
+                const timer::millis_type dt) const {
+            typedef trrojan::constants<double> constants;
+            auto s = dt / constants::millis_per_second;
+            return (static_cast<double>(this->total_size()) / s);
+        }
+
         /// <summary>
         /// Given the size of this problem, convert the given runtime of a
         /// thread to MB/s under the assumption that the given number of memory
@@ -131,9 +215,10 @@ namespace stream {
                 const size_t cnt_accesses) const {
             typedef trrojan::constants<double> constants;
             auto s = dt / constants::millis_per_second;
-            auto m = static_cast<double>(this->size_in_bytes());
+            auto m = static_cast<double>(this->size());
+            m *= this->bytes_per_item(cnt_accesses);
             m /= constants::bytes_per_megabyte;
-            return (m / s * cnt_accesses);
+            return (m / s);
         }
 
         /// <summary>
@@ -150,9 +235,31 @@ namespace stream {
                 const size_t cnt_accesses) const {
             typedef trrojan::constants<double> constants;
             auto s = dt / constants::millis_per_second;
-            auto m = static_cast<double>(this->total_size_in_bytes());
+            auto m = static_cast<double>(this->total_size());
+            m *= this->bytes_per_item(cnt_accesses);
             m /= constants::bytes_per_megabyte;
-            return (m / s * cnt_accesses);
+            return (m / s);
+        }
+
+        /// <summary>
+        /// Gets the array of 32-bit floating point numbers that the conversion
+        /// tasks convert from or to.
+        /// </summary>
+        /// <remarks>
+        /// The array is only allocated if <see cref="is_conversion" /> is
+        /// <c>true</c>. Otherwise, <c>nullptr</c> is returned.
+        /// </remarks>
+        inline float *f(void) {
+            return this->_f.empty() ? nullptr : this->_f.data();
+        }
+
+        /// <summary>
+        /// Answer whether the task of the problem converts between the scalar
+        /// type and 32-bit floating point numbers.
+        /// </summary>
+        inline bool is_conversion(void) const {
+            return ((this->_task_type == task_type_t::pack)
+                || (this->_task_type == task_type_t::unpack));
         }
 
         /// <summary>
@@ -162,6 +269,22 @@ namespace stream {
             return this->_iterations;
         }
 
+        /// <summary>
+        /// Answer how many blocks <see cref="trrojan::stream::task_type::mix" />
+        /// reads before it writes <see cref="mix_writes" /> blocks.
+        /// </summary>
+        inline size_t mix_reads(void) const {
+            return this->_mix_reads;
+        }
+
+        /// <summary>
+        /// Answer how many blocks <see cref="trrojan::stream::task_type::mix" />
+        /// writes after it has read <see cref="mix_reads" /> blocks.
+        /// </summary>
+        inline size_t mix_writes(void) const {
+            return this->_mix_writes;
+        }
+
         /// <summary>
         /// Answer for how many threads the problem is intended.
         /// </summary>
@@ -250,6 +373,20 @@ namespace stream {
             return this->_a.size();
         }
 
+        /// <summary>
+        /// Answer the number of bytes that the task of all threads touches,
+        /// which only includes the arrays that the task actually uses.
+        /// </summary>
+        size_t working_set_in_bytes(void) const;
+
+        /// <summary>
+        /// Answer whether the worker threads should verify their results
+        /// once all iterations have been measured.
+        /// </summary>
+        inline bool verify(void) const {
+            return this->_verify;
+        }
+
     private:
 
         typedef std::vector<std::uint8_t> problem_type;
@@ -259,6 +396,8 @@ namespace stream {
         /// <see cref="trrojan::stream::problem::_b" /> and
         /// <see cref="trrojan::stream::problem::_c" /> to hold
         /// <paramref name="cnt" /> elements of type <tparamref name="T" />.
+        /// If the task is a conversion,
+        /// <see cref="trrojan::stream::problem::_f" /> is allocated, too.
         /// </summary>
         template<scalar_type_t T> void allocate(size_t cnt);
 
@@ -282,16 +421,39 @@ namespace stream {
         /// </summary>
         problem_type _c;
 
+        /// <summary>
+        /// The array of 32-bit floating point numbers for the conversion
+        /// tasks.
+        /// </summary>
+        std::vector<float> _f;
+
         /// <summary>
         /// The number of iterations to perform for the same problem.
         /// </summary>
         size_t _iterations;
 
+        /// <summary>
+        /// The number of blocks read in a cycle of
+        /// <see cref="trrojan::stream::task_type::mix" />.
+        /// </summary>
+        size_t _mix_reads;
+
+        /// <summary>
+        /// The number of blocks written in a cycle of
+        /// <see cref="trrojan::stream::task_type::mix" />.
+        /// </summary>
+        size_t _mix_writes;
+
         /// <summary>
         /// The number of threads the problem is for.
         /// </summary>
         size_t _parallelism;
 
+        /// <summary>
+        /// The parameters of the access pattern.
+        /// </summary>
+        access_pattern_parameters _pattern_parameters;
+
         /// <summary>
         /// Remembers the size of a single scalar.
         /// </summary>
@@ -311,6 +473,11 @@ namespace stream {
         /// The task to be performed on the memory.
         /// </summary>
         task_type_t _task_type;
+
+        /// <summary>
+        /// Determines whether the results are verified after the measurement.
+        /// </summary>
+        bool _verify;
     };
 
 }
@@ -21,12 +21,37 @@ void trrojan::stream::problem::allocate(size_t cnt) {
 
     this->_scalar_size = sizeof(type);
 
+    // Clearing before resizing retains the capacity of recycled arrays while
+    // making sure that no stale elements survive.
     cnt = cnt * this->_parallelism;
+    this->_a.clear();
+    this->_b.clear();
+    this->_c.clear();
     this->_a.resize(cnt * this->_scalar_size);
     this->_b.resize(cnt * this->_scalar_size);
     this->_c.resize(cnt * this->_scalar_size);
 
     std::srand(std::time(nullptr));
-    std::generate(this->a<type>(), this->a<type>() + cnt, std::rand);
-    std::generate(this->b<type>(), this->b<type>() + cnt, std::rand);
+    if constexpr (sizeof(type) < sizeof(std::int32_t)) {
+        // Keep the numbers small such that the narrow types neither overflow
+        // nor lose precision when converting from float.
+        auto next = [](void) {
+            return static_cast<type>(std::rand() % 100);
+        };
+        std::generate(this->a<type>(), this->a<type>() + cnt, next);
+        std::generate(this->b<type>(), this->b<type>() + cnt, next);
+    } else {
+        std::generate(this->a<type>(), this->a<type>() + cnt, std::rand);
+        std::generate(this->b<type>(), this->b<type>() + cnt, std::rand);
+    }
+
+    if (this->is_conversion()) {
+        this->_f.clear();
+        this->_f.resize(cnt);
+        std::generate(this->_f.begin(), this->_f.end(), [](void) {
+            return static_cast<float>(std::rand() % 100);
+        });
+    } else {
+        this->_f.clear();
+    }
 }
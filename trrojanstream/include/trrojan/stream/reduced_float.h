@@ -0,0 +1,210 @@
+/// <copyright file="reduced_float.h" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cinttypes>
+#include <cstring>
+
+#if defined(__F16C__)
+#include <immintrin.h>
+#endif /* defined(__F16C__) */
+
+
+namespace trrojan {
+namespace stream {
+namespace detail {
+
+    /// <summary>
+    /// Converts between 32-bit floating point numbers and IEEE 754 binary16
+    /// numbers.
+    /// </summary>
+    struct half_codec {
+
+        /// <summary>
+        /// Converts <paramref name="value" /> to the nearest binary16 number,
+        /// rounding ties to even.
+        /// </summary>
+        static inline std::uint16_t encode(const float value) {
+#if defined(__F16C__)
+            return static_cast<std::uint16_t>(_cvtss_sh(value,
+                _MM_FROUND_TO_NEAREST_INT));
+#else /* defined(__F16C__) */
+            std::uint32_t f;
+            std::memcpy(&f, &value, sizeof(f));
+            const auto sign = static_cast<std::uint16_t>((f >> 16) & 0x8000);
+            f &= 0x7FFFFFFF;
+
+            if (f >= 0x7F800000) {
+                // Infinity stays infinity and NaN becomes a quiet NaN.
+                return sign | ((f > 0x7F800000) ? 0x7E00 : 0x7C00);
+
+            } else if (f >= 0x477FF000) {
+                // Everything from 65520 on rounds to infinity.
+                return sign | 0x7C00;
+
+            } else if (f < 0x38800000) {
+                // The result is a subnormal number or zero. Adding 0.5 moves
+                // the bits we need to the bottom of the mantissa and lets the
+                // FPU do the rounding.
+                float v;
+                std::memcpy(&v, &f, sizeof(v));
+                v += 0.5f;
+                std::memcpy(&f, &v, sizeof(f));
+                return sign | static_cast<std::uint16_t>(f - 0x3F000000);
+
+            } else {
+                // Rebias the exponent and round the mantissa to even.
+                const auto odd = (f >> 13) & 1;
+                f += 0xC8000FFF + odd;
+                return sign | static_cast<std::uint16_t>(f >> 13);
+            }
+#endif /* defined(__F16C__) */
+        }
+
+        /// <summary>
+        /// Converts the binary16 number <paramref name="bits" /> to a 32-bit
+        /// floating point number, which is always exact.
+        /// </summary>
+        static inline float decode(const std::uint16_t bits) {
+#if defined(__F16C__)
+            return _cvtsh_ss(bits);
+#else /* defined(__F16C__) */
+            const auto sign = static_cast<std::uint32_t>(bits & 0x8000) << 16;
+            const auto exponent = static_cast<std::uint32_t>(bits >> 10) & 0x1F;
+            const auto mantissa = static_cast<std::uint32_t>(bits) & 0x3FF;
+            std::uint32_t f;
+            float retval;
+
+            if (exponent == 0x1F) {
+                f = sign | 0x7F800000 | (mantissa << 13);
+
+            } else if (exponent != 0) {
+                f = sign | ((exponent + 112) << 23) | (mantissa << 13);
+
+            } else {
+                // Subnormal numbers are multiples of 2^-24.
+                retval = static_cast<float>(mantissa) / 16777216.0f;
+                std::memcpy(&f, &retval, sizeof(f));
+                f |= sign;
+            }
+
+            std::memcpy(&retval, &f, sizeof(retval));
+            return retval;
+#endif /* defined(__F16C__) */
+        }
+    };
+
+
+    /// <summary>
+    /// Converts between 32-bit floating point numbers and bfloat16 numbers,
+    /// which are the upper half of the former.
+    /// </summary>
+    struct brain_codec {
+
+        /// <summary>
+        /// Converts <paramref name="value" /> to the nearest bfloat16 number,
+        /// rounding ties to even.
+        /// </summary>
+        static inline std::uint16_t encode(const float value) {
+            std::uint32_t f;
+            std::memcpy(&f, &value, sizeof(f));
+
+            if ((f & 0x7FFFFFFF) > 0x7F800000) {
+                // Make sure that truncating the mantissa does not turn a NaN
+                // into infinity.
+                return static_cast<std::uint16_t>((f >> 16) | 0x0040);
+            }
+
+            f += 0x7FFF + ((f >> 16) & 1);
+            return static_cast<std::uint16_t>(f >> 16);
+        }
+
+        /// <summary>
+        /// Converts the bfloat16 number <paramref name="bits" /> to a 32-bit
+        /// floating point number, which is always exact.
+        /// </summary>
+        static inline float decode(const std::uint16_t bits) {
+            const auto f = static_cast<std::uint32_t>(bits) << 16;
+            float retval;
+            std::memcpy(&retval, &f, sizeof(retval));
+            return retval;
+        }
+    };
+
+} /* end namespace detail */
+
+
+    /// <summary>
+    /// A 16-bit floating point number, which is stored in reduced precision
+    /// and converted to a 32-bit floating point number for all computations.
+    /// </summary>
+    /// <remarks>
+    /// The conversions are implicit such that the number can be used in the
+    /// same way as the built-in types in the tasks of the benchmark. As most
+    /// hardware does not support arithmetics on 16-bit floats, this is also
+    /// what real-world code does with these numbers.
+    /// </remarks>
+    /// <tparam name="C">The codec which converts between the bit pattern and
+    /// <c>float</c>.</tparam>
+    template<class C> class reduced_float {
+
+    public:
+
+        /// <summary>
+        /// Initialises a new instance with positive zero.
+        /// </summary>
+        inline reduced_float(void) : _bits(0) { }
+
+        /// <summary>
+        /// Initialises a new instance with the value nearest to
+        /// <paramref name="value" />.
+        /// </summary>
+        inline reduced_float(const float value) : _bits(C::encode(value)) { }
+
+        /// <summary>
+        /// Gets the bit pattern of the number.
+        /// </summary>
+        inline std::uint16_t bits(void) const {
+            return this->_bits;
+        }
+
+        /// <summary>
+        /// Adds <paramref name="rhs" /> to the number.
+        /// </summary>
+        inline reduced_float& operator +=(const float rhs) {
+            this->_bits = C::encode(C::decode(this->_bits) + rhs);
+            return *this;
+        }
+
+        /// <summary>
+        /// Converts the number to a 32-bit floating point number.
+        /// </summary>
+        inline operator float(void) const {
+            return C::decode(this->_bits);
+        }
+
+    private:
+
+        std::uint16_t _bits;
+    };
+
+    static_assert(sizeof(reduced_float<detail::half_codec>) == 2,
+        "A reduced precision float must not have any padding.");
+
+    /// <summary>
+    /// An IEEE 754 binary16 floating point number.
+    /// </summary>
+    typedef reduced_float<detail::half_codec> float16;
+
+    /// <summary>
+    /// A brain floating point number, which has the range of a 32-bit float,
+    /// but only eight bits of precision.
+    /// </summary>
+    typedef reduced_float<detail::brain_codec> bfloat16;
+
+} /* end namespace stream */
+} /* end namespace trrojan */
@@ -12,6 +12,7 @@
 #include "trrojan/enum_dispatch_list.h"
 
 #include "trrojan/stream/export.h"
+#include "trrojan/stream/reduced_float.h"
 
 
 namespace trrojan {
@@ -22,6 +23,17 @@ namespace stream {
     /// </summary>
     enum class TRROJANSTREAM_API scalar_type {
 
+        /// <summary>
+        /// Brain floating point numbers, which are 16 bits wide and have the
+        /// range of 32-bit floating point numbers.
+        /// </summary>
+        bfloat16,
+
+        /// <summary>
+        /// IEEE 754 16-bit floating point numbers.
+        /// </summary>
+        float16,
+
         /// <summary>
         /// 32-bit floating point numbers.
         /// </summary>
@@ -32,6 +44,11 @@ namespace stream {
         /// </summary>
         float64,
 
+        /// <summary>
+        /// 8-bit integer numbers.
+        /// </summary>
+        int8,
+
         /// <summary>
         /// 32-bit integer numbers.
         /// </summary>
@@ -40,7 +57,12 @@ namespace stream {
         /// <summary>
         /// 64-bit integer numbers.
         /// </summary>
-        int64
+        int64,
+
+        /// <summary>
+        /// 8-bit unsigned integer numbers.
+        /// </summary>
+        uint8
     };
 
 
@@ -72,10 +94,14 @@ namespace stream {
         }                                                                      \
     }
 
+    __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(bfloat16, trrojan::stream::bfloat16);
+    __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(float16, trrojan::stream::float16);
     __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(float32, float);
     __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(float64, double);
+    __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(int8, std::int8_t);
     __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(int32, std::int32_t);
     __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(int64, std::int64_t);
+    __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS(uint8, std::uint8_t);
 
 #undef __TRROJANCORE_DECL_SCALAR_TYPE_TRAITS
 
@@ -83,8 +109,10 @@ namespace stream {
     template<scalar_type... V>
     using scalar_type_list_t = enum_dispatch_list<scalar_type, V...>;
 
-    typedef scalar_type_list_t<scalar_type::float32, scalar_type::float64,
-        scalar_type::int32, scalar_type::int64> scalar_type_list;
+    typedef scalar_type_list_t<scalar_type::bfloat16, scalar_type::float16,
+        scalar_type::float32, scalar_type::float64, scalar_type::int8,
+        scalar_type::int32, scalar_type::int64, scalar_type::uint8>
+        scalar_type_list;
 
 } /* end namespace stream */
 } /* end namespace trrojan */
@@ -14,12 +14,16 @@
 #include <iterator>
 #include <limits>
 #include <memory>
+#include <numeric>
+#include <set>
 
+#include "trrojan/constants.h"
 #include "trrojan/enum_parse_helper.h"
 #include "trrojan/timer.h"
 
 #include "trrojan/stream/export.h"
 #include "trrojan/stream/problem.h"
+#include "trrojan/stream/worker_pool.h"
 #include "trrojan/stream/worker_thread.h"
 
 
@@ -47,13 +51,27 @@ namespace stream {
     /// <term>access_pattern</term>
     /// <description>The memory access pattern if using more than one thread.
     /// See documentation of <see cref="trrojan::stream::access_pattern" /> for
-    /// details on the respective behaviour.</description>
+    /// details on the respective behaviour. By default, only the contiguous
+    /// and the interleaved pattern are tested.</description>
+    /// </item>
+    /// <item>
+    /// <term>block_size</term>
+    /// <description>The number of elements in a block of the blocked and the
+    /// random access pattern. Sweeping this factor for the random pattern
+    /// shows from which block size on the prefetchers become effective.
+    /// This factor is only used by these two patterns and only part of the
+    /// results if it has been configured explicitly. It defaults to 512.
+    /// </description>
     /// </item>
     /// <item>
     /// <term>threads</term>
     /// <description>The number of threads to use simultaneously. Note that at
     /// must one thread per logical core must be started. The problem size will
-    /// be scaled by the number of threads.</description>
+    /// be scaled by the number of threads. The threads are placed on the
+    /// physical cores before their SMT siblings are used (see
+    /// <see cref="trrojan::system_topology::placement" />). By default, one
+    /// thread, one thread per physical core and one thread per logical core
+    /// are tested.</description>
     /// </item>
     /// <item>
     /// <term>iterations</term>
@@ -63,9 +81,29 @@ namespace stream {
     /// results.</description>
     /// </item>
     /// <item>
+    /// <term>mix_reads</term>
+    /// <description>The number of cache-line sized blocks that
+    /// <see cref="trrojan::stream::task_type::mix" /> reads before it writes
+    /// <c>mix_writes</c> blocks. This factor defaults to 2.</description>
+    /// </item>
+    /// <item>
+    /// <term>mix_writes</term>
+    /// <description>The number of cache-line sized blocks that
+    /// <see cref="trrojan::stream::task_type::mix" /> writes after it has
+    /// read <c>mix_reads</c> blocks. This factor defaults to 1.</description>
+    /// </item>
+    /// <item>
     /// <term>problem_size</term>
     /// <description>The problem size in number of items to be processed.
-    /// </description>
+    /// A warning is emitted once for each size if the arrays the task of
+    /// all threads uses fit into four times the last-level cache, in which
+    /// case the results do not reflect the memory bandwidth.</description>
+    /// </item>
+    /// <item>
+    /// <term>row_length</term>
+    /// <description>The number of elements in a row of the matrix the tiled
+    /// access pattern works on. This factor is only part of the results if
+    /// it has been configured explicitly. It defaults to 4096.</description>
     /// </item>
     /// <item>
     /// <term>scalar</term>
@@ -82,12 +120,77 @@ namespace stream {
     /// factor.</description>
     /// </item>
     /// <item>
+    /// <term>stride</term>
+    /// <description>The distance between two accesses of the strided access
+    /// pattern in number of elements. Sweeping this factor shows the
+    /// bandwidth that is lost if the prefetchers cannot follow. This factor is
+    /// only part of the results if it has been configured explicitly. It
+    /// defaults to 16.</description>
+    /// </item>
+    /// <item>
     /// <term>task_type</term>
     /// <description>The task to be performed. The string representation
     /// of <see cref="trrojan::stream::task_type" /> must be used for this
     /// factor.</description>
     /// </item>
+    /// <item>
+    /// <term>timeline</term>
+    /// <description>If not empty, the start, the duration and the time spent
+    /// at the barrier of all iterations of all threads are exported for each
+    /// configuration (see <see cref="trrojan::stream::timeline" />). The
+    /// value is the prefix of the output files, to which the hash of the
+    /// configuration (see <see cref="trrojan::journal::hash" />) and the
+    /// extension <c>.json</c> for the Chrome trace or <c>.trtl</c> for the
+    /// binary file are appended. By default, no timeline is exported and the
+    /// factor is not part of the results.</description>
+    /// </item>
+    /// <item>
+    /// <term>tile_height</term>
+    /// <description>The number of rows in a tile of the tiled access pattern.
+    /// This factor is only part of the results if it has been configured
+    /// explicitly. It defaults to 64.</description>
+    /// </item>
+    /// <item>
+    /// <term>tile_width</term>
+    /// <description>The number of elements in a row of a tile of the tiled
+    /// access pattern. This factor is only part of the results if it has
+    /// been configured explicitly. It defaults to 64.</description>
+    /// </item>
+    /// <item>
+    /// <term>verify</term>
+    /// <description>Determines whether the results are checked after the
+    /// measurement. Each worker thread checks the part of the arrays it has
+    /// processed itself in parallel to the other threads, such that the
+    /// check is reasonably fast even for large problems. The check runs after
+    /// the power scope has been left and is therefore not part of the energy
+    /// measured. The outcome is reported in the result <c>verified</c>, which
+    /// is &quot;passed&quot; or &quot;failed&quot; if the results have been
+    /// checked and &quot;skipped&quot; otherwise. By default, the results
+    /// are not checked.</description>
+    /// </item>
     /// </list>
+    /// <para>If a power collector is passed to the benchmark, the energy
+    /// consumed by a configuration, including the warm-up iteration, is
+    /// reported along with the number of bytes transferred per Joule.</para>
+    /// <para>All transfer rates are reported in MB/s. The results
+    /// <c>item_rate_total</c> and <c>item_rate_aggregated</c> report the
+    /// corresponding number of items processed per second, which allows for
+    /// comparing scalar types of different size and for determining whether
+    /// the conversion tasks are limited by the computation rather than the
+    /// memory.</para>
+    /// <para>The task <see cref="trrojan::stream::task_type::suite" /> runs
+    /// the kernels of McCalpin's STREAM back to back on the same arrays. The
+    /// bandwidth of each kernel, which is computed from the slowest thread,
+    /// is reported in <c>rate_copy</c>, <c>rate_scale</c>, <c>rate_add</c>
+    /// and <c>rate_triad</c>, which are NaN for all other tasks. In addition,
+    /// the classic STREAM table is written to the log.</para>
+    /// <para>The worker threads are kept in a
+    /// <see cref="trrojan::stream::worker_pool" />, which survives across
+    /// configurations and is only resized if the number of threads changes.
+    /// The time spent for starting and stopping threads for a configuration
+    /// is reported in the results <c>time_startup</c> and
+    /// <c>time_teardown</c>, which are zero if the pool could be reused
+    /// as it was.</para>
     /// </remarks>
     class TRROJANSTREAM_API stream_benchmark : public trrojan::benchmark_base {
 
@@ -96,24 +199,45 @@ namespace stream {
         typedef benchmark_base::on_result_callback on_result_callback;
 
         static const std::string factor_access_pattern;
+        static const std::string factor_block_size;
         static const std::string factor_iterations;
+        static const std::string factor_mix_reads;
+        static const std::string factor_mix_writes;
         static const std::string factor_problem_size;
+        static const std::string factor_row_length;
         static const std::string factor_scalar;
         static const std::string factor_scalar_type;
+        static const std::string factor_stride;
         static const std::string factor_task_type;
         static const std::string factor_threads;
+        static const std::string factor_timeline;
+        static const std::string factor_tile_height;
+        static const std::string factor_tile_width;
+        static const std::string factor_verify;
 
+        static const std::string result_name_bytes_per_joule;
+        static const std::string result_name_energy;
+        static const std::string result_name_item_rate_aggregated;
+        static const std::string result_name_item_rate_total;
+        static const std::string result_name_power_uid;
+        static const std::string result_name_rate_add;
         static const std::string result_name_rate_aggregated;
         static const std::string result_name_rate_average;
         static const std::string result_name_rate_maximum;
+        static const std::string result_name_rate_copy;
         static const std::string result_name_rate_minimum;
+        static const std::string result_name_rate_scale;
         static const std::string result_name_rate_total;
+        static const std::string result_name_rate_triad;
         static const std::string result_name_range_start;
         static const std::string result_name_range_total;
         static const std::string result_name_time_average;
         static const std::string result_name_time_maximum;
         static const std::string result_name_time_minimum;
         static const std::string result_name_time_slowest;
+        static const std::string result_name_time_startup;
+        static const std::string result_name_time_teardown;
+        static const std::string result_name_verified;
 
         stream_benchmark(void);
 
@@ -155,11 +279,47 @@ namespace stream {
         }
 
         static trrojan::stream::problem::pointer_type to_problem(
-            const configuration& c);
+            const configuration& c, problem *recycled = nullptr);
+
+        /// <summary>
+        /// Emits a warning if the working set of <paramref name="problem" />
+        /// is too small to measure the memory bandwidth, but only once for
+        /// each size.
+        /// </summary>
+        void check_working_set(const problem& problem);
 
         template<class I>trrojan::result collect_results(
             const configuration& config, problem::pointer_type problem,
+            const std::string& powerUid, const double energy,
+            const timer::millis_type startupTime,
+            const timer::millis_type teardownTime,
             I begin, I end);
+
+        /// <summary>
+        /// Exports the timeline of the worker threads in
+        /// <see cref="pool" /> if requested by <paramref name="config" />.
+        /// </summary>
+        void export_timeline(const configuration& config,
+            const problem& problem);
+
+        /// <summary>
+        /// The problem of the previous configuration, whose arrays are reused
+        /// for the next one in order to avoid allocating and faulting in new
+        /// memory for each configuration.
+        /// </summary>
+        problem::pointer_type last_problem;
+
+        /// <summary>
+        /// The persistent worker threads, which are reused for all
+        /// configurations.
+        /// </summary>
+        worker_pool pool;
+
+        /// <summary>
+        /// The working sets in bytes that
+        /// <see cref="check_working_set" /> has already warned about.
+        /// </summary>
+        std::set<std::size_t> small_working_sets;
     };
 
 }
@@ -11,8 +11,19 @@
 template<class I>
 trrojan::result trrojan::stream::stream_benchmark::collect_results(
         const configuration& config, problem::pointer_type problem,
+        const std::string& powerUid, const double energy,
+        const timer::millis_type startupTime,
+        const timer::millis_type teardownTime,
         I begin, I end) {
     typedef std::numeric_limits<timer::millis_type> timer_limits;
+    typedef trrojan::constants<double> constants;
+    static const char *kernelLabels[worker_thread::suite_kernels] = {
+        "Copy:", "Scale:", "Add:", "Triad:" };
+    static const std::size_t kernelAccesses[worker_thread::suite_kernels] = {
+        task_type_traits<task_type::copy>::memory_accesses,
+        task_type_traits<task_type::scale>::memory_accesses,
+        task_type_traits<task_type::add>::memory_accesses,
+        task_type_traits<task_type::triad>::memory_accesses };
 
     assert(problem != nullptr);
     auto cntResults = problem->iterations();
@@ -23,7 +34,13 @@ trrojan::result trrojan::stream::stream_benchmark::collect_results(
         result_name_time_average, result_name_time_minimum,
         result_name_rate_minimum, result_name_rate_average,
         result_name_rate_maximum, result_name_rate_total,
-        result_name_rate_aggregated };
+        result_name_rate_aggregated, result_name_item_rate_total,
+        result_name_item_rate_aggregated, result_name_rate_copy,
+        result_name_rate_scale, result_name_rate_add, result_name_rate_triad,
+        result_name_power_uid,
+        result_name_energy, result_name_bytes_per_joule,
+        result_name_time_startup, result_name_time_teardown,
+        result_name_verified };
     worker_thread::results_type results;
 
     // Get the results for all iterations of all threads. The array 'results'
@@ -31,21 +48,50 @@ trrojan::result trrojan::stream::stream_benchmark::collect_results(
     // t2/it1, t2/it2, ..., t2/it1, t3/it1, ... }
     results.reserve(cntResults * cntThreads);
     cntThreads = 0;
+    auto passed = true;
     for (auto it = begin; it != end; ++it) {
         (**it).copy_results(std::back_inserter(results));
+        passed = passed && (**it).is_verified();
         ++cntThreads;
     }
     assert(results.size() == cntThreads * cntResults);
 
+    // Distinguish between results that have not been checked and results
+    // that have been checked and found to be wrong.
+    std::string verified("skipped");
+    if (problem->verify()) {
+        verified = passed ? "passed" : "failed";
+        if (passed) {
+            log::instance().write_line(log_level::information, "Verification "
+                "of the stream results on {0} worker thread(s) succeeded.",
+                cntThreads);
+        }
+    }
+
     //for (size_t i = 0; i < cntThreads; ++i) {
     //    names.emplace_back(result_name_rate + std::to_string(i));
     //}
 
+    // The energy covers all iterations including the warm-up, so we need to
+    // relate it to all bytes that have been transferred.
+    auto bytesPerJoule = std::numeric_limits<double>::quiet_NaN();
+    if ((energy > 0.0) && !results.empty()) {
+        auto bytes = static_cast<double>(problem->total_size());
+        bytes *= problem->bytes_per_item(results.front().memory_accesses);
+        bytes *= cntResults + 1;
+        bytesPerJoule = bytes / energy;
+    }
+
     auto retval = std::make_shared<basic_result>(
         config,
         //std::move(configuration::with_system_factors(config)),
         std::move(names));
 
+    // For the suite, remember the time of the slowest thread for each kernel
+    // and iteration, which is what McCalpin's STREAM measures.
+    const auto isSuite = (problem->task_type() == task_type::suite);
+    std::vector<timer::millis_type> kernelTimes[worker_thread::suite_kernels];
+
     // Combine the results per iteration.
     for (size_t i = 0; i < cntResults; ++i) {
         auto accesses = results[i].memory_accesses; // Consistent over threads!
@@ -57,6 +103,7 @@ trrojan::result trrojan::stream::stream_benchmark::collect_results(
         auto minTime = (timer_limits::max)();
         auto maxTime = (timer_limits::min)();
         auto sumTime = static_cast<timer::millis_type>(0);
+        auto sumItemRate = 0.0;
         auto sumRate = 0.0;
 
         for (size_t t = 0; t < cntThreads; ++t) {
@@ -89,6 +136,7 @@ trrojan::result trrojan::stream::stream_benchmark::collect_results(
 
             sumTime += time;
             sumRate += problem->calc_thread_mb_per_s(time, accesses);
+            sumItemRate += problem->calc_thread_items_per_s(time);
         }
 
         auto rangeStart = maxStart - minStart;
@@ -98,6 +146,24 @@ trrojan::result trrojan::stream::stream_benchmark::collect_results(
         auto avgRate = (sumRate / cntThreads);
         auto maxRate = problem->calc_thread_mb_per_s(minTime, accesses);
         auto totalRate = problem->calc_thread_mb_per_s(rangeTotal, accesses);
+        auto totalItemRate = problem->calc_thread_items_per_s(rangeTotal);
+
+        double kernelRates[worker_thread::suite_kernels];
+        for (size_t k = 0; k < worker_thread::suite_kernels; ++k) {
+            if (isSuite) {
+                auto slowest = (timer_limits::min)();
+                for (size_t t = 0; t < cntThreads; ++t) {
+                    auto idx = (t * cntResults) + i;
+                    slowest = (std::max)(slowest,
+                        results[idx].kernel_times[k]);
+                }
+                kernelTimes[k].push_back(slowest);
+                kernelRates[k] = problem->calc_total_mb_per_s(slowest,
+                    kernelAccesses[k]);
+            } else {
+                kernelRates[k] = std::numeric_limits<double>::quiet_NaN();
+            }
+        }
 
 #if (defined(DEBUG) || defined(_DEBUG))
         std::cout << "iteration " << i
@@ -116,7 +182,30 @@ trrojan::result trrojan::stream::stream_benchmark::collect_results(
 #endif /* (defined(DEBUG) || defined(_DEBUG)) */
 
         retval->add({ rangeStart, rangeTotal, maxTime, avgTime,
-            minTime, minRate, avgRate, maxRate, totalRate, sumRate });
+            minTime, minRate, avgRate, maxRate, totalRate, sumRate,
+            totalItemRate, sumItemRate, kernelRates[0], kernelRates[1],
+            kernelRates[2], kernelRates[3], powerUid, energy, bytesPerJoule,
+            startupTime, teardownTime, verified });
+    }
+
+    // Print the table of McCalpin's STREAM, which uses the best iteration of
+    // each kernel for the rate.
+    if (isSuite && (cntResults > 0)) {
+        log::instance().write_line(log_level::information, "Function    "
+            "Best Rate MB/s  Avg time     Min time     Max time");
+        for (size_t k = 0; k < worker_thread::suite_kernels; ++k) {
+            auto& times = kernelTimes[k];
+            auto minmax = std::minmax_element(times.begin(), times.end());
+            auto avg = std::accumulate(times.begin(), times.end(), 0.0)
+                / times.size();
+            log::instance().write_line(log_level::information,
+                "{0:<11}{1:12.1f}  {2:11.6f}  {3:11.6f}  {4:11.6f}",
+                kernelLabels[k],
+                problem->calc_total_mb_per_s(*minmax.first, kernelAccesses[k]),
+                avg / constants::millis_per_second,
+                *minmax.first / constants::millis_per_second,
+                *minmax.second / constants::millis_per_second);
+        }
     }
 
     return std::dynamic_pointer_cast<result::element_type>(retval);
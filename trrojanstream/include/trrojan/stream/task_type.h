@@ -29,17 +29,61 @@ namespace stream {
         /// </summary>
         copy,
 
+        /// <summary>
+        /// Write the scalar value to all elements of an array without reading
+        /// any memory.
+        /// </summary>
+        fill,
+
+        /// <summary>
+        /// Write the scalar value to all elements of an array using
+        /// non-temporal stores, which bypass the caches where the platform
+        /// supports this.
+        /// </summary>
+        fill_nt,
+
+        /// <summary>
+        /// Read from one array and write the scalar value to another array in
+        /// a configurable ratio. The arrays are processed in blocks of a cache
+        /// line, each of which is either read or written.
+        /// </summary>
+        mix,
+
+        /// <summary>
+        /// Convert 32-bit floating point numbers from one array to the scalar
+        /// type and store them in another array.
+        /// </summary>
+        pack,
+
         /// <summary>
         /// Multiply numbers from an array with a scalar value and store the
         /// result in another array.
         /// </summary>
         scale,
 
+        /// <summary>
+        /// Sum up all numbers from an array without writing any memory.
+        /// </summary>
+        sum,
+
+        /// <summary>
+        /// Run <see cref="copy" />, <see cref="scale" />, <see cref="add" />
+        /// and <see cref="triad" /> back to back on the same arrays in each
+        /// iteration like McCalpin's STREAM does.
+        /// </summary>
+        suite,
+
         /// <summary>
         /// Multiply numbers from an array with a scalar, add values from
         /// another array and store the result in a third one.
         /// </summary>
-        triad
+        triad,
+
+        /// <summary>
+        /// Convert numbers of the scalar type from one array to 32-bit
+        /// floating point numbers and store them in another array.
+        /// </summary>
+        unpack
     };
 
 
@@ -59,8 +103,18 @@ namespace stream {
 
     __TRROJANCORE_DECL_TASK_TYPE_TRAITS(add, 3);
     __TRROJANCORE_DECL_TASK_TYPE_TRAITS(copy, 2);
+    __TRROJANCORE_DECL_TASK_TYPE_TRAITS(fill, 1);
+    __TRROJANCORE_DECL_TASK_TYPE_TRAITS(fill_nt, 1);
+    // Each element is either read or written once, regardless of the ratio.
+    __TRROJANCORE_DECL_TASK_TYPE_TRAITS(mix, 1);
+    // The conversions read and write elements of different size.
+    __TRROJANCORE_DECL_TASK_TYPE_TRAITS(pack, 2);
     __TRROJANCORE_DECL_TASK_TYPE_TRAITS(scale, 2);
+    __TRROJANCORE_DECL_TASK_TYPE_TRAITS(sum, 1);
+    // The sum of the accesses of copy, scale, add and triad.
+    __TRROJANCORE_DECL_TASK_TYPE_TRAITS(suite, 10);
     __TRROJANCORE_DECL_TASK_TYPE_TRAITS(triad, 3);
+    __TRROJANCORE_DECL_TASK_TYPE_TRAITS(unpack, 2);
 
 #undef __TRROJANCORE_DECL_TASK_TYPE_TRAITS
 
@@ -69,6 +123,8 @@ namespace stream {
     using task_type_list_t = enum_dispatch_list<task_type, V...>;
 
     typedef task_type_list_t<task_type::add, task_type::copy,
-        task_type::scale, task_type::triad> task_type_list;
+        task_type::fill, task_type::fill_nt, task_type::mix, task_type::pack,
+        task_type::scale, task_type::sum, task_type::suite, task_type::triad,
+        task_type::unpack> task_type_list;
 }
 }
@@ -0,0 +1,135 @@
+/// <copyright file="timeline.h" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <algorithm>
+#include <cstdint>
+#include <iterator>
+#include <limits>
+#include <string>
+#include <vector>
+
+#include "trrojan/configuration.h"
+#include "trrojan/timer.h"
+
+#include "trrojan/stream/export.h"
+#include "trrojan/stream/worker_thread.h"
+
+
+namespace trrojan {
+namespace stream {
+
+    /// <summary>
+    /// The raw timing of all iterations of all worker threads of a single
+    /// configuration, which can be exported for inspecting stragglers and
+    /// interference between the threads.
+    /// </summary>
+    /// <remarks>
+    /// <para>The JSON export uses the trace event format of Chrome, which can
+    /// be opened in chrome://tracing or in Perfetto. Each worker thread is
+    /// a thread of the trace, which shows the time the thread waited at the
+    /// barrier followed by the iteration itself. For
+    /// <see cref="trrojan::stream::task_type::suite" />, the iteration
+    /// contains a span for each kernel and for the waits between them. The
+    /// configuration is stored in the <c>otherData</c> of the trace.</para>
+    /// <para>The binary export is meant for automated analysis. All numbers
+    /// are stored in native byte order. The file starts with the 32-bit
+    /// unsigned integers <see cref="binary_magic" />,
+    /// <see cref="binary_version" />, the number of ranks, the number of
+    /// iterations per rank, the number of kernels per iteration, which is
+    /// zero unless the task is the suite, and a reserved zero. These are
+    /// followed by a 64-bit float holding the origin of the timeline in
+    /// milliseconds since the epoch of <see cref="trrojan::timer" />. The
+    /// rest of the file are the iterations of the first rank, followed by the
+    /// ones of the second rank and so on. Each iteration consists of 64-bit
+    /// floats holding the start relative to the origin, the time spent at
+    /// the barrier before the start and the duration of the iteration, all
+    /// in milliseconds. For the suite, the duration and the wait of each
+    /// kernel follow in the order copy, scale, add and triad.</para>
+    /// <para>The warm-up iteration is not part of the timeline.</para>
+    /// </remarks>
+    class TRROJANSTREAM_API timeline {
+
+    public:
+
+        /// <summary>
+        /// The first four bytes of a binary timeline, which are the
+        /// characters &quot;TRTL&quot; if read from a little-endian file.
+        /// </summary>
+        static const std::uint32_t binary_magic;
+
+        /// <summary>
+        /// The version of the binary format.
+        /// </summary>
+        static const std::uint32_t binary_version;
+
+        /// <summary>
+        /// Initialises a new instance from the results of the given worker
+        /// threads.
+        /// </summary>
+        /// <param name="name">The name of the task, which is used to label
+        /// the iterations.</param>
+        /// <param name="suite">Determines whether the threads have run
+        /// <see cref="trrojan::stream::task_type::suite" />, in which case
+        /// the individual kernels are exported, too.</param>
+        /// <param name="begin">The first worker thread.</param>
+        /// <param name="end">The end of the range of worker threads.</param>
+        /// <tparam name="I">An iterator over
+        /// <see cref="trrojan::stream::worker_thread::pointer_type" />.
+        /// </tparam>
+        template<class I>
+        timeline(const std::string& name, const bool suite, I begin, I end);
+
+        /// <summary>
+        /// Answer the number of iterations of each rank.
+        /// </summary>
+        inline std::size_t iterations(void) const {
+            return this->_ranks.empty() ? 0 : this->_ranks.front().size();
+        }
+
+        /// <summary>
+        /// Answer the number of ranks in the timeline.
+        /// </summary>
+        inline std::size_t ranks(void) const {
+            return this->_ranks.size();
+        }
+
+        /// <summary>
+        /// Writes the timeline in the compact binary format to the given
+        /// file.
+        /// </summary>
+        /// <param name="path">The path to the output file, which will be
+        /// overwritten if it exists.</param>
+        /// <exception cref="std::runtime_error">If the file could not be
+        /// written.</exception>
+        void write_binary(const std::string& path) const;
+
+        /// <summary>
+        /// Writes the timeline in the trace event format of Chrome to the
+        /// given file.
+        /// </summary>
+        /// <param name="path">The path to the output file, which will be
+        /// overwritten if it exists.</param>
+        /// <param name="config">The configuration the timeline has been
+        /// recorded for, which is embedded in the file.</param>
+        /// <exception cref="std::runtime_error">If the file could not be
+        /// written.</exception>
+        void write_json(const std::string& path,
+            const configuration& config) const;
+
+    private:
+
+        std::string _name;
+        timer::millis_type _origin;
+        std::vector<worker_thread::results_type> _ranks;
+        bool _suite;
+    };
+
+}
+}
+
+#include "trrojan/stream/timeline.inl"
@@ -0,0 +1,31 @@
+/// <copyright file="timeline.inl" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+
+/*
+ * trrojan::stream::timeline::timeline
+ */
+template<class I>
+trrojan::stream::timeline::timeline(const std::string& name, const bool suite,
+        I begin, I end)
+        : _name(name),
+        _origin((std::numeric_limits<timer::millis_type>::max)()),
+        _suite(suite) {
+    for (auto it = begin; it != end; ++it) {
+        this->_ranks.emplace_back();
+        (**it).copy_results(std::back_inserter(this->_ranks.back()));
+
+        // The timeline starts when the first thread starts waiting.
+        for (auto& r : this->_ranks.back()) {
+            auto start = timer::millis_since_epoch(r.start) - r.wait_time;
+            this->_origin = (std::min)(this->_origin, start);
+        }
+    }
+
+    if (this->iterations() == 0) {
+        this->_origin = 0;
+    }
+}
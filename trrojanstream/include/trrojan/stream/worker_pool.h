@@ -0,0 +1,176 @@
+/// <copyright file="worker_pool.h" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include <vector>
+
+#include "trrojan/timer.h"
+
+#include "trrojan/stream/export.h"
+#include "trrojan/stream/problem.h"
+#include "trrojan/stream/worker_thread.h"
+
+
+namespace trrojan {
+namespace stream {
+
+    /// <summary>
+    /// A pool of persistent, pinned
+    /// <see cref="trrojan::stream::worker_thread" />s, which is reused for
+    /// all configurations of a benchmark run.
+    /// </summary>
+    /// <remarks>
+    /// <para>The threads are created once and wait for problems being posted
+    /// to them. The pool is only resized if a problem requires a different
+    /// number of threads, in which case only the missing threads are created
+    /// or the surplus ones are stopped. As the placement of a thread only
+    /// depends on its rank, the remaining threads keep their processor.</para>
+    /// <para>Alternatively, the threads can be pinned to an explicit list of
+    /// logical processors, in which case threads that would need to move to
+    /// another processor are restarted.</para>
+    /// <para>The time required for creating and stopping threads is recorded
+    /// separately such that it can be reported independently from the
+    /// measured bandwidth.</para>
+    /// </remarks>
+    class TRROJANSTREAM_API worker_pool {
+
+    public:
+
+        /// <summary>
+        /// The container holding the worker threads.
+        /// </summary>
+        typedef std::vector<worker_thread::pointer_type> container_type;
+
+        /// <summary>
+        /// An iterator over the worker threads.
+        /// </summary>
+        typedef container_type::const_iterator const_iterator;
+
+        /// <summary>
+        /// Initialises a new, empty instance.
+        /// </summary>
+        worker_pool(void);
+
+        worker_pool(const worker_pool&) = delete;
+
+        /// <summary>
+        /// Finalises the instance, stopping all threads.
+        /// </summary>
+        ~worker_pool(void);
+
+        /// <summary>
+        /// Gets an iterator to the first worker thread.
+        /// </summary>
+        inline const_iterator begin(void) const {
+            return this->workers.cbegin();
+        }
+
+        /// <summary>
+        /// Gets an iterator past the last worker thread.
+        /// </summary>
+        inline const_iterator end(void) const {
+            return this->workers.cend();
+        }
+
+        /// <summary>
+        /// Ensures that the pool holds exactly the given number of threads.
+        /// </summary>
+        /// <remarks>
+        /// The time spent for creating and stopping threads in this call is
+        /// available via <see cref="startup_time" /> and
+        /// <see cref="teardown_time" /> afterwards, both of which are zero if
+        /// the pool already had the requested size.
+        /// </remarks>
+        /// <param name="parallelism">The number of threads.</param>
+        void resize(const std::size_t parallelism);
+
+        /// <summary>
+        /// Ensures that the pool holds exactly one thread for each of the
+        /// given logical processors, the i-th thread being pinned to the i-th
+        /// processor.
+        /// </summary>
+        /// <remarks>
+        /// Threads that are already running on the requested processor are
+        /// reused. The time spent for creating and stopping threads is
+        /// recorded as for the rank-based overload.
+        /// </remarks>
+        /// <param name="processors">The IDs of the logical processors.</param>
+        void resize(const std::vector<std::uint32_t>& processors);
+
+        /// <summary>
+        /// Processes the given problem on the threads of the pool and waits
+        /// for all of them to complete the measurement.
+        /// </summary>
+        /// <remarks>
+        /// <para>If the size of the pool does not match the parallelism of the
+        /// problem, the pool is resized before the problem is posted to the
+        /// threads.</para>
+        /// <para>If the problem requested a verification, the threads check
+        /// their results after this method has returned, such that the
+        /// verification is not part of anything measured around the call.
+        /// Use <see cref="wait" /> to wait for the verification to complete.
+        /// </para>
+        /// </remarks>
+        /// <param name="problem">The problem to be processed.</param>
+        /// <exception cref="std::invalid_argument">If
+        /// <paramref name="problem" /> is <c>nullptr</c>.</exception>
+        void run(worker_thread::problem_type problem);
+
+        /// <summary>
+        /// Answer the number of threads in the pool.
+        /// </summary>
+        inline std::size_t size(void) const {
+            return this->workers.size();
+        }
+
+        /// <summary>
+        /// Answer the time in milliseconds the last call to
+        /// <see cref="resize" /> spent for creating threads.
+        /// </summary>
+        inline timer::millis_type startup_time(void) const {
+            return this->_startup_time;
+        }
+
+        /// <summary>
+        /// Stops all threads and empties the pool.
+        /// </summary>
+        void stop(void);
+
+        /// <summary>
+        /// Answer the time in milliseconds the last call to
+        /// <see cref="resize" /> spent for stopping threads.
+        /// </summary>
+        inline timer::millis_type teardown_time(void) const {
+            return this->_teardown_time;
+        }
+
+        /// <summary>
+        /// Waits for all threads of the pool to complete the last problem,
+        /// including its verification.
+        /// </summary>
+        void wait(void);
+
+        worker_pool& operator =(const worker_pool&) = delete;
+
+    private:
+
+        /// <summary>
+        /// Marks a thread in <see cref="processors" /> that has been placed
+        /// according to its rank.
+        /// </summary>
+        static const std::uint32_t placed_by_rank;
+
+        timer::millis_type _startup_time;
+        timer::millis_type _teardown_time;
+        std::vector<std::uint32_t> processors;
+        container_type workers;
+    };
+
+}
+}
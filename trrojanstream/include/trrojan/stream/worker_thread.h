@@ -14,12 +14,17 @@
 #include <atomic>
 #include <cinttypes>
 #include <climits>
+#include <condition_variable>
+#include <cstring>
 #include <iostream>
 #include <iterator>
 #include <memory>
 #include <mutex>
+#include <numeric>
 #include <stdexcept>
 #include <system_error>
+#include <thread>
+#include <utility>
 #include <vector>
 
 #ifdef _WIN32
@@ -28,6 +33,11 @@
 #include <pthread.h>
 #endif /* _WIN32 */
 
+#if defined(__x86_64__) || defined(_M_X64)
+#include <emmintrin.h>
+#define TRROJANSTREAM_STREAMING_STORES
+#endif /* defined(__x86_64__) || defined(_M_X64) */
+
 #include "trrojan/constants.h"
 #include "trrojan/index_sequence.h"
 #include "trrojan/log.h"
@@ -80,11 +90,48 @@ namespace stream {
 
     public:
 
+        /// <summary>
+        /// The alignment that guarantees that two variables are not located
+        /// on the same cache line or on a pair of lines that the hardware
+        /// prefetcher fetches together.
+        /// </summary>
+        static constexpr std::size_t cache_line_padding = 128;
+
+        /// <summary>
+        /// The number of kernels that
+        /// <see cref="trrojan::stream::task_type::suite" /> runs in each
+        /// iteration.
+        /// </summary>
+        static constexpr std::size_t suite_kernels = 4;
+
         /// <summary>
         /// The results of a single iteration of a single test.
         /// </summary>
         struct iteration_result {
 
+            /// <summary>
+            /// The time each of the kernels of
+            /// <see cref="trrojan::stream::task_type::suite" /> took (in
+            /// milliseconds) in the order copy, scale, add and triad.
+            /// </summary>
+            /// <remarks>
+            /// The times are only valid for the suite. For all other tasks,
+            /// their content is undefined.
+            /// </remarks>
+            std::array<trrojan::timer::millis_type, suite_kernels> kernel_times;
+
+            /// <summary>
+            /// The time the thread waited at the barrier before each of the
+            /// kernels of <see cref="trrojan::stream::task_type::suite" />
+            /// (in milliseconds).
+            /// </summary>
+            /// <remarks>
+            /// The first wait is the same as <see cref="wait_time" />. As for
+            /// <see cref="kernel_times" />, the content is undefined for all
+            /// other tasks.
+            /// </remarks>
+            std::array<trrojan::timer::millis_type, suite_kernels> kernel_waits;
+
             /// <summary>
             /// The number of memory accesses per step.
             /// </summary>
@@ -106,6 +153,12 @@ namespace stream {
             /// The time the test run took (in milliseconds).
             /// </summary>
             trrojan::timer::millis_type time;
+
+            /// <summary>
+            /// The time the thread waited at the barrier before the
+            /// <see cref="start" /> of the run (in milliseconds).
+            /// </summary>
+            trrojan::timer::millis_type wait_time;
         };
 
         /// <summary>
@@ -144,6 +197,24 @@ namespace stream {
         /// </summary>
         typedef std::vector<iteration_result> results_type;
 
+        /// <summary>
+        /// Answer the affinity group, which is a block of 64 logical
+        /// processors, that contains the given logical processor.
+        /// </summary>
+        static inline uint16_t affinity_group(const std::uint32_t processor) {
+            return static_cast<uint16_t>(processor
+                / (sizeof(uint64_t) * CHAR_BIT));
+        }
+
+        /// <summary>
+        /// Answer the affinity mask that selects the given logical processor
+        /// within its <see cref="affinity_group" />.
+        /// </summary>
+        static inline uint64_t affinity_mask(const std::uint32_t processor) {
+            return static_cast<uint64_t>(1)
+                << (processor % (sizeof(uint64_t) * CHAR_BIT));
+        }
+
         /// <summary>
         /// Creates and starts a new worker thread for the given problem.
         /// </summary>
@@ -156,6 +227,14 @@ namespace stream {
         /// </summary>
         static std::vector<pointer_type> create(problem_type problem);
 
+        /// <summary>
+        /// Creates and starts a new persistent worker thread, which waits for
+        /// problems being passed to it via <see cref="post" />.
+        /// </summary>
+        static pointer_type create_idle(const rank_type rank,
+            const uint64_t affinity_mask = 0,
+            const uint16_t affinity_group = 0);
+
         /// <summary>
         /// Join all worker threads in the specified range.
         /// </summary>
@@ -166,6 +245,59 @@ namespace stream {
         /// <see cref="worker_thread::pointer_type" />.</tparam>
         template<class I> static void join(I begin, I end);
 
+        /// <summary>
+        /// Restricts the calling thread to the given logical processor.
+        /// </summary>
+        /// <param name="processor">The ID of the logical processor.</param>
+        /// <exception cref="std::system_error">If the affinity could not be
+        /// set.</exception>
+        static void pin_calling_thread(const std::uint32_t processor);
+
+        /// <summary>
+        /// Runs <paramref name="func" /> on one thread per logical processor in
+        /// <paramref name="processors" /> and waits for all of them to exit.
+        /// </summary>
+        /// <remarks>
+        /// All threads are pinned to their processor and wait for each other
+        /// before <paramref name="func" /> is invoked, such that they start
+        /// working at approximately the same time. If any of the threads
+        /// cannot be pinned, <paramref name="func" /> is not invoked at all.
+        /// </remarks>
+        /// <param name="processors">The IDs of the logical processors to run
+        /// the threads on.</param>
+        /// <param name="func">The function to run, which receives the index
+        /// of its processor in <paramref name="processors" />.</param>
+        /// <tparam name="F">A functor accepting a <c>std::size_t</c>.
+        /// </tparam>
+        /// <exception cref="std::system_error">If a thread could not be
+        /// pinned.</exception>
+        template<class F>
+        static void run_pinned(const std::vector<std::uint32_t>& processors,
+            F&& func);
+
+        /// <summary>
+        /// Performs the task <tparamref name="T" /> once on the first
+        /// <paramref name="cnt" /> consecutive elements of the given arrays.
+        /// </summary>
+        /// <remarks>
+        /// This is the kernel the worker threads run, which allows other
+        /// benchmarks to generate the same kind of memory traffic without
+        /// the synchronisation and timing of a worker thread.
+        /// <see cref="trrojan::stream::task_type::suite" /> runs its four
+        /// kernels back to back and therefore overwrites <paramref name="a" />
+        /// and <paramref name="b" />. <paramref name="f" /> is only accessed
+        /// by the conversions.
+        /// </remarks>
+        template<scalar_type S, task_type T>
+        static void run_kernel(typename scalar_type_traits<S>::type *a,
+            typename scalar_type_traits<S>::type *b,
+            typename scalar_type_traits<S>::type *c,
+            float *f,
+            const typename scalar_type_traits<S>::type s,
+            const size_t cnt,
+            const size_t mix_reads = problem::default_mix_reads,
+            const size_t mix_writes = problem::default_mix_writes);
+
         /// <summary>
         /// Creates a pre-initialised barriert for the given number of threads
         /// working on the same problem.
@@ -195,13 +327,66 @@ namespace stream {
         static bool verify(const S *a, const S *b, const S *c, const S s,
             const size_t cnt, const task_type task);
 
+        /// <summary>
+        /// Makes all non-temporal stores issued by the calling thread globally
+        /// visible.
+        /// </summary>
+        static TRROJANSTREAM_FORCE_INLINE void fence_non_temporal(void) {
+#if defined(TRROJANSTREAM_STREAMING_STORES)
+            _mm_sfence();
+#endif /* defined(TRROJANSTREAM_STREAMING_STORES) */
+        }
+
+        /// <summary>
+        /// Stores <paramref name="value" /> at <paramref name="dst" /> while
+        /// bypassing the caches.
+        /// </summary>
+        /// <remarks>
+        /// Non-temporal stores are only available for 32-bit and 64-bit
+        /// scalars on x64. All other stores fall back to a normal store. As
+        /// non-temporal stores are weakly ordered,
+        /// <see cref="fence_non_temporal" /> must be called before the data
+        /// are consumed by another thread.
+        /// </remarks>
+        template<class T>
+        static TRROJANSTREAM_FORCE_INLINE void store_non_temporal(T *dst,
+                const T value) {
+#if defined(TRROJANSTREAM_STREAMING_STORES)
+            if constexpr (sizeof(T) == sizeof(int)) {
+                int v;
+                std::memcpy(&v, &value, sizeof(v));
+                _mm_stream_si32(reinterpret_cast<int *>(dst), v);
+            } else if constexpr (sizeof(T) == sizeof(long long)) {
+                long long v;
+                std::memcpy(&v, &value, sizeof(v));
+                _mm_stream_si64(reinterpret_cast<long long *>(dst), v);
+            } else {
+                *dst = value;
+            }
+#else /* defined(TRROJANSTREAM_STREAMING_STORES) */
+            *dst = value;
+#endif /* defined(TRROJANSTREAM_STREAMING_STORES) */
+        }
+
         /// <summary>
         /// Initialises a new instance.
         /// </summary>
-        inline worker_thread(void) : hThread(0), rank(0) { }
+        inline worker_thread(void) : command(command_type::idle), hThread(0),
+            measured(false), persistent(false), rank(0), runs_origin(0),
+            verified(false) { }
 
         worker_thread(const worker_thread&) = delete;
 
+        /// <summary>
+        /// Finalises the instance.
+        /// </summary>
+        /// <remarks>
+        /// Persistent worker threads are stopped and joined. Threads started
+        /// for a single problem must be joined using <see cref="join" />
+        /// before the object is destroyed.
+        /// </remarks>
+        ~worker_thread(void);
+
         /// <summary>
         /// Copy the results of this worker thread to the specified output
         /// iterator.
@@ -218,6 +403,43 @@ namespace stream {
             this->results_lock.unlock();
         }
 
+        /// <summary>
+        /// Passes a new problem to a persistent worker thread, which will
+        /// immediately start processing it.
+        /// </summary>
+        /// <remarks>
+        /// The result set of the thread is reused and only reallocated if the
+        /// new problem requires more iterations than any problem before.
+        /// </remarks>
+        /// <param name="problem">The problem to be processed.</param>
+        /// <param name="barrier">The barrier synchronising all threads working
+        /// on <paramref name="problem" />.</param>
+        /// <exception cref="std::logic_error">If the thread is not a
+        /// persistent one or if it is still busy with the previous problem.
+        /// </exception>
+        void post(problem_type problem, barrier_type barrier);
+
+        /// <summary>
+        /// Gets the rank of the thread.
+        /// </summary>
+        inline rank_type get_rank(void) const {
+            return this->rank;
+        }
+
+        /// <summary>
+        /// Answer whether the thread has successfully verified the results on
+        /// its part of the arrays.
+        /// </summary>
+        /// <remarks>
+        /// The result is only available after the thread has finished the
+        /// problem. It is always <c>false</c> if the problem did not request
+        /// a verification.
+        /// </remarks>
+        inline bool is_verified(void) const {
+            std::lock_guard<std::mutex> l(this->results_lock);
+            return this->verified;
+        }
+
         /// <summary>
         /// Starts the worker thread.
         /// </summary>
@@ -225,10 +447,66 @@ namespace stream {
             const rank_type rank, const uint64_t affinity_mask = 0,
             const uint16_t affinity_group = 0);
 
+        /// <summary>
+        /// Starts a persistent worker thread, which waits for problems being
+        /// passed to it via <see cref="post" />.
+        /// </summary>
+        void start(const rank_type rank, const uint64_t affinity_mask = 0,
+            const uint16_t affinity_group = 0);
+
+        /// <summary>
+        /// Instructs a persistent worker thread to exit once it has finished
+        /// the current problem and waits for the thread to end.
+        /// </summary>
+        /// <remarks>
+        /// It is safe to call this method on a thread that is not running.
+        /// </remarks>
+        void stop(void);
+
+        /// <summary>
+        /// Blocks the calling thread until a persistent worker thread has
+        /// finished the problem passed to it via <see cref="post" />.
+        /// </summary>
+        void wait(void);
+
+        /// <summary>
+        /// Blocks the calling thread until a persistent worker thread has
+        /// completed the measurement of the problem passed to it via
+        /// <see cref="post" />.
+        /// </summary>
+        /// <remarks>
+        /// If the problem requested a verification, the thread might still be
+        /// checking its results when this method returns, wherefore
+        /// <see cref="wait" /> must be called before the next problem is
+        /// posted. Accessing the results blocks until the verification is
+        /// complete.
+        /// </remarks>
+        void wait_for_measurement(void);
+
         worker_thread& operator =(const worker_thread&) = delete;
 
     private:
 
+        /// <summary>
+        /// The commands that can be passed to the thread.
+        /// </summary>
+        enum class command_type {
+            /// <summary>
+            /// The thread is waiting for work.
+            /// </summary>
+            idle,
+
+            /// <summary>
+            /// The thread should process the current problem.
+            /// </summary>
+            run,
+
+            /// <summary>
+            /// The thread should exit.
+            /// </summary>
+            exit
+        };
+
         /// <summary>
         /// The type of a native thread handle.
         /// </summary>
@@ -360,6 +638,184 @@ namespace stream {
             }
         };
 
+        /// <summary>
+        /// Template specialisation which actually performs the
+        /// <see cref="trrojan::stream::task_type::fill" /> task.
+        /// </summary>
+        template<scalar_type S> struct step<1, S, task_type::fill> {
+            typedef typename scalar_type_traits<S>::type scalar_type;
+
+            static TRROJANSTREAM_FORCE_INLINE void apply(const scalar_type *a,
+                    const scalar_type *b, scalar_type *c, const scalar_type s,
+                    const size_t o) {
+                *c = s;
+            }
+        };
+
+        /// <summary>
+        /// Template specialisation which actually performs the
+        /// <see cref="trrojan::stream::task_type::fill_nt" /> task.
+        /// </summary>
+        template<scalar_type S> struct step<1, S, task_type::fill_nt> {
+            typedef typename scalar_type_traits<S>::type scalar_type;
+
+            static TRROJANSTREAM_FORCE_INLINE void apply(const scalar_type *a,
+                    const scalar_type *b, scalar_type *c, const scalar_type s,
+                    const size_t o) {
+                worker_thread::store_non_temporal(c, s);
+            }
+        };
+
+        /// <summary>
+        /// Template specialisation for the whole
+        /// <see cref="trrojan::stream::task_type::fill_nt" /> task, which
+        /// fences the non-temporal stores such that the time until they
+        /// are complete is measured.
+        /// </summary>
+        template<int N, scalar_type S> struct step<N, S, task_type::fill_nt> {
+            typedef typename scalar_type_traits<S>::type scalar_type;
+
+            static TRROJANSTREAM_FORCE_INLINE void apply(const scalar_type *a,
+                    const scalar_type *b, scalar_type *c, const scalar_type s,
+                    const size_t o) {
+                for (int i = 0; i < N; i += o) {
+                    step<1, S, task_type::fill_nt>::apply(a + i, b + i, c + i,
+                        s, o);
+                }
+                worker_thread::fence_non_temporal();
+            }
+        };
+
+        /// <summary>
+        /// Template specialisation which performs the
+        /// <see cref="trrojan::stream::task_type::sum" /> task for a single
+        /// element.
+        /// </summary>
+        template<scalar_type S> struct step<1, S, task_type::sum> {
+            typedef typename scalar_type_traits<S>::type scalar_type;
+
+            static TRROJANSTREAM_FORCE_INLINE void apply(const scalar_type *a,
+                    const scalar_type *b, scalar_type *c, const scalar_type s,
+                    const size_t o) {
+                *c = *a;
+            }
+        };
+
+        /// <summary>
+        /// Template specialisation for the whole
+        /// <see cref="trrojan::stream::task_type::sum" /> task, which only
+        /// writes the final result to the first element of the output.
+        /// </summary>
+        template<int N, scalar_type S> struct step<N, S, task_type::sum> {
+            typedef typename scalar_type_traits<S>::type scalar_type;
+
+            static TRROJANSTREAM_FORCE_INLINE void apply(const scalar_type *a,
+                    const scalar_type *b, scalar_type *c, const scalar_type s,
+                    const size_t o) {
+                *c = worker_thread::reduce(a, N, o);
+            }
+        };
+
+        /// <summary>
+        /// The type used to sum up scalars of type <tparamref name="T" />,
+        /// which is the type they are promoted to in arithmetic expressions.
+        /// </summary>
+        /// <remarks>
+        /// Summing up 8-bit integers and reduced-precision floats in their
+        /// own type would convert the intermediate results back after each
+        /// addition, which is neither what real-world code does nor something
+        /// the compiler can vectorise well.
+        /// </remarks>
+        template<class T>
+        using accumulator_type = decltype(+std::declval<T>());
+
+        /// <summary>
+        /// The size of the blocks in bytes that
+        /// <see cref="trrojan::stream::task_type::mix" /> either reads or
+        /// writes, which is a typical cache line.
+        /// </summary>
+        static constexpr std::size_t mix_block_size = 64;
+
+        /// <summary>
+        /// Performs the <see cref="trrojan::stream::task_type::mix" /> task,
+        /// which reads <paramref name="reads" /> blocks from
+        /// <paramref name="a" /> and then writes <paramref name="writes" />
+        /// blocks of <paramref name="c" /> until <paramref name="cnt" />
+        /// elements have been processed.
+        /// </summary>
+        /// <remarks>
+        /// The sum of all elements read is stored in the first element of
+        /// <paramref name="c" /> such that the compiler cannot remove the
+        /// reads. This element is part of a block that is only read.
+        /// </remarks>
+        template<class T>
+        static TRROJANSTREAM_FORCE_INLINE void mix(const T *a, T *c,
+                const T s, const size_t cnt, const size_t o,
+                const size_t reads, const size_t writes) {
+            const auto block = (std::max)(static_cast<size_t>(1),
+                mix_block_size / sizeof(T)) * o;
+            const auto cycle = (std::max)(reads + writes,
+                static_cast<size_t>(1));
+            accumulator_type<T> sum = 0;
+
+            for (size_t i = 0, j = 0; i < cnt; i += block, ++j) {
+                const auto e = (std::min)(i + block, cnt);
+                if (j % cycle < reads) {
+                    for (auto k = i; k < e; k += o) {
+                        sum += a[k];
+                    }
+                } else {
+                    for (auto k = i; k < e; k += o) {
+                        c[k] = s;
+                    }
+                }
+            }
+
+            if (reads > 0) {
+                *c = static_cast<T>(sum);
+            }
+        }
+
+        /// <summary>
+        /// Converts every <paramref name="o" />th of the first
+        /// <paramref name="cnt" /> elements of <paramref name="src" /> to
+        /// <tparamref name="D" /> and stores it in <paramref name="dst" />.
+        /// </summary>
+        template<class D, class S>
+        static TRROJANSTREAM_FORCE_INLINE void convert(const S *src, D *dst,
+                const size_t cnt, const size_t o) {
+            for (size_t i = 0; i < cnt; i += o) {
+                dst[i] = static_cast<D>(src[i]);
+            }
+        }
+
+        /// <summary>
+        /// Sums up every <paramref name="o" />th of the first
+        /// <paramref name="cnt" /> elements of <paramref name="a" />.
+        /// </summary>
+        /// <remarks>
+        /// The sum is computed using four independent partial sums such that
+        /// the latency of the additions does not limit the memory throughput.
+        /// </remarks>
+        template<class T>
+        static TRROJANSTREAM_FORCE_INLINE T reduce(const T *a,
+                const size_t cnt, const size_t o) {
+            accumulator_type<T> sums[4] = { 0, 0, 0, 0 };
+            size_t i = 0;
+
+            for (; i + 3 * o < cnt; i += 4 * o) {
+                sums[0] += a[i];
+                sums[1] += a[i + o];
+                sums[2] += a[i + 2 * o];
+                sums[3] += a[i + 3 * o];
+            }
+            for (; i < cnt; i += o) {
+                sums[0] += a[i];
+            }
+
+            return static_cast<T>((sums[0] + sums[1]) + (sums[2] + sums[3]));
+        }
+
         /// <summary>
         /// The thread function which invokes the
         /// <see cref="trrojan::stream::worker_thread::dispatch" />
@@ -498,6 +954,222 @@ namespace stream {
         inline void dispatch(trrojan::stream::task_type_list_t<>,
             const trrojan::stream::task_type t) { }
 
+        /// <summary>
+        /// Performs one iteration of the task <tparamref name="T" /> on the
+        /// given arrays.
+        /// </summary>
+        /// <remarks>
+        /// All tasks except for <see cref="trrojan::stream::task_type::mix" />
+        /// and the conversions are fully determined at compile time and run
+        /// via <see cref="step" />.
+        /// The mixed task requires the read/write ratio of the current
+        /// problem. The conversions work on <paramref name="f" /> in addition
+        /// to the scalar arrays, which is <c>nullptr</c> for all other tasks.
+        /// </remarks>
+        template<int N, trrojan::stream::scalar_type S,
+            trrojan::stream::task_type T>
+        TRROJANSTREAM_FORCE_INLINE void apply(
+                const typename scalar_type_traits<S>::type *a,
+                const typename scalar_type_traits<S>::type *b,
+                typename scalar_type_traits<S>::type *c,
+                float *f,
+                const typename scalar_type_traits<S>::type s,
+                const size_t o) {
+            if constexpr (T == task_type::mix) {
+                worker_thread::mix(a, c, s, N, o, this->_problem->mix_reads(),
+                    this->_problem->mix_writes());
+            } else if constexpr (T == task_type::pack) {
+                worker_thread::convert(f, c, N, o);
+            } else if constexpr (T == task_type::unpack) {
+                worker_thread::convert(a, f, N, o);
+            } else {
+                step<N, S, T>::apply(a, b, c, s, o);
+            }
+        }
+
+        /// <summary>
+        /// Performs one iteration of the task <tparamref name="T" /> on the
+        /// elements designated by <see cref="runs" />.
+        /// </summary>
+        /// <remarks>
+        /// This is the counterpart of <see cref="apply" /> for the access
+        /// patterns that are parameterised at runtime. As the runs are not
+        /// known at compile time, the loops cannot be unrolled by the
+        /// compiler.
+        /// </remarks>
+        template<trrojan::stream::scalar_type S, trrojan::stream::task_type T>
+        TRROJANSTREAM_FORCE_INLINE void apply_runs(
+                const typename scalar_type_traits<S>::type *a,
+                const typename scalar_type_traits<S>::type *b,
+                typename scalar_type_traits<S>::type *c,
+                float *f,
+                const typename scalar_type_traits<S>::type s) {
+            if constexpr (T == task_type::sum) {
+                typedef typename scalar_type_traits<S>::type scalar_type;
+                accumulator_type<scalar_type> sum = 0;
+                for (auto& r : this->runs) {
+                    sum += worker_thread::reduce(a + r.offset,
+                        r.count * r.step, r.step);
+                }
+                c[this->runs_origin] = static_cast<scalar_type>(sum);
+
+            } else if constexpr (T == task_type::mix) {
+                for (auto& r : this->runs) {
+                    worker_thread::mix(a + r.offset, c + r.offset, s,
+                        r.count * r.step, r.step, this->_problem->mix_reads(),
+                        this->_problem->mix_writes());
+                }
+
+            } else if constexpr (T == task_type::pack) {
+                for (auto& r : this->runs) {
+                    worker_thread::convert(f + r.offset, c + r.offset,
+                        r.count * r.step, r.step);
+                }
+
+            } else if constexpr (T == task_type::unpack) {
+                for (auto& r : this->runs) {
+                    worker_thread::convert(a + r.offset, f + r.offset,
+                        r.count * r.step, r.step);
+                }
+
+            } else {
+                for (auto& r : this->runs) {
+                    const auto e = r.offset + r.count * r.step;
+                    for (auto i = r.offset; i < e; i += r.step) {
+                        step<1, S, T>::apply(a + i, b + i, c + i, s, r.step);
+                    }
+                }
+                if constexpr (T == task_type::fill_nt) {
+                    worker_thread::fence_non_temporal();
+                }
+            }
+        }
+
+        /// <summary>
+        /// Performs one iteration of the task <tparamref name="T" /> using
+        /// <see cref="apply_runs" /> if <tparamref name="R" /> is <c>true</c>
+        /// or <see cref="apply" /> otherwise.
+        /// </summary>
+        template<int N, trrojan::stream::scalar_type S,
+            trrojan::stream::task_type T, bool R>
+        TRROJANSTREAM_FORCE_INLINE void apply_kernel(
+                const typename scalar_type_traits<S>::type *a,
+                const typename scalar_type_traits<S>::type *b,
+                typename scalar_type_traits<S>::type *c,
+                const typename scalar_type_traits<S>::type s,
+                const size_t o) {
+            if constexpr (R) {
+                this->apply_runs<S, T>(a, b, c, nullptr, s);
+            } else {
+                this->apply<N, S, T>(a, b, c, nullptr, s, o);
+            }
+        }
+
+        /// <summary>
+        /// Performs one iteration of
+        /// <see cref="trrojan::stream::task_type::suite" />, which runs
+        /// copy (c = a), scale (b = s * c), add (c = a + b) and triad
+        /// (a = b + s * c) like McCalpin's STREAM and synchronises all
+        /// threads before each of the kernels.
+        /// </summary>
+        /// <param name="result">Receives the start time, the time of each
+        /// kernel and their sum as well as the time spent at each barrier.
+        /// </param>
+        /// <param name="barrier">The ID of the barrier before the first kernel.
+        /// The kernels use the <see cref="suite_kernels" /> consecutive IDs
+        /// starting at this one.</param>
+        /// <tparam name="R">Determines whether the access pattern is
+        /// parameterised at runtime.</tparam>
+        template<int N, trrojan::stream::scalar_type S, bool R>
+        TRROJANSTREAM_FORCE_INLINE void apply_suite(iteration_result& result,
+                const int barrier,
+                typename scalar_type_traits<S>::type *a,
+                typename scalar_type_traits<S>::type *b,
+                typename scalar_type_traits<S>::type *c,
+                const typename scalar_type_traits<S>::type s,
+                const size_t o) {
+            trrojan::timer timer;
+
+            timer.start();
+            this->synchronise(barrier);
+            result.kernel_waits[0] = result.wait_time = timer.elapsed_millis();
+            result.start = timer.start();
+            this->apply_kernel<N, S, task_type::copy, R>(a, b, c, s, o);
+            result.kernel_times[0] = timer.elapsed_millis();
+
+            timer.start();
+            this->synchronise(barrier + 1);
+            result.kernel_waits[1] = timer.elapsed_millis();
+            timer.start();
+            this->apply_kernel<N, S, task_type::scale, R>(c, c, b, s, o);
+            result.kernel_times[1] = timer.elapsed_millis();
+
+            timer.start();
+            this->synchronise(barrier + 2);
+            result.kernel_waits[2] = timer.elapsed_millis();
+            timer.start();
+            this->apply_kernel<N, S, task_type::add, R>(a, b, c, s, o);
+            result.kernel_times[2] = timer.elapsed_millis();
+
+            timer.start();
+            this->synchronise(barrier + 3);
+            result.kernel_waits[3] = timer.elapsed_millis();
+            timer.start();
+            this->apply_kernel<N, S, task_type::triad, R>(c, b, a, s, o);
+            result.kernel_times[3] = timer.elapsed_millis();
+
+            // The waiting time at the barriers is not part of the result.
+            result.time = std::accumulate(result.kernel_times.begin(),
+                result.kernel_times.end(), 0.0);
+        }
+
+        /// <summary>
+        /// Checks the results of the task <tparamref name="T" /> on the
+        /// elements the thread has processed itself.
+        /// </summary>
+        /// <remarks>
+        /// <para>The thread verifies the same elements it has measured, which
+        /// are local to its NUMA node if the memory has been placed by the
+        /// threads themselves, and stops at the first mismatch.</para>
+        /// <para><see cref="trrojan::stream::task_type::suite" /> overwrites
+        /// its input, wherefore only the last kernel, triad, can be checked.
+        /// </para>
+        /// </remarks>
+        /// <tparam name="R">Determines whether the access pattern is
+        /// parameterised at runtime, in which case <see cref="runs" /> are
+        /// checked. Otherwise, every <paramref name="o" />th of the first
+        /// <tparamref name="N" /> elements is checked.</tparam>
+        /// <returns><c>true</c> if all results are correct, <c>false</c>
+        /// otherwise.</returns>
+        template<int N, trrojan::stream::scalar_type S,
+            trrojan::stream::task_type T, bool R>
+        bool verify_partition(
+            const typename scalar_type_traits<S>::type *a,
+            const typename scalar_type_traits<S>::type *b,
+            const typename scalar_type_traits<S>::type *c,
+            const float *f,
+            const typename scalar_type_traits<S>::type s,
+            const size_t o) const;
+
+        /// <summary>
+        /// Runs the dispatch cascade for the current problem while holding the
+        /// lock for the results.
+        /// </summary>
+        void execute(void);
+
+        /// <summary>
+        /// Marks the measurement of the current problem as completed and
+        /// wakes all threads in <see cref="wait_for_measurement" />.
+        /// </summary>
+        void signal_measured(void);
+
+        /// <summary>
+        /// Creates the native thread and pins it to the specified logical
+        /// processors or, if <paramref name="affinity_mask" /> is zero, to
+        /// the processor determined by the rank of the thread.
+        /// </summary>
+        void spawn(const uint64_t affinity_mask, const uint16_t affinity_group);
+
         /// <summary>
         /// Synchronises the worker threads using the same
         /// <see cref="trrojan::stream::worker_thread::barrier" />
@@ -511,11 +1183,38 @@ namespace stream {
         /// </summary>
         barrier_type barrier;
 
+        /// <summary>
+        /// The command the thread is supposed to execute next.
+        /// </summary>
+        command_type command;
+
+        /// <summary>
+        /// Signals changes of <see cref="command" />.
+        /// </summary>
+        std::condition_variable command_changed;
+
+        /// <summary>
+        /// The lock for <see cref="command" />.
+        /// </summary>
+        std::mutex command_lock;
+
         /// <summary>
         /// The native thread handle.
         /// </summary>
         handle_type hThread;
 
+        /// <summary>
+        /// Remembers whether the thread has completed the measurement of the
+        /// current problem, which is protected by <see cref="command_lock" />.
+        /// </summary>
+        bool measured;
+
+        /// <summary>
+        /// Determines whether the thread waits for the next problem after it
+        /// has completed the current one.
+        /// </summary>
+        bool persistent;
+
         /// <summary>
         /// Stores the problem, which is shared between the threads.
         /// </summary>
@@ -531,10 +1230,29 @@ namespace stream {
         /// </summary>
         results_type results;
 
+        /// <summary>
+        /// The runs the thread performs for access patterns that are
+        /// parameterised at runtime, which are reused across problems.
+        /// </summary>
+        std::vector<access_run> runs;
+
+        /// <summary>
+        /// The lowest index accessed by any of the <see cref="runs" />, which
+        /// is where the result of
+        /// <see cref="trrojan::stream::task_type::sum" /> is stored.
+        /// </summary>
+        size_t runs_origin;
+
         /// <summary>
         /// The lock for <see cref="results" />.
         /// </summary>
         mutable std::mutex results_lock;
+
+        /// <summary>
+        /// Remembers whether the results of the last problem have been
+        /// verified successfully.
+        /// </summary>
+        bool verified;
     };
 
 }
@@ -49,6 +49,97 @@ void trrojan::stream::worker_thread::join(I begin, I end) {
 }
 
 
+/*
+ * trrojan::stream::worker_thread::run_pinned
+ */
+template<class F>
+void trrojan::stream::worker_thread::run_pinned(
+        const std::vector<std::uint32_t>& processors, F&& func) {
+    const auto cnt = processors.size();
+    std::exception_ptr error;
+    std::mutex errorLock;
+    std::atomic<bool> failed(false);
+    std::atomic<std::size_t> ready(0);
+    std::vector<std::thread> threads;
+
+    threads.reserve(cnt);
+    for (std::size_t i = 0; i < cnt; ++i) {
+        threads.emplace_back([&, i](void) {
+            try {
+                worker_thread::pin_calling_thread(processors[i]);
+            } catch (...) {
+                std::lock_guard<std::mutex> l(errorLock);
+                if (!error) {
+                    error = std::current_exception();
+                }
+                failed.store(true);
+            }
+
+            // Wait for all threads being pinned before starting.
+            ++ready;
+            while (ready.load() < cnt) {
+                std::this_thread::yield();
+            }
+
+            if (!failed.load()) {
+                func(i);
+            }
+        });
+    }
+
+    for (auto& t : threads) {
+        t.join();
+    }
+
+    if (error) {
+        std::rethrow_exception(error);
+    }
+}
+
+
+/*
+ * trrojan::stream::worker_thread::run_kernel
+ */
+template<trrojan::stream::scalar_type S, trrojan::stream::task_type T>
+void trrojan::stream::worker_thread::run_kernel(
+        typename scalar_type_traits<S>::type *a,
+        typename scalar_type_traits<S>::type *b,
+        typename scalar_type_traits<S>::type *c,
+        float *f,
+        const typename scalar_type_traits<S>::type s,
+        const size_t cnt,
+        const size_t mix_reads,
+        const size_t mix_writes) {
+    if constexpr (T == task_type::sum) {
+        *c = worker_thread::reduce(a, cnt, 1);
+
+    } else if constexpr (T == task_type::mix) {
+        worker_thread::mix(a, c, s, cnt, 1, mix_reads, mix_writes);
+
+    } else if constexpr (T == task_type::pack) {
+        worker_thread::convert(f, c, cnt, 1);
+
+    } else if constexpr (T == task_type::unpack) {
+        worker_thread::convert(a, f, cnt, 1);
+
+    } else if constexpr (T == task_type::suite) {
+        // Same order and operands as in apply_suite.
+        worker_thread::run_kernel<S, task_type::copy>(a, b, c, f, s, cnt);
+        worker_thread::run_kernel<S, task_type::scale>(c, c, b, f, s, cnt);
+        worker_thread::run_kernel<S, task_type::add>(a, b, c, f, s, cnt);
+        worker_thread::run_kernel<S, task_type::triad>(c, b, a, f, s, cnt);
+
+    } else {
+        for (size_t i = 0; i < cnt; ++i) {
+            step<1, S, T>::apply(a + i, b + i, c + i, s, 1);
+        }
+        if constexpr (T == task_type::fill_nt) {
+            worker_thread::fence_non_temporal();
+        }
+    }
+}
+
+
 /*
  * trrojan::stream::worker_thread::verify
  */
@@ -87,17 +178,147 @@ bool trrojan::stream::worker_thread::verify(const S *a, const S *b, const S *c,
             return worker_thread::verify<S, task_type::add>(a, b, c, s, cnt);
         case task_type::copy:
             return worker_thread::verify<S, task_type::copy>(a, b, c, s, cnt);
+        case task_type::fill:
+        case task_type::fill_nt:
+            return worker_thread::verify<S, task_type::fill>(a, b, c, s, cnt);
         case task_type::scale:
             return worker_thread::verify<S, task_type::scale>(a, b, c, s, cnt);
         case task_type::triad:
             return worker_thread::verify<S, task_type::triad>(a, b, c, s, cnt);
         default:
+            // The results of sum and mix depend on how the arrays have been
+            // partitioned between the threads, wherefore the threads check
+            // them themselves in verify_partition. The same holds for the
+            // conversions, which do not work on the scalar arrays alone.
             throw std::logic_error("No verification is possible for the given "
                 "task.");
     }
 }
 
 
+/*
+ * trrojan::stream::worker_thread::verify_partition
+ */
+template<int N, trrojan::stream::scalar_type S, trrojan::stream::task_type T,
+    bool R>
+bool trrojan::stream::worker_thread::verify_partition(
+        const typename scalar_type_traits<S>::type *a,
+        const typename scalar_type_traits<S>::type *b,
+        const typename scalar_type_traits<S>::type *c,
+        const float *f,
+        const typename scalar_type_traits<S>::type s,
+        const size_t o) const {
+    typedef typename scalar_type_traits<S>::type scalar_type;
+    // The static patterns are expressed as a single run such that all of
+    // them can be checked in the same way.
+    const std::vector<access_run> single { access_run { 0,
+        (static_cast<size_t>(N) + o - 1) / o, o } };
+    const auto& runs = R ? this->runs : single;
+    const auto origin = R ? this->runs_origin : 0;
+
+    auto fail = [this](const size_t i, const std::string& found,
+            const std::string& expected) {
+        trrojan::log::instance().write_line(trrojan::log_level::warning,
+            "Verification of stream results on worker thread {0} failed for "
+            "item {1}: found {2}, but expected {3}.", this->rank, i, found,
+            expected);
+        return false;
+    };
+
+    if constexpr (T == task_type::sum) {
+        // Use the same order of additions as the test.
+        accumulator_type<scalar_type> sum = 0;
+        for (auto& r : runs) {
+            sum += worker_thread::reduce(a + r.offset, r.count * r.step,
+                r.step);
+        }
+
+        const auto expected = static_cast<scalar_type>(sum);
+        if (c[origin] != expected) {
+            return fail(origin, std::to_string(c[origin]),
+                std::to_string(expected));
+        }
+
+    } else if constexpr (T == task_type::mix) {
+        const auto reads = this->_problem->mix_reads();
+        const auto writes = this->_problem->mix_writes();
+        const auto cycle = (std::max)(reads + writes, static_cast<size_t>(1));
+
+        for (auto& r : runs) {
+            const auto block = (std::max)(static_cast<size_t>(1),
+                mix_block_size / sizeof(scalar_type)) * r.step;
+            const auto cnt = r.count * r.step;
+            accumulator_type<scalar_type> sum = 0;
+
+            for (size_t i = 0, j = 0; i < cnt; i += block, ++j) {
+                const auto e = (std::min)(i + block, cnt);
+                for (auto k = i; k < e; k += r.step) {
+                    if (j % cycle < reads) {
+                        sum += a[r.offset + k];
+                    } else if (c[r.offset + k] != s) {
+                        return fail(r.offset + k,
+                            std::to_string(c[r.offset + k]),
+                            std::to_string(s));
+                    }
+                }
+            }
+
+            const auto expected = static_cast<scalar_type>(sum);
+            if ((reads > 0) && (c[r.offset] != expected)) {
+                return fail(r.offset, std::to_string(c[r.offset]),
+                    std::to_string(expected));
+            }
+        }
+
+    } else {
+        for (auto& r : runs) {
+            const auto e = r.offset + r.count * r.step;
+            for (auto i = r.offset; i < e; i += r.step) {
+                if constexpr (T == task_type::pack) {
+                    const auto expected = static_cast<scalar_type>(f[i]);
+                    if (c[i] != expected) {
+                        return fail(i, std::to_string(c[i]),
+                            std::to_string(expected));
+                    }
+
+                } else if constexpr (T == task_type::unpack) {
+                    const auto expected = static_cast<float>(a[i]);
+                    if (f[i] != expected) {
+                        return fail(i, std::to_string(f[i]),
+                            std::to_string(expected));
+                    }
+
+                } else if constexpr (T == task_type::suite) {
+                    // The last kernel of the suite is a = b + s * c.
+                    scalar_type expected;
+                    step<1, S, task_type::triad>::apply(c + i, b + i,
+                        &expected, s, 0);
+                    if (a[i] != expected) {
+                        return fail(i, std::to_string(a[i]),
+                            std::to_string(expected));
+                    }
+
+                } else {
+                    // The non-temporal fill must yield the same as the
+                    // normal one.
+                    constexpr auto U = (T == task_type::fill_nt)
+                        ? task_type::fill : T;
+                    scalar_type expected;
+                    step<1, S, U>::apply(a + i, b + i, &expected, s, 0);
+                    if (c[i] != expected) {
+                        return fail(i, std::to_string(c[i]),
+                            std::to_string(expected));
+                    }
+                }
+            }
+        }
+    }
+    /* No problem found at this point. */
+
+    return true;
+}
+
+
 /*
  * trrojan::stream::worker_thread::dispatch
  */
@@ -114,23 +335,42 @@ void trrojan::stream::worker_thread::dispatch(
 
     if (T == t) {
         typedef access_pattern_traits<A, P> pattern;
-        typedef step<P, S, T> step;
 
         auto offset = pattern::offset(this->rank);
         auto a = this->_problem->a<S>() + offset;
         auto b = this->_problem->b<S>() + offset;
         auto c = this->_problem->c<S>() + offset;
+        auto f = this->_problem->is_conversion()
+            ? this->_problem->f() + offset : nullptr;
         auto s = this->_problem->s<S>();
         auto o = pattern::step(this->_problem->parallelism());
         auto cnt = this->_problem->iterations();
         trrojan::timer timer;
 
+        if constexpr (pattern::has_runs) {
+            // Compute the runs before the measurement starts, because they
+            // potentially involve shuffling a large number of blocks.
+            this->runs.clear();
+            pattern::runs(std::back_inserter(this->runs), this->rank,
+                this->_problem->parallelism(),
+                this->_problem->pattern_parameters());
+
+            auto it = std::min_element(this->runs.begin(), this->runs.end(),
+                [](const access_run& l, const access_run& r) {
+                    return (l.offset < r.offset);
+                });
+            this->runs_origin = (it != this->runs.end()) ? it->offset
+                : pattern::offset(this->rank);
+        }
+
+        // Note: the scalar is promoted, because the log cannot format the
+        // reduced-precision floats directly.
         log::instance().write(log_level::verbose, "Worker thread {} is "
             "performing the following test: size = {}, offset = {}, "
             "step = {}, task = {}, access pattern = {}, scalar type = {}, "
             "scalar value = {}, iterations = {}\n", this->rank, P, offset, o,
             static_cast<int>(T), static_cast<int>(A), static_cast<int>(S),
-            s, cnt);
+            +s, cnt);
 
         for (size_t i = 0; i <= cnt; ++i) {
             auto& result = this->results[i];
@@ -141,13 +381,44 @@ void trrojan::stream::worker_thread::dispatch(
             // the point where it is in the code. Otherwise, some compilers
             // reorder the operations, because 'result' is not used before the
             // spin lock was passed.
-            this->synchronise(i);
-            result.start = timer.start();
-            step::apply(a, b, c, s, o);
-            result.time = timer.elapsed_millis();
+            if constexpr (T == task_type::suite) {
+                // The suite synchronises before each of its kernels.
+                this->apply_suite<P, S, pattern::has_runs>(result,
+                    static_cast<int>(i * suite_kernels), a, b, c, s, o);
+
+            } else {
+                timer.start();
+                this->synchronise(i);
+                result.wait_time = timer.elapsed_millis();
+                result.start = timer.start();
+                if constexpr (pattern::has_runs) {
+                    this->apply_runs<S, T>(a, b, c, f, s);
+                } else {
+                    this->apply<P, S, T>(a, b, c, f, s, o);
+                }
+                result.time = timer.elapsed_millis();
+            }
             // std::cout << "Iteration " << i << ", worker " << this->rank << ": " << this->_problem->calc_mb_per_s(result.time) << " MB/s" << std::endl;
         }
 
+        // Allow the caller to stop measuring, eg the energy, before the
+        // results are checked.
+        this->signal_measured();
+
+        this->verified = false;
+        if (this->_problem->verify()) {
+            // Wait for all threads to complete their measurements before
+            // verifying such that the checks cannot slow down a thread that
+            // is still being timed. The barrier ID is the number of barriers
+            // passed before.
+            const auto barriers = (T == task_type::suite)
+                ? (cnt + 1) * suite_kernels
+                : cnt + 1;
+            this->synchronise(static_cast<int>(barriers));
+            this->verified = this->verify_partition<P, S, T,
+                pattern::has_runs>(a, b, c, f, s, o);
+        }
+
     } else {
         this->dispatch<S, P, A>(
             trrojan::stream::task_type_list_t<Ts...>(),
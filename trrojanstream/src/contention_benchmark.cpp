@@ -0,0 +1,234 @@
+/// <copyright file="contention_benchmark.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#include "trrojan/stream/contention_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cassert>
+#include <cstdint>
+#include <numeric>
+#include <stdexcept>
+
+#include "trrojan/system_topology.h"
+
+#include "trrojan/stream/worker_thread.h"
+
+
+namespace trrojan {
+namespace stream {
+namespace detail {
+
+    /// <summary>
+    /// The size of a cache line, which is the unit the coherence protocol
+    /// transfers between cores.
+    /// </summary>
+    static constexpr std::size_t cache_line_size = 64;
+
+    /// <summary>
+    /// A counter that occupies a cache line on its own.
+    /// </summary>
+    struct alignas(worker_thread::cache_line_padding) padded_counter {
+        std::atomic<std::uint64_t> value { 0 };
+    };
+
+    /// <summary>
+    /// As many counters as fit on a single cache line.
+    /// </summary>
+    struct alignas(cache_line_size) packed_counters {
+        static constexpr std::size_t size = cache_line_size
+            / sizeof(std::atomic<std::uint64_t>);
+        std::atomic<std::uint64_t> values[size] { };
+    };
+
+    static_assert(sizeof(packed_counters) == cache_line_size,
+        "The packed counters must occupy exactly one cache line.");
+
+    /// <summary>
+    /// Increments <paramref name="counter" /> <paramref name="cnt" /> times
+    /// using an atomic read-modify-write operation.
+    /// </summary>
+    static void fetch_add(std::atomic<std::uint64_t>& counter,
+            const std::uint64_t cnt) {
+        for (std::uint64_t i = 0; i < cnt; ++i) {
+            counter.fetch_add(1);
+        }
+    }
+
+    /// <summary>
+    /// Increments <paramref name="counter" /> <paramref name="cnt" /> times
+    /// using plain loads and stores, which the compiler cannot optimise away.
+    /// </summary>
+    static void increment(std::atomic<std::uint64_t>& counter,
+            const std::uint64_t cnt) {
+        for (std::uint64_t i = 0; i < cnt; ++i) {
+            counter.store(counter.load(std::memory_order_relaxed) + 1,
+                std::memory_order_relaxed);
+        }
+    }
+
+} /* end namespace detail */
+} /* end namespace stream */
+} /* end namespace trrojan */
+
+
+#define _TRROJANSTREAM_DEFINE_FACTOR(f)                                        \
+const std::string trrojan::stream::contention_benchmark::factor_##f(#f)
+
+_TRROJANSTREAM_DEFINE_FACTOR(iterations);
+_TRROJANSTREAM_DEFINE_FACTOR(test);
+_TRROJANSTREAM_DEFINE_FACTOR(threads);
+
+#undef _TRROJANSTREAM_DEFINE_FACTOR
+
+
+#define _TRROJANSTREAM_DEFINE_RES_NAME(r)                                      \
+const std::string trrojan::stream::contention_benchmark::result_name_##r(#r)
+
+_TRROJANSTREAM_DEFINE_RES_NAME(latency);
+_TRROJANSTREAM_DEFINE_RES_NAME(operations_per_second);
+_TRROJANSTREAM_DEFINE_RES_NAME(slowdown);
+
+#undef _TRROJANSTREAM_DEFINE_RES_NAME
+
+
+#define _TRROJANSTREAM_DEFINE_TEST(t)                                          \
+const std::string trrojan::stream::contention_benchmark::test_##t(#t)
+
+_TRROJANSTREAM_DEFINE_TEST(false_sharing);
+_TRROJANSTREAM_DEFINE_TEST(fetch_add);
+
+#undef _TRROJANSTREAM_DEFINE_TEST
+
+
+/*
+ * trrojan::stream::contention_benchmark::contention_benchmark
+ */
+trrojan::stream::contention_benchmark::contention_benchmark(void)
+        : trrojan::benchmark_base("contention") {
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_iterations, static_cast<std::uint64_t>(1000000)));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_test, { test_fetch_add, test_false_sharing }));
+
+    // Test all powers of two and the total number of logical processors.
+    {
+        auto cores = system_topology::instance().logical_cores();
+        std::vector<std::uint32_t> threads;
+        for (std::uint32_t t = 1; t < cores; t *= 2) {
+            threads.push_back(t);
+        }
+        threads.push_back(cores);
+        this->_default_configs.add_factor(factor::from_manifestations(
+            factor_threads, threads));
+    }
+}
+
+
+/*
+ * trrojan::stream::contention_benchmark::~contention_benchmark
+ */
+trrojan::stream::contention_benchmark::~contention_benchmark(void) { }
+
+
+/*
+ * trrojan::stream::contention_benchmark::run
+ */
+trrojan::result trrojan::stream::contention_benchmark::run(
+        const configuration& config) {
+    auto iterations = config.get<std::uint64_t>(factor_iterations);
+    auto test = config.get<std::string>(factor_test);
+    auto threads = config.get<std::uint32_t>(factor_threads);
+
+    if ((test != test_fetch_add) && (test != test_false_sharing)) {
+        throw std::invalid_argument("The contention test must be either \""
+            + test_fetch_add + "\" or \"" + test_false_sharing + "\".");
+    }
+    if (threads < 1) {
+        threads = 1;
+    }
+
+    std::vector<std::uint32_t> processors;
+    {
+        auto placement = system_topology::instance().placement();
+        for (std::uint32_t i = 0; i < threads; ++i) {
+            processors.push_back(placement[i % placement.size()]);
+        }
+    }
+
+    // The slowest thread determines the time for the whole test.
+    auto contended = contention_benchmark::measure(processors, test, false,
+        iterations);
+    auto padded = contention_benchmark::measure(processors, test, true,
+        iterations);
+    auto slowestContended = *std::max_element(contended.begin(),
+        contended.end());
+    auto slowestPadded = *std::max_element(padded.begin(), padded.end());
+    auto averageContended = std::accumulate(contended.begin(),
+        contended.end(), 0.0) / contended.size();
+
+    auto operations = static_cast<double>(iterations) * threads;
+    auto ops = (slowestContended > 0)
+        ? operations / slowestContended * 1000.0
+        : 0.0;
+    auto latency = (iterations > 0)
+        ? averageContended * 1000000.0 / iterations
+        : 0.0;
+    auto slowdown = (slowestPadded > 0)
+        ? slowestContended / slowestPadded
+        : 0.0;
+
+    auto retval = std::make_shared<basic_result>(config,
+        std::vector<std::string> { result_name_operations_per_second,
+        result_name_latency, result_name_slowdown });
+    retval->add({ ops, latency, slowdown });
+
+    return std::dynamic_pointer_cast<result::element_type>(retval);
+}
+
+
+/*
+ * trrojan::stream::contention_benchmark::measure
+ */
+std::vector<trrojan::timer::millis_type>
+trrojan::stream::contention_benchmark::measure(
+        const std::vector<std::uint32_t>& processors,
+        const std::string& test, const bool padded,
+        const std::uint64_t iterations) {
+    const auto fetchAdd = (test == test_fetch_add);
+    constexpr auto perLine = detail::packed_counters::size;
+    std::vector<detail::padded_counter> paddedCounters(processors.size());
+    std::vector<detail::packed_counters> packedCounters(
+        (processors.size() + perLine - 1) / perLine);
+    std::vector<timer::millis_type> retval(processors.size());
+
+    assert(reinterpret_cast<std::uintptr_t>(packedCounters.data())
+        % detail::cache_line_size == 0);
+
+    worker_thread::run_pinned(processors, [&](const std::size_t rank) {
+        // Select the counter for the thread: for fetch_add, the contended
+        // case uses a single counter for all threads, for false sharing,
+        // each thread uses its own counter, which shares the line with the
+        // counters of up to seven other threads.
+        auto& counter = padded
+            ? paddedCounters[rank].value
+            : (fetchAdd
+            ? packedCounters[0].values[0]
+            : packedCounters[rank / perLine].values[rank % perLine]);
+        trrojan::timer timer;
+
+        timer.start();
+        if (fetchAdd) {
+            detail::fetch_add(counter, iterations);
+        } else {
+            detail::increment(counter, iterations);
+        }
+        retval[rank] = timer.elapsed_millis();
+    });
+
+    return retval;
+}
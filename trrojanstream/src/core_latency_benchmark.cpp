@@ -0,0 +1,176 @@
+/// <copyright file="core_latency_benchmark.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#include "trrojan/stream/core_latency_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <sstream>
+
+#include "trrojan/log.h"
+#include "trrojan/system_topology.h"
+#include "trrojan/timer.h"
+
+#include "trrojan/stream/worker_thread.h"
+
+
+#define _TRROJANSTREAM_DEFINE_FACTOR(f)                                        \
+const std::string trrojan::stream::core_latency_benchmark::factor_##f(#f)
+
+_TRROJANSTREAM_DEFINE_FACTOR(iterations);
+_TRROJANSTREAM_DEFINE_FACTOR(processors);
+
+#undef _TRROJANSTREAM_DEFINE_FACTOR
+
+
+#define _TRROJANSTREAM_DEFINE_RES_NAME(r)                                      \
+const std::string trrojan::stream::core_latency_benchmark::result_name_##r(#r)
+
+_TRROJANSTREAM_DEFINE_RES_NAME(first_processor);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency);
+_TRROJANSTREAM_DEFINE_RES_NAME(relation);
+_TRROJANSTREAM_DEFINE_RES_NAME(second_processor);
+
+#undef _TRROJANSTREAM_DEFINE_RES_NAME
+
+
+/*
+ * trrojan::stream::core_latency_benchmark::core_latency_benchmark
+ */
+trrojan::stream::core_latency_benchmark::core_latency_benchmark(void)
+        : trrojan::benchmark_base("core_latency") {
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_iterations, static_cast<std::uint32_t>(10000)));
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_processors, static_cast<std::uint32_t>(0)));
+}
+
+
+/*
+ * trrojan::stream::core_latency_benchmark::~core_latency_benchmark
+ */
+trrojan::stream::core_latency_benchmark::~core_latency_benchmark(void) { }
+
+
+/*
+ * trrojan::stream::core_latency_benchmark::run
+ */
+trrojan::result trrojan::stream::core_latency_benchmark::run(
+        const configuration& config) {
+    auto& topology = system_topology::instance();
+    auto iterations = config.get<std::uint32_t>(factor_iterations);
+    auto limit = config.get<std::uint32_t>(factor_processors);
+    std::vector<std::uint32_t> processors;
+
+    for (auto& p : topology.processors()) {
+        processors.push_back(p.id);
+    }
+    if ((limit > 0) && (limit < processors.size())) {
+        processors.resize(limit);
+    }
+
+    auto retval = std::make_shared<basic_result>(config,
+        std::vector<std::string> { result_name_first_processor,
+        result_name_second_processor, result_name_relation,
+        result_name_latency });
+
+    for (std::size_t i = 0; i < processors.size(); ++i) {
+        std::stringstream row;
+
+        for (std::size_t j = i + 1; j < processors.size(); ++j) {
+            auto f = processors[i];
+            auto s = processors[j];
+            auto latency = core_latency_benchmark::measure(f, s, iterations);
+            retval->add({ f, s, core_latency_benchmark::relation(f, s),
+                latency });
+            row << " " << static_cast<std::uint64_t>(latency + 0.5);
+        }
+
+        log::instance().write_line(log_level::verbose, "Latency (ns) from "
+            "processor {0} to processors {1} and above:{2}", processors[i],
+            (i + 1 < processors.size()) ? processors[i + 1] : 0, row.str());
+    }
+
+    return std::dynamic_pointer_cast<result::element_type>(retval);
+}
+
+
+/*
+ * trrojan::stream::core_latency_benchmark::measure
+ */
+double trrojan::stream::core_latency_benchmark::measure(
+        const std::uint32_t first, const std::uint32_t second,
+        const std::uint32_t iterations) {
+    static const std::uint64_t warm_up = 1000;
+    struct alignas(worker_thread::cache_line_padding) line_type {
+        std::atomic<std::uint64_t> value;
+    } line;
+    const std::uint64_t total = warm_up + iterations;
+    timer::millis_type elapsed = 0;
+
+    line.value.store(0);
+
+    // The first thread sets the counter to odd values and the second one to
+    // even values, so each round trip moves the line there and back again.
+    worker_thread::run_pinned({ first, second }, [&](const std::size_t rank) {
+        const std::uint64_t parity = (rank == 0) ? 0 : 1;
+        trrojan::timer timer;
+
+        for (std::uint64_t i = 0; i < total; ++i) {
+            if ((rank == 0) && (i == warm_up)) {
+                timer.start();
+            }
+
+            const auto expected = 2 * i + parity;
+            while (line.value.load(std::memory_order_acquire) != expected);
+            line.value.store(expected + 1, std::memory_order_release);
+        }
+
+        if (rank == 0) {
+            while (line.value.load(std::memory_order_acquire) != 2 * total);
+            elapsed = timer.elapsed_millis();
+        }
+    });
+
+    return (iterations > 0)
+        ? elapsed * 1000000.0 / iterations / 2.0
+        : 0.0;
+}
+
+
+/*
+ * trrojan::stream::core_latency_benchmark::relation
+ */
+std::string trrojan::stream::core_latency_benchmark::relation(
+        const std::uint32_t first, const std::uint32_t second) {
+    auto& topology = system_topology::instance();
+    auto& processors = topology.processors();
+    auto f = std::find_if(processors.begin(), processors.end(),
+        [first](const system_topology::processor& p) { return p.id == first; });
+    auto s = std::find_if(processors.begin(), processors.end(),
+        [second](const system_topology::processor& p) {
+            return p.id == second;
+        });
+
+    if ((f == processors.end()) || (s == processors.end())) {
+        return "unknown";
+    }
+
+    if ((f->package == s->package) && (f->die == s->die)
+            && (f->core == s->core)) {
+        return "smt";
+    }
+
+    if (topology.shares_cache(topology.last_level_cache(), first, second)) {
+        return "shared_llc";
+    }
+
+    if (f->package == s->package) {
+        return (f->die == s->die) ? "same_die" : "cross_die";
+    }
+
+    return "cross_package";
+}
@@ -0,0 +1,429 @@
+/// <copyright file="loaded_latency_benchmark.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#include "trrojan/stream/loaded_latency_benchmark.h"
+
+#include <algorithm>
+#include <atomic>
+#include <mutex>
+#include <numeric>
+#include <random>
+#include <thread>
+#include <vector>
+
+#include "trrojan/constants.h"
+#include "trrojan/log.h"
+#include "trrojan/system_topology.h"
+#include "trrojan/timer.h"
+
+#include "trrojan/stream/worker_thread.h"
+
+
+namespace trrojan {
+namespace stream {
+namespace detail {
+
+    /// <summary>
+    /// A node of the pointer-chasing list, which occupies a whole cache line.
+    /// </summary>
+    struct alignas(64) chase_node {
+        const chase_node *next;
+    };
+
+    /// <summary>
+    /// The size of the blocks in bytes after which the traffic generators
+    /// throttle themselves.
+    /// </summary>
+    static constexpr std::size_t generator_block = 4096;
+
+    /// <summary>
+    /// The number of dependent loads forming one latency sample.
+    /// </summary>
+    static constexpr std::size_t hops_per_sample = 256;
+
+    /// <summary>
+    /// Creates a single cycle through <paramref name="cnt" /> cache lines in
+    /// random order, which defeats the hardware prefetchers.
+    /// </summary>
+    static std::vector<chase_node> make_chase_list(std::size_t cnt) {
+        if (cnt < 2) {
+            cnt = 2;
+        }
+
+        std::vector<std::size_t> order(cnt);
+        std::iota(order.begin(), order.end(), 0);
+
+        // Sattolo's algorithm yields a permutation with a single cycle.
+        std::mt19937_64 rng(cnt);
+        for (auto i = cnt - 1; i > 0; --i) {
+            std::uniform_int_distribution<std::size_t> dist(0, i - 1);
+            std::swap(order[i], order[dist(rng)]);
+        }
+
+        std::vector<chase_node> retval(cnt);
+        for (std::size_t i = 0; i < cnt; ++i) {
+            retval[order[i]].next = &retval[order[(i + 1) % cnt]];
+        }
+
+        return retval;
+    }
+
+    /// <summary>
+    /// Busy-waits until <paramref name="millis" /> milliseconds have passed
+    /// according to <see cref="trrojan::timer" />.
+    /// </summary>
+    /// <remarks>
+    /// Waiting on the timer rather than for a number of spin iterations
+    /// makes the delay independent of the clock speed of the core, which
+    /// changes with the load on the system.
+    /// </remarks>
+    static void wait(const trrojan::timer::millis_type millis) {
+        if (millis > 0.0) {
+            trrojan::timer timer;
+            timer.start();
+            while (timer.elapsed_millis() < millis);
+        }
+    }
+
+    /// <summary>
+    /// Recursion stop.
+    /// </summary>
+    template<scalar_type S>
+    static std::uint64_t run_block(task_type_list_t<>, const task_type t,
+            typename scalar_type_traits<S>::type *a,
+            typename scalar_type_traits<S>::type *b,
+            typename scalar_type_traits<S>::type *c,
+            float *f,
+            const typename scalar_type_traits<S>::type s,
+            const std::size_t cnt) {
+        return 0;
+    }
+
+    /// <summary>
+    /// Runs the task <paramref name="t" /> once on the first
+    /// <paramref name="cnt" /> elements of the given arrays using the
+    /// kernels of <see cref="trrojan::stream::worker_thread" />.
+    /// </summary>
+    /// <returns>The number of bytes read and written.</returns>
+    template<scalar_type S, task_type T, task_type... Ts>
+    static std::uint64_t run_block(task_type_list_t<T, Ts...>,
+            const task_type t,
+            typename scalar_type_traits<S>::type *a,
+            typename scalar_type_traits<S>::type *b,
+            typename scalar_type_traits<S>::type *c,
+            float *f,
+            const typename scalar_type_traits<S>::type s,
+            const std::size_t cnt) {
+        typedef typename scalar_type_traits<S>::type scalar_type;
+
+        if (T == t) {
+            worker_thread::run_kernel<S, T>(a, b, c, f, s, cnt);
+
+            if constexpr ((T == task_type::pack) || (T == task_type::unpack)) {
+                // The conversions access a 32-bit float instead of a second
+                // scalar.
+                return cnt * (sizeof(scalar_type) + sizeof(float));
+            } else {
+                return cnt * task_type_traits<T>::memory_accesses
+                    * sizeof(scalar_type);
+            }
+
+        } else {
+            return run_block<S>(task_type_list_t<Ts...>(), t, a, b, c, f, s,
+                cnt);
+        }
+    }
+
+    /// <summary>
+    /// Allocates private arrays of <paramref name="cnt" /> elements and
+    /// runs <paramref name="task" /> on them in blocks, waiting for
+    /// <paramref name="delay" /> milliseconds after each block, until
+    /// <paramref name="stop" /> is set.
+    /// </summary>
+    /// <remarks>
+    /// The arrays are allocated and initialised by the calling thread such
+    /// that they are local to it on NUMA systems. <paramref name="ready" />
+    /// is invoked once this is done and before the traffic starts.
+    /// </remarks>
+    /// <returns>The bandwidth achieved in MB/s.</returns>
+    template<scalar_type S, class F>
+    static double generate(const task_type task, const std::size_t cnt,
+            const trrojan::timer::millis_type delay,
+            const std::atomic<bool>& stop, F&& ready) {
+        typedef trrojan::constants<double> constants;
+        typedef typename scalar_type_traits<S>::type scalar_type;
+
+        const auto block = (std::max)(static_cast<std::size_t>(1),
+            generator_block / sizeof(scalar_type));
+        const auto s = static_cast<scalar_type>(42);
+        std::vector<scalar_type> a(cnt, static_cast<scalar_type>(1));
+        std::vector<scalar_type> b(cnt, static_cast<scalar_type>(2));
+        std::vector<scalar_type> c(cnt, static_cast<scalar_type>(0));
+        std::vector<float> f(((task == task_type::pack)
+            || (task == task_type::unpack)) ? cnt : 0, 3.0f);
+        auto fp = f.empty() ? nullptr : f.data();
+        std::uint64_t bytes = 0;
+        trrojan::timer timer;
+
+        ready();
+
+        timer.start();
+        while (!stop.load(std::memory_order_relaxed)) {
+            for (std::size_t o = 0; o < cnt; o += block) {
+                const auto e = (std::min)(o + block, cnt);
+                bytes += run_block<S>(task_type_list(), task, a.data() + o,
+                    b.data() + o, c.data() + o, (fp != nullptr) ? fp + o
+                    : nullptr, s, e - o);
+                wait(delay);
+
+                if (stop.load(std::memory_order_relaxed)) {
+                    break;
+                }
+            }
+        }
+
+        auto dt = timer.elapsed_millis() / constants::millis_per_second;
+        return (dt > 0.0) ? bytes / constants::bytes_per_megabyte / dt : 0.0;
+    }
+
+    /// <summary>
+    /// Recursion stop.
+    /// </summary>
+    template<class F>
+    static double generate(scalar_type_list_t<>, const scalar_type s,
+            const task_type task, const std::size_t cnt,
+            const trrojan::timer::millis_type delay,
+            const std::atomic<bool>& stop, F&& ready) {
+        ready();
+        return 0.0;
+    }
+
+    /// <summary>
+    /// Invokes <see cref="generate" /> for the scalar type
+    /// <paramref name="s" />.
+    /// </summary>
+    template<scalar_type S, scalar_type... Ss, class F>
+    static double generate(scalar_type_list_t<S, Ss...>,
+            const scalar_type s, const task_type task, const std::size_t cnt,
+            const trrojan::timer::millis_type delay,
+            const std::atomic<bool>& stop, F&& ready) {
+        if (S == s) {
+            return generate<S>(task, cnt, delay, stop, ready);
+        } else {
+            return generate(scalar_type_list_t<Ss...>(), s, task, cnt, delay,
+                stop, ready);
+        }
+    }
+
+} /* end namespace detail */
+} /* end namespace stream */
+} /* end namespace trrojan */
+
+
+#define _TRROJANSTREAM_DEFINE_FACTOR(f)                                        \
+const std::string trrojan::stream::loaded_latency_benchmark::factor_##f(#f)
+
+_TRROJANSTREAM_DEFINE_FACTOR(chase_size);
+_TRROJANSTREAM_DEFINE_FACTOR(injection_delay);
+_TRROJANSTREAM_DEFINE_FACTOR(latency_threads);
+_TRROJANSTREAM_DEFINE_FACTOR(problem_size);
+_TRROJANSTREAM_DEFINE_FACTOR(samples);
+_TRROJANSTREAM_DEFINE_FACTOR(scalar_type);
+_TRROJANSTREAM_DEFINE_FACTOR(task_type);
+_TRROJANSTREAM_DEFINE_FACTOR(threads);
+
+#undef _TRROJANSTREAM_DEFINE_FACTOR
+
+
+#define _TRROJANSTREAM_DEFINE_RES_NAME(r)                                      \
+const std::string trrojan::stream::loaded_latency_benchmark::result_name_##r(#r)
+
+_TRROJANSTREAM_DEFINE_RES_NAME(bandwidth);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency_average);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency_maximum);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency_minimum);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency_p50);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency_p90);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency_p99);
+_TRROJANSTREAM_DEFINE_RES_NAME(latency_p999);
+
+#undef _TRROJANSTREAM_DEFINE_RES_NAME
+
+
+/*
+ * trrojan::stream::loaded_latency_benchmark::loaded_latency_benchmark
+ */
+trrojan::stream::loaded_latency_benchmark::loaded_latency_benchmark(void)
+        : trrojan::benchmark_base("loaded_latency") {
+    auto& topology = system_topology::instance();
+
+    // Make the chased list large enough to miss all caches.
+    {
+        const std::uint64_t minimum = 64 * 1024 * 1024;
+        auto llc = topology.cache_size(topology.last_level_cache());
+        this->_default_configs.add_factor(factor::from_manifestations(
+            factor_chase_size, (std::max)(8 * llc, minimum)));
+    }
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_injection_delay, std::vector<std::uint32_t> { 0, 50, 100, 200,
+        500, 1000, 2000, 5000, 10000, 20000 }));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_latency_threads, static_cast<std::uint32_t>(1)));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_problem_size, static_cast<std::uint64_t>(2000000)));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_samples, static_cast<std::uint32_t>(10000)));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_scalar_type, scalar_type_traits<scalar_type::float64>::name()));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_task_type, task_type_traits<task_type::triad>::name()));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_threads, topology.physical_cores()));
+}
+
+
+/*
+ * trrojan::stream::loaded_latency_benchmark::~loaded_latency_benchmark
+ */
+trrojan::stream::loaded_latency_benchmark::~loaded_latency_benchmark(void) { }
+
+
+/*
+ * trrojan::stream::loaded_latency_benchmark::run
+ */
+trrojan::result trrojan::stream::loaded_latency_benchmark::run(
+        const configuration& config) {
+    auto chaseSize = config.get<std::uint64_t>(factor_chase_size);
+    // The delay is configured in nanoseconds.
+    auto delay = config.get<std::uint32_t>(factor_injection_delay)
+        / 1000000.0;
+    auto latencyThreads = config.get<std::uint32_t>(factor_latency_threads);
+    auto problemSize = config.get<std::uint64_t>(factor_problem_size);
+    auto samples = config.get<std::uint32_t>(factor_samples);
+    auto scalar = parse_scalar_type(*config.find(factor_scalar_type));
+    auto task = parse_task_type(*config.find(factor_task_type));
+    auto threads = config.get<std::uint32_t>(factor_threads);
+
+    if (latencyThreads < 1) {
+        latencyThreads = 1;
+    }
+    if (threads < latencyThreads) {
+        log::instance().write_line(log_level::warning, "The loaded latency "
+            "benchmark requires at least as many threads as latency ranks, "
+            "wherefore {0} threads are used instead of {1}.", latencyThreads,
+            threads);
+        threads = latencyThreads;
+    }
+    if (samples < 1) {
+        samples = 1;
+    }
+
+    std::vector<std::uint32_t> processors;
+    {
+        auto placement = system_topology::instance().placement();
+        for (std::uint32_t i = 0; i < threads; ++i) {
+            processors.push_back(placement[i % placement.size()]);
+        }
+    }
+
+    std::vector<double> latencies;
+    std::mutex latenciesLock;
+    std::atomic<std::uint32_t> finished(0);
+    std::atomic<std::uint32_t> prepared(0);
+    std::atomic<bool> stop(false);
+    std::vector<double> rates(threads, 0.0);
+
+    latencies.reserve(static_cast<std::size_t>(samples) * latencyThreads);
+
+    worker_thread::run_pinned(processors, [&](const std::size_t rank) {
+        if (rank < latencyThreads) {
+            // Latency rank: build a private list and chase it.
+            auto list = detail::make_chase_list(static_cast<std::size_t>(
+                chaseSize / sizeof(detail::chase_node)));
+            const detail::chase_node *p = list.data();
+            std::vector<double> local(samples);
+            const auto warmUp = samples / 10;
+            trrojan::timer timer;
+
+            ++prepared;
+            while (prepared.load() < threads) {
+                std::this_thread::yield();
+            }
+
+            for (std::uint32_t s = 0; s < warmUp + samples; ++s) {
+                timer.start();
+                for (std::size_t h = 0; h < detail::hops_per_sample; ++h) {
+                    p = p->next;
+                }
+                auto dt = timer.elapsed_millis();
+                if (s >= warmUp) {
+                    local[s - warmUp] = dt * 1000000.0
+                        / detail::hops_per_sample;
+                }
+            }
+
+            // Make sure that the compiler cannot remove the chase.
+            if (p == nullptr) {
+                log::instance().write_line(log_level::debug, "The pointer "
+                    "chase ended unexpectedly.");
+            }
+
+            {
+                std::lock_guard<std::mutex> l(latenciesLock);
+                latencies.insert(latencies.end(), local.begin(), local.end());
+            }
+
+            if (++finished == latencyThreads) {
+                stop.store(true);
+            }
+
+        } else {
+            // Traffic generator: build private arrays and stream them until
+            // all latency ranks are done.
+            rates[rank] = detail::generate(scalar_type_list(), scalar, task,
+                static_cast<std::size_t>(problemSize), delay, stop,
+                [&](void) {
+                    ++prepared;
+                    while (prepared.load() < threads) {
+                        std::this_thread::yield();
+                    }
+                });
+        }
+    });
+
+    std::sort(latencies.begin(), latencies.end());
+    auto percentile = [&latencies](const double q) {
+        auto i = static_cast<std::size_t>(q * (latencies.size() - 1) + 0.5);
+        return latencies[i];
+    };
+
+    auto retval = std::make_shared<basic_result>(config,
+        std::vector<std::string> { result_name_bandwidth,
+        result_name_latency_minimum, result_name_latency_average,
+        result_name_latency_p50, result_name_latency_p90,
+        result_name_latency_p99, result_name_latency_p999,
+        result_name_latency_maximum });
+    retval->add({
+        std::accumulate(rates.begin(), rates.end(), 0.0),
+        latencies.front(),
+        std::accumulate(latencies.begin(), latencies.end(), 0.0)
+            / latencies.size(),
+        percentile(0.5),
+        percentile(0.9),
+        percentile(0.99),
+        percentile(0.999),
+        latencies.back()
+    });
+
+    return std::dynamic_pointer_cast<result::element_type>(retval);
+}
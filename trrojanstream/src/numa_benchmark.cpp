@@ -0,0 +1,329 @@
+/// <copyright file="numa_benchmark.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#include "trrojan/stream/numa_benchmark.h"
+
+#include <algorithm>
+#include <cassert>
+#include <climits>
+#include <stdexcept>
+#include <limits>
+#include <set>
+
+#if defined(__linux__)
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif /* defined(__linux__) */
+
+#include "trrojan/log.h"
+#include "trrojan/system_topology.h"
+
+#include "trrojan/stream/worker_thread.h"
+
+
+namespace trrojan {
+namespace stream {
+namespace detail {
+
+    /// <summary>
+    /// The memory policy binding allocations to a set of nodes
+    /// (<c>MPOL_BIND</c> in <c>numaif.h</c>).
+    /// </summary>
+    static constexpr int memory_policy_bind = 2;
+
+    /// <summary>
+    /// The memory policy interleaving allocations across a set of nodes
+    /// (<c>MPOL_INTERLEAVE</c> in <c>numaif.h</c>).
+    /// </summary>
+    static constexpr int memory_policy_interleave = 3;
+
+    /// <summary>
+    /// Sets the NUMA memory policy of the calling thread.
+    /// </summary>
+    /// <remarks>
+    /// The system call is used directly in order not to depend on libnuma.
+    /// </remarks>
+    /// <returns><c>true</c> if the policy was set, <c>false</c> if this is
+    /// not supported.</returns>
+    static bool set_memory_policy(const int mode,
+            const std::vector<std::uint32_t>& nodes) {
+#if defined(__linux__) && defined(SYS_set_mempolicy)
+        static constexpr auto bits = sizeof(unsigned long) * CHAR_BIT;
+        auto last = *std::max_element(nodes.begin(), nodes.end());
+        std::vector<unsigned long> mask(last / bits + 1, 0);
+
+        for (auto n : nodes) {
+            mask[n / bits] |= 1ul << (n % bits);
+        }
+
+        return (::syscall(SYS_set_mempolicy, mode, mask.data(),
+            mask.size() * bits + 1) == 0);
+#else /* defined(__linux__) && defined(SYS_set_mempolicy) */
+        return false;
+#endif /* defined(__linux__) && defined(SYS_set_mempolicy) */
+    }
+
+} /* end namespace detail */
+} /* end namespace stream */
+} /* end namespace trrojan */
+
+
+#define _TRROJANSTREAM_DEFINE_FACTOR(f)                                        \
+const std::string trrojan::stream::numa_benchmark::factor_##f(#f)
+
+_TRROJANSTREAM_DEFINE_FACTOR(iterations);
+_TRROJANSTREAM_DEFINE_FACTOR(problem_size);
+_TRROJANSTREAM_DEFINE_FACTOR(scalar_type);
+_TRROJANSTREAM_DEFINE_FACTOR(task_type);
+_TRROJANSTREAM_DEFINE_FACTOR(threads);
+
+#undef _TRROJANSTREAM_DEFINE_FACTOR
+
+
+#define _TRROJANSTREAM_DEFINE_RES_NAME(r)                                      \
+const std::string trrojan::stream::numa_benchmark::result_name_##r(#r)
+
+_TRROJANSTREAM_DEFINE_RES_NAME(cpu_node);
+_TRROJANSTREAM_DEFINE_RES_NAME(distance);
+_TRROJANSTREAM_DEFINE_RES_NAME(memory_node);
+_TRROJANSTREAM_DEFINE_RES_NAME(memory_policy);
+_TRROJANSTREAM_DEFINE_RES_NAME(rate_average);
+_TRROJANSTREAM_DEFINE_RES_NAME(rate_maximum);
+_TRROJANSTREAM_DEFINE_RES_NAME(rate_relative);
+_TRROJANSTREAM_DEFINE_RES_NAME(threads);
+
+#undef _TRROJANSTREAM_DEFINE_RES_NAME
+
+
+/*
+ * trrojan::stream::numa_benchmark::numa_benchmark
+ */
+trrojan::stream::numa_benchmark::numa_benchmark(void)
+        : trrojan::benchmark_base("numa"), policy_warned(false) {
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_iterations, static_cast<std::uint64_t>(
+        problem::default_iterations)));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_problem_size, static_cast<std::uint64_t>(
+        problem::default_problem_size)));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_scalar_type, scalar_type_traits<scalar_type::float64>::name()));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_task_type, { task_type_traits<task_type::add>::name(),
+        task_type_traits<task_type::copy>::name(),
+        task_type_traits<task_type::fill>::name(),
+        task_type_traits<task_type::fill_nt>::name(),
+        task_type_traits<task_type::mix>::name(),
+        task_type_traits<task_type::scale>::name(),
+        task_type_traits<task_type::sum>::name(),
+        task_type_traits<task_type::triad>::name() }));
+
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_threads, static_cast<std::uint32_t>(0)));
+}
+
+
+/*
+ * trrojan::stream::numa_benchmark::~numa_benchmark
+ */
+trrojan::stream::numa_benchmark::~numa_benchmark(void) { }
+
+
+/*
+ * trrojan::stream::numa_benchmark::run
+ */
+trrojan::result trrojan::stream::numa_benchmark::run(
+        const configuration& config) {
+    static const std::string bind("bind");
+    static const std::string interleave("interleave");
+    auto& topology = system_topology::instance();
+    auto threads = config.get<std::uint32_t>(factor_threads);
+    const auto placement = topology.placement();
+    std::vector<std::uint32_t> allNodes;
+
+    {
+        auto size = config.get<std::uint64_t>(factor_problem_size);
+        auto sizes = worker_thread::problem_sizes::to_vector();
+        if (std::find(sizes.begin(), sizes.end(), size) == sizes.end()) {
+            throw std::invalid_argument("The requested problem size is not "
+                "one of the sizes the worker threads have been compiled for.");
+        }
+    }
+
+    for (auto& n : topology.nodes()) {
+        allNodes.push_back(n.id);
+    }
+
+    auto retval = std::make_shared<basic_result>(config,
+        std::vector<std::string> { result_name_cpu_node,
+        result_name_memory_policy, result_name_memory_node,
+        result_name_distance, result_name_threads,
+        result_name_rate_average, result_name_rate_maximum,
+        result_name_rate_relative });
+
+    for (auto& cpuNode : topology.nodes()) {
+        // Place the threads on the processors of the node in the same order
+        // as the stream benchmark places them on the whole machine.
+        std::vector<std::uint32_t> processors;
+        {
+            std::set<std::uint32_t> local(cpuNode.processors.begin(),
+                cpuNode.processors.end());
+            std::set<std::uint32_t> cores;
+
+            for (auto p : placement) {
+                if (local.count(p) > 0) {
+                    processors.push_back(p);
+                }
+            }
+
+            for (auto& p : topology.processors()) {
+                if (local.count(p.id) > 0) {
+                    cores.insert(p.siblings.empty()
+                        ? p.id
+                        : p.siblings.front());
+                }
+            }
+
+            // Oversubscribe the node if requested by the user.
+            const auto available = processors.size();
+            const auto cnt = (threads > 0)
+                ? static_cast<std::size_t>(threads)
+                : cores.size();
+            for (auto i = available; (available > 0) && (i < cnt); ++i) {
+                processors.push_back(processors[i % available]);
+            }
+            processors.resize((std::min)(cnt, processors.size()));
+        }
+
+        if (processors.empty()) {
+            log::instance().write_line(log_level::verbose, "NUMA node {0} has "
+                "no processors and is only tested as memory node.",
+                cpuNode.id);
+            continue;
+        }
+
+        this->pool.resize(processors);
+
+        // Measure the baseline with the memory being interleaved across all
+        // nodes first such that all other rates can be related to it.
+        // As the memory is on all nodes, the memory node is left empty.
+        auto baseline = this->measure(this->allocate(config,
+            processors.size(), allNodes));
+        retval->add({ cpuNode.id, interleave, trrojan::variant(),
+            std::numeric_limits<double>::quiet_NaN(),
+            static_cast<std::uint32_t>(processors.size()), baseline.first,
+            baseline.second, 1.0 });
+
+        // The distances are ordered like the nodes, which are not necessarily
+        // numbered contiguously, wherefore they must be addressed by the
+        // position of the memory node rather than by its ID.
+        const auto& memNodes = topology.nodes();
+        for (std::size_t i = 0; i < memNodes.size(); ++i) {
+            auto& memNode = memNodes[i];
+            auto rate = this->measure(this->allocate(config,
+                processors.size(), { memNode.id }));
+            auto distance = (i < cpuNode.distances.size())
+                ? static_cast<double>(cpuNode.distances[i])
+                : std::numeric_limits<double>::quiet_NaN();
+            retval->add({ cpuNode.id, bind, memNode.id, distance,
+                static_cast<std::uint32_t>(processors.size()), rate.first,
+                rate.second, rate.second / baseline.second });
+
+            log::instance().write_line(log_level::verbose, "Bandwidth from "
+                "NUMA node {0} to node {1}: {2} MB/s ({3} of the interleaved "
+                "baseline).", cpuNode.id, memNode.id, rate.second,
+                rate.second / baseline.second);
+        }
+    }
+
+    return std::dynamic_pointer_cast<result::element_type>(retval);
+}
+
+
+/*
+ * trrojan::stream::numa_benchmark::allocate
+ */
+trrojan::stream::problem::pointer_type
+trrojan::stream::numa_benchmark::allocate(const configuration& config,
+        const std::size_t parallelism,
+        const std::vector<std::uint32_t>& nodes) {
+    assert(!nodes.empty());
+    auto& topology = system_topology::instance();
+    auto iterations = config.get<std::uint64_t>(factor_iterations);
+    auto scalar = parse_scalar_type(*config.find(factor_scalar_type));
+    auto size = config.get<std::uint64_t>(factor_problem_size);
+    auto task = parse_task_type(*config.find(factor_task_type));
+    problem::pointer_type retval;
+
+    // Allocate on a processor of the memory node, if it has any, such that
+    // first touch places the pages correctly if we cannot set the policy.
+    auto processor = topology.placement().front();
+    if (nodes.size() == 1) {
+        for (auto& n : topology.nodes()) {
+            if ((n.id == nodes.front()) && !n.processors.empty()) {
+                processor = n.processors.front();
+            }
+        }
+    }
+
+    worker_thread::run_pinned({ processor }, [&](const std::size_t) {
+        auto policy = (nodes.size() > 1)
+            ? detail::memory_policy_interleave
+            : detail::memory_policy_bind;
+        if (!detail::set_memory_policy(policy, nodes)
+                && !this->policy_warned) {
+            // The policy fails for all allocations alike, so it is sufficient
+            // to warn once.
+            log::instance().write_line(log_level::warning, "The memory policy "
+                "could not be set, wherefore the problems are placed on the "
+                "NUMA node of the allocating thread by first touch.");
+            this->policy_warned = true;
+        }
+
+        // The policy only affects the allocating thread, which exits right
+        // after the problem has been created.
+        retval = std::make_shared<problem>(scalar, 42, task,
+            access_pattern::contiguous, size, iterations, parallelism);
+    });
+
+    return retval;
+}
+
+
+/*
+ * trrojan::stream::numa_benchmark::measure
+ */
+std::pair<double, double> trrojan::stream::numa_benchmark::measure(
+        problem::pointer_type problem) {
+    std::vector<worker_thread::results_type> results;
+    std::pair<double, double> retval(0.0, 0.0);
+
+    this->pool.run(problem);
+
+    for (auto it = this->pool.begin(); it != this->pool.end(); ++it) {
+        results.emplace_back();
+        (**it).copy_results(std::back_inserter(results.back()));
+    }
+
+    // The rate of an iteration is determined by the slowest thread.
+    const auto cnt = results.front().size();
+    for (std::size_t i = 0; i < cnt; ++i) {
+        timer::millis_type slowest = 0;
+        for (auto& r : results) {
+            slowest = (std::max)(slowest, r[i].time);
+        }
+
+        auto rate = problem->calc_total_mb_per_s(slowest,
+            results.front()[i].memory_accesses);
+        retval.first += rate / cnt;
+        retval.second = (std::max)(retval.second, rate);
+    }
+
+    return retval;
+}
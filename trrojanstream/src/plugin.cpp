@@ -6,13 +6,25 @@
 
 #include "trrojan/stream/plugin.h"
 
+#include "trrojan/stream/contention_benchmark.h"
+#include "trrojan/stream/core_latency_benchmark.h"
+#include "trrojan/stream/loaded_latency_benchmark.h"
+#include "trrojan/stream/numa_benchmark.h"
 #include "trrojan/stream/stream_benchmark.h"
 
 
 /// <summary>
 /// Gets a new instance of the plugin descriptor.
 /// </summary>
+/// <remarks>
+/// If the plugin is linked statically, the entry point is named after the
+/// plugin such that it does not clash with the ones of other plugins.
+/// </remarks>
+#if defined(TRROJANSTREAM_STATIC)
+extern "C" trrojan::plugin_base *get_trrojanstream_plugin(void) {
+#else /* defined(TRROJANSTREAM_STATIC) */
 extern "C" TRROJANSTREAM_API trrojan::plugin_base *get_trrojan_plugin(void) {
+#endif /* defined(TRROJANSTREAM_STATIC) */
     return new trrojan::stream::plugin();
 }
 
@@ -28,7 +40,11 @@ trrojan::stream::plugin::~plugin(void) { }
  */
 size_t trrojan::stream::plugin::create_benchmarks(benchmark_list& dst) const {
     dst.push_back(std::make_shared<stream_benchmark>());
-    return 1;
+    dst.push_back(std::make_shared<core_latency_benchmark>());
+    dst.push_back(std::make_shared<contention_benchmark>());
+    dst.push_back(std::make_shared<loaded_latency_benchmark>());
+    dst.push_back(std::make_shared<numa_benchmark>());
+    return 5;
 }
 
 
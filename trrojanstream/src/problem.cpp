@@ -16,15 +16,49 @@ trrojan::stream::problem::problem(const scalar_type_t scalar,
         const access_pattern_t pattern,
         const size_t size,
         const size_t iterations,
-        const size_t parallelism)
+        const size_t parallelism,
+        const size_t mix_reads,
+        const size_t mix_writes,
+        const access_pattern_parameters& pattern_parameters,
+        const bool verify,
+        problem *recycled)
         : _access_pattern(pattern),
         _iterations(iterations),
+        _mix_reads(mix_reads),
+        _mix_writes(mix_writes),
         _parallelism(parallelism),
+        _pattern_parameters(pattern_parameters),
         _scalar_size(0),
         _scalar_type(scalar),
         _scalar_value(value),
-        _task_type(task) {
+        _task_type(task),
+        _verify(verify) {
+    // A mix that neither reads nor writes is meaningless, so fall back to
+    // alternating between reads and writes.
+    if ((this->_mix_reads == 0) && (this->_mix_writes == 0)) {
+        this->_mix_reads = this->_mix_writes = 1;
+    }
+
+    if ((recycled != nullptr) && (recycled != this)) {
+        this->_a = std::move(recycled->_a);
+        this->_b = std::move(recycled->_b);
+        this->_c = std::move(recycled->_c);
+        this->_f = std::move(recycled->_f);
+        recycled->_a.clear();
+        recycled->_b.clear();
+        recycled->_c.clear();
+        recycled->_f.clear();
+    }
+
     switch (this->_scalar_type) {
+        case trrojan::stream::scalar_type::bfloat16:
+            this->allocate<trrojan::stream::scalar_type::bfloat16>(size);
+            break;
+
+        case trrojan::stream::scalar_type::float16:
+            this->allocate<trrojan::stream::scalar_type::float16>(size);
+            break;
+
         case trrojan::stream::scalar_type::float32:
             this->allocate<trrojan::stream::scalar_type::float32>(size);
             break;
@@ -33,6 +67,10 @@ trrojan::stream::problem::problem(const scalar_type_t scalar,
             this->allocate<trrojan::stream::scalar_type::float64>(size);
             break;
 
+        case trrojan::stream::scalar_type::int8:
+            this->allocate<trrojan::stream::scalar_type::int8>(size);
+            break;
+
         case trrojan::stream::scalar_type::int32:
             this->allocate<trrojan::stream::scalar_type::int32>(size);
             break;
@@ -40,5 +78,36 @@ trrojan::stream::problem::problem(const scalar_type_t scalar,
         case trrojan::stream::scalar_type::int64:
             this->allocate<trrojan::stream::scalar_type::int64>(size);
             break;
+
+        case trrojan::stream::scalar_type::uint8:
+            this->allocate<trrojan::stream::scalar_type::uint8>(size);
+            break;
+    }
+}
+
+
+/*
+ * trrojan::stream::problem::working_set_in_bytes
+ */
+size_t trrojan::stream::problem::working_set_in_bytes(void) const {
+    switch (this->_task_type) {
+        case task_type_t::fill:
+        case task_type_t::fill_nt:
+        case task_type_t::sum:
+            return this->total_size_in_bytes();
+
+        case task_type_t::copy:
+        case task_type_t::mix:
+        case task_type_t::scale:
+            return 2 * this->total_size_in_bytes();
+
+        case task_type_t::pack:
+        case task_type_t::unpack:
+            // The conversions use one array of 32-bit floats.
+            return this->total_size_in_bytes()
+                + this->total_size() * sizeof(float);
+
+        default:
+            return 3 * this->total_size_in_bytes();
     }
 }
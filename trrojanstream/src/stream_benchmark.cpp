@@ -6,24 +6,40 @@
 
 #include "trrojan/stream/stream_benchmark.h"
 
+#include <algorithm>
 #include <cinttypes>
+#include <iomanip>
+#include <sstream>
 
 #include "trrojan/factor_enum.h"
 #include "trrojan/factor_range.h"
+#include "trrojan/journal.h"
 #include "trrojan/system_factors.h"
+#include "trrojan/system_topology.h"
 #include "trrojan/timer.h"
 
+#include "trrojan/stream/timeline.h"
+
 
 #define _TRROJANSTREAM_DEFINE_FACTOR(f)                                        \
 const std::string trrojan::stream::stream_benchmark::factor_##f(#f)
 
 _TRROJANSTREAM_DEFINE_FACTOR(access_pattern);
+_TRROJANSTREAM_DEFINE_FACTOR(block_size);
 _TRROJANSTREAM_DEFINE_FACTOR(iterations);
+_TRROJANSTREAM_DEFINE_FACTOR(mix_reads);
+_TRROJANSTREAM_DEFINE_FACTOR(mix_writes);
 _TRROJANSTREAM_DEFINE_FACTOR(problem_size);
+_TRROJANSTREAM_DEFINE_FACTOR(row_length);
 _TRROJANSTREAM_DEFINE_FACTOR(scalar);
 _TRROJANSTREAM_DEFINE_FACTOR(scalar_type);
+_TRROJANSTREAM_DEFINE_FACTOR(stride);
 _TRROJANSTREAM_DEFINE_FACTOR(task_type);
 _TRROJANSTREAM_DEFINE_FACTOR(threads);
+_TRROJANSTREAM_DEFINE_FACTOR(timeline);
+_TRROJANSTREAM_DEFINE_FACTOR(tile_height);
+_TRROJANSTREAM_DEFINE_FACTOR(tile_width);
+_TRROJANSTREAM_DEFINE_FACTOR(verify);
 
 #undef _TRROJANSTREAM_DEFINE_FACTOR
 
@@ -31,17 +47,29 @@ _TRROJANSTREAM_DEFINE_FACTOR(threads);
 #define _TRROJANSTREAM_DEFINE_RES_NAME(r)                                      \
 const std::string trrojan::stream::stream_benchmark::result_name_##r(#r)
 
+_TRROJANSTREAM_DEFINE_RES_NAME(bytes_per_joule);
+_TRROJANSTREAM_DEFINE_RES_NAME(energy);
+_TRROJANSTREAM_DEFINE_RES_NAME(item_rate_aggregated);
+_TRROJANSTREAM_DEFINE_RES_NAME(item_rate_total);
+_TRROJANSTREAM_DEFINE_RES_NAME(power_uid);
+_TRROJANSTREAM_DEFINE_RES_NAME(rate_add);
 _TRROJANSTREAM_DEFINE_RES_NAME(rate_aggregated);
 _TRROJANSTREAM_DEFINE_RES_NAME(rate_average);
 _TRROJANSTREAM_DEFINE_RES_NAME(rate_maximum);
+_TRROJANSTREAM_DEFINE_RES_NAME(rate_copy);
 _TRROJANSTREAM_DEFINE_RES_NAME(rate_minimum);
+_TRROJANSTREAM_DEFINE_RES_NAME(rate_scale);
 _TRROJANSTREAM_DEFINE_RES_NAME(rate_total);
+_TRROJANSTREAM_DEFINE_RES_NAME(rate_triad);
 _TRROJANSTREAM_DEFINE_RES_NAME(range_start);
 _TRROJANSTREAM_DEFINE_RES_NAME(range_total);
 _TRROJANSTREAM_DEFINE_RES_NAME(time_average);
 _TRROJANSTREAM_DEFINE_RES_NAME(time_maximum);
 _TRROJANSTREAM_DEFINE_RES_NAME(time_minimum);
 _TRROJANSTREAM_DEFINE_RES_NAME(time_slowest);
+_TRROJANSTREAM_DEFINE_RES_NAME(time_startup);
+_TRROJANSTREAM_DEFINE_RES_NAME(time_teardown);
+_TRROJANSTREAM_DEFINE_RES_NAME(verified);
 
 #undef _TRROJANSTREAM_DEFINE_RES_NAME
 
@@ -64,15 +92,27 @@ trrojan::stream::stream_benchmark::stream_benchmark(void)
         factor_access_pattern, { ap_traits<access_pattern::contiguous>::name(),
         ap_traits<access_pattern::interleaved>::name() }));
 
+    // The parameters of the runtime-parameterised access patterns have no
+    // default factors, because they only affect some of the patterns and would
+    // otherwise be reported for all of them. If they are not configured,
+    // to_problem uses the defaults of access_pattern_parameters.
+
     // If no number of iterations is specified, use a magic number.
     this->_default_configs.add_factor(factor::from_manifestations(
         factor_iterations, 10));
 
-    // If no number of threads is specifed, use all possible values up
-    // to the number of logical processors in the system.
-    auto lc = system_factors::instance().logical_cores().as<uint32_t>();
-    this->_default_configs.add_factor(factor::from_manifestations(
-        factor_threads, { 1u, lc }));
+    // If no number of threads is specifed, use a single thread, all physical
+    // cores and all logical processors in the system.
+    {
+        auto& topology = system_topology::instance();
+        std::vector<std::uint32_t> threads { 1u, topology.physical_cores(),
+            topology.logical_cores() };
+        std::sort(threads.begin(), threads.end());
+        threads.erase(std::unique(threads.begin(), threads.end()),
+            threads.end());
+        this->_default_configs.add_factor(factor::from_manifestations(
+            factor_threads, threads));
+    }
 
     // If no problem size is given, test all all of them.
     this->_default_configs.add_factor(factor::from_manifestations(
@@ -84,8 +124,29 @@ trrojan::stream::stream_benchmark::stream_benchmark(void)
     this->_default_configs.add_factor(factor::from_manifestations(
         factor_task_type, { task_type_traits<task_type::add>::name(),
         task_type_traits<task_type::copy>::name(),
+        task_type_traits<task_type::fill>::name(),
+        task_type_traits<task_type::fill_nt>::name(),
+        task_type_traits<task_type::mix>::name(),
         task_type_traits<task_type::scale>::name(),
+        task_type_traits<task_type::sum>::name(),
+        task_type_traits<task_type::suite>::name(),
         task_type_traits<task_type::triad>::name() }));
+
+    // If no read/write ratio is specified for the mixed task, read two blocks
+    // for each block written.
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_mix_reads, static_cast<std::uint32_t>(
+        problem::default_mix_reads)));
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_mix_writes, static_cast<std::uint32_t>(
+        problem::default_mix_writes)));
+
+    // Do not spend time on checking the results unless requested.
+    this->_default_configs.add_factor(factor::from_manifestations(
+        factor_verify, false));
+
+    // The timeline has no default factor, because it is only exported if the
+    // user configures a prefix for the files.
 }
 
 
@@ -119,7 +180,6 @@ size_t trrojan::stream::stream_benchmark::run(const configuration_set& configs,
         //std::cout << std::endl;
         //retval.push_back(this->run(c));
         //return true;
-        // TODO: optimise reallocs.
         cde.check();
         try {
             this->log_run(c);
@@ -140,11 +200,89 @@ size_t trrojan::stream::stream_benchmark::run(const configuration_set& configs,
  */
 trrojan::result trrojan::stream::stream_benchmark::run(
         const configuration& config) {
-    auto problem = stream_benchmark::to_problem(config);
-    auto threads = worker_thread::create(problem);
-    worker_thread::join(threads.begin(), threads.end());
-    return stream_benchmark::collect_results(config, problem, threads.begin(),
-        threads.end());
+    auto powerCollector = benchmark_base::initialise_power_collector(config);
+    auto problem = stream_benchmark::to_problem(config,
+        this->last_problem.get());
+    this->last_problem = problem;
+    this->check_working_set(*problem);
+
+    // Adjust the number of persistent threads before entering the power
+    // scope such that starting and stopping threads is not measured.
+    this->pool.resize(problem->parallelism());
+
+    power_scope powerScope(powerCollector);
+    const auto powerUid = powerScope.uid();
+    this->pool.run(problem);
+    const auto energy = powerScope.leave();
+
+    // The verification, if any, runs after the power scope has been left.
+    this->pool.wait();
+
+    this->export_timeline(config, *problem);
+
+    return stream_benchmark::collect_results(config, problem, powerUid,
+        energy, this->pool.startup_time(), this->pool.teardown_time(),
+        this->pool.begin(), this->pool.end());
+}
+
+
+/*
+ * trrojan::stream::stream_benchmark::check_working_set
+ */
+void trrojan::stream::stream_benchmark::check_working_set(
+        const problem& problem) {
+    // As in McCalpin's STREAM, the arrays must be at least four times the
+    // size of the last-level cache in order to measure the memory rather than
+    // the cache bandwidth.
+    auto& topology = system_topology::instance();
+    auto llc = topology.total_cache_size(topology.last_level_cache());
+    auto workingSet = problem.working_set_in_bytes();
+
+    if ((workingSet < 4 * llc)
+            && this->small_working_sets.insert(workingSet).second) {
+        log::instance().write_line(log_level::warning, "The working set of "
+            "{0} bytes is less than four times the size of the last-level "
+            "cache ({1} bytes), wherefore the results are affected by the "
+            "cache.", workingSet, llc);
+    }
+}
+
+
+/*
+ * trrojan::stream::stream_benchmark::export_timeline
+ */
+void trrojan::stream::stream_benchmark::export_timeline(
+        const configuration& config, const problem& problem) {
+    auto prefix = config.get(factor_timeline, std::string());
+    if (prefix.empty()) {
+        return;
+    }
+
+    auto name = config.find(factor_task_type)->value().as<std::string>();
+    auto suite = (problem.task_type() == task_type::suite);
+    trrojan::stream::timeline timeline(name, suite, this->pool.begin(),
+        this->pool.end());
+
+    // Name the files after the hash the journal uses for the configuration,
+    // which is stable across runs and thus also when a run is resumed.
+    std::string path;
+    {
+        std::stringstream ss;
+        ss << prefix << "-" << std::hex << std::setw(16) << std::setfill('0')
+            << journal::hash(config);
+        path = ss.str();
+    }
+    try {
+        // The timeline is only a by-product, so a failure to write it must
+        // not discard the result of the measurement.
+        timeline.write_json(path + ".json", config);
+        timeline.write_binary(path + ".trtl");
+        log::instance().write_line(log_level::information, "The timeline of "
+            "{0} thread(s) has been exported to \"{1}.json\" and "
+            "\"{1}.trtl\".", timeline.ranks(), path);
+    } catch (const std::exception& ex) {
+        log::instance().write_line(ex);
+    }
 }
 
 
@@ -152,7 +290,8 @@ trrojan::result trrojan::stream::stream_benchmark::run(
  * trrojan::stream::stream_benchmark::to_problem
  */
 trrojan::stream::problem::pointer_type
-trrojan::stream::stream_benchmark::to_problem(const configuration& c) {
+trrojan::stream::stream_benchmark::to_problem(const configuration& c,
+        problem *recycled) {
     assert(c.contains(factor_scalar_type));
     assert(c.contains(factor_scalar));
     assert(c.contains(factor_access_pattern));
@@ -164,7 +303,20 @@ trrojan::stream::stream_benchmark::to_problem(const configuration& c) {
     auto size = c.get(factor_problem_size, problem::default_problem_size);
     auto iterations = c.get(factor_iterations, problem::default_iterations);
     auto parallelism = c.get(factor_threads, 1);
+    auto mixReads = c.get(factor_mix_reads, problem::default_mix_reads);
+    auto mixWrites = c.get(factor_mix_writes, problem::default_mix_writes);
+    auto verify = c.get(factor_verify, false);
 
-    return std::make_shared<problem>(scalar, value, task, pattern, size,
-        iterations, parallelism);
+    access_pattern_parameters params;
+    params.block_size = c.get(factor_block_size, params.block_size);
+    params.row_length = c.get(factor_row_length, params.row_length);
+    params.stride = c.get(factor_stride, params.stride);
+    params.tile_height = c.get(factor_tile_height, params.tile_height);
+    params.tile_width = c.get(factor_tile_width, params.tile_width);
+
+    auto retval = std::make_shared<problem>(scalar, value, task, pattern, size,
+        iterations, parallelism, mixReads, mixWrites, params, verify,
+        recycled);
+
+    return retval;
 }
@@ -0,0 +1,198 @@
+/// <copyright file="timeline.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#include "trrojan/stream/timeline.h"
+
+#include <fstream>
+#include <sstream>
+#include <stdexcept>
+
+#include "trrojan/json_util.h"
+
+#include "trrojan/stream/task_type.h"
+
+
+namespace trrojan {
+namespace stream {
+namespace detail {
+
+    /// <summary>
+    /// Opens <paramref name="path" /> for writing or throws.
+    /// </summary>
+    static std::ofstream open_timeline(const std::string& path) {
+        std::ofstream retval(path, std::ios::trunc | std::ios::binary);
+        if (!retval) {
+            std::stringstream msg;
+            msg << "Failed to open timeline file \"" << path << "\""
+                << std::ends;
+            throw std::runtime_error(msg.str());
+        }
+        return retval;
+    }
+
+    /// <summary>
+    /// Writes a complete event (phase &quot;X&quot;) spanning from
+    /// <paramref name="start" /> to <paramref name="start" /> +
+    /// <paramref name="duration" /> milliseconds.
+    /// </summary>
+    static void write_json_span(std::ostream& stream, const std::string& name,
+            const char *category, const std::size_t rank,
+            const std::size_t iteration, const timer::millis_type start,
+            const timer::millis_type duration) {
+        // The trace event format expects microseconds.
+        stream << ",\n{\"name\":";
+        print_json_string(stream, name);
+        stream << ",\"cat\":\"" << category
+            << "\",\"ph\":\"X\",\"pid\":0,\"tid\":" << rank
+            << ",\"ts\":" << start * 1000.0
+            << ",\"dur\":" << duration * 1000.0
+            << ",\"args\":{\"iteration\":" << iteration << "}}";
+    }
+
+    /// <summary>
+    /// Writes <paramref name="value" /> in native byte order.
+    /// </summary>
+    template<class T>
+    static inline void write_binary_value(std::ostream& stream,
+            const T value) {
+        stream.write(reinterpret_cast<const char *>(&value), sizeof(value));
+    }
+
+} /* end namespace detail */
+} /* end namespace stream */
+} /* end namespace trrojan */
+
+
+/*
+ * trrojan::stream::timeline::binary_magic
+ */
+const std::uint32_t trrojan::stream::timeline::binary_magic = 0x4C545254;
+
+
+/*
+ * trrojan::stream::timeline::binary_version
+ */
+const std::uint32_t trrojan::stream::timeline::binary_version = 1;
+
+
+/*
+ * trrojan::stream::timeline::write_binary
+ */
+void trrojan::stream::timeline::write_binary(const std::string& path) const {
+    auto stream = detail::open_timeline(path);
+    const auto kernels = this->_suite ? worker_thread::suite_kernels : 0;
+
+    detail::write_binary_value(stream, binary_magic);
+    detail::write_binary_value(stream, binary_version);
+    detail::write_binary_value(stream,
+        static_cast<std::uint32_t>(this->ranks()));
+    detail::write_binary_value(stream,
+        static_cast<std::uint32_t>(this->iterations()));
+    detail::write_binary_value(stream, static_cast<std::uint32_t>(kernels));
+    detail::write_binary_value(stream, static_cast<std::uint32_t>(0));
+    detail::write_binary_value(stream, this->_origin);
+
+    for (auto& rank : this->_ranks) {
+        for (auto& r : rank) {
+            detail::write_binary_value(stream,
+                timer::millis_since_epoch(r.start) - this->_origin);
+            detail::write_binary_value(stream, r.wait_time);
+            detail::write_binary_value(stream, r.time);
+            for (std::size_t k = 0; k < kernels; ++k) {
+                detail::write_binary_value(stream, r.kernel_times[k]);
+                detail::write_binary_value(stream, r.kernel_waits[k]);
+            }
+        }
+    }
+
+    if (!stream) {
+        throw std::runtime_error("Failed to write binary timeline.");
+    }
+}
+
+
+/*
+ * trrojan::stream::timeline::write_json
+ */
+void trrojan::stream::timeline::write_json(const std::string& path,
+        const configuration& config) const {
+    static const std::string kernelNames[worker_thread::suite_kernels] = {
+        task_type_traits<task_type::copy>::name(),
+        task_type_traits<task_type::scale>::name(),
+        task_type_traits<task_type::add>::name(),
+        task_type_traits<task_type::triad>::name() };
+    static const std::string wait("barrier");
+    auto stream = detail::open_timeline(path);
+
+    stream << std::fixed;
+    stream.precision(3);
+
+    // Name the process after the task and the threads after their rank.
+    stream << "{\"displayTimeUnit\":\"ms\",\"traceEvents\":[\n"
+        << "{\"name\":\"process_name\",\"ph\":\"M\",\"pid\":0,\"args\":"
+        << "{\"name\":";
+    print_json_string(stream, this->_name);
+    stream << "}}";
+
+    for (std::size_t t = 0; t < this->_ranks.size(); ++t) {
+        stream << ",\n{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":0,"
+            << "\"tid\":" << t << ",\"args\":{\"name\":\"rank " << t
+            << "\"}}";
+    }
+
+    for (std::size_t t = 0; t < this->_ranks.size(); ++t) {
+        auto& rank = this->_ranks[t];
+        for (std::size_t i = 0; i < rank.size(); ++i) {
+            auto& r = rank[i];
+            auto start = timer::millis_since_epoch(r.start) - this->_origin;
+
+            detail::write_json_span(stream, wait, "wait", t, i,
+                start - r.wait_time, r.wait_time);
+
+            if (this->_suite) {
+                // The kernels follow each other with the waits for the
+                // barrier in between, the first of which is the one before
+                // the iteration.
+                auto end = start;
+                for (std::size_t k = 0; k < worker_thread::suite_kernels;
+                        ++k) {
+                    if (k > 0) {
+                        detail::write_json_span(stream, wait, "wait", t, i,
+                            end, r.kernel_waits[k]);
+                        end += r.kernel_waits[k];
+                    }
+                    detail::write_json_span(stream, kernelNames[k], "kernel",
+                        t, i, end, r.kernel_times[k]);
+                    end += r.kernel_times[k];
+                }
+
+                detail::write_json_span(stream, this->_name, "iteration", t,
+                    i, start, end - start);
+
+            } else {
+                detail::write_json_span(stream, this->_name, "iteration", t,
+                    i, start, r.time);
+            }
+        }
+    }
+
+    // Embed the configuration such that the trace is self-contained.
+    stream << "\n],\"otherData\":{\"origin\":";
+    print_json_string(stream, std::to_string(this->_origin));
+    for (auto& f : config) {
+        std::stringstream value;
+        value << f.value();
+        stream << ",";
+        print_json_string(stream, f.name());
+        stream << ":";
+        print_json_string(stream, value.str());
+    }
+    stream << "}}\n";
+
+    if (!stream) {
+        throw std::runtime_error("Failed to write trace of the timeline.");
+    }
+}
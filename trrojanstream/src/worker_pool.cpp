@@ -0,0 +1,150 @@
+/// <copyright file="worker_pool.cpp" company="Visualisierungsinstitut der Universität Stuttgart">
+/// Copyright © 2024 Visualisierungsinstitut der Universität Stuttgart.
+/// Licensed under the MIT licence. See LICENCE.txt file in the project root for full licence information.
+/// </copyright>
+/// <author>Christoph Müller</author>
+
+#include "trrojan/stream/worker_pool.h"
+
+#include <algorithm>
+#include <cassert>
+#include <limits>
+#include <stdexcept>
+
+#include "trrojan/log.h"
+
+
+/*
+ * trrojan::stream::worker_pool::placed_by_rank
+ */
+const std::uint32_t trrojan::stream::worker_pool::placed_by_rank
+    = (std::numeric_limits<std::uint32_t>::max)();
+
+
+/*
+ * trrojan::stream::worker_pool::worker_pool
+ */
+trrojan::stream::worker_pool::worker_pool(void)
+    : _startup_time(0), _teardown_time(0) { }
+
+
+/*
+ * trrojan::stream::worker_pool::~worker_pool
+ */
+trrojan::stream::worker_pool::~worker_pool(void) {
+    try {
+        this->stop();
+    } catch (std::exception& ex) {
+        log::instance().write_line(ex);
+    }
+}
+
+
+/*
+ * trrojan::stream::worker_pool::resize
+ */
+void trrojan::stream::worker_pool::resize(const std::size_t parallelism) {
+    this->resize(std::vector<std::uint32_t>(parallelism, placed_by_rank));
+}
+
+
+/*
+ * trrojan::stream::worker_pool::resize
+ */
+void trrojan::stream::worker_pool::resize(
+        const std::vector<std::uint32_t>& processors) {
+    assert(this->processors.size() == this->workers.size());
+    const auto parallelism = processors.size();
+    trrojan::timer timer;
+
+    this->_startup_time = 0;
+    this->_teardown_time = 0;
+
+    // Keep all threads up to the first one that is surplus or pinned to the
+    // wrong processor.
+    auto keep = (std::min)(parallelism, this->workers.size());
+    {
+        auto mismatch = std::mismatch(processors.begin(),
+            processors.begin() + keep, this->processors.begin());
+        keep = std::distance(processors.begin(), mismatch.first);
+    }
+
+    if (keep < this->workers.size()) {
+        log::instance().write_line(log_level::verbose, "Stopping {0} surplus "
+            "or misplaced worker thread(s) ...", this->workers.size() - keep);
+        timer.start();
+        for (auto i = keep; i < this->workers.size(); ++i) {
+            this->workers[i]->stop();
+        }
+        this->workers.resize(keep);
+        this->_teardown_time = timer.elapsed_millis();
+    }
+
+    if (parallelism > this->workers.size()) {
+        log::instance().write_line(log_level::verbose, "Starting {0} "
+            "additional worker thread(s) ...",
+            parallelism - this->workers.size());
+        timer.start();
+        this->workers.reserve(parallelism);
+        for (auto i = this->workers.size(); i < parallelism; ++i) {
+            auto p = processors[i];
+            this->workers.push_back((p == placed_by_rank)
+                ? worker_thread::create_idle(i)
+                : worker_thread::create_idle(i,
+                    worker_thread::affinity_mask(p),
+                    worker_thread::affinity_group(p)));
+        }
+        this->_startup_time = timer.elapsed_millis();
+    }
+
+    this->processors = processors;
+}
+
+
+/*
+ * trrojan::stream::worker_pool::run
+ */
+void trrojan::stream::worker_pool::run(worker_thread::problem_type problem) {
+    if (problem == nullptr) {
+        throw std::invalid_argument("The problem must not be null.");
+    }
+
+    // Make sure that the threads have completed the verification of the
+    // previous problem before posting the next one.
+    this->wait();
+
+    if (this->workers.size() != problem->parallelism()) {
+        this->resize(problem->parallelism());
+    }
+
+    auto barrier = worker_thread::make_barrier(problem->parallelism());
+    for (auto& w : this->workers) {
+        w->post(problem, barrier);
+    }
+
+    for (auto& w : this->workers) {
+        w->wait_for_measurement();
+    }
+}
+
+
+/*
+ * trrojan::stream::worker_pool::wait
+ */
+void trrojan::stream::worker_pool::wait(void) {
+    for (auto& w : this->workers) {
+        w->wait();
+    }
+}
+
+
+/*
+ * trrojan::stream::worker_pool::stop
+ */
+void trrojan::stream::worker_pool::stop(void) {
+    for (auto& w : this->workers) {
+        w->stop();
+    }
+    this->processors.clear();
+    this->workers.clear();
+}
@@ -6,6 +6,72 @@
 
 #include "trrojan/stream/worker_thread.h"
 
+#include "trrojan/system_topology.h"
+
+
+namespace trrojan {
+namespace stream {
+namespace detail {
+
+#if defined(_WIN32)
+    /// <summary>
+    /// Computes the group affinity for the given mask and group or, if the
+    /// mask is zero, for the given rank.
+    /// </summary>
+    static GROUP_AFFINITY make_affinity(const std::size_t rank,
+            const uint64_t affinity_mask, const uint16_t affinity_group) {
+        GROUP_AFFINITY retval;
+        ::ZeroMemory(&retval, sizeof(retval));
+
+        if (affinity_mask != 0) {
+            retval.Group = affinity_group;
+            retval.Mask = affinity_mask;
+        } else {
+            uint64_t groupSize = sizeof(retval.Mask) * CHAR_BIT;
+            uint64_t r = rank;
+            retval.Group = static_cast<WORD>(r / groupSize);
+            r %= groupSize;
+            retval.Mask = static_cast<uint64_t>(1) << r;
+        }
+
+        return retval;
+    }
+
+#else /* defined(_WIN32) */
+    /// <summary>
+    /// Computes the CPU set for the given mask and group or, if the mask is
+    /// zero, for the given rank.
+    /// </summary>
+    static cpu_set_t make_affinity(const std::size_t rank,
+            const uint64_t affinity_mask, const uint16_t affinity_group) {
+        cpu_set_t retval;
+        CPU_ZERO(&retval);
+
+        if (affinity_mask != 0) {
+            // Interpret the group as in Windows, ie as block of 64 logical
+            // processors.
+            const auto groupSize = sizeof(affinity_mask) * CHAR_BIT;
+            for (std::size_t i = 0; i < groupSize; ++i) {
+                if ((affinity_mask & (static_cast<uint64_t>(1) << i)) != 0) {
+                    CPU_SET(affinity_group * groupSize + i, &retval);
+                }
+            }
+        } else {
+            // Place the ranks on distinct physical cores first and use the
+            // SMT siblings only if there are more threads than cores.
+            auto placement = system_topology::instance().placement();
+            assert(!placement.empty());
+            CPU_SET(placement[rank % placement.size()], &retval);
+        }
+
+        return retval;
+    }
+#endif /* defined(_WIN32) */
+
+} /* end namespace detail */
+} /* end namespace stream */
+} /* end namespace trrojan */
+
 
 /*
  * trrojan::stream::worker_thread::create
@@ -42,6 +108,93 @@ trrojan::stream::worker_thread::create(problem_type problem) {
 }
 
 
+/*
+ * trrojan::stream::worker_thread::create_idle
+ */
+trrojan::stream::worker_thread::pointer_type
+trrojan::stream::worker_thread::create_idle(const rank_type rank,
+        const uint64_t affinity_mask, const uint16_t affinity_group) {
+    auto retval = std::make_shared<worker_thread>();
+    retval->start(rank, affinity_mask, affinity_group);
+    return retval;
+}
+
+
+/*
+ * trrojan::stream::worker_thread::~worker_thread
+ */
+trrojan::stream::worker_thread::~worker_thread(void) {
+    try {
+        this->stop();
+    } catch (std::exception& ex) {
+        log::instance().write_line(ex);
+    }
+}
+
+
+/*
+ * trrojan::stream::worker_thread::pin_calling_thread
+ */
+void trrojan::stream::worker_thread::pin_calling_thread(
+        const std::uint32_t processor) {
+    const auto mask = worker_thread::affinity_mask(processor);
+    const auto group = worker_thread::affinity_group(processor);
+    auto affinity = detail::make_affinity(0, mask, group);
+
+#ifdef _WIN32
+    if (!::SetThreadGroupAffinity(::GetCurrentThread(), &affinity, nullptr)) {
+        std::error_code ec(::GetLastError(), std::system_category());
+        throw std::system_error(ec, "Setting thread affinity failed.");
+    }
+
+#else /* _WIN32 */
+    auto status = ::pthread_setaffinity_np(::pthread_self(), sizeof(affinity),
+        &affinity);
+    if (status != 0) {
+        std::error_code ec(status, std::system_category());
+        throw std::system_error(ec, "Setting thread affinity failed.");
+    }
+#endif /* _WIN32 */
+}
+
+
+/*
+ * trrojan::stream::worker_thread::post
+ */
+void trrojan::stream::worker_thread::post(problem_type problem,
+        barrier_type barrier) {
+    if (problem == nullptr) {
+        throw std::invalid_argument("The problem must not be null.");
+    }
+    if (barrier == nullptr) {
+        throw std::invalid_argument("The barrier must not be null.");
+    }
+    if (!this->persistent) {
+        throw std::logic_error("Problems can only be posted to persistent "
+            "worker threads.");
+    }
+
+    std::lock_guard<std::mutex> l(this->command_lock);
+    if (this->command != command_type::idle) {
+        throw std::logic_error("A problem can only be posted to a worker "
+            "thread which is idle.");
+    }
+
+    this->barrier = barrier;
+    this->measured = false;
+    this->_problem = problem;
+
+    // The thread is waiting for the command, so it is not holding the lock
+    // for the results at this point.
+    this->results_lock.lock();
+    this->results.resize(this->_problem->iterations() + 1);
+    this->results_lock.unlock();
+
+    this->command = command_type::run;
+    this->command_changed.notify_all();
+}
+
+
 /*
  * trrojan::stream::worker_thread::start
  */
@@ -60,8 +213,11 @@ void trrojan::stream::worker_thread::start(problem_type problem,
     }
 
     this->barrier = barrier;
+    this->measured = false;
     this->_problem = problem;
     this->rank = rank;
+    this->command = command_type::run;
+    this->persistent = false;
 
     /* Allocate the result set before starting the thread. */
     this->results_lock.lock();
@@ -70,7 +226,119 @@ void trrojan::stream::worker_thread::start(problem_type problem,
 
     trrojan::log::instance().write(log_level::verbose, "Starting worker "
         "thread with rank {}...\n", this->rank);
+    this->spawn(affinity_mask, affinity_group);
+}
+
+
+/*
+ * trrojan::stream::worker_thread::start
+ */
+void trrojan::stream::worker_thread::start(const rank_type rank,
+        const uint64_t affinity_mask, const uint16_t affinity_group) {
+    if (this->hThread != static_cast<handle_type>(0)) {
+        throw std::logic_error("A worker thread can only be started while it "
+            "is not yet running.");
+    }
+
+    this->rank = rank;
+    this->command = command_type::idle;
+    this->persistent = true;
+
+    trrojan::log::instance().write(log_level::verbose, "Starting persistent "
+        "worker thread with rank {}...\n", this->rank);
+    this->spawn(affinity_mask, affinity_group);
+}
+
+
+/*
+ * trrojan::stream::worker_thread::stop
+ */
+void trrojan::stream::worker_thread::stop(void) {
+    if (!this->persistent
+            || (this->hThread == static_cast<handle_type>(0))) {
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> l(this->command_lock);
+        this->command = command_type::exit;
+        this->command_changed.notify_all();
+    }
 
+#ifdef _WIN32
+    auto status = ::WaitForSingleObject(this->hThread, INFINITE);
+    if (status != WAIT_OBJECT_0) {
+        std::error_code ec(::GetLastError(), std::system_category());
+        throw std::system_error(ec, "Failed to join worker thread.");
+    }
+    ::CloseHandle(this->hThread);
+
+#else /* _WIN32 */
+    auto status = ::pthread_join(this->hThread, nullptr);
+    if (status != 0) {
+        std::error_code ec(status, std::system_category());
+        throw std::system_error(ec, "Failed to join worker thread.");
+    }
+#endif /* _WIN32 */
+
+    this->hThread = static_cast<handle_type>(0);
+    this->persistent = false;
+    this->command = command_type::idle;
+}
+
+
+/*
+ * trrojan::stream::worker_thread::wait
+ */
+void trrojan::stream::worker_thread::wait(void) {
+    std::unique_lock<std::mutex> l(this->command_lock);
+    this->command_changed.wait(l, [this](void) {
+        return (this->command != command_type::run);
+    });
+}
+
+
+/*
+ * trrojan::stream::worker_thread::wait_for_measurement
+ */
+void trrojan::stream::worker_thread::wait_for_measurement(void) {
+    std::unique_lock<std::mutex> l(this->command_lock);
+    this->command_changed.wait(l, [this](void) {
+        return (this->measured || (this->command != command_type::run));
+    });
+}
+
+
+/*
+ * trrojan::stream::worker_thread::execute
+ */
+void trrojan::stream::worker_thread::execute(void) {
+    assert(this->_problem != nullptr);
+    this->results_lock.lock();
+    this->dispatch(scalar_type_list(),
+        this->_problem->scalar_type(),
+        this->_problem->access_pattern(),
+        this->_problem->size(),
+        this->_problem->task_type());
+    this->results_lock.unlock();
+}
+
+
+/*
+ * trrojan::stream::worker_thread::signal_measured
+ */
+void trrojan::stream::worker_thread::signal_measured(void) {
+    std::lock_guard<std::mutex> l(this->command_lock);
+    this->measured = true;
+    this->command_changed.notify_all();
+}
+
+
+/*
+ * trrojan::stream::worker_thread::spawn
+ */
+void trrojan::stream::worker_thread::spawn(const uint64_t affinity_mask,
+        const uint16_t affinity_group) {
 #ifdef _WIN32
     /* Create suspended thread. */
     this->hThread = ::CreateThread(nullptr, 0, worker_thread::thunk, this,
@@ -82,19 +350,8 @@ void trrojan::stream::worker_thread::start(problem_type problem,
 
     /* Set affinity. */
     {
-        GROUP_AFFINITY ga;
-        ::ZeroMemory(&ga, sizeof(ga));
-        if (affinity_mask != 0) {
-            ga.Group = affinity_group;
-            ga.Mask = affinity_mask;
-        } else {
-            uint64_t groupSize = sizeof(ga.Mask) * CHAR_BIT;
-            uint64_t r = rank;
-            ga.Group = static_cast<WORD>(r / groupSize);
-            r %= groupSize;
-            ga.Mask = static_cast<uint64_t>(1) << r;
-        }
-
+        auto ga = detail::make_affinity(this->rank, affinity_mask,
+            affinity_group);
         auto status = ::SetThreadGroupAffinity(this->hThread, &ga, nullptr);
         if (!status) {
             std::error_code ec(::GetLastError(), std::system_category());
@@ -123,40 +380,37 @@ void trrojan::stream::worker_thread::start(problem_type problem,
     }
 
 #else /* _WIN32 */
+    /* Determine the affinity. */
+    auto cpuset = detail::make_affinity(this->rank, affinity_mask,
+        affinity_group);
+
     pthread_attr_t attribs;
     ::pthread_attr_init(&attribs);
     ::pthread_attr_setscope(&attribs, PTHREAD_SCOPE_SYSTEM);
     ::pthread_attr_setdetachstate(&attribs, PTHREAD_CREATE_JOINABLE);
 
-    if (::pthread_create(&this->hThread, &attribs, worker_thread::thunk,
-            static_cast<void *>(this)) != 0) {
-        std::error_code ec(errno, std::system_category());
-        ::pthread_attr_destroy(&attribs);
-        throw std::system_error(ec, "Failed to spawn worker thread.");
-    } else {
-        ::pthread_attr_destroy(&attribs);
+    /* Set affinity before the thread starts running. */
+    {
+        auto status = ::pthread_attr_setaffinity_np(&attribs, sizeof(cpuset),
+            &cpuset);
+        if (status != 0) {
+            std::error_code ec(status, std::system_category());
+            ::pthread_attr_destroy(&attribs);
+            throw std::system_error(ec, "Setting thread affinity failed.");
+        }
     }
 
-    // TODO: priority
-    // TODO: affinity
-
-    log::instance().write(log_level::error, "TODO: IMPLEMENTATION OF AFFINITY MISSING!\n");
-
-    // http://eli.thegreenplace.net/2016/c11-threads-affinity-and-hyperthreading/
-    /*
-    // Create a cpu_set_t object representing a set of CPUs. Clear it and mark
-    // only CPU i as set.
-    cpu_set_t cpuset;
-    CPU_ZERO(&cpuset);
-    CPU_SET(i, &cpuset);
-    int rc = pthread_setaffinity_np(threads[i].native_handle(),
-    sizeof(cpu_set_t), &cpuset);
-    if (rc != 0) {
-    std::cerr << "Error calling pthread_setaffinity_np: " << rc << "\n";
+    {
+        auto status = ::pthread_create(&this->hThread, &attribs,
+            worker_thread::thunk, static_cast<void *>(this));
+        ::pthread_attr_destroy(&attribs);
+        if (status != 0) {
+            std::error_code ec(status, std::system_category());
+            throw std::system_error(ec, "Failed to spawn worker thread.");
+        }
     }
-    */
 
-//    throw 1;
+    // TODO: priority
 
 #endif /* _WIN32 */
 }
@@ -172,15 +426,27 @@ void *trrojan::stream::worker_thread::thunk(void *param) {
 #endif /* _WIN32*/
     auto that = static_cast<worker_thread *>(param);
     assert(that != nullptr);
-    assert(that->_problem != nullptr);
 
-    that->results_lock.lock();
-    that->dispatch(scalar_type_list(),
-        that->_problem->scalar_type(),
-        that->_problem->access_pattern(),
-        that->_problem->size(),
-        that->_problem->task_type());
-    that->results_lock.unlock();
+    // Persistent threads process one problem after the other until they are
+    // told to exit. All other threads process their problem only once.
+    do {
+        std::unique_lock<std::mutex> l(that->command_lock);
+        that->command_changed.wait(l, [that](void) {
+            return (that->command != command_type::idle);
+        });
+        if (that->command == command_type::exit) {
+            break;
+        }
+        l.unlock();
+
+        that->execute();
+
+        l.lock();
+        if (that->command == command_type::run) {
+            that->command = command_type::idle;
+        }
+        that->command_changed.notify_all();
+    } while (that->persistent);
 
     return 0;
 }
@@ -196,10 +462,13 @@ void trrojan::stream::worker_thread::synchronise(const int barrierId) {
     assert(this->_problem != nullptr);
     assert(INT_MAX / this->_problem->parallelism() > barrierId);
     auto& barrier = *this->barrier;
+    // The barrier starts at the number of threads and each thread increments
+    // it once for every consecutive barrier ID, so all threads have arrived
+    // once it has reached the following value.
     auto expected = static_cast<int>(this->_problem->parallelism());
-    expected *= (barrierId + 1);
+    expected *= (barrierId + 2);
     ++barrier;
-    while (barrier.load() - barrierId < 0);    // TODO: Should yield if too many threads?
+    while (barrier.load() < expected);    // TODO: Should yield if too many threads?
 }
 
 #if 0